@@ -0,0 +1,509 @@
+
+/*
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+/*
+ * Deterministic check of the QUIC congestion controllers and pacing.
+ *
+ * A bulk sender driven by ngx_event_quic_congestion.c runs over a
+ * simulated bottleneck with a fixed rate, base RTT and drop-tail
+ * queue, and optionally a random loss rate.  Time advances in steps
+ * of 1 ms in ngx_current_msec, and random numbers come from a fixed
+ * seed, so every run produces the same numbers.
+ *
+ * The ack and loss accounting of ngx_quic_congestion_ack() and
+ * ngx_quic_congestion_lost() is repeated here, a dropped packet is
+ * declared lost once a packet sent 3 packets later is acknowledged,
+ * or after 2 RTTs.  The following is checked for every scenario:
+ *
+ *     the window is never below the minimum of the controller;
+ *     no more than the pacing burst is sent at once with pacing,
+ *     after the initial window;
+ *     a loss reduces the window of reno to 1/2 and of cubic to 0.7;
+ *     the link is utilized to the scenario's minimum;
+ *     bbr estimates the bottleneck rate and the base RTT.
+ *
+ * The average queue is reported but not checked.
+ *
+ * After nginx is configured with --with-http_v3_module, with the
+ * include paths of ALL_INCS in objs/Makefile as $INCS:
+ *
+ *     cc -g -O2 $INCS misc/ngx_event_quic_cc_sim.c \
+ *         src/event/quic/ngx_event_quic_congestion.c \
+ *         src/event/ngx_event_timer.c src/core/ngx_rbtree.c \
+ *         -o objs/ngx_event_quic_cc_sim
+ *
+ *     objs/ngx_event_quic_cc_sim [-v]
+ *
+ * With -v, the state is printed every 100 ms.  The program exits
+ * with 1 if a check fails.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_event.h>
+#include <ngx_event_quic_connection.h>
+
+
+#define NGX_SIM_MTU          1200
+#define NGX_SIM_PACKETS      65536
+#define NGX_SIM_DURATION     20000   /* ms */
+
+
+typedef struct {
+    char            *name;
+    ngx_uint_t       congestion;
+    size_t           rate;           /* bytes per ms */
+    ngx_msec_t       rtt;            /* base RTT, ms */
+    size_t           queue;          /* bottleneck queue, bytes */
+    ngx_uint_t       loss;           /* random loss, per 10000 packets */
+    ngx_uint_t       utilization;    /* required, percents */
+} ngx_sim_scenario_t;
+
+
+typedef struct {
+    ngx_quic_frame_t  frame;
+    ngx_msec_t        ack_time;
+    unsigned          dropped:1;
+    unsigned          done:1;
+} ngx_sim_packet_t;
+
+
+static ngx_int_t ngx_sim_run(ngx_sim_scenario_t *sc, ngx_uint_t verbose);
+static void ngx_sim_ack(ngx_connection_t *c, ngx_quic_frame_t *f);
+static ngx_int_t ngx_sim_lost(ngx_connection_t *c, ngx_quic_frame_t *f,
+    ngx_sim_scenario_t *sc);
+static void ngx_sim_update_rtt(ngx_quic_connection_t *qc, ngx_msec_t rtt);
+static void ngx_sim_pacing_handler(ngx_event_t *ev);
+static ngx_uint_t ngx_sim_random(void);
+
+
+volatile ngx_cycle_t  *ngx_cycle;
+volatile ngx_msec_t    ngx_current_msec;
+
+static uint64_t          ngx_sim_seed;
+static ngx_sim_packet_t  ngx_sim_packets[NGX_SIM_PACKETS];
+
+
+static ngx_sim_scenario_t  ngx_sim_scenarios[] = {
+
+    /* 10 Mbit/s, 40 ms, a BDP of queue */
+    { "reno", NGX_QUIC_CONGESTION_RENO, 1250, 40, 50000, 0, 80 },
+    { "cubic", NGX_QUIC_CONGESTION_CUBIC, 1250, 40, 50000, 0, 85 },
+    { "bbr", NGX_QUIC_CONGESTION_BBR, 1250, 40, 50000, 0, 85 },
+
+    /* 50 Mbit/s, 100 ms, a shallow queue and 1% random loss */
+    { "reno", NGX_QUIC_CONGESTION_RENO, 6250, 100, 62500, 100, 0 },
+    { "cubic", NGX_QUIC_CONGESTION_CUBIC, 6250, 100, 62500, 100, 0 },
+    { "bbr", NGX_QUIC_CONGESTION_BBR, 6250, 100, 62500, 100, 80 },
+
+    /* 1 Mbit/s, 20 ms, a deep queue */
+    { "reno", NGX_QUIC_CONGESTION_RENO, 125, 20, 250000, 0, 90 },
+    { "cubic", NGX_QUIC_CONGESTION_CUBIC, 125, 20, 250000, 0, 90 },
+    { "bbr", NGX_QUIC_CONGESTION_BBR, 125, 20, 250000, 0, 90 }
+};
+
+
+int
+main(int argc, char *argv[])
+{
+    ngx_uint_t  i, n, verbose, failed;
+
+    verbose = (argc > 1 && ngx_strcmp(argv[1], "-v") == 0);
+
+    ngx_event_timer_init(NULL);
+
+    n = sizeof(ngx_sim_scenarios) / sizeof(ngx_sim_scenario_t);
+    failed = 0;
+
+    for (i = 0; i < n; i++) {
+        if (ngx_sim_run(&ngx_sim_scenarios[i], verbose) != NGX_OK) {
+            failed = 1;
+        }
+    }
+
+    printf("%s\n", failed ? "failed" : "ok");
+
+    return failed;
+}
+
+
+static ngx_int_t
+ngx_sim_run(ngx_sim_scenario_t *sc, ngx_uint_t verbose)
+{
+    size_t                  burst, credit, queued, sent, min_window;
+    uint64_t                pnum, head, acked, tail, delivered, queue_sum;
+    ngx_int_t               rc;
+    ngx_uint_t              samples;
+    ngx_msec_t              end, start;
+    ngx_quic_path_t         path;
+    ngx_quic_conf_t         conf;
+    ngx_connection_t        c;
+    ngx_sim_packet_t       *p, *q;
+    ngx_quic_socket_t       qsock;
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    qc = calloc(1, sizeof(ngx_quic_connection_t));
+    if (qc == NULL) {
+        return NGX_ERROR;
+    }
+
+    ngx_memzero(&c, sizeof(ngx_connection_t));
+    ngx_memzero(&qsock, sizeof(ngx_quic_socket_t));
+    ngx_memzero(&path, sizeof(ngx_quic_path_t));
+    ngx_memzero(&conf, sizeof(ngx_quic_conf_t));
+    ngx_memzero(ngx_sim_packets, sizeof(ngx_sim_packets));
+
+    ngx_sim_seed = 1;
+    ngx_current_msec = 1000;
+    srandom(1);
+
+    qsock.quic = qc;
+    c.udp = &qsock.udp;
+
+    conf.congestion = sc->congestion;
+    path.mtu = NGX_SIM_MTU;
+
+    qc->conf = &conf;
+    qc->path = &path;
+    qc->tp.max_udp_payload_size = NGX_SIM_MTU;
+
+    qc->pacing.handler = ngx_sim_pacing_handler;
+    qc->pacing.data = &c;
+
+    ngx_quic_init_rtt(qc);
+    ngx_quic_congestion_init(qc);
+
+    cg = &qc->congestion;
+
+    min_window = (sc->congestion == NGX_QUIC_CONGESTION_BBR)
+                 ? 4 * NGX_SIM_MTU : 2 * NGX_SIM_MTU;
+
+    pnum = 0;
+    head = 0;
+    acked = 0;
+    tail = 0;
+    queued = 0;
+    credit = 0;
+    delivered = 0;
+    queue_sum = 0;
+    samples = 0;
+    rc = NGX_OK;
+
+    start = ngx_current_msec + NGX_SIM_DURATION / 2;
+    end = ngx_current_msec + NGX_SIM_DURATION;
+
+    for ( /* void */ ; ngx_current_msec != end; ngx_current_msec++) {
+
+        ngx_event_expire_timers();
+
+        /* acknowledgments, in order as the queue is FIFO */
+
+        while (acked != tail) {
+            p = &ngx_sim_packets[acked % NGX_SIM_PACKETS];
+
+            if (p->dropped || p->done) {
+                acked++;
+                continue;
+            }
+
+            if (p->ack_time == 0
+                || (ngx_msec_int_t) (p->ack_time - ngx_current_msec) > 0)
+            {
+                break;
+            }
+
+            /* losses found by the packet threshold */
+
+            for ( /* void */ ; head + 3 <= p->frame.pnum; head++) {
+                q = &ngx_sim_packets[head % NGX_SIM_PACKETS];
+
+                if (!q->done && ngx_sim_lost(&c, &q->frame, sc) != NGX_OK) {
+                    rc = NGX_ERROR;
+                }
+            }
+
+            ngx_sim_update_rtt(qc, ngx_current_msec - p->frame.send_time);
+            ngx_sim_ack(&c, &p->frame);
+
+            p->done = 1;
+
+            if (ngx_current_msec >= start) {
+                delivered += p->frame.len;
+            }
+
+            acked++;
+        }
+
+        /* losses found by the time threshold */
+
+        for ( /* void */ ; head != pnum; head++) {
+            p = &ngx_sim_packets[head % NGX_SIM_PACKETS];
+
+            if (p->done) {
+                continue;
+            }
+
+            if (!p->dropped
+                || ngx_current_msec - p->frame.send_time < 2 * qc->avg_rtt)
+            {
+                break;
+            }
+
+            if (ngx_sim_lost(&c, &p->frame, sc) != NGX_OK) {
+                rc = NGX_ERROR;
+            }
+        }
+
+        /* the bottleneck serves "rate" bytes per ms */
+
+        credit += sc->rate;
+
+        while (tail != pnum) {
+            p = &ngx_sim_packets[tail % NGX_SIM_PACKETS];
+
+            if (p->dropped) {
+                tail++;
+                continue;
+            }
+
+            if (credit < (size_t) p->frame.len) {
+                break;
+            }
+
+            credit -= p->frame.len;
+            queued -= p->frame.len;
+
+            p->ack_time = ngx_current_msec + sc->rtt;
+
+            tail++;
+        }
+
+        if (tail == pnum) {
+            credit = 0;
+        }
+
+        /* the sender always has data, as in ngx_quic_create_datagrams() */
+
+        sent = 0;
+        burst = ngx_max(cg->pacing_rate * 2 / 1000, 4 * NGX_SIM_MTU)
+                + NGX_SIM_MTU;
+
+        while (cg->in_flight < cg->window
+               && pnum - head < NGX_SIM_PACKETS)
+        {
+            if (ngx_quic_pacing_budget(&c) == 0) {
+                break;
+            }
+
+            p = &ngx_sim_packets[pnum % NGX_SIM_PACKETS];
+            ngx_memzero(p, sizeof(ngx_sim_packet_t));
+
+            p->frame.pnum = pnum++;
+            p->frame.plen = NGX_SIM_MTU;
+            p->frame.len = NGX_SIM_MTU;
+            p->frame.send_time = ngx_current_msec;
+
+            ngx_quic_congestion_sent(&c, &p->frame);
+            ngx_quic_pacing_sent(&c, NGX_SIM_MTU);
+
+            sent += NGX_SIM_MTU;
+
+            if (queued + NGX_SIM_MTU > sc->queue
+                || ngx_sim_random() % 10000 < sc->loss)
+            {
+                p->dropped = 1;
+                continue;
+            }
+
+            queued += NGX_SIM_MTU;
+        }
+
+        /* the initial window is sent at once */
+
+        if (cg->pacing_rate && cg->delivered && sent > burst) {
+            printf("%s: %zu bytes sent at once, burst is %zu\n",
+                   sc->name, sent, burst);
+            rc = NGX_ERROR;
+        }
+
+        if (cg->window < min_window) {
+            printf("%s: window %zu is below %zu\n",
+                   sc->name, cg->window, min_window);
+            rc = NGX_ERROR;
+        }
+
+        if (ngx_current_msec >= start) {
+            queue_sum += queued;
+            samples++;
+        }
+
+        if (verbose && ngx_current_msec % 100 == 0) {
+            printf("  %6lu ms win:%zu if:%zu queue:%zu rate:%lu rtt:%lu\n",
+                   (unsigned long) (ngx_current_msec - 1000), cg->window,
+                   cg->in_flight, queued, (unsigned long) cg->pacing_rate,
+                   (unsigned long) qc->avg_rtt);
+        }
+    }
+
+    delivered = delivered * 100 / (sc->rate * (NGX_SIM_DURATION / 2));
+
+    printf("%-6s %6zu kB/s %4lu ms queue %6zu loss %3lu.%02lu%%: "
+           "utilization %3lu%%, queue %6lu bytes\n",
+           sc->name, sc->rate, (unsigned long) sc->rtt, sc->queue,
+           (unsigned long) sc->loss / 100, (unsigned long) sc->loss % 100,
+           (unsigned long) delivered, (unsigned long) (queue_sum / samples));
+
+    if (delivered < sc->utilization) {
+        printf("%s: utilization below %lu%%\n",
+               sc->name, (unsigned long) sc->utilization);
+        rc = NGX_ERROR;
+    }
+
+    if (sc->congestion == NGX_QUIC_CONGESTION_BBR) {
+
+        if (cg->u.bbr.max_bw < sc->rate * 1000 * 9 / 10
+            || cg->u.bbr.max_bw > sc->rate * 1000 * 3 / 2)
+        {
+            printf("bbr: bandwidth estimate %lu, bottleneck %lu\n",
+                   (unsigned long) cg->u.bbr.max_bw,
+                   (unsigned long) sc->rate * 1000);
+            rc = NGX_ERROR;
+        }
+
+        /* the minimum window of 4 packets is queued at the bottleneck */
+
+        if (cg->u.bbr.min_rtt < sc->rtt
+            || cg->u.bbr.min_rtt > sc->rtt + 4 * NGX_SIM_MTU / sc->rate + 2)
+        {
+            printf("bbr: min rtt %lu, base rtt %lu\n",
+                   (unsigned long) cg->u.bbr.min_rtt,
+                   (unsigned long) sc->rtt);
+            rc = NGX_ERROR;
+        }
+    }
+
+    if (qc->pacing.timer_set) {
+        ngx_del_timer(&qc->pacing);
+    }
+
+    free(qc);
+
+    return rc;
+}
+
+
+static void
+ngx_sim_ack(ngx_connection_t *c, ngx_quic_frame_t *f)
+{
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    /* as in ngx_quic_congestion_ack() */
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+
+    cg->in_flight -= f->plen;
+
+    cg->delivered += f->plen;
+    cg->delivered_time = ngx_current_msec;
+
+    if (cg->app_limited && cg->delivered > cg->app_limited) {
+        cg->app_limited = 0;
+    }
+
+    cg->ops->ack(c, f);
+}
+
+
+static ngx_int_t
+ngx_sim_lost(ngx_connection_t *c, ngx_quic_frame_t *f,
+    ngx_sim_scenario_t *sc)
+{
+    size_t                  window, expected;
+    ngx_msec_t              recovery_start;
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    /* as in ngx_quic_congestion_lost() */
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+
+    if (f->plen == 0) {
+        return NGX_OK;
+    }
+
+    window = cg->window;
+    recovery_start = cg->recovery_start;
+
+    cg->in_flight -= f->plen;
+
+    cg->ops->lost(c, f);
+
+    f->plen = 0;
+
+    ngx_sim_packets[f->pnum % NGX_SIM_PACKETS].done = 1;
+
+    if (cg->recovery_start == recovery_start
+        || sc->congestion == NGX_QUIC_CONGESTION_BBR)
+    {
+        /* inside of a recovery period */
+        return NGX_OK;
+    }
+
+    expected = (sc->congestion == NGX_QUIC_CONGESTION_RENO)
+               ? window / 2 : window * 7 / 10;
+
+    expected = ngx_max(expected, 2 * NGX_SIM_MTU);
+
+    if (cg->window != expected) {
+        printf("%s: window %zu after loss at %zu, expected %zu\n",
+               sc->name, cg->window, window, expected);
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_sim_update_rtt(ngx_quic_connection_t *qc, ngx_msec_t rtt)
+{
+    /* RFC 9002, 5.3, without ack delay */
+
+    if (qc->min_rtt == NGX_TIMER_INFINITE) {
+        qc->min_rtt = rtt;
+        qc->avg_rtt = rtt;
+        qc->rttvar = rtt / 2;
+        return;
+    }
+
+    qc->min_rtt = ngx_min(qc->min_rtt, rtt);
+
+    qc->rttvar = (3 * qc->rttvar
+                  + ngx_abs((ngx_msec_int_t) (qc->avg_rtt - rtt))) / 4;
+    qc->avg_rtt = (7 * qc->avg_rtt + rtt) / 8;
+}
+
+
+static void
+ngx_sim_pacing_handler(ngx_event_t *ev)
+{
+    /* the sender is polled every millisecond */
+}
+
+
+static ngx_uint_t
+ngx_sim_random(void)
+{
+    ngx_sim_seed = ngx_sim_seed * 6364136223846793005ULL
+                   + 1442695040888963407ULL;
+
+    return (ngx_uint_t) (ngx_sim_seed >> 33);
+}
@@ -0,0 +1,196 @@
+
+/*
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+/*
+ * Micro-benchmark of the HPACK and QPACK Huffman decoder.
+ *
+ * Typical request header values are Huffman encoded once and then
+ * decoded repeatedly by ngx_http_huff_decode() and by a second copy
+ * of it built with NGX_HTTP_HUFF_DECODE_FAST disabled, which decodes
+ * a single symbol per step with the 4-bit state table only.  Both
+ * results are checked against the original values before timing.
+ *
+ * After nginx is configured, with the include paths of ALL_INCS
+ * in objs/Makefile as $INCS:
+ *
+ *     cc -O2 $INCS misc/ngx_http_huff_bench.c \
+ *         src/http/ngx_http_huff_decode.c src/http/ngx_http_huff_encode.c \
+ *         -o objs/ngx_http_huff_bench
+ *
+ *     objs/ngx_http_huff_bench [iterations]
+ *
+ * The program prints the time per decoded octet of each decoder,
+ * it exits with 1 if a value is decoded incorrectly.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+#define NGX_HTTP_HUFF_DECODE_FAST  0
+#define ngx_http_huff_decode       ngx_http_huff_decode_single
+
+#include <ngx_http_huff_decode.c>
+
+#undef ngx_http_huff_decode
+
+
+#define NGX_BENCH_MAX_VALUE  512
+
+
+typedef ngx_int_t (*ngx_bench_decode_pt)(u_char *state, u_char *src,
+    size_t len, u_char **dst, ngx_uint_t last, ngx_log_t *log);
+
+
+typedef struct {
+    ngx_str_t       value;
+    size_t          len;
+    u_char          data[NGX_BENCH_MAX_VALUE];
+} ngx_bench_sample_t;
+
+
+static ngx_int_t ngx_bench_check(ngx_bench_decode_pt decode,
+    ngx_bench_sample_t *sample);
+static double ngx_bench_run(ngx_bench_decode_pt decode, ngx_uint_t iterations,
+    size_t *total);
+
+
+volatile ngx_cycle_t  *ngx_cycle;
+
+static ngx_log_t  ngx_bench_log;
+
+
+static ngx_bench_sample_t  ngx_bench_samples[] = {
+    { ngx_string("Mozilla/5.0 (Windows NT 10.0; Win64; x64) "
+                 "AppleWebKit/537.36 (KHTML, like Gecko) "
+                 "Chrome/120.0.0.0 Safari/537.36"), 0, "" },
+    { ngx_string("text/html,application/xhtml+xml,application/xml;q=0.9,"
+                 "image/avif,image/webp,*/*;q=0.8"), 0, "" },
+    { ngx_string("en-US,en;q=0.9,de;q=0.8"), 0, "" },
+    { ngx_string("gzip, deflate, br"), 0, "" },
+    { ngx_string("/static/js/main.4f2a9c1e.chunk.js?v=20231107"), 0, "" },
+    { ngx_string("https://www.example.com/catalog/items?page=2&sort=price"),
+      0, "" },
+    { ngx_string("session=7b1d0e5a9c2f4e8b; _ga=GA1.2.1234567890.1699999999; "
+                 "theme=dark; consent=yes"), 0, "" },
+    { ngx_string("max-age=0"), 0, "" },
+    { ngx_string("W/\"5e1f-18b9a0c4d2e\""), 0, "" },
+    { ngx_string("Tue, 07 Nov 2023 12:34:56 GMT"), 0, "" },
+    { ngx_string("www.example.com"), 0, "" },
+    { ngx_string("Bearer eyJhbGciOiJIUzI1NiIsInR5cCI6IkpXVCJ9.eyJzdWIiOiIx"
+                 "MjM0NTY3ODkwIn0.dozjgNryP4J3jVmNHl0w5N_XgL0n3I9PlFUP0THsR8U"),
+      0, "" }
+};
+
+
+int
+main(int argc, char *argv[])
+{
+    double      multi, single;
+    size_t      total;
+    ngx_uint_t  i, n, iterations;
+
+    iterations = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000000;
+
+    n = sizeof(ngx_bench_samples) / sizeof(ngx_bench_sample_t);
+
+    for (i = 0; i < n; i++) {
+        ngx_bench_samples[i].len =
+                        ngx_http_huff_encode(ngx_bench_samples[i].value.data,
+                                             ngx_bench_samples[i].value.len,
+                                             ngx_bench_samples[i].data, 0);
+
+        if (ngx_bench_check(ngx_http_huff_decode, &ngx_bench_samples[i])
+            != NGX_OK
+            || ngx_bench_check(ngx_http_huff_decode_single,
+                               &ngx_bench_samples[i])
+               != NGX_OK)
+        {
+            printf("value \"%.*s\" decoded incorrectly\n",
+                   (int) ngx_bench_samples[i].value.len,
+                   ngx_bench_samples[i].value.data);
+            return 1;
+        }
+    }
+
+    single = ngx_bench_run(ngx_http_huff_decode_single, iterations, &total);
+    multi = ngx_bench_run(ngx_http_huff_decode, iterations, &total);
+
+    printf("%lu iterations, %lu octets decoded by each\n",
+           (unsigned long) iterations, (unsigned long) total);
+    printf("single-symbol: %.3f ns/octet\n", single * 1e9 / total);
+    printf("multi-symbol:  %.3f ns/octet\n", multi * 1e9 / total);
+    printf("speedup:       %.2f\n", single / multi);
+
+    return 0;
+}
+
+
+static ngx_int_t
+ngx_bench_check(ngx_bench_decode_pt decode, ngx_bench_sample_t *sample)
+{
+    u_char  *p, state, buf[NGX_BENCH_MAX_VALUE];
+
+    if (sample->len == 0) {
+        /* the value is not shorter when encoded */
+        return NGX_OK;
+    }
+
+    state = 0;
+    p = buf;
+
+    if (decode(&state, sample->data, sample->len, &p, 1, &ngx_bench_log)
+        != NGX_OK)
+    {
+        return NGX_ERROR;
+    }
+
+    if ((size_t) (p - buf) != sample->value.len
+        || ngx_memcmp(buf, sample->value.data, sample->value.len) != 0)
+    {
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+
+static double
+ngx_bench_run(ngx_bench_decode_pt decode, ngx_uint_t iterations,
+    size_t *total)
+{
+    u_char              *p, state, buf[NGX_BENCH_MAX_VALUE];
+    ngx_uint_t           i, k, n;
+    struct timespec      start, end;
+    ngx_bench_sample_t  *sample;
+
+    n = sizeof(ngx_bench_samples) / sizeof(ngx_bench_sample_t);
+
+    *total = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (i = 0; i < iterations; i++) {
+        for (k = 0; k < n; k++) {
+            sample = &ngx_bench_samples[k];
+
+            state = 0;
+            p = buf;
+
+            (void) decode(&state, sample->data, sample->len, &p, 1,
+                          &ngx_bench_log);
+
+            *total += p - buf;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (end.tv_sec - start.tv_sec)
+           + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
@@ -0,0 +1,441 @@
+
+/*
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+/*
+ * Differential fuzzer for the SSE4.2 paths of the HTTP request line
+ * and header parsers.
+ *
+ * Every input is parsed twice by the same ngx_http_parse_request_line()
+ * and ngx_http_parse_header_line() calls, with NGX_CPU_SSE42 set and
+ * cleared in ngx_cpu_features, and all return codes, buffer positions
+ * and parsed request fields are compared.  The input is passed in
+ * random chunks, identical for both runs, to cover parsing resumed
+ * in the middle of a skipped run.
+ *
+ * After nginx is configured on a CPU with SSE4.2, with the include
+ * paths of ALL_INCS in objs/Makefile as $INCS:
+ *
+ *     cc -g -O2 -fsanitize=address,undefined -fno-sanitize=alignment \
+ *         $INCS misc/ngx_http_parse_fuzz.c src/http/ngx_http_parse.c \
+ *         src/core/ngx_string.c -o objs/ngx_http_parse_fuzz
+ *
+ *     objs/ngx_http_parse_fuzz [iterations [seed]]
+ *
+ * The alignment check is disabled as the parsers compare methods
+ * with unaligned loads where the platform allows it.  The program
+ * exits with 1 and dumps the input on the first mismatch.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+#define NGX_FUZZ_MAX_INPUT  2048
+#define NGX_FUZZ_MAX_TRACE  256
+
+
+typedef struct {
+    ngx_int_t       rc;
+    off_t           pos;
+
+    ngx_uint_t      method;
+    ngx_uint_t      http_version;
+    off_t           request_start;
+    off_t           request_end;
+    off_t           method_end;
+    off_t           uri_start;
+    off_t           uri_end;
+    off_t           uri_ext;
+    off_t           args_start;
+    off_t           schema_start;
+    off_t           schema_end;
+    off_t           host_start;
+    off_t           host_end;
+    unsigned        complex_uri:1;
+    unsigned        quoted_uri:1;
+    unsigned        plus_in_uri:1;
+    unsigned        empty_path_in_uri:1;
+
+    off_t           header_name_start;
+    off_t           header_name_end;
+    off_t           header_start;
+    off_t           header_end;
+    ngx_uint_t      header_hash;
+    ngx_uint_t      lowcase_index;
+    u_char          lowcase_header[NGX_HTTP_LC_HEADER_LEN];
+    unsigned        invalid_header:1;
+} ngx_fuzz_step_t;
+
+
+typedef struct {
+    ngx_uint_t      nsteps;
+    ngx_fuzz_step_t steps[NGX_FUZZ_MAX_TRACE];
+} ngx_fuzz_trace_t;
+
+
+static void ngx_fuzz_run(u_char *data, size_t len, size_t *splits,
+    ngx_uint_t nsplits, ngx_uint_t underscores, ngx_fuzz_trace_t *trace);
+static void ngx_fuzz_record(ngx_http_request_t *r, ngx_buf_t *b,
+    u_char *start, ngx_int_t rc, ngx_fuzz_trace_t *trace);
+static size_t ngx_fuzz_generate(u_char *p);
+static u_char *ngx_fuzz_string(u_char *p, const char *alphabet, size_t max);
+static void ngx_fuzz_dump(u_char *data, size_t len, size_t *splits,
+    ngx_uint_t nsplits, ngx_uint_t step);
+
+
+volatile ngx_cycle_t  *ngx_cycle;
+ngx_uint_t             ngx_cpu_features;
+
+static ngx_fuzz_trace_t  ngx_fuzz_sse42, ngx_fuzz_scalar;
+
+
+static const char *ngx_fuzz_methods[] = {
+    "GET", "HEAD", "POST", "PUT", "DELETE", "MKCOL", "COPY", "MOVE",
+    "OPTIONS", "PROPFIND", "PROPPATCH", "LOCK", "UNLOCK", "PATCH",
+    "TRACE", "CONNECT", "get", "GE", "G_T", ""
+};
+
+static const char *ngx_fuzz_versions[] = {
+    " HTTP/1.1", " HTTP/1.0", " HTTP/0.9", " HTTP/2.0", " HTTP/1.10",
+    " HTTP/1.1 ", " http/1.1", " HTTP/1.", " HTTP/", ""
+};
+
+static const char *ngx_fuzz_ends[] = {
+    "\r\n", "\n", "\r", "\r\r\n", ""
+};
+
+static const char  ngx_fuzz_uri_chars[] =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
+    "////....??%%%++##--__~~!$&'()*,;=:@ \"<>[\\]^`{|}\t\x01\x7f\x80\xff";
+
+static const char  ngx_fuzz_name_chars[] =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
+    "------____.:;/ \t\x01\x7f\x80\xff";
+
+static const char  ngx_fuzz_value_chars[] =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
+    "          \t\t,;=/:.\"'()<>@?[]{}\\\x01\x7f\x80\xff";
+
+
+int
+main(int argc, char *argv[])
+{
+    size_t      len, splits[16];
+    ngx_uint_t  i, n, k, iterations, seed, nsplits, underscores;
+    u_char      data[NGX_FUZZ_MAX_INPUT];
+
+    iterations = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000000;
+    seed = (argc > 2) ? strtoul(argv[2], NULL, 10) : (ngx_uint_t) time(NULL);
+
+    srandom(seed);
+
+    printf("seed %lu, %lu iterations\n", (unsigned long) seed,
+           (unsigned long) iterations);
+
+    for (n = 0; n < iterations; n++) {
+
+        len = ngx_fuzz_generate(data);
+
+        /* random byte mutations */
+
+        k = random() % 4;
+
+        for (i = 0; len && i < k; i++) {
+            data[random() % len] = (u_char) random();
+        }
+
+        nsplits = random() % 16;
+
+        for (i = 0; i < nsplits; i++) {
+            splits[i] = len ? random() % (len + 1) : 0;
+        }
+
+        underscores = random() % 2;
+
+        ngx_cpu_features = NGX_CPU_SSE42;
+        ngx_fuzz_run(data, len, splits, nsplits, underscores,
+                     &ngx_fuzz_sse42);
+
+        ngx_cpu_features = 0;
+        ngx_fuzz_run(data, len, splits, nsplits, underscores,
+                     &ngx_fuzz_scalar);
+
+        if (ngx_fuzz_sse42.nsteps != ngx_fuzz_scalar.nsteps) {
+            printf("mismatch: %lu steps with sse4.2, %lu without\n",
+                   (unsigned long) ngx_fuzz_sse42.nsteps,
+                   (unsigned long) ngx_fuzz_scalar.nsteps);
+            ngx_fuzz_dump(data, len, splits, nsplits, 0);
+            return 1;
+        }
+
+        for (i = 0; i < ngx_fuzz_sse42.nsteps; i++) {
+            if (ngx_memcmp(&ngx_fuzz_sse42.steps[i], &ngx_fuzz_scalar.steps[i],
+                           sizeof(ngx_fuzz_step_t))
+                != 0)
+            {
+                printf("mismatch at step %lu, rc %ld and %ld\n",
+                       (unsigned long) i,
+                       (long) ngx_fuzz_sse42.steps[i].rc,
+                       (long) ngx_fuzz_scalar.steps[i].rc);
+                ngx_fuzz_dump(data, len, splits, nsplits, i);
+                return 1;
+            }
+        }
+    }
+
+    printf("ok\n");
+
+    return 0;
+}
+
+
+static void
+ngx_fuzz_run(u_char *data, size_t len, size_t *splits, ngx_uint_t nsplits,
+    ngx_uint_t underscores, ngx_fuzz_trace_t *trace)
+{
+    u_char              *start;
+    ngx_int_t            rc;
+    ngx_buf_t            b;
+    ngx_uint_t           i, headers;
+    ngx_http_request_t   r;
+
+    /*
+     * a fresh copy at the end of an allocation of exactly the input
+     * size lets the address sanitizer catch reads past b->last
+     */
+
+    start = malloc(len + 1);
+    if (start == NULL) {
+        exit(2);
+    }
+
+    ngx_memcpy(start, data, len);
+
+    ngx_memzero(&r, sizeof(ngx_http_request_t));
+    ngx_memzero(&b, sizeof(ngx_buf_t));
+    ngx_memzero(trace, sizeof(ngx_fuzz_trace_t));
+
+    b.start = start;
+    b.pos = start;
+    b.end = start + len;
+
+    headers = 0;
+    i = 0;
+
+    for ( ;; ) {
+
+        /* the next chunk is appended to the buffer */
+
+        while (i < nsplits && start + splits[i] <= b.last) {
+            i++;
+        }
+
+        b.last = (i < nsplits) ? start + splits[i++] : start + len;
+
+        for ( ;; ) {
+
+            if (!headers) {
+                rc = ngx_http_parse_request_line(&r, &b);
+
+            } else {
+                rc = ngx_http_parse_header_line(&r, &b, underscores);
+            }
+
+            ngx_fuzz_record(&r, &b, start, rc, trace);
+
+            if (trace->nsteps == NGX_FUZZ_MAX_TRACE) {
+                goto done;
+            }
+
+            if (rc == NGX_AGAIN) {
+                break;
+            }
+
+            if (!headers && rc == NGX_OK) {
+                headers = 1;
+                continue;
+            }
+
+            if (headers
+                && (rc == NGX_OK || rc == NGX_HTTP_PARSE_INVALID_HEADER))
+            {
+                continue;
+            }
+
+            goto done;
+        }
+
+        if (b.last == start + len) {
+            break;
+        }
+    }
+
+done:
+
+    free(start);
+}
+
+
+#define ngx_fuzz_offset(p)  ((p) ? (off_t) ((p) - start) : -1)
+
+static void
+ngx_fuzz_record(ngx_http_request_t *r, ngx_buf_t *b, u_char *start,
+    ngx_int_t rc, ngx_fuzz_trace_t *trace)
+{
+    ngx_fuzz_step_t  *s;
+
+    s = &trace->steps[trace->nsteps++];
+
+    s->rc = rc;
+    s->pos = ngx_fuzz_offset(b->pos);
+
+    s->method = r->method;
+    s->http_version = r->http_version;
+    s->request_start = ngx_fuzz_offset(r->request_start);
+    s->request_end = ngx_fuzz_offset(r->request_end);
+    s->method_end = ngx_fuzz_offset(r->method_end);
+    s->uri_start = ngx_fuzz_offset(r->uri_start);
+    s->uri_end = ngx_fuzz_offset(r->uri_end);
+    s->uri_ext = ngx_fuzz_offset(r->uri_ext);
+    s->args_start = ngx_fuzz_offset(r->args_start);
+    s->schema_start = ngx_fuzz_offset(r->schema_start);
+    s->schema_end = ngx_fuzz_offset(r->schema_end);
+    s->host_start = ngx_fuzz_offset(r->host_start);
+    s->host_end = ngx_fuzz_offset(r->host_end);
+    s->complex_uri = r->complex_uri;
+    s->quoted_uri = r->quoted_uri;
+    s->plus_in_uri = r->plus_in_uri;
+    s->empty_path_in_uri = r->empty_path_in_uri;
+
+    s->header_name_start = ngx_fuzz_offset(r->header_name_start);
+    s->header_name_end = ngx_fuzz_offset(r->header_name_end);
+    s->header_start = ngx_fuzz_offset(r->header_start);
+    s->header_end = ngx_fuzz_offset(r->header_end);
+    s->header_hash = r->header_hash;
+    s->lowcase_index = r->lowcase_index;
+    s->invalid_header = r->invalid_header;
+
+    ngx_memcpy(s->lowcase_header, r->lowcase_header,
+               ngx_min(r->lowcase_index, NGX_HTTP_LC_HEADER_LEN));
+}
+
+
+static size_t
+ngx_fuzz_generate(u_char *p)
+{
+    u_char      *start;
+    ngx_uint_t   i, n;
+
+    start = p;
+
+    /* request line */
+
+    if (random() % 8 == 0) {
+        p = ngx_fuzz_string(p, "\r\n", 2);
+    }
+
+    p = ngx_sprintf(p, "%s", ngx_fuzz_methods[random() % 20]);
+
+    p = ngx_fuzz_string(p, " ", (random() % 8 == 0) ? 3 : 1);
+
+    if (random() % 4 == 0) {
+        p = ngx_sprintf(p, "http://");
+        p = ngx_fuzz_string(p, "abcdefghijklmnopqrstuvwxyz0123456789.-:[]",
+                            40);
+    }
+
+    if (random() % 8) {
+        *p++ = '/';
+    }
+
+    p = ngx_fuzz_string(p, ngx_fuzz_uri_chars, (random() % 2) ? 100 : 20);
+    p = ngx_sprintf(p, "%s%s", ngx_fuzz_versions[random() % 10],
+                    ngx_fuzz_ends[random() % 5]);
+
+    /* header lines */
+
+    n = random() % 8;
+
+    for (i = 0; i < n; i++) {
+        p = ngx_fuzz_string(p, ngx_fuzz_name_chars, (random() % 4) ? 20 : 60);
+
+        if (random() % 16) {
+            *p++ = ':';
+        }
+
+        p = ngx_fuzz_string(p, ngx_fuzz_value_chars,
+                            (random() % 2) ? 120 : 20);
+        p = ngx_sprintf(p, "%s", ngx_fuzz_ends[random() % 5]);
+    }
+
+    p = ngx_sprintf(p, "%s", ngx_fuzz_ends[random() % 5]);
+
+    return p - start;
+}
+
+
+static u_char *
+ngx_fuzz_string(u_char *p, const char *alphabet, size_t max)
+{
+    size_t  i, n, len;
+
+    len = ngx_strlen(alphabet);
+    n = random() % (max + 1);
+
+    for (i = 0; i < n; i++) {
+        *p++ = alphabet[random() % len];
+    }
+
+    return p;
+}
+
+
+static void
+ngx_fuzz_dump(u_char *data, size_t len, size_t *splits, ngx_uint_t nsplits,
+    ngx_uint_t step)
+{
+    size_t      i;
+    ngx_uint_t  n;
+
+    printf("input of %lu bytes:", (unsigned long) len);
+
+    for (i = 0; i < len; i++) {
+        printf("%s%02x", (i % 32) ? " " : "\n    ", data[i]);
+    }
+
+    printf("\nsplits:");
+
+    for (n = 0; n < nsplits; n++) {
+        printf(" %lu", (unsigned long) splits[n]);
+    }
+
+    printf("\nfirst differing step: %lu\n", (unsigned long) step);
+}
+
+
+/* the parsers only use these in debug logging and unescaping */
+
+void
+ngx_log_error_core(ngx_uint_t level, ngx_log_t *log, ngx_err_t err,
+    const char *fmt, ...)
+{
+}
+
+
+void *
+ngx_alloc(size_t size, ngx_log_t *log)
+{
+    return malloc(size);
+}
+
+
+void *
+ngx_pnalloc(ngx_pool_t *pool, size_t size)
+{
+    return malloc(size);
+}
@@ -44,6 +44,11 @@
 #endif
 
 
+#if (NGX_HAVE_SSE42)
+#include <nmmintrin.h>
+#endif
+
+
 #ifndef NGX_HAVE_SO_SNDLOWAT
 #define NGX_HAVE_SO_SNDLOWAT     1
 #endif
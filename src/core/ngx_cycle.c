@@ -466,6 +466,7 @@ ngx_init_cycle(ngx_cycle_t *old_cycle)
                 && !shm_zone[i].noreuse)
             {
                 shm_zone[i].shm.addr = oshm_zone[n].shm.addr;
+                shm_zone[i].shm.hugepages = oshm_zone[n].shm.hugepages;
 #if (NGX_WIN32)
                 shm_zone[i].shm.handle = oshm_zone[n].shm.handle;
 #endif
@@ -482,6 +483,12 @@ ngx_init_cycle(ngx_cycle_t *old_cycle)
             break;
         }
 
+        if (ccf->shm_hugepages
+            && shm_zone[i].shm.size >= ccf->shm_hugepages)
+        {
+            shm_zone[i].shm.hugepages = NGX_SHM_HUGEPAGES;
+        }
+
         if (ngx_shm_alloc(&shm_zone[i].shm) != NGX_OK) {
             goto failed;
         }
@@ -1354,6 +1361,7 @@ ngx_shared_memory_add(ngx_conf_t *cf, ngx_str_t *name, size_t size, void *tag)
     shm_zone->shm.size = size;
     shm_zone->shm.name = *name;
     shm_zone->shm.exists = 0;
+    shm_zone->shm.hugepages = 0;
     shm_zone->init = NULL;
     shm_zone->tag = tag;
     shm_zone->noreuse = 0;
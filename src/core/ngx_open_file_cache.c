@@ -51,6 +51,13 @@ static ngx_cached_open_file_t *
     ngx_open_file_lookup(ngx_open_file_cache_t *cache, ngx_str_t *name,
     uint32_t hash);
 static void ngx_open_file_cache_remove(ngx_event_t *ev);
+static ngx_int_t ngx_open_file_shared_init(ngx_shm_zone_t *shm_zone,
+    void *data);
+static uint64_t ngx_open_file_shared_key(ngx_str_t *name, uint32_t hash);
+static time_t ngx_open_file_shared_get(ngx_open_file_cache_t *cache,
+    ngx_str_t *name, uint64_t key, ngx_open_file_info_t *of);
+static void ngx_open_file_shared_set(ngx_open_file_cache_t *cache,
+    ngx_str_t *name, uint64_t key, ngx_open_file_info_t *of, time_t created);
 
 
 ngx_open_file_cache_t *
@@ -72,6 +79,7 @@ ngx_open_file_cache_init(ngx_pool_t *pool, ngx_uint_t max, time_t inactive)
     cache->current = 0;
     cache->max = max;
     cache->inactive = inactive;
+    cache->shm_zone = NULL;
 
     cln = ngx_pool_cleanup_add(pool, 0);
     if (cln == NULL) {
@@ -85,6 +93,182 @@ ngx_open_file_cache_init(ngx_pool_t *pool, ngx_uint_t max, time_t inactive)
 }
 
 
+ngx_int_t
+ngx_open_file_cache_share(ngx_conf_t *cf, ngx_open_file_cache_t *cache,
+    ngx_str_t *name, size_t size)
+{
+    cache->shm_zone = ngx_shared_memory_add(cf, name, size,
+                                            &ngx_open_file_cache_share);
+    if (cache->shm_zone == NULL) {
+        return NGX_ERROR;
+    }
+
+    cache->shm_zone->init = ngx_open_file_shared_init;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_open_file_shared_init(ngx_shm_zone_t *shm_zone, void *data)
+{
+    ngx_open_file_shared_t *osh = data;
+
+    size_t                   size;
+    ngx_uint_t               n;
+    ngx_slab_pool_t         *shpool;
+    ngx_open_file_shared_t  *sh;
+
+    if (osh) {
+        shm_zone->data = osh;
+        return NGX_OK;
+    }
+
+    shpool = (ngx_slab_pool_t *) shm_zone->shm.addr;
+
+    if (shm_zone->shm.exists) {
+        shm_zone->data = shpool->data;
+        return NGX_OK;
+    }
+
+    sh = ngx_slab_alloc(shpool, sizeof(ngx_open_file_shared_t));
+    if (sh == NULL) {
+        return NGX_ERROR;
+    }
+
+    /* the largest power of two number of nodes fitting into a half */
+
+    size = shm_zone->shm.size / 2 / sizeof(ngx_open_file_shared_node_t);
+
+    for (n = 1; n * 2 <= size; n *= 2) { /* void */ }
+
+    sh->nodes = ngx_slab_calloc(shpool,
+                                n * sizeof(ngx_open_file_shared_node_t));
+    if (sh->nodes == NULL) {
+        return NGX_ERROR;
+    }
+
+    sh->mask = n - 1;
+
+    shpool->data = sh;
+    shm_zone->data = sh;
+
+    return NGX_OK;
+}
+
+
+static uint64_t
+ngx_open_file_shared_key(ngx_str_t *name, uint32_t hash)
+{
+    return ((uint64_t) hash << 32) | ngx_hash_key(name->data, name->len);
+}
+
+
+static time_t
+ngx_open_file_shared_get(ngx_open_file_cache_t *cache, ngx_str_t *name,
+    uint64_t key, ngx_open_file_info_t *of)
+{
+    ngx_atomic_uint_t             lock;
+    ngx_open_file_shared_t       *sh;
+    ngx_open_file_shared_node_t   node, *sn;
+
+    sh = cache->shm_zone->data;
+    sn = &sh->nodes[key & sh->mask];
+
+    lock = sn->lock;
+
+    if (lock & 1) {
+        return 0;
+    }
+
+    ngx_memory_barrier();
+
+    node = *sn;
+
+    ngx_memory_barrier();
+
+    if (sn->lock != lock
+        || node.key != key
+        || node.len != name->len
+        || ngx_time() - node.created >= of->valid
+#if (NGX_HAVE_OPENAT)
+        || node.disable_symlinks != of->disable_symlinks
+        || node.disable_symlinks_from != of->disable_symlinks_from
+#endif
+       )
+    {
+        return 0;
+    }
+
+    of->uniq = node.uniq;
+    of->mtime = node.mtime;
+    of->size = node.size;
+    of->fs_size = node.fs_size;
+    of->err = node.err;
+
+    of->is_dir = node.is_dir;
+    of->is_file = node.is_file;
+    of->is_link = node.is_link;
+    of->is_exec = node.is_exec;
+
+    if (node.err) {
+#if (NGX_HAVE_OPENAT)
+        of->failed = node.disable_symlinks ? ngx_openat_file_n
+                                           : ngx_open_file_n;
+#else
+        of->failed = ngx_open_file_n;
+#endif
+    }
+
+    return node.created;
+}
+
+
+static void
+ngx_open_file_shared_set(ngx_open_file_cache_t *cache, ngx_str_t *name,
+    uint64_t key, ngx_open_file_info_t *of, time_t created)
+{
+    ngx_atomic_uint_t             lock;
+    ngx_open_file_shared_t       *sh;
+    ngx_open_file_shared_node_t  *sn;
+
+    sh = cache->shm_zone->data;
+    sn = &sh->nodes[key & sh->mask];
+
+    lock = sn->lock;
+
+    /* the node is skipped if another process updates it */
+
+    if ((lock & 1) || !ngx_atomic_cmp_set(&sn->lock, lock, lock + 1)) {
+        return;
+    }
+
+    sn->key = key;
+    sn->len = name->len;
+    sn->created = created;
+
+    sn->uniq = of->uniq;
+    sn->mtime = of->mtime;
+    sn->size = of->size;
+    sn->fs_size = of->fs_size;
+    sn->err = of->err;
+
+#if (NGX_HAVE_OPENAT)
+    sn->disable_symlinks = of->disable_symlinks;
+    sn->disable_symlinks_from = of->disable_symlinks_from;
+#endif
+
+    sn->is_dir = of->is_dir;
+    sn->is_file = of->is_file;
+    sn->is_link = of->is_link;
+    sn->is_exec = of->is_exec;
+
+    ngx_memory_barrier();
+
+    sn->lock = lock + 2;
+}
+
+
 static void
 ngx_open_file_cache_cleanup(void *data)
 {
@@ -144,8 +328,9 @@ ngx_int_t
 ngx_open_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
     ngx_open_file_info_t *of, ngx_pool_t *pool)
 {
-    time_t                          now;
+    time_t                          now, created;
     uint32_t                        hash;
+    uint64_t                        key;
     ngx_int_t                       rc;
     ngx_file_info_t                 fi;
     ngx_pool_cleanup_t             *cln;
@@ -206,6 +391,9 @@ ngx_open_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
 
     hash = ngx_crc32_long(name->data, name->len);
 
+    key = cache->shm_zone ? ngx_open_file_shared_key(name, hash) : 0;
+    created = 0;
+
     file = ngx_open_file_lookup(cache, name, hash);
 
     if (file) {
@@ -283,6 +471,36 @@ ngx_open_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
             of->test_dir = 1;
         }
 
+        /*
+         * a recent test of the same file by another worker
+         * saves a stat() if it has not found any changes
+         */
+
+        if (cache->shm_zone) {
+            created = ngx_open_file_shared_get(cache, name, key, of);
+
+            if (created
+                && of->err == file->err
+                && of->is_dir == file->is_dir
+                && (of->err || of->is_dir || of->uniq == file->uniq))
+            {
+                ngx_log_debug1(NGX_LOG_DEBUG_CORE, pool->log, 0,
+                               "shared open file: %s", file->name);
+
+                of->fd = file->fd;
+                of->is_directio = file->is_directio;
+
+                if (file->event) {
+                    file->use_event = 1;
+                }
+
+                goto update;
+            }
+
+            created = 0;
+            of->err = 0;
+        }
+
         of->fd = file->fd;
         of->uniq = file->uniq;
 
@@ -351,6 +569,21 @@ ngx_open_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
 
     /* not found */
 
+    /* directories and errors do not need a descriptor */
+
+    if (cache->shm_zone) {
+        created = ngx_open_file_shared_get(cache, name, key, of);
+
+        if (created && (of->is_dir || (of->err && of->errors))) {
+            ngx_log_debug1(NGX_LOG_DEBUG_CORE, pool->log, 0,
+                           "shared open file: %V", name);
+            goto create;
+        }
+
+        created = 0;
+        of->err = 0;
+    }
+
     rc = ngx_open_and_stat_file(name, of, pool->log);
 
     if (rc != NGX_OK && (of->err == 0 || !of->errors)) {
@@ -421,7 +654,16 @@ update:
         }
     }
 
-    file->created = now;
+    if (created) {
+        file->created = created;
+
+    } else {
+        file->created = now;
+
+        if (cache->shm_zone) {
+            ngx_open_file_shared_set(cache, name, key, of, now);
+        }
+    }
 
 found:
 
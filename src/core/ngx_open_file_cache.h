@@ -88,6 +88,43 @@ struct ngx_cached_open_file_s {
 };
 
 
+/*
+ * a shared node is updated under a sequence lock: the lock is odd while
+ * a writer changes the node, readers retry if it was changed during copy
+ */
+
+typedef struct {
+    ngx_atomic_t             lock;
+
+    uint64_t                 key;
+    size_t                   len;
+
+    time_t                   created;
+
+    ngx_file_uniq_t          uniq;
+    time_t                   mtime;
+    off_t                    size;
+    off_t                    fs_size;
+    ngx_err_t                err;
+
+#if (NGX_HAVE_OPENAT)
+    size_t                   disable_symlinks_from;
+    unsigned                 disable_symlinks:2;
+#endif
+
+    unsigned                 is_dir:1;
+    unsigned                 is_file:1;
+    unsigned                 is_link:1;
+    unsigned                 is_exec:1;
+} ngx_open_file_shared_node_t;
+
+
+typedef struct {
+    ngx_open_file_shared_node_t  *nodes;
+    ngx_uint_t                    mask;
+} ngx_open_file_shared_t;
+
+
 typedef struct {
     ngx_rbtree_t             rbtree;
     ngx_rbtree_node_t        sentinel;
@@ -96,6 +133,8 @@ typedef struct {
     ngx_uint_t               current;
     ngx_uint_t               max;
     time_t                   inactive;
+
+    ngx_shm_zone_t          *shm_zone;
 } ngx_open_file_cache_t;
 
 
@@ -122,6 +161,8 @@ typedef struct {
 
 ngx_open_file_cache_t *ngx_open_file_cache_init(ngx_pool_t *pool,
     ngx_uint_t max, time_t inactive);
+ngx_int_t ngx_open_file_cache_share(ngx_conf_t *cf,
+    ngx_open_file_cache_t *cache, ngx_str_t *name, size_t size);
 ngx_int_t ngx_open_cached_file(ngx_open_file_cache_t *cache, ngx_str_t *name,
     ngx_open_file_info_t *of, ngx_pool_t *pool);
 
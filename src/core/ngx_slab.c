@@ -75,6 +75,12 @@ static void ngx_slab_free_pages(ngx_slab_pool_t *pool, ngx_slab_page_t *page,
     ngx_uint_t pages);
 static void ngx_slab_error(ngx_slab_pool_t *pool, ngx_uint_t level,
     char *text);
+static ngx_slab_magazine_t *ngx_slab_magazine(ngx_slab_pool_t *pool,
+    ngx_uint_t shift);
+static ngx_uint_t ngx_slab_chunk_shift(ngx_slab_pool_t *pool, void *p);
+static void ngx_slab_refill(ngx_slab_pool_t *pool, ngx_slab_magazine_t *m,
+    ngx_uint_t shift);
+static void ngx_slab_drain(ngx_slab_pool_t *pool, ngx_slab_cache_t *cache);
 
 
 static ngx_uint_t  ngx_slab_max_size;
@@ -162,18 +168,54 @@ ngx_slab_init(ngx_slab_pool_t *pool)
     pool->log_nomem = 1;
     pool->log_ctx = &pool->zero;
     pool->zero = '\0';
+
+    /* up to 1/16 of the pool may be cached in magazines */
+
+    pool->magazine_size = (pool->end - (u_char *) pool)
+                          / (16 * NGX_SLAB_MAGAZINES * n);
+
+    ngx_memzero(pool->caches, sizeof(pool->caches));
 }
 
 
 void *
 ngx_slab_alloc(ngx_slab_pool_t *pool, size_t size)
 {
-    void  *p;
+    void                 *p;
+    size_t                s;
+    ngx_uint_t            shift;
+    ngx_slab_magazine_t  *m;
+
+    m = NULL;
+    shift = 0;
+
+    if (size <= ngx_slab_max_size) {
+
+        if (size > pool->min_size) {
+            shift = 1;
+            for (s = size - 1; s >>= 1; shift++) { /* void */ }
+
+        } else {
+            shift = pool->min_shift;
+        }
+
+        m = ngx_slab_magazine(pool, shift);
+
+        if (m && m->nelts) {
+            m->hits++;
+            return m->elts[--m->nelts];
+        }
+    }
 
     ngx_shmtx_lock(&pool->mutex);
 
     p = ngx_slab_alloc_locked(pool, size);
 
+    if (p && m) {
+        ngx_slab_refill(pool, m, shift);
+        m->misses++;
+    }
+
     ngx_shmtx_unlock(&pool->mutex);
 
     return p;
@@ -422,11 +464,10 @@ ngx_slab_calloc(ngx_slab_pool_t *pool, size_t size)
 {
     void  *p;
 
-    ngx_shmtx_lock(&pool->mutex);
-
-    p = ngx_slab_calloc_locked(pool, size);
-
-    ngx_shmtx_unlock(&pool->mutex);
+    p = ngx_slab_alloc(pool, size);
+    if (p) {
+        ngx_memzero(p, size);
+    }
 
     return p;
 }
@@ -449,10 +490,37 @@ ngx_slab_calloc_locked(ngx_slab_pool_t *pool, size_t size)
 void
 ngx_slab_free(ngx_slab_pool_t *pool, void *p)
 {
+    ngx_uint_t            n, shift;
+    ngx_slab_magazine_t  *m;
+
+    n = 0;
+
+    shift = ngx_slab_chunk_shift(pool, p);
+
+    m = shift ? ngx_slab_magazine(pool, shift) : NULL;
+
+    if (m) {
+        n = ngx_min(NGX_SLAB_MAGAZINE_SIZE, pool->magazine_size >> shift);
+
+        if (m->nelts < n) {
+            ngx_slab_junk(p, (size_t) 1 << shift);
+            m->elts[m->nelts] = p;
+            m->nelts++;
+            return;
+        }
+    }
+
     ngx_shmtx_lock(&pool->mutex);
 
     ngx_slab_free_locked(pool, p);
 
+    if (m) {
+        while (m->nelts > n / 2) {
+            p = m->elts[--m->nelts];
+            ngx_slab_free_locked(pool, p);
+        }
+    }
+
     ngx_shmtx_unlock(&pool->mutex);
 }
 
@@ -810,6 +878,282 @@ ngx_slab_free_pages(ngx_slab_pool_t *pool, ngx_slab_page_t *page,
 }
 
 
+/*
+ * a worker process keeps a few free chunks of each size class in its
+ * own magazine: most allocations and frees are served from it without
+ * the pool mutex, and it is refilled or flushed by halves under a single
+ * lock; magazines are disabled in small pools where cached chunks would
+ * take a noticeable share of memory
+ */
+
+static ngx_slab_magazine_t *
+ngx_slab_magazine(ngx_slab_pool_t *pool, ngx_uint_t shift)
+{
+#if (NGX_WIN32)
+
+    return NULL;
+
+#else
+
+    size_t             size;
+    ngx_uint_t         n;
+    ngx_slab_cache_t  *cache;
+
+    if ((pool->magazine_size >> shift) < 2
+        || ngx_process != NGX_PROCESS_WORKER
+        || ngx_process_slot >= NGX_SLAB_MAGAZINES)
+    {
+        return NULL;
+    }
+
+    cache = pool->caches[ngx_process_slot];
+
+    if (cache == NULL) {
+        n = ngx_pagesize_shift - pool->min_shift;
+        size = sizeof(ngx_slab_cache_t) + (n - 1) * sizeof(ngx_slab_magazine_t);
+
+        ngx_shmtx_lock(&pool->mutex);
+        cache = ngx_slab_alloc_locked(pool, size);
+        ngx_shmtx_unlock(&pool->mutex);
+
+        if (cache == NULL) {
+            return NULL;
+        }
+
+        ngx_memzero(cache, size);
+        cache->pid = ngx_pid;
+
+        pool->caches[ngx_process_slot] = cache;
+
+    } else if (cache->pid != ngx_pid) {
+
+        /*
+         * a process slot is never shared by live processes: the previous
+         * owner has exited, and if it crashed, its cached chunks are
+         * returned to the pool; counters are kept for statistics
+         */
+
+        ngx_shmtx_lock(&pool->mutex);
+        ngx_slab_drain(pool, cache);
+        ngx_shmtx_unlock(&pool->mutex);
+
+        cache->pid = ngx_pid;
+    }
+
+    return &cache->magazine[shift - pool->min_shift];
+
+#endif
+}
+
+
+static ngx_uint_t
+ngx_slab_chunk_shift(ngx_slab_pool_t *pool, void *p)
+{
+    ngx_slab_page_t  *page;
+
+    if ((u_char *) p < pool->start || (u_char *) p >= pool->end) {
+        return 0;
+    }
+
+    /*
+     * the type and the chunk size of a page do not change
+     * while the page has allocated chunks
+     */
+
+    page = &pool->pages[((u_char *) p - pool->start) >> ngx_pagesize_shift];
+
+    switch (ngx_slab_page_type(page)) {
+
+    case NGX_SLAB_SMALL:
+    case NGX_SLAB_BIG:
+        return page->slab & NGX_SLAB_SHIFT_MASK;
+
+    case NGX_SLAB_EXACT:
+        return ngx_slab_exact_shift;
+
+    default: /* NGX_SLAB_PAGE */
+        return 0;
+    }
+}
+
+
+static void
+ngx_slab_refill(ngx_slab_pool_t *pool, ngx_slab_magazine_t *m,
+    ngx_uint_t shift)
+{
+    void             *p;
+    ngx_uint_t        n, slot;
+    ngx_slab_page_t  *page, *slots;
+
+    n = ngx_min(NGX_SLAB_MAGAZINE_SIZE, pool->magazine_size >> shift) / 2;
+
+    slot = shift - pool->min_shift;
+    slots = ngx_slab_slots(pool);
+
+    while (m->nelts < n) {
+
+        /* do not hit a memory shortage while refilling */
+
+        page = slots[slot].next;
+
+        if (page->next == page && pool->pfree == 0) {
+            break;
+        }
+
+        p = ngx_slab_alloc_locked(pool, (size_t) 1 << shift);
+        if (p == NULL) {
+            break;
+        }
+
+        /* chunks are requested when they are taken from the magazine */
+
+        pool->stats[slot].reqs--;
+
+        m->elts[m->nelts] = p;
+        m->nelts++;
+    }
+}
+
+
+void
+ngx_slab_flush(ngx_slab_pool_t *pool)
+{
+#if !(NGX_WIN32)
+
+    ngx_slab_cache_t  *cache;
+
+    if (ngx_process_slot >= NGX_SLAB_MAGAZINES) {
+        return;
+    }
+
+    cache = pool->caches[ngx_process_slot];
+
+    if (cache == NULL || cache->pid != ngx_pid) {
+        return;
+    }
+
+    ngx_shmtx_lock(&pool->mutex);
+
+    ngx_slab_drain(pool, cache);
+
+    ngx_shmtx_unlock(&pool->mutex);
+
+#endif
+}
+
+
+static void
+ngx_slab_drain(ngx_slab_pool_t *pool, ngx_slab_cache_t *cache)
+{
+    void        *p;
+    ngx_uint_t   i, n;
+
+    n = ngx_pagesize_shift - pool->min_shift;
+
+    for (i = 0; i < n; i++) {
+        while (cache->magazine[i].nelts) {
+            p = cache->magazine[i].elts[--cache->magazine[i].nelts];
+            ngx_slab_free_locked(pool, p);
+        }
+    }
+
+    cache->flushes++;
+}
+
+
+void
+ngx_slab_magazine_stat(ngx_slab_pool_t *pool, ngx_slab_magazine_stat_t *stat)
+{
+    ngx_uint_t         i, j, n;
+    ngx_slab_cache_t  *cache;
+
+    ngx_memzero(stat, sizeof(ngx_slab_magazine_stat_t));
+
+    n = ngx_pagesize_shift - pool->min_shift;
+
+    for (i = 0; i < NGX_SLAB_MAGAZINES; i++) {
+        cache = pool->caches[i];
+
+        if (cache == NULL) {
+            continue;
+        }
+
+        for (j = 0; j < n; j++) {
+            stat->hits += cache->magazine[j].hits;
+            stat->misses += cache->magazine[j].misses;
+            stat->cached += cache->magazine[j].nelts;
+        }
+
+        stat->flushes += cache->flushes;
+    }
+}
+
+
+ngx_int_t
+ngx_slab_pool_stat(ngx_slab_pool_t *pool, ngx_slab_pool_stat_t *stat,
+    ngx_pool_t *p)
+{
+    ngx_uint_t         i, j, n, cached;
+    ngx_slab_page_t   *page;
+    ngx_slab_cache_t  *cache;
+
+    n = ngx_pagesize_shift - pool->min_shift;
+
+    stat->slots = ngx_palloc(p, n * sizeof(ngx_slab_stat_t));
+    if (stat->slots == NULL) {
+        return NGX_ERROR;
+    }
+
+    stat->nslots = n;
+    stat->pages = pool->last - pool->pages;
+    stat->runs = 0;
+    stat->largest = 0;
+
+    /* the lock is held only to copy counters and walk free page runs */
+
+    ngx_shmtx_lock(&pool->mutex);
+
+    stat->free = pool->pfree;
+
+    ngx_memcpy(stat->slots, pool->stats, n * sizeof(ngx_slab_stat_t));
+
+    for (page = pool->free.next; page != &pool->free; page = page->next) {
+        stat->runs++;
+
+        if (page->slab > stat->largest) {
+            stat->largest = page->slab;
+        }
+    }
+
+    ngx_shmtx_unlock(&pool->mutex);
+
+    /*
+     * requests served by magazines are only counted by workers,
+     * and chunks cached in magazines are not in use
+     */
+
+    for (i = 0; i < NGX_SLAB_MAGAZINES; i++) {
+        cache = pool->caches[i];
+
+        if (cache == NULL) {
+            continue;
+        }
+
+        for (j = 0; j < n; j++) {
+            stat->slots[j].reqs += cache->magazine[j].hits;
+
+            cached = cache->magazine[j].nelts;
+
+            stat->slots[j].used -= ngx_min(cached, stat->slots[j].used);
+        }
+    }
+
+    ngx_slab_magazine_stat(pool, &stat->magazines);
+
+    return NGX_OK;
+}
+
+
 static void
 ngx_slab_error(ngx_slab_pool_t *pool, ngx_uint_t level, char *text)
 {
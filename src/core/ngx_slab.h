@@ -13,6 +13,10 @@
 #include <ngx_core.h>
 
 
+#define NGX_SLAB_MAGAZINES      64
+#define NGX_SLAB_MAGAZINE_SIZE  8
+
+
 typedef struct ngx_slab_page_s  ngx_slab_page_t;
 
 struct ngx_slab_page_s {
@@ -31,18 +35,61 @@ typedef struct {
 } ngx_slab_stat_t;
 
 
+/*
+ * the elements are stored before the count is updated, and the count
+ * is decremented before an element is freed, so the cached chunks
+ * are known even if the owner process crashes
+ */
+
+typedef struct {
+    volatile ngx_uint_t   nelts;
+    void *volatile        elts[NGX_SLAB_MAGAZINE_SIZE];
+
+    ngx_uint_t            hits;
+    ngx_uint_t            misses;
+} ngx_slab_magazine_t;
+
+
+typedef struct {
+    ngx_uint_t        hits;
+    ngx_uint_t        misses;
+    ngx_uint_t        flushes;
+    ngx_uint_t        cached;
+} ngx_slab_magazine_stat_t;
+
+
+/*
+ * free chunks cached by a worker process per size class,
+ * they are used without taking the pool mutex
+ */
+
+typedef struct {
+    ngx_pid_t             pid;
+    ngx_uint_t            flushes;
+    ngx_slab_magazine_t   magazine[1];
+} ngx_slab_cache_t;
+
+
+/*
+ * the lock and the fields it protects are kept away from the fields
+ * read without the lock, and from the stats following the pool
+ */
+
 typedef struct {
     ngx_shmtx_sh_t    lock;
 
+    ngx_slab_page_t   free;
+    ngx_uint_t        pfree;
+
+    u_char            pad[NGX_CPU_CACHE_LINE];
+
     size_t            min_size;
     size_t            min_shift;
 
     ngx_slab_page_t  *pages;
     ngx_slab_page_t  *last;
-    ngx_slab_page_t   free;
 
     ngx_slab_stat_t  *stats;
-    ngx_uint_t        pfree;
 
     u_char           *start;
     u_char           *end;
@@ -56,9 +103,25 @@ typedef struct {
 
     void             *data;
     void             *addr;
+
+    size_t            magazine_size;
+    ngx_slab_cache_t *caches[NGX_SLAB_MAGAZINES];
+
+    u_char            tail[NGX_CPU_CACHE_LINE];
 } ngx_slab_pool_t;
 
 
+typedef struct {
+    ngx_uint_t                 pages;
+    ngx_uint_t                 free;
+    ngx_uint_t                 runs;
+    ngx_uint_t                 largest;
+    ngx_uint_t                 nslots;
+    ngx_slab_stat_t           *slots;
+    ngx_slab_magazine_stat_t   magazines;
+} ngx_slab_pool_stat_t;
+
+
 void ngx_slab_sizes_init(void);
 void ngx_slab_init(ngx_slab_pool_t *pool);
 void *ngx_slab_alloc(ngx_slab_pool_t *pool, size_t size);
@@ -67,6 +130,11 @@ void *ngx_slab_calloc(ngx_slab_pool_t *pool, size_t size);
 void *ngx_slab_calloc_locked(ngx_slab_pool_t *pool, size_t size);
 void ngx_slab_free(ngx_slab_pool_t *pool, void *p);
 void ngx_slab_free_locked(ngx_slab_pool_t *pool, void *p);
+void ngx_slab_flush(ngx_slab_pool_t *pool);
+void ngx_slab_magazine_stat(ngx_slab_pool_t *pool,
+    ngx_slab_magazine_stat_t *stat);
+ngx_int_t ngx_slab_pool_stat(ngx_slab_pool_t *pool, ngx_slab_pool_stat_t *stat,
+    ngx_pool_t *p);
 
 
 #endif /* _NGX_SLAB_H_INCLUDED_ */
@@ -30,8 +30,13 @@ struct ngx_thread_pool_s {
     ngx_thread_mutex_t        mtx;
     ngx_thread_pool_queue_t   queue;
     ngx_int_t                 waiting;
+    ngx_uint_t                sleeping;
     ngx_thread_cond_t         cond;
 
+    ngx_atomic_t              tasks;
+    ngx_atomic_t              wait[NGX_THREAD_POOL_BUCKETS];
+    ngx_atomic_t              exec[NGX_THREAD_POOL_BUCKETS];
+
     ngx_log_t                *log;
 
     ngx_str_t                 name;
@@ -50,6 +55,8 @@ static void ngx_thread_pool_exit_handler(void *data, ngx_log_t *log);
 
 static void *ngx_thread_pool_cycle(void *data);
 static void ngx_thread_pool_handler(ngx_event_t *ev);
+static uint64_t ngx_thread_pool_usec(void);
+static ngx_uint_t ngx_thread_pool_bucket(uint64_t usec);
 
 static char *ngx_thread_pool(ngx_conf_t *cf, ngx_command_t *cmd, void *conf);
 
@@ -99,8 +106,13 @@ ngx_module_t  ngx_thread_pool_module = {
 static ngx_str_t  ngx_thread_pool_default = ngx_string("default");
 
 static ngx_uint_t               ngx_thread_pool_task_id;
-static ngx_atomic_t             ngx_thread_pool_done_lock;
-static ngx_thread_pool_queue_t  ngx_thread_pool_done;
+
+/*
+ * completed tasks are pushed onto a lock-free list by pool threads,
+ * only the push onto an empty list notifies the event loop
+ */
+
+static ngx_atomic_t             ngx_thread_pool_done;
 
 
 static ngx_int_t
@@ -253,8 +265,13 @@ ngx_thread_task_post(ngx_thread_pool_t *tp, ngx_thread_task_t *task)
 
     task->id = ngx_thread_pool_task_id++;
     task->next = NULL;
+    task->posted = ngx_thread_pool_usec();
 
-    if (ngx_thread_cond_signal(&tp->cond, tp->log) != NGX_OK) {
+    /* busy threads recheck the queue before going to sleep */
+
+    if (tp->sleeping
+        && ngx_thread_cond_signal(&tp->cond, tp->log) != NGX_OK)
+    {
         (void) ngx_thread_mutex_unlock(&tp->mtx, tp->log);
         return NGX_ERROR;
     }
@@ -281,6 +298,9 @@ ngx_thread_pool_cycle(void *data)
 
     int                 err;
     sigset_t            set;
+    uint64_t            start;
+    ngx_uint_t          n;
+    ngx_atomic_uint_t   head;
     ngx_thread_task_t  *task;
 
 #if 0
@@ -312,12 +332,17 @@ ngx_thread_pool_cycle(void *data)
         tp->waiting--;
 
         while (tp->queue.first == NULL) {
+            tp->sleeping++;
+
             if (ngx_thread_cond_wait(&tp->cond, &tp->mtx, tp->log)
                 != NGX_OK)
             {
+                tp->sleeping--;
                 (void) ngx_thread_mutex_unlock(&tp->mtx, tp->log);
                 return NULL;
             }
+
+            tp->sleeping--;
         }
 
         task = tp->queue.first;
@@ -339,24 +364,32 @@ ngx_thread_pool_cycle(void *data)
                        "run task #%ui in thread pool \"%V\"",
                        task->id, &tp->name);
 
+        start = ngx_thread_pool_usec();
+
+        n = ngx_thread_pool_bucket(start - task->posted);
+        (void) ngx_atomic_fetch_add(&tp->wait[n], 1);
+
         task->handler(task->ctx, tp->log);
 
+        n = ngx_thread_pool_bucket(ngx_thread_pool_usec() - start);
+        (void) ngx_atomic_fetch_add(&tp->exec[n], 1);
+
+        (void) ngx_atomic_fetch_add(&tp->tasks, 1);
+
         ngx_log_debug2(NGX_LOG_DEBUG_CORE, tp->log, 0,
                        "complete task #%ui in thread pool \"%V\"",
                        task->id, &tp->name);
 
-        task->next = NULL;
+        do {
+            head = ngx_thread_pool_done;
+            task->next = (ngx_thread_task_t *) head;
 
-        ngx_spinlock(&ngx_thread_pool_done_lock, 1, 2048);
+        } while (!ngx_atomic_cmp_set(&ngx_thread_pool_done, head,
+                                     (ngx_atomic_uint_t) task));
 
-        *ngx_thread_pool_done.last = task;
-        ngx_thread_pool_done.last = &task->next;
-
-        ngx_memory_barrier();
-
-        ngx_unlock(&ngx_thread_pool_done_lock);
-
-        (void) ngx_notify(ngx_thread_pool_handler);
+        if (head == 0) {
+            (void) ngx_notify(ngx_thread_pool_handler);
+        }
     }
 }
 
@@ -365,19 +398,27 @@ static void
 ngx_thread_pool_handler(ngx_event_t *ev)
 {
     ngx_event_t        *event;
-    ngx_thread_task_t  *task;
+    ngx_atomic_uint_t   head;
+    ngx_thread_task_t  *task, *next, *prev;
 
     ngx_log_debug0(NGX_LOG_DEBUG_CORE, ev->log, 0, "thread pool handler");
 
-    ngx_spinlock(&ngx_thread_pool_done_lock, 1, 2048);
+    do {
+        head = ngx_thread_pool_done;
+
+    } while (!ngx_atomic_cmp_set(&ngx_thread_pool_done, head, 0));
 
-    task = ngx_thread_pool_done.first;
-    ngx_thread_pool_done.first = NULL;
-    ngx_thread_pool_done.last = &ngx_thread_pool_done.first;
+    /* the list is in reverse completion order */
 
-    ngx_memory_barrier();
+    prev = NULL;
+
+    for (task = (ngx_thread_task_t *) head; task; task = next) {
+        next = task->next;
+        task->next = prev;
+        prev = task;
+    }
 
-    ngx_unlock(&ngx_thread_pool_done_lock);
+    task = prev;
 
     while (task) {
         ngx_log_debug1(NGX_LOG_DEBUG_CORE, ev->log, 0,
@@ -394,6 +435,92 @@ ngx_thread_pool_handler(ngx_event_t *ev)
 }
 
 
+static uint64_t
+ngx_thread_pool_usec(void)
+{
+#if (NGX_HAVE_CLOCK_MONOTONIC)
+    struct timespec  ts;
+
+#if defined(CLOCK_MONOTONIC_FAST)
+    clock_gettime(CLOCK_MONOTONIC_FAST, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+
+#else
+    struct timeval   tv;
+
+    ngx_gettimeofday(&tv);
+
+    return (uint64_t) tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+}
+
+
+static ngx_uint_t
+ngx_thread_pool_bucket(uint64_t usec)
+{
+    ngx_uint_t  n;
+
+    for (n = 0; n < NGX_THREAD_POOL_BUCKETS - 1; n++) {
+        if (usec < 16) {
+            break;
+        }
+
+        usec >>= 2;
+    }
+
+    return n;
+}
+
+
+ngx_array_t *
+ngx_thread_pool_stats(ngx_cycle_t *cycle, ngx_pool_t *pool)
+{
+    ngx_uint_t                i, n;
+    ngx_array_t              *stats;
+    ngx_thread_pool_t       **tpp;
+    ngx_thread_pool_stat_t   *st;
+    ngx_thread_pool_conf_t   *tcf;
+
+    tcf = (ngx_thread_pool_conf_t *) ngx_get_conf(cycle->conf_ctx,
+                                                  ngx_thread_pool_module);
+
+    stats = ngx_array_create(pool, tcf->pools.nelts + 1,
+                             sizeof(ngx_thread_pool_stat_t));
+    if (stats == NULL) {
+        return NULL;
+    }
+
+    tpp = tcf->pools.elts;
+
+    for (i = 0; i < tcf->pools.nelts; i++) {
+        st = ngx_array_push(stats);
+        if (st == NULL) {
+            return NULL;
+        }
+
+        st->name = &tpp[i]->name;
+        st->threads = tpp[i]->threads;
+        st->max_queue = tpp[i]->max_queue;
+        st->tasks = tpp[i]->tasks;
+
+        /* read without the mutex, "waiting" is negative while idle */
+
+        st->queue = tpp[i]->waiting > 0 ? (ngx_uint_t) tpp[i]->waiting : 0;
+
+        for (n = 0; n < NGX_THREAD_POOL_BUCKETS; n++) {
+            st->wait[n] = tpp[i]->wait[n];
+            st->exec[n] = tpp[i]->exec[n];
+        }
+    }
+
+    return stats;
+}
+
+
 static void *
 ngx_thread_pool_create_conf(ngx_cycle_t *cycle)
 {
@@ -599,7 +726,7 @@ ngx_thread_pool_init_worker(ngx_cycle_t *cycle)
         return NGX_OK;
     }
 
-    ngx_thread_pool_queue_init(&ngx_thread_pool_done);
+    ngx_thread_pool_done = 0;
 
     tpp = tcf->pools.elts;
 
@@ -14,23 +14,45 @@
 #include <ngx_event.h>
 
 
+#define NGX_THREAD_POOL_BUCKETS  12
+
+
 struct ngx_thread_task_s {
     ngx_thread_task_t   *next;
     ngx_uint_t           id;
     void                *ctx;
     void               (*handler)(void *data, ngx_log_t *log);
     ngx_event_t          event;
+    uint64_t             posted;
 };
 
 
 typedef struct ngx_thread_pool_s  ngx_thread_pool_t;
 
 
+/*
+ * wait and execution times are counted in buckets with upper bounds
+ * of 16, 64, 256, ... microseconds, the last bucket is unbounded
+ */
+
+typedef struct {
+    ngx_str_t           *name;
+    ngx_uint_t           threads;
+    ngx_uint_t           queue;
+    ngx_uint_t           max_queue;
+    ngx_uint_t           tasks;
+    ngx_uint_t           wait[NGX_THREAD_POOL_BUCKETS];
+    ngx_uint_t           exec[NGX_THREAD_POOL_BUCKETS];
+} ngx_thread_pool_stat_t;
+
+
 ngx_thread_pool_t *ngx_thread_pool_add(ngx_conf_t *cf, ngx_str_t *name);
 ngx_thread_pool_t *ngx_thread_pool_get(ngx_cycle_t *cycle, ngx_str_t *name);
 
 ngx_thread_task_t *ngx_thread_task_alloc(ngx_pool_t *pool, size_t size);
 ngx_int_t ngx_thread_task_post(ngx_thread_pool_t *tp, ngx_thread_task_t *task);
 
+ngx_array_t *ngx_thread_pool_stats(ngx_cycle_t *cycle, ngx_pool_t *pool);
+
 
 #endif /* _NGX_THREAD_POOL_H_INCLUDED_ */
@@ -103,6 +103,11 @@ ngx_quic_connstate_dbg(ngx_connection_t *c)
                              qc->push.timer.key - ngx_current_msec);
         }
 
+        if (qc->pacing.timer_set) {
+            p = ngx_slprintf(p, last, " pacing:%M",
+                             qc->pacing.timer.key - ngx_current_msec);
+        }
+
         if (qc->pto.timer_set) {
             p = ngx_slprintf(p, last, " pto:%M",
                              qc->pto.timer.key - ngx_current_msec);
@@ -270,6 +275,10 @@ ngx_quic_new_connection(ngx_connection_t *c, ngx_quic_conf_t *conf,
     qc->push.data = c;
     qc->push.handler = ngx_quic_push_handler;
 
+    qc->pacing.log = c->log;
+    qc->pacing.data = c;
+    qc->pacing.handler = ngx_quic_push_handler;
+
     qc->close.log = c->log;
     qc->close.data = c;
     qc->close.handler = ngx_quic_close_handler;
@@ -305,11 +314,7 @@ ngx_quic_new_connection(ngx_connection_t *c, ngx_quic_conf_t *conf,
     qc->streams.client_max_streams_uni = qc->tp.initial_max_streams_uni;
     qc->streams.client_max_streams_bidi = qc->tp.initial_max_streams_bidi;
 
-    qc->congestion.window = ngx_min(10 * qc->tp.max_udp_payload_size,
-                                    ngx_max(2 * qc->tp.max_udp_payload_size,
-                                            14720));
-    qc->congestion.ssthresh = (size_t) -1;
-    qc->congestion.recovery_start = ngx_current_msec;
+    ngx_quic_congestion_init(qc);
 
     if (pkt->validated && pkt->retried) {
         qc->tp.retry_scid.len = pkt->dcid.len;
@@ -553,6 +558,10 @@ ngx_quic_close_connection(ngx_connection_t *c, ngx_int_t rc)
         ngx_del_timer(&qc->push);
     }
 
+    if (qc->pacing.timer_set) {
+        ngx_del_timer(&qc->pacing);
+    }
+
     if (qc->pto.timer_set) {
         ngx_del_timer(&qc->pto);
     }
@@ -333,30 +333,14 @@ ngx_quic_congestion_ack(ngx_connection_t *c, ngx_quic_frame_t *f)
 
     cg->in_flight -= f->plen;
 
-    timer = f->send_time - cg->recovery_start;
+    cg->delivered += f->plen;
+    cg->delivered_time = ngx_current_msec;
 
-    if ((ngx_msec_int_t) timer <= 0) {
-        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
-                       "quic congestion ack recovery win:%uz ss:%z if:%uz",
-                       cg->window, cg->ssthresh, cg->in_flight);
-
-        goto done;
+    if (cg->app_limited && cg->delivered > cg->app_limited) {
+        cg->app_limited = 0;
     }
 
-    if (cg->window < cg->ssthresh) {
-        cg->window += f->plen;
-
-        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
-                       "quic congestion slow start win:%uz ss:%z if:%uz",
-                       cg->window, cg->ssthresh, cg->in_flight);
-
-    } else {
-        cg->window += qc->tp.max_udp_payload_size * f->plen / cg->window;
-
-        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
-                       "quic congestion avoidance win:%uz ss:%z if:%uz",
-                       cg->window, cg->ssthresh, cg->in_flight);
-    }
+    cg->ops->ack(c, f);
 
     /* prevent recovery_start from wrapping */
 
@@ -366,8 +350,6 @@ ngx_quic_congestion_ack(ngx_connection_t *c, ngx_quic_frame_t *f)
         cg->recovery_start = ngx_current_msec - qc->tp.max_idle_timeout * 2;
     }
 
-done:
-
     if (blocked && cg->in_flight < cg->window) {
         ngx_post_event(&qc->push, &ngx_posted_events);
     }
@@ -550,6 +532,10 @@ ngx_quic_persistent_congestion(ngx_connection_t *c)
     cg->recovery_start = ngx_current_msec;
     cg->window = qc->tp.max_udp_payload_size * 2;
 
+    if (cg->ops->persistent) {
+        cg->ops->persistent(c);
+    }
+
     ngx_log_debug1(NGX_LOG_DEBUG_EVENT, c->log, 0,
                    "quic persistent congestion win:%uz", cg->window);
 }
@@ -660,7 +646,6 @@ static void
 ngx_quic_congestion_lost(ngx_connection_t *c, ngx_quic_frame_t *f)
 {
     ngx_uint_t              blocked;
-    ngx_msec_t              timer;
     ngx_quic_congestion_t  *cg;
     ngx_quic_connection_t  *qc;
 
@@ -678,32 +663,10 @@ ngx_quic_congestion_lost(ngx_connection_t *c, ngx_quic_frame_t *f)
     blocked = (cg->in_flight >= cg->window) ? 1 : 0;
 
     cg->in_flight -= f->plen;
-    f->plen = 0;
 
-    timer = f->send_time - cg->recovery_start;
+    cg->ops->lost(c, f);
 
-    if ((ngx_msec_int_t) timer <= 0) {
-        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
-                       "quic congestion lost recovery win:%uz ss:%z if:%uz",
-                       cg->window, cg->ssthresh, cg->in_flight);
-
-        goto done;
-    }
-
-    cg->recovery_start = ngx_current_msec;
-    cg->window /= 2;
-
-    if (cg->window < qc->tp.max_udp_payload_size * 2) {
-        cg->window = qc->tp.max_udp_payload_size * 2;
-    }
-
-    cg->ssthresh = cg->window;
-
-    ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
-                   "quic congestion lost win:%uz ss:%z if:%uz",
-                   cg->window, cg->ssthresh, cg->in_flight);
-
-done:
+    f->plen = 0;
 
     if (blocked && cg->in_flight < cg->window) {
         ngx_post_event(&qc->push, &ngx_posted_events);
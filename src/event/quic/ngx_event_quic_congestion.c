@@ -0,0 +1,913 @@
+
+/*
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_event.h>
+#include <ngx_event_quic_connection.h>
+
+
+/* RFC 9438, 4.6.  Multiplicative Decrease: beta_cubic = 0.7 */
+#define NGX_QUIC_CUBIC_BETA                  7       /* tenths */
+/* RFC 9438, 4.3.  Reno-Friendly Region: 3 * (1 - 0.7) / (1 + 0.7) */
+#define NGX_QUIC_CUBIC_ALPHA                 529     /* thousandths */
+/* time offsets are clamped to keep the cube within 64 bits */
+#define NGX_QUIC_CUBIC_MAX_T                 100000  /* ms */
+
+#define NGX_QUIC_BBR_STARTUP                 0
+#define NGX_QUIC_BBR_DRAIN                   1
+#define NGX_QUIC_BBR_PROBE_BW                2
+#define NGX_QUIC_BBR_PROBE_RTT               3
+
+#define NGX_QUIC_BBR_HIGH_GAIN               289     /* 2 / ln(2) */
+#define NGX_QUIC_BBR_DRAIN_GAIN              35      /* 1 / high gain */
+#define NGX_QUIC_BBR_CWND_GAIN               200
+#define NGX_QUIC_BBR_CYCLE_LEN               8
+#define NGX_QUIC_BBR_FULL_BW_ROUNDS          3
+#define NGX_QUIC_BBR_MIN_RTT_WINDOW          10000   /* ms */
+#define NGX_QUIC_BBR_PROBE_RTT_TIME          200     /* ms */
+#define NGX_QUIC_BBR_MIN_WINDOW              4       /* packets */
+#define NGX_QUIC_BBR_LOSS_THRESH             2       /* percents */
+#define NGX_QUIC_BBR_FULL_LOSS_COUNT         8       /* packets */
+#define NGX_QUIC_BBR_BETA                    7       /* tenths */
+
+/* allowed send burst when pacing, with timers of millisecond resolution */
+#define NGX_QUIC_PACING_BURST                2       /* ms */
+#define NGX_QUIC_PACING_MIN_BURST            4       /* packets */
+
+
+static void ngx_quic_reno_ack(ngx_connection_t *c, ngx_quic_frame_t *f);
+static void ngx_quic_reno_lost(ngx_connection_t *c, ngx_quic_frame_t *f);
+
+static void ngx_quic_cubic_init(ngx_quic_connection_t *qc);
+static void ngx_quic_cubic_ack(ngx_connection_t *c, ngx_quic_frame_t *f);
+static void ngx_quic_cubic_lost(ngx_connection_t *c, ngx_quic_frame_t *f);
+static void ngx_quic_cubic_persistent(ngx_connection_t *c);
+static size_t ngx_quic_cubic_window(ngx_quic_connection_t *qc,
+    ngx_msec_t t);
+static void ngx_quic_cubic_pacing(ngx_quic_connection_t *qc);
+static uint64_t ngx_quic_cbrt(uint64_t x);
+
+static void ngx_quic_bbr_init(ngx_quic_connection_t *qc);
+static void ngx_quic_bbr_ack(ngx_connection_t *c, ngx_quic_frame_t *f);
+static void ngx_quic_bbr_lost(ngx_connection_t *c, ngx_quic_frame_t *f);
+static void ngx_quic_bbr_update_model(ngx_connection_t *c,
+    ngx_quic_frame_t *f);
+static void ngx_quic_bbr_check_loss(ngx_connection_t *c);
+static void ngx_quic_bbr_update_state(ngx_connection_t *c);
+static void ngx_quic_bbr_enter_probe_bw(ngx_quic_connection_t *qc);
+static size_t ngx_quic_bbr_bdp(ngx_quic_connection_t *qc, ngx_uint_t gain);
+
+
+static ngx_quic_congestion_ops_t  ngx_quic_congestion_ops[] = {
+
+    /* NGX_QUIC_CONGESTION_RENO */
+    { NULL,
+      ngx_quic_reno_ack,
+      ngx_quic_reno_lost,
+      NULL },
+
+    /* NGX_QUIC_CONGESTION_CUBIC */
+    { ngx_quic_cubic_init,
+      ngx_quic_cubic_ack,
+      ngx_quic_cubic_lost,
+      ngx_quic_cubic_persistent },
+
+    /* NGX_QUIC_CONGESTION_BBR */
+    { ngx_quic_bbr_init,
+      ngx_quic_bbr_ack,
+      ngx_quic_bbr_lost,
+      NULL }
+};
+
+
+static ngx_uint_t  ngx_quic_bbr_cycle[NGX_QUIC_BBR_CYCLE_LEN] = {
+    125, 75, 100, 100, 100, 100, 100, 100
+};
+
+
+void
+ngx_quic_congestion_init(ngx_quic_connection_t *qc)
+{
+    ngx_quic_congestion_t  *cg;
+
+    cg = &qc->congestion;
+
+    ngx_memzero(cg, sizeof(ngx_quic_congestion_t));
+
+    cg->window = ngx_min(10 * qc->tp.max_udp_payload_size,
+                         ngx_max(2 * qc->tp.max_udp_payload_size, 14720));
+    cg->ssthresh = (size_t) -1;
+    cg->recovery_start = ngx_current_msec;
+    cg->delivered_time = ngx_current_msec;
+
+    cg->pacing_budget = cg->window;
+    cg->pacing_time = ngx_current_msec;
+
+    cg->ops = &ngx_quic_congestion_ops[qc->conf->congestion];
+
+    if (cg->ops->init) {
+        cg->ops->init(qc);
+    }
+}
+
+
+void
+ngx_quic_congestion_sent(ngx_connection_t *c, ngx_quic_frame_t *f)
+{
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    if (f->plen == 0) {
+        return;
+    }
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+
+    if (cg->in_flight == 0) {
+        /* delivery rate is measured from the start of a flight */
+        cg->delivered_time = ngx_current_msec;
+    }
+
+    f->delivered = cg->delivered;
+    f->delivered_time = cg->delivered_time;
+    f->app_limited = cg->app_limited ? 1 : 0;
+
+    cg->in_flight += f->plen;
+}
+
+
+size_t
+ngx_quic_pacing_budget(ngx_connection_t *c)
+{
+    size_t                  burst, mtu;
+    uint64_t                add;
+    ngx_msec_t              elapsed, delay;
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+
+    if (cg->pacing_rate == 0) {
+        return NGX_MAX_SIZE_T_VALUE;
+    }
+
+    mtu = qc->path->mtu;
+
+    elapsed = ngx_current_msec - cg->pacing_time;
+
+    if (elapsed) {
+        cg->pacing_time = ngx_current_msec;
+
+        burst = cg->pacing_rate * NGX_QUIC_PACING_BURST / 1000;
+        burst = ngx_max(burst, NGX_QUIC_PACING_MIN_BURST * mtu);
+
+        add = (elapsed < 1000) ? cg->pacing_rate * elapsed / 1000 : burst;
+
+        if (cg->pacing_budget < burst) {
+            cg->pacing_budget = ngx_min(cg->pacing_budget + add, burst);
+        }
+    }
+
+    if (cg->pacing_budget) {
+        return cg->pacing_budget;
+    }
+
+    delay = mtu * 1000 / cg->pacing_rate + 1;
+
+    if (qc->pacing.timer_set) {
+
+        if ((ngx_msec_int_t) (qc->pacing.timer.key - ngx_current_msec - delay)
+            <= 0)
+        {
+            return 0;
+        }
+
+        /* the rate has grown, an earlier wakeup is needed */
+
+        ngx_del_timer(&qc->pacing);
+    }
+
+    ngx_log_debug2(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                   "quic pacing delay:%M rate:%uL", delay, cg->pacing_rate);
+
+    ngx_add_timer(&qc->pacing, delay);
+
+    return 0;
+}
+
+
+void
+ngx_quic_pacing_sent(ngx_connection_t *c, size_t len)
+{
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+
+    if (cg->pacing_rate == 0) {
+        return;
+    }
+
+    cg->pacing_budget = (cg->pacing_budget > len) ? cg->pacing_budget - len
+                                                  : 0;
+}
+
+
+static void
+ngx_quic_reno_ack(ngx_connection_t *c, ngx_quic_frame_t *f)
+{
+    ngx_msec_t              timer;
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+
+    timer = f->send_time - cg->recovery_start;
+
+    if ((ngx_msec_int_t) timer <= 0) {
+        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "quic congestion ack recovery win:%uz ss:%z if:%uz",
+                       cg->window, cg->ssthresh, cg->in_flight);
+        return;
+    }
+
+    if (cg->window < cg->ssthresh) {
+        cg->window += f->plen;
+
+        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "quic congestion slow start win:%uz ss:%z if:%uz",
+                       cg->window, cg->ssthresh, cg->in_flight);
+
+    } else {
+        cg->window += qc->tp.max_udp_payload_size * f->plen / cg->window;
+
+        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "quic congestion avoidance win:%uz ss:%z if:%uz",
+                       cg->window, cg->ssthresh, cg->in_flight);
+    }
+}
+
+
+static void
+ngx_quic_reno_lost(ngx_connection_t *c, ngx_quic_frame_t *f)
+{
+    ngx_msec_t              timer;
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+
+    timer = f->send_time - cg->recovery_start;
+
+    if ((ngx_msec_int_t) timer <= 0) {
+        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "quic congestion lost recovery win:%uz ss:%z if:%uz",
+                       cg->window, cg->ssthresh, cg->in_flight);
+        return;
+    }
+
+    cg->recovery_start = ngx_current_msec;
+    cg->window /= 2;
+
+    if (cg->window < qc->tp.max_udp_payload_size * 2) {
+        cg->window = qc->tp.max_udp_payload_size * 2;
+    }
+
+    cg->ssthresh = cg->window;
+
+    ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                   "quic congestion lost win:%uz ss:%z if:%uz",
+                   cg->window, cg->ssthresh, cg->in_flight);
+}
+
+
+static void
+ngx_quic_cubic_init(ngx_quic_connection_t *qc)
+{
+    ngx_quic_cubic_pacing(qc);
+}
+
+
+static void
+ngx_quic_cubic_ack(ngx_connection_t *c, ngx_quic_frame_t *f)
+{
+    size_t                  mss, target;
+    ngx_msec_t              timer;
+    ngx_quic_cubic_t       *cubic;
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+    cubic = &cg->u.cubic;
+
+    mss = qc->tp.max_udp_payload_size;
+
+    timer = f->send_time - cg->recovery_start;
+
+    if ((ngx_msec_int_t) timer <= 0) {
+        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "quic cubic ack recovery win:%uz ss:%z if:%uz",
+                       cg->window, cg->ssthresh, cg->in_flight);
+        return;
+    }
+
+    if (cg->window < cg->ssthresh) {
+        cg->window += f->plen;
+
+        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "quic cubic slow start win:%uz ss:%z if:%uz",
+                       cg->window, cg->ssthresh, cg->in_flight);
+
+        ngx_quic_cubic_pacing(qc);
+        return;
+    }
+
+    if (!cubic->epoch) {
+        cubic->epoch = 1;
+        cubic->epoch_start = ngx_current_msec;
+        cubic->w_max = cg->window;
+        cubic->w_est = cg->window;
+        cubic->k = 0;
+    }
+
+    /* RFC 9438, 4.3.  Reno-Friendly Region */
+
+    cubic->w_est += (uint64_t) mss * f->plen * NGX_QUIC_CUBIC_ALPHA
+                    / 1000 / cg->window;
+
+    /* RFC 9438, 4.4.  Concave Region, 4.5.  Convex Region */
+
+    target = ngx_quic_cubic_window(qc, ngx_current_msec - cubic->epoch_start
+                                       + qc->avg_rtt);
+
+    if (target < cubic->w_est) {
+        cg->window = ngx_max(cg->window, cubic->w_est);
+
+    } else {
+        target = ngx_min(target, cg->window + cg->window / 2);
+
+        if (target > cg->window) {
+            cg->window += (uint64_t) (target - cg->window) * f->plen
+                          / cg->window;
+        }
+    }
+
+    ngx_log_debug4(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                   "quic cubic avoidance win:%uz wmax:%uz west:%uz if:%uz",
+                   cg->window, cubic->w_max, cubic->w_est, cg->in_flight);
+
+    ngx_quic_cubic_pacing(qc);
+}
+
+
+static void
+ngx_quic_cubic_lost(ngx_connection_t *c, ngx_quic_frame_t *f)
+{
+    size_t                  mss;
+    uint64_t                diff;
+    ngx_msec_t              timer;
+    ngx_quic_cubic_t       *cubic;
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+    cubic = &cg->u.cubic;
+
+    mss = qc->tp.max_udp_payload_size;
+
+    timer = f->send_time - cg->recovery_start;
+
+    if ((ngx_msec_int_t) timer <= 0) {
+        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "quic cubic lost recovery win:%uz ss:%z if:%uz",
+                       cg->window, cg->ssthresh, cg->in_flight);
+        return;
+    }
+
+    cg->recovery_start = ngx_current_msec;
+
+    /* RFC 9438, 4.7.  Fast Convergence */
+
+    if (cubic->epoch && cg->window < cubic->w_max) {
+        cubic->w_max = cg->window * (10 + NGX_QUIC_CUBIC_BETA) / 20;
+
+    } else {
+        cubic->w_max = cg->window;
+    }
+
+    cg->window = cg->window * NGX_QUIC_CUBIC_BETA / 10;
+
+    if (cg->window < mss * 2) {
+        cg->window = mss * 2;
+    }
+
+    cg->ssthresh = cg->window;
+
+    /* K = cbrt((W_max - cwnd) / C), C = 0.4, in milliseconds */
+
+    diff = (cubic->w_max > cg->window) ? cubic->w_max - cg->window : 0;
+
+    cubic->k = ngx_quic_cbrt(diff * 1000 / mss * 2500000);
+    cubic->epoch_start = ngx_current_msec;
+    cubic->w_est = cg->window;
+    cubic->epoch = 1;
+
+    ngx_log_debug4(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                   "quic cubic lost win:%uz wmax:%uz k:%M if:%uz",
+                   cg->window, cubic->w_max, cubic->k, cg->in_flight);
+
+    ngx_quic_cubic_pacing(qc);
+}
+
+
+static void
+ngx_quic_cubic_persistent(ngx_connection_t *c)
+{
+    ngx_quic_connection_t  *qc;
+
+    qc = ngx_quic_get_connection(c);
+
+    qc->congestion.u.cubic.epoch = 0;
+    qc->congestion.ssthresh = (size_t) -1;
+
+    ngx_quic_cubic_pacing(qc);
+}
+
+
+static size_t
+ngx_quic_cubic_window(ngx_quic_connection_t *qc, ngx_msec_t t)
+{
+    int64_t            d, w;
+    ngx_quic_cubic_t  *cubic;
+
+    cubic = &qc->congestion.u.cubic;
+
+    /* W_cubic(t) = C * (t - K)^3 + W_max, C = 0.4 */
+
+    d = (int64_t) t - (int64_t) cubic->k;
+
+    if (d > NGX_QUIC_CUBIC_MAX_T) {
+        d = NGX_QUIC_CUBIC_MAX_T;
+
+    } else if (d < -NGX_QUIC_CUBIC_MAX_T) {
+        d = -NGX_QUIC_CUBIC_MAX_T;
+    }
+
+    w = (int64_t) cubic->w_max
+        + d * d * d / 1000000 * (int64_t) qc->tp.max_udp_payload_size * 4
+          / 10000;
+
+    if (w < (int64_t) qc->tp.max_udp_payload_size * 2) {
+        return qc->tp.max_udp_payload_size * 2;
+    }
+
+    return (size_t) w;
+}
+
+
+static void
+ngx_quic_cubic_pacing(ngx_quic_connection_t *qc)
+{
+    uint64_t                rate;
+    ngx_quic_congestion_t  *cg;
+
+    cg = &qc->congestion;
+
+    /* pace at 2x the window per RTT in slow start, 1.25x afterwards */
+
+    rate = (uint64_t) cg->window * 1000 / ngx_max(qc->avg_rtt, 1);
+
+    cg->pacing_rate = (cg->window < cg->ssthresh) ? rate * 2 : rate * 5 / 4;
+}
+
+
+static uint64_t
+ngx_quic_cbrt(uint64_t x)
+{
+    int       s;
+    uint64_t  y, b;
+
+    y = 0;
+
+    for (s = 63; s >= 0; s -= 3) {
+        y += y;
+        b = 3 * y * (y + 1) + 1;
+
+        if ((x >> s) >= b) {
+            x -= b << s;
+            y++;
+        }
+    }
+
+    return y;
+}
+
+
+static void
+ngx_quic_bbr_init(ngx_quic_connection_t *qc)
+{
+    ngx_quic_bbr_t         *bbr;
+    ngx_quic_congestion_t  *cg;
+
+    cg = &qc->congestion;
+    bbr = &cg->u.bbr;
+
+    bbr->state = NGX_QUIC_BBR_STARTUP;
+    bbr->pacing_gain = NGX_QUIC_BBR_HIGH_GAIN;
+    bbr->cwnd_gain = NGX_QUIC_BBR_HIGH_GAIN;
+    bbr->min_rtt = NGX_TIMER_INFINITE;
+    bbr->min_rtt_stamp = ngx_current_msec;
+
+    cg->pacing_rate = (uint64_t) cg->window * 1000 / NGX_QUIC_INITIAL_RTT
+                      * NGX_QUIC_BBR_HIGH_GAIN / 100;
+}
+
+
+static void
+ngx_quic_bbr_ack(ngx_connection_t *c, ngx_quic_frame_t *f)
+{
+    size_t                  mss, target;
+    uint64_t                rate;
+    ngx_quic_bbr_t         *bbr;
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+    bbr = &cg->u.bbr;
+
+    mss = qc->tp.max_udp_payload_size;
+
+    ngx_quic_bbr_update_model(c, f);
+    ngx_quic_bbr_update_state(c);
+
+    if (bbr->max_bw) {
+        rate = bbr->max_bw * bbr->pacing_gain / 100;
+
+        if (bbr->filled_pipe || rate > cg->pacing_rate) {
+            cg->pacing_rate = rate;
+        }
+    }
+
+    if (bbr->recovery) {
+        /* packet conservation */
+        cg->window = ngx_max(cg->window, cg->in_flight + f->plen);
+
+    } else if (bbr->max_bw) {
+        target = ngx_quic_bbr_bdp(qc, bbr->cwnd_gain) + 3 * mss;
+
+        if (bbr->inflight_hi) {
+            target = ngx_min(target, bbr->inflight_hi);
+        }
+
+        if (bbr->filled_pipe) {
+            cg->window = ngx_min(cg->window + f->plen, target);
+
+        } else if (cg->window < target || cg->delivered < 10 * mss) {
+            cg->window += f->plen;
+        }
+    }
+
+    if (bbr->state == NGX_QUIC_BBR_PROBE_RTT) {
+        cg->window = ngx_min(cg->window, NGX_QUIC_BBR_MIN_WINDOW * mss);
+    }
+
+    cg->window = ngx_max(cg->window, NGX_QUIC_BBR_MIN_WINDOW * mss);
+
+    ngx_log_debug6(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                   "quic bbr ack state:%ui win:%uz if:%uz bw:%uL"
+                   " min_rtt:%M rate:%uL",
+                   bbr->state, cg->window, cg->in_flight, bbr->max_bw,
+                   bbr->min_rtt, cg->pacing_rate);
+}
+
+
+static void
+ngx_quic_bbr_update_model(ngx_connection_t *c, ngx_quic_frame_t *f)
+{
+    uint64_t                bw;
+    ngx_uint_t              i;
+    ngx_msec_t              rtt, interval;
+    ngx_quic_bbr_t         *bbr;
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+    bbr = &cg->u.bbr;
+
+    /* packet-timed rounds */
+
+    bbr->round_start = 0;
+
+    if (f->delivered >= bbr->next_round_delivered) {
+        bbr->next_round_delivered = cg->delivered;
+        bbr->round_count++;
+        bbr->round_start = 1;
+
+        bbr->bw[bbr->round_count % NGX_QUIC_BBR_BW_ROUNDS] = 0;
+
+        ngx_quic_bbr_check_loss(c);
+    }
+
+    /* delivery rate sample, windowed max over the last rounds */
+
+    interval = ngx_current_msec - f->delivered_time;
+    bw = (cg->delivered - f->delivered) * 1000 / ngx_max(interval, 1);
+
+    if (!f->app_limited || bw >= bbr->max_bw) {
+        i = bbr->round_count % NGX_QUIC_BBR_BW_ROUNDS;
+
+        if (bw > bbr->bw[i]) {
+            bbr->bw[i] = bw;
+        }
+    }
+
+    bbr->max_bw = 0;
+
+    for (i = 0; i < NGX_QUIC_BBR_BW_ROUNDS; i++) {
+        bbr->max_bw = ngx_max(bbr->max_bw, bbr->bw[i]);
+    }
+
+    /* windowed min RTT, expiry triggers ProbeRTT */
+
+    rtt = ngx_current_msec - f->send_time;
+
+    if (bbr->state != NGX_QUIC_BBR_PROBE_RTT
+        && bbr->min_rtt != NGX_TIMER_INFINITE
+        && ngx_current_msec - bbr->min_rtt_stamp > NGX_QUIC_BBR_MIN_RTT_WINDOW)
+    {
+        bbr->state = NGX_QUIC_BBR_PROBE_RTT;
+        bbr->pacing_gain = 100;
+        bbr->probe_rtt_done = 0;
+        bbr->prior_window = ngx_max(bbr->prior_window, cg->window);
+
+        bbr->min_rtt = rtt;
+        bbr->min_rtt_stamp = ngx_current_msec;
+
+        ngx_log_debug0(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "quic bbr enter probe rtt");
+
+    } else if (rtt <= bbr->min_rtt) {
+        bbr->min_rtt = rtt;
+        bbr->min_rtt_stamp = ngx_current_msec;
+    }
+
+    /* full pipe detection */
+
+    if (!bbr->filled_pipe && bbr->round_start && !f->app_limited) {
+
+        if (bbr->max_bw >= bbr->full_bw * 5 / 4) {
+            bbr->full_bw = bbr->max_bw;
+            bbr->full_bw_count = 0;
+
+        } else if (++bbr->full_bw_count >= NGX_QUIC_BBR_FULL_BW_ROUNDS) {
+            bbr->filled_pipe = 1;
+        }
+    }
+
+    /* end of recovery */
+
+    if (bbr->recovery
+        && (ngx_msec_int_t) (f->send_time - cg->recovery_start) > 0)
+    {
+        bbr->recovery = 0;
+        cg->window = ngx_max(cg->window, bbr->prior_window);
+        bbr->prior_window = 0;
+    }
+}
+
+
+static void
+ngx_quic_bbr_check_loss(ngx_connection_t *c)
+{
+    size_t                  hi;
+    uint64_t                delivered;
+    ngx_quic_bbr_t         *bbr;
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+    bbr = &cg->u.bbr;
+
+    /*
+     * as in BBRv2, a round with excessive loss bounds inflight data
+     * and ends startup, instead of relying on the bandwidth plateau only
+     */
+
+    delivered = cg->delivered - bbr->round_delivered;
+
+    if (bbr->round_lost >= NGX_QUIC_BBR_FULL_LOSS_COUNT
+                           * qc->tp.max_udp_payload_size
+        && bbr->round_lost * 100
+           > (bbr->round_lost + delivered) * NGX_QUIC_BBR_LOSS_THRESH)
+    {
+        hi = bbr->inflight_hi ? bbr->inflight_hi : cg->window;
+        hi = hi * NGX_QUIC_BBR_BETA / 10;
+
+        bbr->inflight_hi = ngx_max(hi, ngx_quic_bbr_bdp(qc, 100));
+        bbr->filled_pipe = 1;
+
+        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "quic bbr loss lost:%uz delivered:%uL hi:%uz",
+                       bbr->round_lost, delivered, bbr->inflight_hi);
+    }
+
+    bbr->round_lost = 0;
+    bbr->round_delivered = cg->delivered;
+}
+
+
+static void
+ngx_quic_bbr_update_state(ngx_connection_t *c)
+{
+    size_t                  mss;
+    ngx_uint_t              advance;
+    ngx_msec_t              elapsed;
+    ngx_quic_bbr_t         *bbr;
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+    bbr = &cg->u.bbr;
+
+    mss = qc->tp.max_udp_payload_size;
+
+    switch (bbr->state) {
+
+    case NGX_QUIC_BBR_STARTUP:
+
+        if (bbr->filled_pipe) {
+            bbr->state = NGX_QUIC_BBR_DRAIN;
+            bbr->pacing_gain = NGX_QUIC_BBR_DRAIN_GAIN;
+
+            ngx_log_debug1(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                           "quic bbr enter drain bw:%uL", bbr->max_bw);
+        }
+
+        break;
+
+    case NGX_QUIC_BBR_DRAIN:
+
+        if (cg->in_flight <= ngx_quic_bbr_bdp(qc, 100)) {
+            ngx_quic_bbr_enter_probe_bw(qc);
+        }
+
+        break;
+
+    case NGX_QUIC_BBR_PROBE_BW:
+
+        elapsed = ngx_current_msec - bbr->cycle_stamp;
+        advance = (elapsed > bbr->min_rtt);
+
+        if (bbr->pacing_gain > 100) {
+            advance = advance && cg->in_flight
+                                 >= ngx_quic_bbr_bdp(qc, bbr->pacing_gain);
+
+        } else if (bbr->pacing_gain < 100) {
+            advance = advance || cg->in_flight <= ngx_quic_bbr_bdp(qc, 100);
+        }
+
+        if (advance) {
+            bbr->cycle_index = (bbr->cycle_index + 1) % NGX_QUIC_BBR_CYCLE_LEN;
+            bbr->cycle_stamp = ngx_current_msec;
+            bbr->pacing_gain = ngx_quic_bbr_cycle[bbr->cycle_index];
+
+            if (bbr->pacing_gain > 100 && bbr->inflight_hi) {
+                /* probe for more inflight room */
+                bbr->inflight_hi += bbr->inflight_hi / 4;
+            }
+        }
+
+        break;
+
+    case NGX_QUIC_BBR_PROBE_RTT:
+
+        if (bbr->probe_rtt_done == 0) {
+
+            if (cg->in_flight <= NGX_QUIC_BBR_MIN_WINDOW * mss) {
+                bbr->probe_rtt_done = ngx_current_msec
+                                      + NGX_QUIC_BBR_PROBE_RTT_TIME;
+                bbr->probe_rtt_round = 0;
+                bbr->next_round_delivered = cg->delivered;
+            }
+
+            break;
+        }
+
+        if (bbr->round_start) {
+            bbr->probe_rtt_round = 1;
+        }
+
+        if (bbr->probe_rtt_round
+            && (ngx_msec_int_t) (ngx_current_msec - bbr->probe_rtt_done) >= 0)
+        {
+            bbr->min_rtt_stamp = ngx_current_msec;
+            cg->window = ngx_max(cg->window, bbr->prior_window);
+            bbr->prior_window = 0;
+
+            if (bbr->filled_pipe) {
+                ngx_quic_bbr_enter_probe_bw(qc);
+
+            } else {
+                bbr->state = NGX_QUIC_BBR_STARTUP;
+                bbr->pacing_gain = NGX_QUIC_BBR_HIGH_GAIN;
+                bbr->cwnd_gain = NGX_QUIC_BBR_HIGH_GAIN;
+            }
+
+            ngx_log_debug1(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                           "quic bbr exit probe rtt min_rtt:%M",
+                           bbr->min_rtt);
+        }
+
+        break;
+    }
+}
+
+
+static void
+ngx_quic_bbr_enter_probe_bw(ngx_quic_connection_t *qc)
+{
+    ngx_quic_bbr_t  *bbr;
+
+    bbr = &qc->congestion.u.bbr;
+
+    /* start at a random phase other than the draining one */
+
+    bbr->state = NGX_QUIC_BBR_PROBE_BW;
+    bbr->cwnd_gain = NGX_QUIC_BBR_CWND_GAIN;
+    bbr->cycle_index = (NGX_QUIC_BBR_CYCLE_LEN
+                        - ngx_random() % (NGX_QUIC_BBR_CYCLE_LEN - 1))
+                       % NGX_QUIC_BBR_CYCLE_LEN;
+    bbr->cycle_stamp = ngx_current_msec;
+    bbr->pacing_gain = ngx_quic_bbr_cycle[bbr->cycle_index];
+}
+
+
+static void
+ngx_quic_bbr_lost(ngx_connection_t *c, ngx_quic_frame_t *f)
+{
+    size_t                  mss;
+    ngx_msec_t              timer;
+    ngx_quic_bbr_t         *bbr;
+    ngx_quic_congestion_t  *cg;
+    ngx_quic_connection_t  *qc;
+
+    qc = ngx_quic_get_connection(c);
+    cg = &qc->congestion;
+    bbr = &cg->u.bbr;
+
+    mss = qc->tp.max_udp_payload_size;
+
+    bbr->round_lost += f->plen;
+
+    timer = f->send_time - cg->recovery_start;
+
+    if ((ngx_msec_int_t) timer <= 0) {
+        return;
+    }
+
+    cg->recovery_start = ngx_current_msec;
+
+    if (!bbr->recovery) {
+        bbr->recovery = 1;
+        bbr->prior_window = ngx_max(bbr->prior_window, cg->window);
+    }
+
+    cg->window = ngx_max(cg->in_flight, NGX_QUIC_BBR_MIN_WINDOW * mss);
+
+    ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                   "quic bbr lost win:%uz prior:%uz if:%uz",
+                   cg->window, bbr->prior_window, cg->in_flight);
+}
+
+
+static size_t
+ngx_quic_bbr_bdp(ngx_quic_connection_t *qc, ngx_uint_t gain)
+{
+    ngx_msec_t       rtt;
+    ngx_quic_bbr_t  *bbr;
+
+    bbr = &qc->congestion.u.bbr;
+
+    if (bbr->max_bw == 0 || bbr->min_rtt == NGX_TIMER_INFINITE) {
+        return qc->congestion.window;
+    }
+
+    rtt = ngx_max(bbr->min_rtt, 1);
+
+    return bbr->max_bw * rtt / 1000 * gain / 100;
+}
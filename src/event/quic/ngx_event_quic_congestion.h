@@ -0,0 +1,74 @@
+
+/*
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#ifndef _NGX_EVENT_QUIC_CONGESTION_H_INCLUDED_
+#define _NGX_EVENT_QUIC_CONGESTION_H_INCLUDED_
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+
+
+#define NGX_QUIC_BBR_BW_ROUNDS               10
+
+
+typedef struct {
+    size_t                            w_max;
+    size_t                            w_est;
+    ngx_msec_t                        epoch_start;
+    ngx_msec_t                        k;
+    unsigned                          epoch:1;
+} ngx_quic_cubic_t;
+
+
+typedef struct {
+    ngx_uint_t                        state;
+    ngx_uint_t                        pacing_gain;      /* percents */
+    ngx_uint_t                        cwnd_gain;        /* percents */
+
+    uint64_t                          bw[NGX_QUIC_BBR_BW_ROUNDS];
+    uint64_t                          max_bw;           /* bytes per second */
+    uint64_t                          full_bw;
+    ngx_uint_t                        full_bw_count;
+
+    uint64_t                          round_count;
+    uint64_t                          next_round_delivered;
+    uint64_t                          round_delivered;
+    size_t                            round_lost;
+    size_t                            inflight_hi;
+
+    ngx_msec_t                        min_rtt;
+    ngx_msec_t                        min_rtt_stamp;
+    ngx_msec_t                        probe_rtt_done;
+
+    ngx_uint_t                        cycle_index;
+    ngx_msec_t                        cycle_stamp;
+
+    size_t                            prior_window;
+
+    unsigned                          filled_pipe:1;
+    unsigned                          round_start:1;
+    unsigned                          probe_rtt_round:1;
+    unsigned                          recovery:1;
+} ngx_quic_bbr_t;
+
+
+typedef struct {
+    void                            (*init)(ngx_quic_connection_t *qc);
+    void                            (*ack)(ngx_connection_t *c,
+                                           ngx_quic_frame_t *f);
+    void                            (*lost)(ngx_connection_t *c,
+                                            ngx_quic_frame_t *f);
+    void                            (*persistent)(ngx_connection_t *c);
+} ngx_quic_congestion_ops_t;
+
+
+void ngx_quic_congestion_init(ngx_quic_connection_t *qc);
+void ngx_quic_congestion_sent(ngx_connection_t *c, ngx_quic_frame_t *f);
+size_t ngx_quic_pacing_budget(ngx_connection_t *c);
+void ngx_quic_pacing_sent(ngx_connection_t *c, size_t len);
+
+#endif /* _NGX_EVENT_QUIC_CONGESTION_H_INCLUDED_ */
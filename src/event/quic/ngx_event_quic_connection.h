@@ -37,6 +37,7 @@ typedef struct ngx_quic_keys_s        ngx_quic_keys_t;
 #include <ngx_event_quic_ssl.h>
 #include <ngx_event_quic_tokens.h>
 #include <ngx_event_quic_ack.h>
+#include <ngx_event_quic_congestion.h>
 #include <ngx_event_quic_output.h>
 #include <ngx_event_quic_socket.h>
 
@@ -169,6 +170,21 @@ typedef struct {
     size_t                            window;
     size_t                            ssthresh;
     ngx_msec_t                        recovery_start;
+
+    uint64_t                          delivered;
+    ngx_msec_t                        delivered_time;
+    uint64_t                          app_limited;
+
+    uint64_t                          pacing_rate;  /* bytes per second */
+    size_t                            pacing_budget;
+    ngx_msec_t                        pacing_time;
+
+    ngx_quic_congestion_ops_t        *ops;
+
+    union {
+        ngx_quic_cubic_t              cubic;
+        ngx_quic_bbr_t                bbr;
+    } u;
 } ngx_quic_congestion_t;
 
 
@@ -234,6 +250,7 @@ struct ngx_quic_connection_s {
     ngx_quic_conf_t                  *conf;
 
     ngx_event_t                       push;
+    ngx_event_t                       pacing;
     ngx_event_t                       pto;
     ngx_event_t                       close;
     ngx_event_t                       path_validation;
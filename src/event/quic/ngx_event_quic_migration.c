@@ -180,13 +180,7 @@ valid:
         ctx = ngx_quic_get_send_ctx(qc, ssl_encryption_application);
         qc->rst_pnum = ctx->pnum;
 
-        ngx_memzero(&qc->congestion, sizeof(ngx_quic_congestion_t));
-
-        qc->congestion.window = ngx_min(10 * qc->tp.max_udp_payload_size,
-                                   ngx_max(2 * qc->tp.max_udp_payload_size,
-                                           14720));
-        qc->congestion.ssthresh = (size_t) -1;
-        qc->congestion.recovery_start = ngx_current_msec;
+        ngx_quic_congestion_init(qc);
 
         ngx_quic_init_rtt(qc);
     }
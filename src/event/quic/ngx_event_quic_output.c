@@ -93,6 +93,13 @@ ngx_quic_output(ngx_connection_t *c)
         return NGX_ERROR;
     }
 
+    if (cg->in_flight < cg->window
+        && (cg->pacing_rate == 0 || cg->pacing_budget))
+    {
+        /* neither congestion nor pacing limited */
+        cg->app_limited = ngx_max(cg->delivered + cg->in_flight, 1);
+    }
+
     if (in_flight == cg->in_flight || qc->closing) {
         /* no ack-eliciting data was sent or we are done */
         return NGX_OK;
@@ -129,6 +136,10 @@ ngx_quic_create_datagrams(ngx_connection_t *c)
 
     while (cg->in_flight < cg->window) {
 
+        if (ngx_quic_pacing_budget(c) == 0) {
+            break;
+        }
+
         p = dst;
 
         len = ngx_quic_path_limit(c, path, path->mtu);
@@ -192,6 +203,8 @@ ngx_quic_create_datagrams(ngx_connection_t *c)
             ngx_quic_commit_send(c, &qc->send_ctx[i]);
         }
 
+        ngx_quic_pacing_sent(c, len);
+
         path->sent += len;
     }
 
@@ -204,13 +217,10 @@ ngx_quic_commit_send(ngx_connection_t *c, ngx_quic_send_ctx_t *ctx)
 {
     ngx_queue_t            *q;
     ngx_quic_frame_t       *f;
-    ngx_quic_congestion_t  *cg;
     ngx_quic_connection_t  *qc;
 
     qc = ngx_quic_get_connection(c);
 
-    cg = &qc->congestion;
-
     while (!ngx_queue_empty(&ctx->sending)) {
 
         q = ngx_queue_head(&ctx->sending);
@@ -221,7 +231,7 @@ ngx_quic_commit_send(ngx_connection_t *c, ngx_quic_send_ctx_t *ctx)
         if (f->pkt_need_ack && !qc->closing) {
             ngx_queue_insert_tail(&ctx->sent, q);
 
-            cg->in_flight += f->plen;
+            ngx_quic_congestion_sent(c, f);
 
         } else {
             ngx_quic_free_frame(c, f);
@@ -308,7 +318,7 @@ ngx_quic_allow_segmentation(ngx_connection_t *c)
 static ngx_int_t
 ngx_quic_create_segments(ngx_connection_t *c)
 {
-    size_t                  len, segsize;
+    size_t                  len, segsize, budget;
     ssize_t                 n;
     u_char                 *p, *end;
     uint64_t                preserved_pnum;
@@ -337,11 +347,15 @@ ngx_quic_create_segments(ngx_connection_t *c)
 
     preserved_pnum = ctx->pnum;
 
+    budget = ngx_quic_pacing_budget(c);
+
     for ( ;; ) {
 
         len = ngx_min(segsize, (size_t) (end - p));
 
-        if (len && cg->in_flight + (p - dst) < cg->window) {
+        if (len && cg->in_flight + (p - dst) < cg->window
+            && (size_t) (p - dst) < budget)
+        {
 
             n = ngx_quic_output_packet(c, ctx, p, len, len);
             if (n == NGX_ERROR) {
@@ -376,12 +390,15 @@ ngx_quic_create_segments(ngx_connection_t *c)
             }
 
             ngx_quic_commit_send(c, ctx);
+            ngx_quic_pacing_sent(c, n);
 
             path->sent += n;
 
             p = dst;
             nseg = 0;
             preserved_pnum = ctx->pnum;
+
+            budget = ngx_quic_pacing_budget(c);
         }
     }
 
@@ -1280,7 +1297,7 @@ ngx_quic_frame_sendto(ngx_connection_t *c, ngx_quic_frame_t *frame,
     if (frame->need_ack && !qc->closing) {
         ngx_queue_insert_tail(&ctx->sent, &frame->queue);
 
-        cg->in_flight += frame->plen;
+        ngx_quic_congestion_sent(c, frame);
 
     } else {
         ngx_quic_free_frame(c, frame);
@@ -10,12 +10,11 @@
 #include <ngx_http.h>
 
 
-typedef struct {
-    ngx_array_t               *flushes;
-    ngx_array_t               *lengths;
-    ngx_array_t               *values;
-    ngx_hash_t                 hash;
-} ngx_http_grpc_headers_t;
+#define NGX_HTTP_GRPC_MUX_WINDOW       (256 * 1024)
+#define NGX_HTTP_GRPC_MUX_BUFFER       (32 * 1024)
+#define NGX_HTTP_GRPC_MUX_CHUNK        NGX_HTTP_V2_DEFAULT_FRAME_SIZE
+#define NGX_HTTP_GRPC_MUX_BUFFERED     (64 * 1024)
+#define NGX_HTTP_GRPC_MUX_MAX_STREAM   0x7ffffff0
 
 
 typedef struct {
@@ -61,10 +60,99 @@ typedef struct {
     size_t                     init_window;
     size_t                     send_window;
     size_t                     recv_window;
+    size_t                     stream_window;
     ngx_uint_t                 last_stream_id;
+    unsigned                   shared:1;
 } ngx_http_grpc_conn_t;
 
 
+typedef struct ngx_http_grpc_session_s  ngx_http_grpc_session_t;
+
+
+typedef struct {
+    ngx_uint_t                 streams;
+    ngx_uint_t                 connections;
+    ngx_msec_t                 timeout;
+
+    ngx_queue_t                sessions;
+
+    ngx_http_upstream_init_pt       original_init_upstream;
+    ngx_http_upstream_init_peer_pt  original_init_peer;
+} ngx_http_grpc_mux_conf_t;
+
+
+typedef struct {
+    ngx_connection_t           connection;
+    ngx_event_t                read;
+    ngx_event_t                write;
+
+    ngx_http_grpc_session_t   *session;
+    ngx_queue_t                queue;
+
+    ngx_http_request_t        *request;
+
+    ngx_chain_t               *in;
+
+    unsigned                   started:1;
+    unsigned                   blocked:1;
+    unsigned                   error:1;
+} ngx_http_grpc_stream_t;
+
+
+struct ngx_http_grpc_session_s {
+    ngx_http_grpc_mux_conf_t  *conf;
+    ngx_queue_t                queue;
+
+    ngx_connection_t          *connection;
+    ngx_pool_t                *pool;
+
+    ngx_http_grpc_conn_t       conn;
+
+    ngx_queue_t                streams;
+    ngx_uint_t                 nstreams;
+    ngx_uint_t                 max_streams;
+
+    ngx_buf_t                 *buffer;
+
+    ngx_chain_t               *out;
+    ngx_chain_t               *free;
+    size_t                     buffered;
+
+    ngx_http_grpc_stream_t    *stream;
+    size_t                     rest;
+    ngx_uint_t                 stream_id;
+    u_char                     type;
+    u_char                     flags;
+
+    ngx_str_t                  name;
+    socklen_t                  socklen;
+    ngx_sockaddr_t             sockaddr;
+
+    unsigned                   payload:1;
+    unsigned                   connected:1;
+    unsigned                   confirmed:1;
+    unsigned                   draining:1;
+    unsigned                   closed:1;
+};
+
+
+typedef struct {
+    ngx_http_grpc_mux_conf_t  *conf;
+    ngx_http_request_t        *request;
+    ngx_http_grpc_stream_t    *stream;
+
+    void                      *data;
+
+    ngx_event_get_peer_pt      original_get_peer;
+    ngx_event_free_peer_pt     original_free_peer;
+
+#if (NGX_HTTP_SSL)
+    ngx_event_set_peer_session_pt   original_set_session;
+    ngx_event_save_peer_session_pt  original_save_session;
+#endif
+} ngx_http_grpc_mux_peer_data_t;
+
+
 typedef struct {
     ngx_http_grpc_state_e      state;
     ngx_uint_t                 frame_state;
@@ -125,7 +213,12 @@ typedef struct {
 
     ngx_http_request_t        *request;
 
+    ngx_http_grpc_headers_t   *headers;
+    ngx_uint_t                 host_set;
+
     ngx_str_t                  host;
+    ngx_str_t                  method;
+    ngx_str_t                  uri;
 } ngx_http_grpc_ctx_t;
 
 
@@ -143,7 +236,7 @@ typedef struct {
 
 
 static ngx_int_t ngx_http_grpc_eval(ngx_http_request_t *r,
-    ngx_http_grpc_ctx_t *ctx, ngx_http_grpc_loc_conf_t *glcf);
+    ngx_http_grpc_request_t *gr, ngx_http_grpc_loc_conf_t *glcf);
 static ngx_int_t ngx_http_grpc_create_request(ngx_http_request_t *r);
 static ngx_int_t ngx_http_grpc_reinit_request(ngx_http_request_t *r);
 static ngx_int_t ngx_http_grpc_body_output_filter(void *data, ngx_chain_t *in);
@@ -193,16 +286,64 @@ static void ngx_http_grpc_finalize_request(ngx_http_request_t *r,
 static ngx_int_t ngx_http_grpc_internal_trailers_variable(
     ngx_http_request_t *r, ngx_http_variable_value_t *v, uintptr_t data);
 
+static ngx_int_t ngx_http_grpc_mux_init(ngx_conf_t *cf,
+    ngx_http_upstream_srv_conf_t *us);
+static ngx_int_t ngx_http_grpc_mux_init_peer(ngx_http_request_t *r,
+    ngx_http_upstream_srv_conf_t *us);
+static ngx_int_t ngx_http_grpc_mux_get_peer(ngx_peer_connection_t *pc,
+    void *data);
+static void ngx_http_grpc_mux_free_peer(ngx_peer_connection_t *pc,
+    void *data, ngx_uint_t state);
+#if (NGX_HTTP_SSL)
+static ngx_int_t ngx_http_grpc_mux_set_session(ngx_peer_connection_t *pc,
+    void *data);
+static void ngx_http_grpc_mux_save_session(ngx_peer_connection_t *pc,
+    void *data);
+#endif
+
+static ngx_http_grpc_session_t *ngx_http_grpc_mux_session(
+    ngx_http_grpc_mux_conf_t *mcf, ngx_peer_connection_t *pc,
+    ngx_http_upstream_t *u);
+static ngx_http_grpc_stream_t *ngx_http_grpc_mux_create_stream(
+    ngx_http_grpc_session_t *s, ngx_http_request_t *r);
+static void ngx_http_grpc_mux_close_stream(ngx_http_grpc_stream_t *st);
+static void ngx_http_grpc_mux_read_handler(ngx_event_t *rev);
+static void ngx_http_grpc_mux_write_handler(ngx_event_t *wev);
+static ngx_int_t ngx_http_grpc_mux_parse(ngx_http_grpc_session_t *s);
+static ngx_int_t ngx_http_grpc_mux_control(ngx_http_grpc_session_t *s,
+    u_char *p);
+static ngx_http_grpc_stream_t *ngx_http_grpc_mux_find_stream(
+    ngx_http_grpc_session_t *s, ngx_uint_t id);
+static ngx_chain_t *ngx_http_grpc_mux_get_buf(ngx_http_grpc_session_t *s,
+    ngx_chain_t **chain);
+static ngx_int_t ngx_http_grpc_mux_queue(ngx_http_grpc_session_t *s,
+    ngx_chain_t **chain, u_char *data, size_t size);
+static ngx_int_t ngx_http_grpc_mux_frame(ngx_http_grpc_session_t *s,
+    ngx_uint_t type, ngx_uint_t flags, ngx_uint_t sid, u_char *data,
+    size_t size);
+static void ngx_http_grpc_mux_flush(ngx_http_grpc_session_t *s);
+static void ngx_http_grpc_mux_notify(ngx_http_grpc_stream_t *st);
+static void ngx_http_grpc_mux_wake(ngx_http_grpc_session_t *s,
+    ngx_uint_t all);
+static void ngx_http_grpc_mux_close(ngx_http_grpc_session_t *s,
+    ngx_uint_t error);
+static ssize_t ngx_http_grpc_mux_recv(ngx_connection_t *c, u_char *buf,
+    size_t size);
+static ssize_t ngx_http_grpc_mux_send(ngx_connection_t *c, u_char *buf,
+    size_t size);
+static ngx_chain_t *ngx_http_grpc_mux_send_chain(ngx_connection_t *c,
+    ngx_chain_t *in, off_t limit);
+
 static ngx_int_t ngx_http_grpc_add_variables(ngx_conf_t *cf);
+static void *ngx_http_grpc_create_srv_conf(ngx_conf_t *cf);
 static void *ngx_http_grpc_create_loc_conf(ngx_conf_t *cf);
 static char *ngx_http_grpc_merge_loc_conf(ngx_conf_t *cf,
     void *parent, void *child);
-static ngx_int_t ngx_http_grpc_init_headers(ngx_conf_t *cf,
-    ngx_http_grpc_loc_conf_t *conf, ngx_http_grpc_headers_t *headers,
-    ngx_keyval_t *default_headers);
 
 static char *ngx_http_grpc_pass(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
+static char *ngx_http_grpc_multiplex(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf);
 
 #if (NGX_HTTP_SSL)
 static char *ngx_http_grpc_ssl_password_file(ngx_conf_t *cf,
@@ -260,6 +401,13 @@ static ngx_command_t  ngx_http_grpc_commands[] = {
       0,
       NULL },
 
+    { ngx_string("http2_multiplex"),
+      NGX_HTTP_UPS_CONF|NGX_CONF_TAKE123,
+      ngx_http_grpc_multiplex,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      0,
+      NULL },
+
     { ngx_string("grpc_bind"),
       NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_TAKE12,
       ngx_http_upstream_bind_set_slot,
@@ -464,7 +612,7 @@ static ngx_http_module_t  ngx_http_grpc_module_ctx = {
     NULL,                                  /* create main configuration */
     NULL,                                  /* init main configuration */
 
-    NULL,                                  /* create server configuration */
+    ngx_http_grpc_create_srv_conf,         /* create server configuration */
     NULL,                                  /* merge server configuration */
 
     ngx_http_grpc_create_loc_conf,         /* create location configuration */
@@ -500,6 +648,20 @@ static u_char  ngx_http_grpc_connection_start[] =
     "\x7f\xff\x00\x00";
 
 
+/* the initial stream window is NGX_HTTP_GRPC_MUX_WINDOW */
+
+static u_char  ngx_http_grpc_mux_start[] =
+    "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"         /* connection preface */
+
+    "\x00\x00\x12\x04\x00\x00\x00\x00\x00"     /* settings frame */
+    "\x00\x01\x00\x00\x00\x00"                 /* header table size */
+    "\x00\x02\x00\x00\x00\x00"                 /* disable push */
+    "\x00\x04\x00\x04\x00\x00"                 /* initial window */
+
+    "\x00\x00\x04\x08\x00\x00\x00\x00\x00"     /* window update frame */
+    "\x7f\xff\x00\x00";
+
+
 static ngx_keyval_t  ngx_http_grpc_headers[] = {
     { ngx_string("Content-Length"), ngx_string("$content_length") },
     { ngx_string("TE"), ngx_string("$grpc_internal_trailers") },
@@ -540,28 +702,24 @@ ngx_http_grpc_handler(ngx_http_request_t *r)
 {
     ngx_int_t                  rc;
     ngx_http_upstream_t       *u;
-    ngx_http_grpc_ctx_t       *ctx;
+    ngx_http_grpc_request_t    gr;
     ngx_http_grpc_loc_conf_t  *glcf;
 
     if (ngx_http_upstream_create(r) != NGX_OK) {
         return NGX_HTTP_INTERNAL_SERVER_ERROR;
     }
 
-    ctx = ngx_pcalloc(r->pool, sizeof(ngx_http_grpc_ctx_t));
-    if (ctx == NULL) {
-        return NGX_HTTP_INTERNAL_SERVER_ERROR;
-    }
-
-    ctx->request = r;
-
-    ngx_http_set_ctx(r, ctx, ngx_http_grpc_module);
-
     glcf = ngx_http_get_module_loc_conf(r, ngx_http_grpc_module);
 
     u = r->upstream;
 
+    ngx_memzero(&gr, sizeof(ngx_http_grpc_request_t));
+
+    gr.headers = &glcf->headers;
+    gr.host_set = glcf->host_set;
+
     if (glcf->grpc_lengths == NULL) {
-        ctx->host = glcf->host;
+        gr.host = glcf->host;
 
 #if (NGX_HTTP_SSL)
         u->ssl = glcf->ssl;
@@ -577,24 +735,16 @@ ngx_http_grpc_handler(ngx_http_request_t *r)
 #endif
 
     } else {
-        if (ngx_http_grpc_eval(r, ctx, glcf) != NGX_OK) {
+        if (ngx_http_grpc_eval(r, &gr, glcf) != NGX_OK) {
             return NGX_HTTP_INTERNAL_SERVER_ERROR;
         }
     }
 
-    u->output.tag = (ngx_buf_tag_t) &ngx_http_grpc_module;
-
     u->conf = &glcf->upstream;
 
-    u->create_request = ngx_http_grpc_create_request;
-    u->reinit_request = ngx_http_grpc_reinit_request;
-    u->process_header = ngx_http_grpc_process_header;
-    u->abort_request = ngx_http_grpc_abort_request;
-    u->finalize_request = ngx_http_grpc_finalize_request;
-
-    u->input_filter_init = ngx_http_grpc_filter_init;
-    u->input_filter = ngx_http_grpc_filter;
-    u->input_filter_ctx = ctx;
+    if (ngx_http_grpc_init_upstream(r, &gr) != NGX_OK) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
 
     r->request_body_no_buffering = 1;
 
@@ -608,8 +758,48 @@ ngx_http_grpc_handler(ngx_http_request_t *r)
 }
 
 
+ngx_int_t
+ngx_http_grpc_init_upstream(ngx_http_request_t *r,
+    ngx_http_grpc_request_t *gr)
+{
+    ngx_http_upstream_t  *u;
+    ngx_http_grpc_ctx_t  *ctx;
+
+    ctx = ngx_pcalloc(r->pool, sizeof(ngx_http_grpc_ctx_t));
+    if (ctx == NULL) {
+        return NGX_ERROR;
+    }
+
+    ctx->request = r;
+
+    ctx->headers = gr->headers;
+    ctx->host_set = gr->host_set;
+    ctx->host = gr->host;
+    ctx->method = gr->method;
+    ctx->uri = gr->uri;
+
+    ngx_http_set_ctx(r, ctx, ngx_http_grpc_module);
+
+    u = r->upstream;
+
+    u->output.tag = (ngx_buf_tag_t) &ngx_http_grpc_module;
+
+    u->create_request = ngx_http_grpc_create_request;
+    u->reinit_request = ngx_http_grpc_reinit_request;
+    u->process_header = ngx_http_grpc_process_header;
+    u->abort_request = ngx_http_grpc_abort_request;
+    u->finalize_request = ngx_http_grpc_finalize_request;
+
+    u->input_filter_init = ngx_http_grpc_filter_init;
+    u->input_filter = ngx_http_grpc_filter;
+    u->input_filter_ctx = ctx;
+
+    return NGX_OK;
+}
+
+
 static ngx_int_t
-ngx_http_grpc_eval(ngx_http_request_t *r, ngx_http_grpc_ctx_t *ctx,
+ngx_http_grpc_eval(ngx_http_request_t *r, ngx_http_grpc_request_t *gr,
     ngx_http_grpc_loc_conf_t *glcf)
 {
     size_t                add;
@@ -690,15 +880,15 @@ ngx_http_grpc_eval(ngx_http_request_t *r, ngx_http_grpc_ctx_t *ctx,
     if (url.family != AF_UNIX) {
 
         if (url.no_port) {
-            ctx->host = url.host;
+            gr->host = url.host;
 
         } else {
-            ctx->host.len = url.host.len + 1 + url.port_text.len;
-            ctx->host.data = url.host.data;
+            gr->host.len = url.host.len + 1 + url.port_text.len;
+            gr->host.data = url.host.data;
         }
 
     } else {
-        ngx_str_set(&ctx->host, "localhost");
+        ngx_str_set(&gr->host, "localhost");
     }
 
     return NGX_OK;
@@ -712,6 +902,7 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
     size_t                        len, tmp_len, key_len, val_len, uri_len;
     uintptr_t                     escape;
     ngx_buf_t                    *b;
+    ngx_str_t                    *method;
     ngx_uint_t                    i, next;
     ngx_chain_t                  *cl, *body;
     ngx_list_part_t              *part;
@@ -720,28 +911,32 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
     ngx_http_upstream_t          *u;
     ngx_http_grpc_frame_t        *f;
     ngx_http_script_code_pt       code;
-    ngx_http_grpc_loc_conf_t     *glcf;
+    ngx_http_grpc_headers_t      *headers;
     ngx_http_script_engine_t      e, le;
     ngx_http_script_len_code_pt   lcode;
 
     u = r->upstream;
 
-    glcf = ngx_http_get_module_loc_conf(r, ngx_http_grpc_module);
-
     ctx = ngx_http_get_module_ctx(r, ngx_http_grpc_module);
 
+    headers = ctx->headers;
+
     len = sizeof(ngx_http_grpc_connection_start) - 1
           + sizeof(ngx_http_grpc_frame_t);             /* headers frame */
 
     /* :method header */
 
-    if (r->method == NGX_HTTP_GET || r->method == NGX_HTTP_POST) {
+    method = ctx->method.len ? &ctx->method : &r->method_name;
+
+    if (ctx->method.len == 0
+        && (r->method == NGX_HTTP_GET || r->method == NGX_HTTP_POST))
+    {
         len += 1;
         tmp_len = 0;
 
     } else {
-        len += 1 + NGX_HTTP_V2_INT_OCTETS + r->method_name.len;
-        tmp_len = r->method_name.len;
+        len += 1 + NGX_HTTP_V2_INT_OCTETS + method->len;
+        tmp_len = method->len;
     }
 
     /* :scheme header */
@@ -750,7 +945,11 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
 
     /* :path header */
 
-    if (r->valid_unparsed_uri) {
+    if (ctx->uri.len) {
+        escape = 0;
+        uri_len = ctx->uri.len;
+
+    } else if (r->valid_unparsed_uri) {
         escape = 0;
         uri_len = r->unparsed_uri.len;
 
@@ -768,7 +967,7 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
 
     /* :authority header */
 
-    if (!glcf->host_set) {
+    if (!ctx->host_set) {
         len += 1 + NGX_HTTP_V2_INT_OCTETS + ctx->host.len;
 
         if (tmp_len < ctx->host.len) {
@@ -778,10 +977,10 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
 
     /* other headers */
 
-    ngx_http_script_flush_no_cacheable_variables(r, glcf->headers.flushes);
+    ngx_http_script_flush_no_cacheable_variables(r, headers->flushes);
     ngx_memzero(&le, sizeof(ngx_http_script_engine_t));
 
-    le.ip = glcf->headers.lengths->elts;
+    le.ip = headers->lengths->elts;
     le.request = r;
     le.flushed = 1;
 
@@ -811,7 +1010,7 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
         }
     }
 
-    if (glcf->upstream.pass_request_headers) {
+    if (u->conf->pass_request_headers) {
         part = &r->headers_in.headers.part;
         header = part->elts;
 
@@ -827,7 +1026,7 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
                 i = 0;
             }
 
-            if (ngx_hash_find(&glcf->headers.hash, header[i].hash,
+            if (ngx_hash_find(&headers->hash, header[i].hash,
                               header[i].lowcase_key, header[i].key.len))
             {
                 continue;
@@ -895,13 +1094,13 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
     f->stream_id_2 = 0;
     f->stream_id_3 = 1;
 
-    if (r->method == NGX_HTTP_GET) {
+    if (ctx->method.len == 0 && r->method == NGX_HTTP_GET) {
         *b->last++ = ngx_http_v2_indexed(NGX_HTTP_V2_METHOD_GET_INDEX);
 
         ngx_log_debug0(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
                        "grpc header: \":method: GET\"");
 
-    } else if (r->method == NGX_HTTP_POST) {
+    } else if (ctx->method.len == 0 && r->method == NGX_HTTP_POST) {
         *b->last++ = ngx_http_v2_indexed(NGX_HTTP_V2_METHOD_POST_INDEX);
 
         ngx_log_debug0(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
@@ -909,11 +1108,11 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
 
     } else {
         *b->last++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_METHOD_INDEX);
-        b->last = ngx_http_v2_write_value(b->last, r->method_name.data,
-                                          r->method_name.len, tmp);
+        b->last = ngx_http_v2_write_value(b->last, method->data,
+                                          method->len, tmp);
 
         ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
-                       "grpc header: \":method: %V\"", &r->method_name);
+                       "grpc header: \":method: %V\"", method);
     }
 
 #if (NGX_HTTP_SSL)
@@ -931,7 +1130,15 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
                        "grpc header: \":scheme: http\"");
     }
 
-    if (r->valid_unparsed_uri) {
+    if (ctx->uri.len) {
+        *b->last++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_PATH_INDEX);
+        b->last = ngx_http_v2_write_value(b->last, ctx->uri.data,
+                                          ctx->uri.len, tmp);
+
+        ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                       "grpc header: \":path: %V\"", &ctx->uri);
+
+    } else if (r->valid_unparsed_uri) {
 
         if (r->unparsed_uri.len == 1 && r->unparsed_uri.data[0] == '/') {
             *b->last++ = ngx_http_v2_indexed(NGX_HTTP_V2_PATH_ROOT_INDEX);
@@ -976,7 +1183,7 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
                        "grpc header: \":path: %V\"", &r->uri);
     }
 
-    if (!glcf->host_set) {
+    if (!ctx->host_set) {
         *b->last++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_AUTHORITY_INDEX);
         b->last = ngx_http_v2_write_value(b->last, ctx->host.data,
                                           ctx->host.len, tmp);
@@ -987,11 +1194,11 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
 
     ngx_memzero(&e, sizeof(ngx_http_script_engine_t));
 
-    e.ip = glcf->headers.values->elts;
+    e.ip = headers->values->elts;
     e.request = r;
     e.flushed = 1;
 
-    le.ip = glcf->headers.lengths->elts;
+    le.ip = headers->lengths->elts;
 
     while (*(uintptr_t *) le.ip) {
 
@@ -1047,7 +1254,7 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
 #endif
     }
 
-    if (glcf->upstream.pass_request_headers) {
+    if (u->conf->pass_request_headers) {
         part = &r->headers_in.headers.part;
         header = part->elts;
 
@@ -1063,7 +1270,7 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
                 i = 0;
             }
 
-            if (ngx_hash_find(&glcf->headers.hash, header[i].hash,
+            if (ngx_hash_find(&headers->hash, header[i].hash,
                               header[i].lowcase_key, header[i].key.len))
             {
                 continue;
@@ -1153,7 +1360,7 @@ ngx_http_grpc_create_request(ngx_http_request_t *r)
 
     } else {
 
-        body = u->request_bufs;
+        body = u->conf->pass_request_body ? u->request_bufs : NULL;
         u->request_bufs = cl;
 
         if (body == NULL) {
@@ -1262,10 +1469,10 @@ ngx_http_grpc_body_output_filter(void *data, ngx_chain_t *in)
 
         ctx->header_sent = 1;
 
-        if (ctx->id != 1) {
+        if (ctx->id != 1 || ctx->connection->shared) {
             /*
-             * keepalive connection: skip connection preface,
-             * update stream identifiers
+             * keepalive or multiplexed connection: skip connection
+             * preface, update stream identifiers
              */
 
             b = ctx->in->buf;
@@ -1912,7 +2119,12 @@ ngx_http_grpc_process_header(ngx_http_request_t *r)
                                "grpc header done");
 
                 if (ctx->end_stream) {
-                    u->headers_in.content_length_n = 0;
+
+                    /* responses to HEAD keep the length of the resource */
+
+                    if (r->method != NGX_HTTP_HEAD) {
+                        u->headers_in.content_length_n = 0;
+                    }
 
                     if (ctx->in == NULL
                         && ctx->out == NULL
@@ -2092,19 +2304,29 @@ ngx_http_grpc_filter(void *data, ssize_t bytes)
                     return NGX_ERROR;
                 }
 
-                if (ctx->rest > ctx->connection->recv_window) {
-                    ngx_log_error(NGX_LOG_ERR, r->connection->log, 0,
-                                  "upstream violated connection flow control, "
-                                  "received %uz data frame with window %uz",
-                                  ctx->rest, ctx->connection->recv_window);
-                    return NGX_ERROR;
+                /*
+                 * on multiplexed connections the connection window
+                 * is maintained by the session
+                 */
+
+                if (!ctx->connection->shared) {
+
+                    if (ctx->rest > ctx->connection->recv_window) {
+                        ngx_log_error(NGX_LOG_ERR, r->connection->log, 0,
+                                      "upstream violated connection flow "
+                                      "control, received %uz data frame "
+                                      "with window %uz",
+                                      ctx->rest, ctx->connection->recv_window);
+                        return NGX_ERROR;
+                    }
+
+                    ctx->connection->recv_window -= ctx->rest;
                 }
 
                 ctx->recv_window -= ctx->rest;
-                ctx->connection->recv_window -= ctx->rest;
 
                 if (ctx->connection->recv_window < NGX_HTTP_V2_MAX_WINDOW / 4
-                    || ctx->recv_window < NGX_HTTP_V2_MAX_WINDOW / 4)
+                    || ctx->recv_window < ctx->connection->stream_window / 4)
                 {
                     if (ngx_http_grpc_send_window_update(r, ctx) != NGX_OK) {
                         return NGX_ERROR;
@@ -4078,26 +4300,30 @@ ngx_http_grpc_send_window_update(ngx_http_request_t *r,
         return NGX_ERROR;
     }
 
-    f = (ngx_http_grpc_frame_t *) cl->buf->last;
-    cl->buf->last += sizeof(ngx_http_grpc_frame_t);
+    /* multiplexed connections are updated by the session */
 
-    f->length_0 = 0;
-    f->length_1 = 0;
-    f->length_2 = 4;
-    f->type = NGX_HTTP_V2_WINDOW_UPDATE_FRAME;
-    f->flags = 0;
-    f->stream_id_0 = 0;
-    f->stream_id_1 = 0;
-    f->stream_id_2 = 0;
-    f->stream_id_3 = 0;
+    if (!ctx->connection->shared) {
+        f = (ngx_http_grpc_frame_t *) cl->buf->last;
+        cl->buf->last += sizeof(ngx_http_grpc_frame_t);
 
-    n = NGX_HTTP_V2_MAX_WINDOW - ctx->connection->recv_window;
-    ctx->connection->recv_window = NGX_HTTP_V2_MAX_WINDOW;
+        f->length_0 = 0;
+        f->length_1 = 0;
+        f->length_2 = 4;
+        f->type = NGX_HTTP_V2_WINDOW_UPDATE_FRAME;
+        f->flags = 0;
+        f->stream_id_0 = 0;
+        f->stream_id_1 = 0;
+        f->stream_id_2 = 0;
+        f->stream_id_3 = 0;
 
-    *cl->buf->last++ = (u_char) ((n >> 24) & 0xff);
-    *cl->buf->last++ = (u_char) ((n >> 16) & 0xff);
-    *cl->buf->last++ = (u_char) ((n >> 8) & 0xff);
-    *cl->buf->last++ = (u_char) (n & 0xff);
+        n = NGX_HTTP_V2_MAX_WINDOW - ctx->connection->recv_window;
+        ctx->connection->recv_window = NGX_HTTP_V2_MAX_WINDOW;
+
+        *cl->buf->last++ = (u_char) ((n >> 24) & 0xff);
+        *cl->buf->last++ = (u_char) ((n >> 16) & 0xff);
+        *cl->buf->last++ = (u_char) ((n >> 8) & 0xff);
+        *cl->buf->last++ = (u_char) (n & 0xff);
+    }
 
     f = (ngx_http_grpc_frame_t *) cl->buf->last;
     cl->buf->last += sizeof(ngx_http_grpc_frame_t);
@@ -4112,8 +4338,8 @@ ngx_http_grpc_send_window_update(ngx_http_request_t *r,
     f->stream_id_2 = (u_char) ((ctx->id >> 8) & 0xff);
     f->stream_id_3 = (u_char) (ctx->id & 0xff);
 
-    n = NGX_HTTP_V2_MAX_WINDOW - ctx->recv_window;
-    ctx->recv_window = NGX_HTTP_V2_MAX_WINDOW;
+    n = ctx->connection->stream_window - ctx->recv_window;
+    ctx->recv_window = ctx->connection->stream_window;
 
     *cl->buf->last++ = (u_char) ((n >> 24) & 0xff);
     *cl->buf->last++ = (u_char) ((n >> 16) & 0xff);
@@ -4199,11 +4425,11 @@ ngx_http_grpc_get_connection_data(ngx_http_request_t *r,
 
     c = pc->connection;
 
-    if (pc->cached) {
+    if (pc->cached || c->shared) {
 
         /*
-         * for cached connections, connection data can be found
-         * in the cleanup handler
+         * for cached and multiplexed connections, connection data
+         * can be found in the cleanup handler
          */
 
         for (cln = c->pool->cleanup; cln; cln = cln->next) {
@@ -4221,7 +4447,7 @@ ngx_http_grpc_get_connection_data(ngx_http_request_t *r,
         }
 
         ctx->send_window = ctx->connection->init_window;
-        ctx->recv_window = NGX_HTTP_V2_MAX_WINDOW;
+        ctx->recv_window = ctx->connection->stream_window;
 
         ctx->connection->last_stream_id += 2;
         ctx->id = ctx->connection->last_stream_id;
@@ -4240,6 +4466,8 @@ ngx_http_grpc_get_connection_data(ngx_http_request_t *r,
     ctx->connection->init_window = NGX_HTTP_V2_DEFAULT_WINDOW;
     ctx->connection->send_window = NGX_HTTP_V2_DEFAULT_WINDOW;
     ctx->connection->recv_window = NGX_HTTP_V2_MAX_WINDOW;
+    ctx->connection->stream_window = NGX_HTTP_V2_MAX_WINDOW;
+    ctx->connection->shared = 0;
 
     ctx->send_window = NGX_HTTP_V2_DEFAULT_WINDOW;
     ctx->recv_window = NGX_HTTP_V2_MAX_WINDOW;
@@ -4313,98 +4541,1534 @@ ngx_http_grpc_internal_trailers_variable(ngx_http_request_t *r,
 
 
 static ngx_int_t
-ngx_http_grpc_add_variables(ngx_conf_t *cf)
+ngx_http_grpc_mux_init(ngx_conf_t *cf, ngx_http_upstream_srv_conf_t *us)
 {
-    ngx_http_variable_t  *var, *v;
+    ngx_http_grpc_mux_conf_t  *mcf;
 
-    for (v = ngx_http_grpc_vars; v->name.len; v++) {
-        var = ngx_http_add_variable(cf, &v->name, v->flags);
-        if (var == NULL) {
-            return NGX_ERROR;
-        }
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, cf->log, 0, "init http2 multiplex");
 
-        var->get_handler = v->get_handler;
-        var->data = v->data;
+    mcf = ngx_http_conf_upstream_srv_conf(us, ngx_http_grpc_module);
+
+    if (mcf->original_init_upstream(cf, us) != NGX_OK) {
+        return NGX_ERROR;
     }
 
+    mcf->original_init_peer = us->peer.init;
+
+    us->peer.init = ngx_http_grpc_mux_init_peer;
+
+    ngx_queue_init(&mcf->sessions);
+
     return NGX_OK;
 }
 
 
-static void *
-ngx_http_grpc_create_loc_conf(ngx_conf_t *cf)
+static ngx_int_t
+ngx_http_grpc_mux_init_peer(ngx_http_request_t *r,
+    ngx_http_upstream_srv_conf_t *us)
 {
-    ngx_http_grpc_loc_conf_t  *conf;
+    ngx_http_grpc_mux_conf_t       *mcf;
+    ngx_http_grpc_mux_peer_data_t  *mp;
 
-    conf = ngx_pcalloc(cf->pool, sizeof(ngx_http_grpc_loc_conf_t));
-    if (conf == NULL) {
-        return NULL;
-    }
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "init http2 multiplex peer");
 
-    /*
-     * set by ngx_pcalloc():
-     *
-     *     conf->upstream.ignore_headers = 0;
-     *     conf->upstream.next_upstream = 0;
-     *     conf->upstream.hide_headers_hash = { NULL, 0 };
-     *
-     *     conf->headers.lengths = NULL;
-     *     conf->headers.values = NULL;
-     *     conf->headers.hash = { NULL, 0 };
-     *     conf->host = { 0, NULL };
-     *     conf->host_set = 0;
-     *     conf->ssl = 0;
-     *     conf->ssl_protocols = 0;
-     *     conf->ssl_ciphers = { 0, NULL };
-     *     conf->ssl_trusted_certificate = { 0, NULL };
-     *     conf->ssl_crl = { 0, NULL };
-     */
+    mcf = ngx_http_conf_upstream_srv_conf(us, ngx_http_grpc_module);
 
-    conf->upstream.local = NGX_CONF_UNSET_PTR;
-    conf->upstream.socket_keepalive = NGX_CONF_UNSET;
-    conf->upstream.next_upstream_tries = NGX_CONF_UNSET_UINT;
-    conf->upstream.connect_timeout = NGX_CONF_UNSET_MSEC;
-    conf->upstream.send_timeout = NGX_CONF_UNSET_MSEC;
-    conf->upstream.read_timeout = NGX_CONF_UNSET_MSEC;
-    conf->upstream.next_upstream_timeout = NGX_CONF_UNSET_MSEC;
+    mp = ngx_palloc(r->pool, sizeof(ngx_http_grpc_mux_peer_data_t));
+    if (mp == NULL) {
+        return NGX_ERROR;
+    }
 
-    conf->upstream.buffer_size = NGX_CONF_UNSET_SIZE;
+    if (mcf->original_init_peer(r, us) != NGX_OK) {
+        return NGX_ERROR;
+    }
 
-    conf->upstream.hide_headers = NGX_CONF_UNSET_PTR;
-    conf->upstream.pass_headers = NGX_CONF_UNSET_PTR;
+    mp->conf = mcf;
+    mp->request = r;
+    mp->stream = NULL;
+    mp->data = r->upstream->peer.data;
+    mp->original_get_peer = r->upstream->peer.get;
+    mp->original_free_peer = r->upstream->peer.free;
 
-    conf->upstream.intercept_errors = NGX_CONF_UNSET;
+    r->upstream->peer.data = mp;
+    r->upstream->peer.get = ngx_http_grpc_mux_get_peer;
+    r->upstream->peer.free = ngx_http_grpc_mux_free_peer;
 
 #if (NGX_HTTP_SSL)
-    conf->upstream.ssl_session_reuse = NGX_CONF_UNSET;
-    conf->upstream.ssl_name = NGX_CONF_UNSET_PTR;
-    conf->upstream.ssl_server_name = NGX_CONF_UNSET;
-    conf->upstream.ssl_verify = NGX_CONF_UNSET;
-    conf->ssl_verify_depth = NGX_CONF_UNSET_UINT;
-    conf->upstream.ssl_certificate = NGX_CONF_UNSET_PTR;
-    conf->upstream.ssl_certificate_key = NGX_CONF_UNSET_PTR;
-    conf->upstream.ssl_passwords = NGX_CONF_UNSET_PTR;
-    conf->ssl_conf_commands = NGX_CONF_UNSET_PTR;
+    mp->original_set_session = r->upstream->peer.set_session;
+    mp->original_save_session = r->upstream->peer.save_session;
+    r->upstream->peer.set_session = ngx_http_grpc_mux_set_session;
+    r->upstream->peer.save_session = ngx_http_grpc_mux_save_session;
 #endif
 
-    /* the hardcoded values */
-    conf->upstream.cyclic_temp_file = 0;
-    conf->upstream.buffering = 0;
-    conf->upstream.ignore_client_abort = 0;
-    conf->upstream.send_lowat = 0;
-    conf->upstream.bufs.num = 0;
-    conf->upstream.busy_buffers_size = 0;
-    conf->upstream.max_temp_file_size = 0;
-    conf->upstream.temp_file_write_size = 0;
-    conf->upstream.pass_request_headers = 1;
-    conf->upstream.pass_request_body = 1;
-    conf->upstream.force_ranges = 0;
-    conf->upstream.pass_trailers = 1;
-    conf->upstream.preserve_output = 1;
+    return NGX_OK;
+}
 
-    conf->headers_source = NGX_CONF_UNSET_PTR;
 
-    ngx_str_set(&conf->upstream.module, "grpc");
+static ngx_int_t
+ngx_http_grpc_mux_get_peer(ngx_peer_connection_t *pc, void *data)
+{
+    ngx_http_grpc_mux_peer_data_t  *mp = data;
+
+    ngx_int_t                 rc;
+    ngx_http_request_t       *r;
+    ngx_http_upstream_t      *u;
+    ngx_http_grpc_stream_t   *st;
+    ngx_http_grpc_session_t  *s;
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                   "get http2 multiplex peer");
+
+    /* ask balancer */
+
+    rc = mp->original_get_peer(pc, mp->data);
+
+    if (rc != NGX_OK) {
+        return rc;
+    }
+
+    r = mp->request;
+    u = r->upstream;
+
+    /*
+     * only plain text HTTP/2 requests are multiplexed; stream connections
+     * are never added to the event method, which is only safe with
+     * edge-triggered notifications
+     */
+
+    if (u->ssl
+        || !(ngx_event_flags & NGX_USE_CLEAR_EVENT)
+        || ngx_http_get_module_ctx(r, ngx_http_grpc_module) == NULL)
+    {
+        return NGX_OK;
+    }
+
+    /* all sessions are busy: fall back to a dedicated connection */
+
+    s = ngx_http_grpc_mux_session(mp->conf, pc, u);
+    if (s == NULL) {
+        return NGX_OK;
+    }
+
+    st = ngx_http_grpc_mux_create_stream(s, r);
+    if (st == NULL) {
+        return NGX_ERROR;
+    }
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                   "get http2 multiplex peer: using session %p, streams: %ui",
+                   s, s->nstreams);
+
+    mp->stream = st;
+
+    /*
+     * failures on a session which already got data from the upstream
+     * are retried like the ones on cached keepalive connections
+     */
+
+    pc->connection = &st->connection;
+    pc->cached = s->confirmed;
+
+    return NGX_DONE;
+}
+
+
+static void
+ngx_http_grpc_mux_free_peer(ngx_peer_connection_t *pc, void *data,
+    ngx_uint_t state)
+{
+    ngx_http_grpc_mux_peer_data_t  *mp = data;
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                   "free http2 multiplex peer");
+
+    if (mp->stream) {
+        ngx_http_grpc_mux_close_stream(mp->stream);
+
+        mp->stream = NULL;
+        pc->connection = NULL;
+    }
+
+    mp->original_free_peer(pc, mp->data, state);
+}
+
+
+#if (NGX_HTTP_SSL)
+
+static ngx_int_t
+ngx_http_grpc_mux_set_session(ngx_peer_connection_t *pc, void *data)
+{
+    ngx_http_grpc_mux_peer_data_t  *mp = data;
+
+    return mp->original_set_session(pc, mp->data);
+}
+
+
+static void
+ngx_http_grpc_mux_save_session(ngx_peer_connection_t *pc, void *data)
+{
+    ngx_http_grpc_mux_peer_data_t  *mp = data;
+
+    mp->original_save_session(pc, mp->data);
+}
+
+#endif
+
+
+static ngx_http_grpc_session_t *
+ngx_http_grpc_mux_session(ngx_http_grpc_mux_conf_t *mcf,
+    ngx_peer_connection_t *pc, ngx_http_upstream_t *u)
+{
+    ngx_int_t                 rc;
+    ngx_uint_t                n;
+    ngx_pool_t               *pool;
+    ngx_queue_t              *q;
+    ngx_connection_t         *c;
+    ngx_peer_connection_t     peer;
+    ngx_http_grpc_session_t  *s, *best;
+
+    n = 0;
+    best = NULL;
+
+    for (q = ngx_queue_head(&mcf->sessions);
+         q != ngx_queue_sentinel(&mcf->sessions);
+         q = ngx_queue_next(q))
+    {
+        s = ngx_queue_data(q, ngx_http_grpc_session_t, queue);
+
+        if (ngx_memn2cmp((u_char *) &s->sockaddr, (u_char *) pc->sockaddr,
+                         s->socklen, pc->socklen)
+            != 0)
+        {
+            continue;
+        }
+
+        n++;
+
+        if (s->nstreams >= s->max_streams) {
+            continue;
+        }
+
+        if (best == NULL || s->nstreams < best->nstreams) {
+            best = s;
+        }
+    }
+
+    if (best) {
+        return best;
+    }
+
+    if (n >= mcf->connections || pc->socklen > sizeof(ngx_sockaddr_t)) {
+        return NULL;
+    }
+
+    pool = ngx_create_pool(1024, ngx_cycle->log);
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    s = ngx_pcalloc(pool, sizeof(ngx_http_grpc_session_t));
+    if (s == NULL) {
+        goto failed;
+    }
+
+    s->conf = mcf;
+    s->pool = pool;
+
+    ngx_memcpy(&s->sockaddr, pc->sockaddr, pc->socklen);
+    s->socklen = pc->socklen;
+
+    s->name.data = ngx_pstrdup(pool, pc->name);
+    if (s->name.data == NULL) {
+        goto failed;
+    }
+
+    s->name.len = pc->name->len;
+
+    s->buffer = ngx_create_temp_buf(pool, NGX_HTTP_GRPC_MUX_BUFFER);
+    if (s->buffer == NULL) {
+        goto failed;
+    }
+
+    ngx_queue_init(&s->streams);
+
+    s->max_streams = mcf->streams;
+
+    s->conn.init_window = NGX_HTTP_V2_DEFAULT_WINDOW;
+    s->conn.send_window = NGX_HTTP_V2_DEFAULT_WINDOW;
+    s->conn.recv_window = NGX_HTTP_V2_MAX_WINDOW;
+    s->conn.stream_window = NGX_HTTP_GRPC_MUX_WINDOW;
+    s->conn.last_stream_id = (ngx_uint_t) -1;
+    s->conn.shared = 1;
+
+    if (ngx_http_grpc_mux_queue(s, &s->out, ngx_http_grpc_mux_start,
+                                sizeof(ngx_http_grpc_mux_start) - 1)
+        != NGX_OK)
+    {
+        goto failed;
+    }
+
+    s->buffered = sizeof(ngx_http_grpc_mux_start) - 1;
+
+    ngx_memzero(&peer, sizeof(ngx_peer_connection_t));
+
+    peer.sockaddr = &s->sockaddr.sockaddr;
+    peer.socklen = s->socklen;
+    peer.name = &s->name;
+    peer.get = ngx_event_get_peer;
+    peer.local = pc->local;
+    peer.so_keepalive = pc->so_keepalive;
+    peer.log = ngx_cycle->log;
+    peer.log_error = NGX_ERROR_ERR;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                   "http2 multiplex connect to %V", &s->name);
+
+    rc = ngx_event_connect_peer(&peer);
+
+    if (rc == NGX_ERROR || rc == NGX_BUSY || rc == NGX_DECLINED) {
+        if (peer.connection) {
+            ngx_close_connection(peer.connection);
+        }
+
+        goto failed;
+    }
+
+    c = peer.connection;
+
+    c->pool = pool;
+    c->data = s;
+    c->read->handler = ngx_http_grpc_mux_read_handler;
+    c->write->handler = ngx_http_grpc_mux_write_handler;
+
+    s->connection = c;
+
+    ngx_queue_insert_tail(&mcf->sessions, &s->queue);
+
+    if (rc == NGX_AGAIN) {
+        ngx_add_timer(c->write, u->conf->connect_timeout);
+        return s;
+    }
+
+    s->connected = 1;
+
+    ngx_post_event(c->write, &ngx_posted_events);
+
+    return s;
+
+failed:
+
+    ngx_destroy_pool(pool);
+
+    return NULL;
+}
+
+
+static ngx_http_grpc_stream_t *
+ngx_http_grpc_mux_create_stream(ngx_http_grpc_session_t *s,
+    ngx_http_request_t *r)
+{
+    ngx_pool_t              *pool;
+    ngx_connection_t        *c, *fc;
+    ngx_pool_cleanup_t      *cln;
+    ngx_http_grpc_stream_t  *st;
+
+    pool = ngx_create_pool(512, r->connection->log);
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    st = ngx_pcalloc(pool, sizeof(ngx_http_grpc_stream_t));
+    if (st == NULL) {
+        ngx_destroy_pool(pool);
+        return NULL;
+    }
+
+    /* connection data, see ngx_http_grpc_get_connection_data() */
+
+    cln = ngx_pool_cleanup_add(pool, 0);
+    if (cln == NULL) {
+        ngx_destroy_pool(pool);
+        return NULL;
+    }
+
+    cln->handler = ngx_http_grpc_cleanup;
+    cln->data = &s->conn;
+
+    c = s->connection;
+    fc = &st->connection;
+
+    fc->fd = c->fd;
+    fc->read = &st->read;
+    fc->write = &st->write;
+    fc->pool = pool;
+    fc->log = r->connection->log;
+
+    fc->recv = ngx_http_grpc_mux_recv;
+    fc->send = ngx_http_grpc_mux_send;
+    fc->send_chain = ngx_http_grpc_mux_send_chain;
+
+    fc->sockaddr = c->sockaddr;
+    fc->socklen = c->socklen;
+
+    fc->number = ngx_atomic_fetch_add(ngx_connection_counter, 1);
+    fc->start_time = ngx_current_msec;
+
+    fc->shared = 1;
+    fc->tcp_nopush = NGX_TCP_NOPUSH_DISABLED;
+    fc->tcp_nodelay = NGX_TCP_NODELAY_DISABLED;
+
+    st->read.data = fc;
+    st->read.log = fc->log;
+    st->read.active = 1;
+    st->read.index = NGX_INVALID_INDEX;
+
+    st->write.data = fc;
+    st->write.log = fc->log;
+    st->write.write = 1;
+    st->write.active = 1;
+    st->write.ready = 1;
+    st->write.index = NGX_INVALID_INDEX;
+
+    st->session = s;
+    st->request = r;
+
+    ngx_queue_insert_tail(&s->streams, &st->queue);
+    s->nstreams++;
+
+    c->idle = 0;
+    c->requests++;
+
+    if (c->read->timer_set) {
+        ngx_del_timer(c->read);
+    }
+
+    if (c->requests >= NGX_HTTP_GRPC_MUX_MAX_STREAM / 2) {
+
+        /* stream identifiers are exhausted */
+
+        ngx_queue_remove(&s->queue);
+        s->draining = 1;
+    }
+
+    return st;
+}
+
+
+static void
+ngx_http_grpc_mux_close_stream(ngx_http_grpc_stream_t *st)
+{
+    u_char                    rst[4];
+    ngx_chain_t              *cl;
+    ngx_http_request_t       *r;
+    ngx_http_grpc_ctx_t      *ctx;
+    ngx_http_grpc_session_t  *s;
+
+    s = st->session;
+    r = st->request;
+
+    ctx = ngx_http_get_module_ctx(r, ngx_http_grpc_module);
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "http2 multiplex close stream %ui, streams: %ui",
+                   st->started ? ctx->id : 0, s->nstreams);
+
+    if (st->started
+        && !st->error
+        && !s->closed
+        && !ctx->rst
+        && !r->upstream->keepalive)
+    {
+        /* RST_STREAM with CANCEL */
+
+        rst[0] = 0;
+        rst[1] = 0;
+        rst[2] = 0;
+        rst[3] = 0x08;
+
+        if (ngx_http_grpc_mux_frame(s, NGX_HTTP_V2_RST_STREAM_FRAME, 0,
+                                    ctx->id, rst, 4)
+            != NGX_OK)
+        {
+            ngx_http_grpc_mux_close(s, 1);
+        }
+    }
+
+    if (st->in) {
+        for (cl = st->in; cl->next; cl = cl->next) { /* void */ }
+
+        cl->next = s->free;
+        s->free = st->in;
+    }
+
+    if (s->stream == st) {
+        s->stream = NULL;
+    }
+
+    if (st->read.timer_set) {
+        ngx_del_timer(&st->read);
+    }
+
+    if (st->write.timer_set) {
+        ngx_del_timer(&st->write);
+    }
+
+    if (st->read.posted) {
+        ngx_delete_posted_event(&st->read);
+    }
+
+    if (st->write.posted) {
+        ngx_delete_posted_event(&st->write);
+    }
+
+    ngx_queue_remove(&st->queue);
+    s->nstreams--;
+
+    ngx_destroy_pool(st->connection.pool);
+
+    if (s->nstreams) {
+        return;
+    }
+
+    if (s->closed) {
+        ngx_destroy_pool(s->pool);
+        return;
+    }
+
+    if (s->draining || ngx_exiting || ngx_terminate) {
+        ngx_http_grpc_mux_close(s, 0);
+        return;
+    }
+
+    s->connection->idle = 1;
+
+    ngx_add_timer(s->connection->read, s->conf->timeout);
+}
+
+
+static void
+ngx_http_grpc_mux_read_handler(ngx_event_t *rev)
+{
+    ssize_t                   n;
+    ngx_buf_t                *b;
+    ngx_connection_t         *c;
+    ngx_http_grpc_session_t  *s;
+
+    c = rev->data;
+    s = c->data;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "http2 multiplex read handler, streams: %ui", s->nstreams);
+
+    if (c->close || rev->timedout) {
+        ngx_http_grpc_mux_close(s, 0);
+        return;
+    }
+
+    b = s->buffer;
+
+    for ( ;; ) {
+
+        n = c->recv(c, b->last, b->end - b->last);
+
+        if (n == NGX_AGAIN) {
+            break;
+        }
+
+        if (n == 0 || n == NGX_ERROR) {
+
+            if (n == 0 && s->nstreams) {
+                ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                              "upstream prematurely closed multiplexed "
+                              "connection to %V", &s->name);
+            }
+
+            ngx_http_grpc_mux_close(s, 0);
+            return;
+        }
+
+        b->last += n;
+        s->confirmed = 1;
+
+        if (ngx_http_grpc_mux_parse(s) != NGX_OK) {
+            ngx_http_grpc_mux_close(s, 1);
+            return;
+        }
+    }
+
+    if (s->draining && s->nstreams == 0) {
+        ngx_http_grpc_mux_close(s, 0);
+        return;
+    }
+
+    if (ngx_handle_read_event(rev, 0) != NGX_OK) {
+        ngx_http_grpc_mux_close(s, 1);
+        return;
+    }
+
+    ngx_http_grpc_mux_flush(s);
+}
+
+
+static void
+ngx_http_grpc_mux_write_handler(ngx_event_t *wev)
+{
+    ngx_connection_t         *c;
+    ngx_http_grpc_session_t  *s;
+
+    c = wev->data;
+    s = c->data;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "http2 multiplex write handler, buffered: %uz",
+                   s->buffered);
+
+    if (wev->timedout) {
+        ngx_log_error(NGX_LOG_ERR, c->log, NGX_ETIMEDOUT,
+                      "upstream timed out while connecting to %V", &s->name);
+
+        ngx_http_grpc_mux_close(s, 1);
+        return;
+    }
+
+    if (!s->connected) {
+
+        if (!wev->ready) {
+            return;
+        }
+
+        if (wev->timer_set) {
+            ngx_del_timer(wev);
+        }
+
+        if (ngx_http_upstream_test_connect(c) != NGX_OK) {
+            ngx_http_grpc_mux_close(s, 1);
+            return;
+        }
+
+        s->connected = 1;
+    }
+
+    ngx_http_grpc_mux_flush(s);
+}
+
+
+static ngx_int_t
+ngx_http_grpc_mux_parse(ngx_http_grpc_session_t *s)
+{
+    u_char                  *p, window[4];
+    size_t                   size, length;
+    ngx_buf_t               *b;
+    ngx_uint_t               sid;
+    ngx_http_grpc_stream_t  *st;
+
+    b = s->buffer;
+
+    for ( ;; ) {
+
+        if (s->payload) {
+
+            /* frame payload, possibly split between reads */
+
+            size = ngx_min((size_t) (b->last - b->pos), s->rest);
+
+            if (s->stream && size) {
+                if (ngx_http_grpc_mux_queue(s, &s->stream->in, b->pos, size)
+                    != NGX_OK)
+                {
+                    return NGX_ERROR;
+                }
+
+                ngx_http_grpc_mux_notify(s->stream);
+            }
+
+            b->pos += size;
+            s->rest -= size;
+
+            if (s->rest) {
+                break;
+            }
+
+            s->payload = 0;
+            continue;
+        }
+
+        if (b->last - b->pos < NGX_HTTP_V2_FRAME_HEADER_SIZE) {
+            break;
+        }
+
+        p = b->pos;
+
+        length = (p[0] << 16) | (p[1] << 8) | p[2];
+        sid = ngx_http_v2_parse_sid(&p[5]);
+
+        ngx_log_debug3(NGX_LOG_DEBUG_HTTP, s->connection->log, 0,
+                       "http2 multiplex frame type:%ui l:%uz sid:%ui",
+                       (ngx_uint_t) p[3], length, sid);
+
+        if (length > NGX_HTTP_V2_DEFAULT_FRAME_SIZE) {
+            ngx_log_error(NGX_LOG_ERR, s->connection->log, 0,
+                          "upstream sent too large http2 frame: %uz", length);
+            return NGX_ERROR;
+        }
+
+        if (sid == 0) {
+
+            /* control frames are processed as a whole */
+
+            if ((size_t) (b->last - b->pos)
+                < NGX_HTTP_V2_FRAME_HEADER_SIZE + length)
+            {
+                break;
+            }
+
+            if (ngx_http_grpc_mux_control(s, p) != NGX_OK) {
+                return NGX_ERROR;
+            }
+
+            b->pos += NGX_HTTP_V2_FRAME_HEADER_SIZE + length;
+            continue;
+        }
+
+        if (p[3] == NGX_HTTP_V2_DATA_FRAME) {
+
+            /*
+             * the connection window is released as soon as data
+             * are received, streams are limited by their own windows
+             */
+
+            if (length > s->conn.recv_window) {
+                ngx_log_error(NGX_LOG_ERR, s->connection->log, 0,
+                              "upstream violated connection flow control, "
+                              "received %uz data frame with window %uz",
+                              length, s->conn.recv_window);
+                return NGX_ERROR;
+            }
+
+            s->conn.recv_window -= length;
+
+            if (s->conn.recv_window < NGX_HTTP_V2_MAX_WINDOW / 4) {
+                size = NGX_HTTP_V2_MAX_WINDOW - s->conn.recv_window;
+                s->conn.recv_window = NGX_HTTP_V2_MAX_WINDOW;
+
+                window[0] = (u_char) ((size >> 24) & 0xff);
+                window[1] = (u_char) ((size >> 16) & 0xff);
+                window[2] = (u_char) ((size >> 8) & 0xff);
+                window[3] = (u_char) (size & 0xff);
+
+                if (ngx_http_grpc_mux_frame(s, NGX_HTTP_V2_WINDOW_UPDATE_FRAME,
+                                            0, 0, window, 4)
+                    != NGX_OK)
+                {
+                    return NGX_ERROR;
+                }
+            }
+        }
+
+        /* frames of streams already closed are skipped */
+
+        st = ngx_http_grpc_mux_find_stream(s, sid);
+
+        if (st) {
+            if (ngx_http_grpc_mux_queue(s, &st->in, p,
+                                        NGX_HTTP_V2_FRAME_HEADER_SIZE)
+                != NGX_OK)
+            {
+                return NGX_ERROR;
+            }
+
+            ngx_http_grpc_mux_notify(st);
+        }
+
+        b->pos += NGX_HTTP_V2_FRAME_HEADER_SIZE;
+
+        s->stream = st;
+        s->rest = length;
+        s->payload = 1;
+    }
+
+    if (b->pos == b->last) {
+        b->pos = b->start;
+        b->last = b->start;
+
+    } else if (b->pos != b->start) {
+        size = b->last - b->pos;
+        ngx_memmove(b->start, b->pos, size);
+
+        b->pos = b->start;
+        b->last = b->start + size;
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_grpc_mux_control(ngx_http_grpc_session_t *s, u_char *p)
+{
+    u_char                  *end;
+    size_t                   length, window;
+    ssize_t                  delta;
+    ngx_uint_t               type, flags, id, value, last;
+    ngx_queue_t             *q;
+    ngx_connection_t        *c;
+    ngx_http_grpc_ctx_t     *ctx;
+    ngx_http_grpc_stream_t  *st;
+
+    c = s->connection;
+
+    length = (p[0] << 16) | (p[1] << 8) | p[2];
+    type = p[3];
+    flags = p[4];
+
+    p += NGX_HTTP_V2_FRAME_HEADER_SIZE;
+    end = p + length;
+
+    switch (type) {
+
+    case NGX_HTTP_V2_SETTINGS_FRAME:
+
+        if (flags & NGX_HTTP_V2_ACK_FLAG) {
+            return NGX_OK;
+        }
+
+        if (length % 6) {
+            ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                          "upstream sent settings frame "
+                          "with invalid length: %uz", length);
+            return NGX_ERROR;
+        }
+
+        for ( /* void */ ; p < end; p += 6) {
+
+            id = (p[0] << 8) | p[1];
+            value = ngx_http_v2_parse_uint32(&p[2]);
+
+            ngx_log_debug2(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                           "http2 multiplex setting %ui:%ui", id, value);
+
+            if (id == 0x03) {
+                /* SETTINGS_MAX_CONCURRENT_STREAMS */
+
+                s->max_streams = ngx_min(value, s->conf->streams);
+                continue;
+            }
+
+            if (id != 0x04) {
+                continue;
+            }
+
+            /* SETTINGS_INITIAL_WINDOW_SIZE */
+
+            if (value > NGX_HTTP_V2_MAX_WINDOW) {
+                ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                              "upstream sent settings frame "
+                              "with too large initial window size: %ui",
+                              value);
+                return NGX_ERROR;
+            }
+
+            delta = value - s->conn.init_window;
+            s->conn.init_window = value;
+
+            for (q = ngx_queue_head(&s->streams);
+                 q != ngx_queue_sentinel(&s->streams);
+                 q = ngx_queue_next(q))
+            {
+                st = ngx_queue_data(q, ngx_http_grpc_stream_t, queue);
+
+                if (st->started) {
+                    ctx = ngx_http_get_module_ctx(st->request,
+                                                  ngx_http_grpc_module);
+                    ctx->send_window += delta;
+                }
+            }
+        }
+
+        if (ngx_http_grpc_mux_frame(s, NGX_HTTP_V2_SETTINGS_FRAME,
+                                    NGX_HTTP_V2_ACK_FLAG, 0, NULL, 0)
+            != NGX_OK)
+        {
+            return NGX_ERROR;
+        }
+
+        ngx_http_grpc_mux_wake(s, 1);
+
+        return NGX_OK;
+
+    case NGX_HTTP_V2_PING_FRAME:
+
+        if (length != 8) {
+            ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                          "upstream sent ping frame "
+                          "with invalid length: %uz", length);
+            return NGX_ERROR;
+        }
+
+        if (flags & NGX_HTTP_V2_ACK_FLAG) {
+            return NGX_OK;
+        }
+
+        return ngx_http_grpc_mux_frame(s, NGX_HTTP_V2_PING_FRAME,
+                                       NGX_HTTP_V2_ACK_FLAG, 0, p, 8);
+
+    case NGX_HTTP_V2_WINDOW_UPDATE_FRAME:
+
+        if (length != 4) {
+            ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                          "upstream sent window update frame "
+                          "with invalid length: %uz", length);
+            return NGX_ERROR;
+        }
+
+        window = ngx_http_v2_parse_window(p);
+
+        if (window == 0
+            || window > NGX_HTTP_V2_MAX_WINDOW - s->conn.send_window)
+        {
+            ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                          "upstream sent invalid window update: %uz",
+                          window);
+            return NGX_ERROR;
+        }
+
+        s->conn.send_window += window;
+
+        ngx_http_grpc_mux_wake(s, 1);
+
+        return NGX_OK;
+
+    case NGX_HTTP_V2_GOAWAY_FRAME:
+
+        if (length < 8) {
+            ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                          "upstream sent goaway frame "
+                          "with invalid length: %uz", length);
+            return NGX_ERROR;
+        }
+
+        last = ngx_http_v2_parse_sid(p);
+
+        ngx_log_debug2(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                       "http2 multiplex goaway, last stream: %ui, error: %ui",
+                       last, (ngx_uint_t) ngx_http_v2_parse_uint32(&p[4]));
+
+        if (!s->draining) {
+            ngx_queue_remove(&s->queue);
+            s->draining = 1;
+        }
+
+        /* streams not processed by the upstream can be retried */
+
+        for (q = ngx_queue_head(&s->streams);
+             q != ngx_queue_sentinel(&s->streams);
+             q = ngx_queue_next(q))
+        {
+            st = ngx_queue_data(q, ngx_http_grpc_stream_t, queue);
+            ctx = ngx_http_get_module_ctx(st->request, ngx_http_grpc_module);
+
+            if (st->started && ctx->id > last) {
+                st->error = 1;
+                ngx_http_grpc_mux_notify(st);
+            }
+        }
+
+        return NGX_OK;
+
+    case NGX_HTTP_V2_DATA_FRAME:
+    case NGX_HTTP_V2_HEADERS_FRAME:
+    case NGX_HTTP_V2_PRIORITY_FRAME:
+    case NGX_HTTP_V2_RST_STREAM_FRAME:
+    case NGX_HTTP_V2_PUSH_PROMISE_FRAME:
+    case NGX_HTTP_V2_CONTINUATION_FRAME:
+
+        ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                      "upstream sent frame of type %ui for stream 0", type);
+        return NGX_ERROR;
+
+    default:
+
+        /* unknown frame types are ignored */
+
+        return NGX_OK;
+    }
+}
+
+
+static ngx_http_grpc_stream_t *
+ngx_http_grpc_mux_find_stream(ngx_http_grpc_session_t *s, ngx_uint_t id)
+{
+    ngx_queue_t             *q;
+    ngx_http_grpc_ctx_t     *ctx;
+    ngx_http_grpc_stream_t  *st;
+
+    for (q = ngx_queue_head(&s->streams);
+         q != ngx_queue_sentinel(&s->streams);
+         q = ngx_queue_next(q))
+    {
+        st = ngx_queue_data(q, ngx_http_grpc_stream_t, queue);
+
+        if (!st->started) {
+            continue;
+        }
+
+        ctx = ngx_http_get_module_ctx(st->request, ngx_http_grpc_module);
+
+        if (ctx->id == id) {
+            return st;
+        }
+    }
+
+    return NULL;
+}
+
+
+static ngx_chain_t *
+ngx_http_grpc_mux_get_buf(ngx_http_grpc_session_t *s, ngx_chain_t **chain)
+{
+    ngx_buf_t    *b;
+    ngx_chain_t  *cl, **ll;
+
+    cl = NULL;
+
+    for (ll = chain; *ll; ll = &(*ll)->next) {
+        cl = *ll;
+    }
+
+    if (cl && cl->buf->last < cl->buf->end) {
+        return cl;
+    }
+
+    cl = s->free;
+
+    if (cl) {
+        s->free = cl->next;
+
+        b = cl->buf;
+        b->pos = b->start;
+        b->last = b->start;
+
+    } else {
+        cl = ngx_alloc_chain_link(s->pool);
+        if (cl == NULL) {
+            return NULL;
+        }
+
+        cl->buf = ngx_create_temp_buf(s->pool, NGX_HTTP_GRPC_MUX_CHUNK);
+        if (cl->buf == NULL) {
+            return NULL;
+        }
+    }
+
+    cl->next = NULL;
+    *ll = cl;
+
+    return cl;
+}
+
+
+static ngx_int_t
+ngx_http_grpc_mux_queue(ngx_http_grpc_session_t *s, ngx_chain_t **chain,
+    u_char *data, size_t size)
+{
+    size_t        n;
+    ngx_buf_t    *b;
+    ngx_chain_t  *cl;
+
+    while (size) {
+        cl = ngx_http_grpc_mux_get_buf(s, chain);
+        if (cl == NULL) {
+            return NGX_ERROR;
+        }
+
+        b = cl->buf;
+
+        n = ngx_min(size, (size_t) (b->end - b->last));
+
+        b->last = ngx_cpymem(b->last, data, n);
+
+        data += n;
+        size -= n;
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_grpc_mux_frame(ngx_http_grpc_session_t *s, ngx_uint_t type,
+    ngx_uint_t flags, ngx_uint_t sid, u_char *data, size_t size)
+{
+    ngx_http_grpc_frame_t  f;
+
+    ngx_log_debug3(NGX_LOG_DEBUG_HTTP, s->connection->log, 0,
+                   "http2 multiplex send frame type:%ui l:%uz sid:%ui",
+                   type, size, sid);
+
+    f.length_0 = (u_char) ((size >> 16) & 0xff);
+    f.length_1 = (u_char) ((size >> 8) & 0xff);
+    f.length_2 = (u_char) (size & 0xff);
+    f.type = (u_char) type;
+    f.flags = (u_char) flags;
+    f.stream_id_0 = (u_char) ((sid >> 24) & 0xff);
+    f.stream_id_1 = (u_char) ((sid >> 16) & 0xff);
+    f.stream_id_2 = (u_char) ((sid >> 8) & 0xff);
+    f.stream_id_3 = (u_char) (sid & 0xff);
+
+    if (ngx_http_grpc_mux_queue(s, &s->out, (u_char *) &f, sizeof(f))
+        != NGX_OK)
+    {
+        return NGX_ERROR;
+    }
+
+    if (ngx_http_grpc_mux_queue(s, &s->out, data, size) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    s->buffered += sizeof(ngx_http_grpc_frame_t) + size;
+
+    ngx_post_event(s->connection->write, &ngx_posted_events);
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_http_grpc_mux_flush(ngx_http_grpc_session_t *s)
+{
+    ngx_chain_t       *cl, *ln;
+    ngx_connection_t  *c;
+
+    if (!s->connected || s->out == NULL) {
+        return;
+    }
+
+    c = s->connection;
+
+    cl = c->send_chain(c, s->out, 0);
+
+    if (cl == NGX_CHAIN_ERROR) {
+        ngx_http_grpc_mux_close(s, 1);
+        return;
+    }
+
+    while (s->out != cl) {
+        ln = s->out;
+        s->out = ln->next;
+
+        ln->next = s->free;
+        s->free = ln;
+    }
+
+    s->buffered = 0;
+
+    for (cl = s->out; cl; cl = cl->next) {
+        s->buffered += cl->buf->last - cl->buf->pos;
+    }
+
+    if (s->out && ngx_handle_write_event(c->write, 0) != NGX_OK) {
+        ngx_http_grpc_mux_close(s, 1);
+        return;
+    }
+
+    if (s->buffered < NGX_HTTP_GRPC_MUX_BUFFERED) {
+        ngx_http_grpc_mux_wake(s, 0);
+    }
+}
+
+
+static void
+ngx_http_grpc_mux_notify(ngx_http_grpc_stream_t *st)
+{
+    st->read.ready = 1;
+    ngx_post_event(&st->read, &ngx_posted_events);
+}
+
+
+static void
+ngx_http_grpc_mux_wake(ngx_http_grpc_session_t *s, ngx_uint_t all)
+{
+    ngx_queue_t             *q;
+    ngx_http_grpc_stream_t  *st;
+
+    for (q = ngx_queue_head(&s->streams);
+         q != ngx_queue_sentinel(&s->streams);
+         q = ngx_queue_next(q))
+    {
+        st = ngx_queue_data(q, ngx_http_grpc_stream_t, queue);
+
+        if (!all && !st->blocked) {
+            continue;
+        }
+
+        st->blocked = 0;
+        st->write.ready = 1;
+
+        ngx_post_event(&st->write, &ngx_posted_events);
+    }
+}
+
+
+static void
+ngx_http_grpc_mux_close(ngx_http_grpc_session_t *s, ngx_uint_t error)
+{
+    ngx_queue_t             *q;
+    ngx_http_grpc_stream_t  *st;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, s->connection->log, 0,
+                   "close http2 multiplex session %V, streams: %ui",
+                   &s->name, s->nstreams);
+
+    if (!s->draining) {
+        ngx_queue_remove(&s->queue);
+        s->draining = 1;
+    }
+
+    s->closed = 1;
+
+    ngx_close_connection(s->connection);
+    s->connection = NULL;
+
+    /* streams see either an error or a premature end of data */
+
+    for (q = ngx_queue_head(&s->streams);
+         q != ngx_queue_sentinel(&s->streams);
+         q = ngx_queue_next(q))
+    {
+        st = ngx_queue_data(q, ngx_http_grpc_stream_t, queue);
+
+        st->connection.fd = (ngx_socket_t) -1;
+
+        if (error) {
+            st->error = 1;
+        }
+
+        ngx_http_grpc_mux_notify(st);
+
+        st->write.ready = 1;
+        ngx_post_event(&st->write, &ngx_posted_events);
+    }
+
+    if (s->nstreams == 0) {
+        ngx_destroy_pool(s->pool);
+    }
+}
+
+
+static ssize_t
+ngx_http_grpc_mux_recv(ngx_connection_t *c, u_char *buf, size_t size)
+{
+    ngx_http_grpc_stream_t  *st = (ngx_http_grpc_stream_t *) c;
+
+    size_t                    n, len;
+    ngx_buf_t                *b;
+    ngx_chain_t              *cl;
+    ngx_http_grpc_session_t  *s;
+
+    s = st->session;
+
+    if (st->error) {
+        c->read->error = 1;
+        return NGX_ERROR;
+    }
+
+    n = 0;
+
+    while (st->in && size) {
+        cl = st->in;
+        b = cl->buf;
+
+        len = ngx_min(size, (size_t) (b->last - b->pos));
+
+        buf = ngx_cpymem(buf, b->pos, len);
+        b->pos += len;
+
+        n += len;
+        size -= len;
+
+        if (b->pos == b->last) {
+            st->in = cl->next;
+
+            cl->next = s->free;
+            s->free = cl;
+        }
+    }
+
+    if (st->in == NULL) {
+        c->read->ready = 0;
+    }
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "http2 multiplex recv: %uz, closed: %d", n, s->closed);
+
+    if (n) {
+        return n;
+    }
+
+    if (s->closed) {
+        c->read->eof = 1;
+        return 0;
+    }
+
+    return NGX_AGAIN;
+}
+
+
+static ssize_t
+ngx_http_grpc_mux_send(ngx_connection_t *c, u_char *buf, size_t size)
+{
+    ngx_buf_t     b;
+    ngx_chain_t   cl, *rc;
+
+    ngx_memzero(&b, sizeof(ngx_buf_t));
+
+    b.pos = buf;
+    b.last = buf + size;
+    b.temporary = 1;
+
+    cl.buf = &b;
+    cl.next = NULL;
+
+    rc = ngx_http_grpc_mux_send_chain(c, &cl, 0);
+
+    if (rc == NGX_CHAIN_ERROR) {
+        return NGX_ERROR;
+    }
+
+    if (rc) {
+        return NGX_AGAIN;
+    }
+
+    return size;
+}
+
+
+static ngx_chain_t *
+ngx_http_grpc_mux_send_chain(ngx_connection_t *c, ngx_chain_t *in,
+    off_t limit)
+{
+    ngx_http_grpc_stream_t  *st = (ngx_http_grpc_stream_t *) c;
+
+    off_t                     sent;
+    size_t                    size;
+    ssize_t                   n;
+    ngx_buf_t                *b;
+    ngx_chain_t              *cl, *ln;
+    ngx_http_grpc_session_t  *s;
+
+    s = st->session;
+
+    if (st->error || s->closed) {
+        c->write->error = 1;
+        return NGX_CHAIN_ERROR;
+    }
+
+    /*
+     * the first write is always accepted to keep stream identifiers
+     * in order, other writes are delayed while the session is congested
+     */
+
+    if (st->started && s->buffered >= NGX_HTTP_GRPC_MUX_BUFFERED) {
+        ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                       "http2 multiplex send blocked, buffered: %uz",
+                       s->buffered);
+
+        st->blocked = 1;
+        c->write->ready = 0;
+
+        return in;
+    }
+
+    st->started = 1;
+
+    /* frames are either copied completely, or the session is closed */
+
+    sent = 0;
+
+    for (cl = in; cl; cl = cl->next) {
+        b = cl->buf;
+
+        if (ngx_buf_special(b)) {
+            continue;
+        }
+
+        if (!b->in_file) {
+            size = b->last - b->pos;
+
+            if (ngx_http_grpc_mux_queue(s, &s->out, b->pos, size) != NGX_OK) {
+                goto failed;
+            }
+
+            b->pos = b->last;
+            sent += size;
+
+            continue;
+        }
+
+        while (b->file_pos < b->file_last) {
+            ln = ngx_http_grpc_mux_get_buf(s, &s->out);
+            if (ln == NULL) {
+                goto failed;
+            }
+
+            size = (size_t) ngx_min(b->file_last - b->file_pos,
+                                    (off_t) (ln->buf->end - ln->buf->last));
+
+            n = ngx_read_file(b->file, ln->buf->last, size, b->file_pos);
+
+            if (n != (ssize_t) size) {
+                goto failed;
+            }
+
+            ln->buf->last += n;
+            b->file_pos += n;
+            sent += n;
+        }
+
+        if (b->in_file && ngx_buf_in_memory(b)) {
+            b->pos = b->last;
+        }
+    }
+
+    c->sent += sent;
+    s->buffered += sent;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "http2 multiplex send: %O, buffered: %uz",
+                   sent, s->buffered);
+
+    if (s->connected) {
+        ngx_post_event(s->connection->write, &ngx_posted_events);
+    }
+
+    return NULL;
+
+failed:
+
+    ngx_http_grpc_mux_close(s, 1);
+
+    return NGX_CHAIN_ERROR;
+}
+
+
+static ngx_int_t
+ngx_http_grpc_add_variables(ngx_conf_t *cf)
+{
+    ngx_http_variable_t  *var, *v;
+
+    for (v = ngx_http_grpc_vars; v->name.len; v++) {
+        var = ngx_http_add_variable(cf, &v->name, v->flags);
+        if (var == NULL) {
+            return NGX_ERROR;
+        }
+
+        var->get_handler = v->get_handler;
+        var->data = v->data;
+    }
+
+    return NGX_OK;
+}
+
+
+static void *
+ngx_http_grpc_create_srv_conf(ngx_conf_t *cf)
+{
+    ngx_http_grpc_mux_conf_t  *conf;
+
+    conf = ngx_pcalloc(cf->pool, sizeof(ngx_http_grpc_mux_conf_t));
+    if (conf == NULL) {
+        return NULL;
+    }
+
+    /*
+     * set by ngx_pcalloc():
+     *
+     *     conf->streams = 0;
+     *     conf->connections = 0;
+     *     conf->timeout = 0;
+     *     conf->original_init_upstream = NULL;
+     *     conf->original_init_peer = NULL;
+     */
+
+    return conf;
+}
+
+
+static void *
+ngx_http_grpc_create_loc_conf(ngx_conf_t *cf)
+{
+    ngx_http_grpc_loc_conf_t  *conf;
+
+    conf = ngx_pcalloc(cf->pool, sizeof(ngx_http_grpc_loc_conf_t));
+    if (conf == NULL) {
+        return NULL;
+    }
+
+    /*
+     * set by ngx_pcalloc():
+     *
+     *     conf->upstream.ignore_headers = 0;
+     *     conf->upstream.next_upstream = 0;
+     *     conf->upstream.hide_headers_hash = { NULL, 0 };
+     *
+     *     conf->headers.lengths = NULL;
+     *     conf->headers.values = NULL;
+     *     conf->headers.hash = { NULL, 0 };
+     *     conf->host = { 0, NULL };
+     *     conf->host_set = 0;
+     *     conf->ssl = 0;
+     *     conf->ssl_protocols = 0;
+     *     conf->ssl_ciphers = { 0, NULL };
+     *     conf->ssl_trusted_certificate = { 0, NULL };
+     *     conf->ssl_crl = { 0, NULL };
+     */
+
+    conf->upstream.local = NGX_CONF_UNSET_PTR;
+    conf->upstream.socket_keepalive = NGX_CONF_UNSET;
+    conf->upstream.next_upstream_tries = NGX_CONF_UNSET_UINT;
+    conf->upstream.connect_timeout = NGX_CONF_UNSET_MSEC;
+    conf->upstream.send_timeout = NGX_CONF_UNSET_MSEC;
+    conf->upstream.read_timeout = NGX_CONF_UNSET_MSEC;
+    conf->upstream.next_upstream_timeout = NGX_CONF_UNSET_MSEC;
+
+    conf->upstream.buffer_size = NGX_CONF_UNSET_SIZE;
+
+    conf->upstream.hide_headers = NGX_CONF_UNSET_PTR;
+    conf->upstream.pass_headers = NGX_CONF_UNSET_PTR;
+
+    conf->upstream.intercept_errors = NGX_CONF_UNSET;
+
+#if (NGX_HTTP_SSL)
+    conf->upstream.ssl_session_reuse = NGX_CONF_UNSET;
+    conf->upstream.ssl_name = NGX_CONF_UNSET_PTR;
+    conf->upstream.ssl_server_name = NGX_CONF_UNSET;
+    conf->upstream.ssl_verify = NGX_CONF_UNSET;
+    conf->ssl_verify_depth = NGX_CONF_UNSET_UINT;
+    conf->upstream.ssl_certificate = NGX_CONF_UNSET_PTR;
+    conf->upstream.ssl_certificate_key = NGX_CONF_UNSET_PTR;
+    conf->upstream.ssl_passwords = NGX_CONF_UNSET_PTR;
+    conf->ssl_conf_commands = NGX_CONF_UNSET_PTR;
+#endif
+
+    /* the hardcoded values */
+    conf->upstream.cyclic_temp_file = 0;
+    conf->upstream.buffering = 0;
+    conf->upstream.ignore_client_abort = 0;
+    conf->upstream.send_lowat = 0;
+    conf->upstream.bufs.num = 0;
+    conf->upstream.busy_buffers_size = 0;
+    conf->upstream.max_temp_file_size = 0;
+    conf->upstream.temp_file_write_size = 0;
+    conf->upstream.pass_request_headers = 1;
+    conf->upstream.pass_request_body = 1;
+    conf->upstream.force_ranges = 0;
+    conf->upstream.pass_trailers = 1;
+    conf->upstream.preserve_output = 1;
+
+    conf->headers_source = NGX_CONF_UNSET_PTR;
+
+    ngx_str_set(&conf->upstream.module, "grpc");
 
     return conf;
 }
@@ -4548,8 +6212,8 @@ ngx_http_grpc_merge_loc_conf(ngx_conf_t *cf, void *parent, void *child)
         conf->host_set = prev->host_set;
     }
 
-    rc = ngx_http_grpc_init_headers(cf, conf, &conf->headers,
-                                    ngx_http_grpc_headers);
+    rc = ngx_http_grpc_init_headers(cf, conf->headers_source, &conf->headers,
+                                    ngx_http_grpc_headers, &conf->host_set);
     if (rc != NGX_OK) {
         return NGX_CONF_ERROR;
     }
@@ -4570,9 +6234,10 @@ ngx_http_grpc_merge_loc_conf(ngx_conf_t *cf, void *parent, void *child)
 }
 
 
-static ngx_int_t
-ngx_http_grpc_init_headers(ngx_conf_t *cf, ngx_http_grpc_loc_conf_t *conf,
-    ngx_http_grpc_headers_t *headers, ngx_keyval_t *default_headers)
+ngx_int_t
+ngx_http_grpc_init_headers(ngx_conf_t *cf, ngx_array_t *headers_source,
+    ngx_http_grpc_headers_t *headers, ngx_keyval_t *default_headers,
+    ngx_uint_t *host_set)
 {
     u_char                       *p;
     size_t                        size;
@@ -4611,15 +6276,15 @@ ngx_http_grpc_init_headers(ngx_conf_t *cf, ngx_http_grpc_loc_conf_t *conf,
         return NGX_ERROR;
     }
 
-    if (conf->headers_source) {
+    if (headers_source) {
 
-        src = conf->headers_source->elts;
-        for (i = 0; i < conf->headers_source->nelts; i++) {
+        src = headers_source->elts;
+        for (i = 0; i < headers_source->nelts; i++) {
 
             if (src[i].key.len == 4
                 && ngx_strncasecmp(src[i].key.data, (u_char *) "Host", 4) == 0)
             {
-                conf->host_set = 1;
+                *host_set = 1;
             }
 
             s = ngx_array_push(&headers_merged);
@@ -4844,6 +6509,88 @@ ngx_http_grpc_pass(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 }
 
 
+static char *
+ngx_http_grpc_multiplex(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
+{
+    ngx_http_grpc_mux_conf_t  *mcf = conf;
+
+    ngx_int_t                      n;
+    ngx_str_t                     *value, s;
+    ngx_uint_t                     i;
+    ngx_http_upstream_srv_conf_t  *uscf;
+
+    if (mcf->streams) {
+        return "is duplicate";
+    }
+
+    value = cf->args->elts;
+
+    n = ngx_atoi(value[1].data, value[1].len);
+
+    if (n == NGX_ERROR || n == 0) {
+        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "invalid value \"%V\" in \"%V\" directive",
+                           &value[1], &cmd->name);
+        return NGX_CONF_ERROR;
+    }
+
+    mcf->streams = n;
+    mcf->connections = 1;
+    mcf->timeout = 60000;
+
+    for (i = 2; i < cf->args->nelts; i++) {
+
+        if (ngx_strncmp(value[i].data, "connections=", 12) == 0) {
+
+            n = ngx_atoi(value[i].data + 12, value[i].len - 12);
+
+            if (n == NGX_ERROR || n == 0) {
+                goto invalid;
+            }
+
+            mcf->connections = n;
+
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "timeout=", 8) == 0) {
+
+            s.len = value[i].len - 8;
+            s.data = value[i].data + 8;
+
+            mcf->timeout = ngx_parse_time(&s, 0);
+
+            if (mcf->timeout == (ngx_msec_t) NGX_ERROR) {
+                goto invalid;
+            }
+
+            continue;
+        }
+
+        goto invalid;
+    }
+
+    /* init upstream handler */
+
+    uscf = ngx_http_conf_get_module_srv_conf(cf, ngx_http_upstream_module);
+
+    mcf->original_init_upstream = uscf->peer.init_upstream
+                                  ? uscf->peer.init_upstream
+                                  : ngx_http_upstream_init_round_robin;
+
+    uscf->peer.init_upstream = ngx_http_grpc_mux_init;
+
+    return NGX_CONF_OK;
+
+invalid:
+
+    ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                       "invalid parameter \"%V\"", &value[i]);
+
+    return NGX_CONF_ERROR;
+}
+
+
 #if (NGX_HTTP_SSL)
 
 static char *
@@ -5018,19 +6765,10 @@ ngx_http_grpc_set_ssl(ngx_conf_t *cf, ngx_http_grpc_loc_conf_t *glcf)
         return NGX_ERROR;
     }
 
-#ifdef TLSEXT_TYPE_application_layer_protocol_negotiation
-
-    if (SSL_CTX_set_alpn_protos(glcf->upstream.ssl->ctx,
-                                (u_char *) "\x02h2", 3)
-        != 0)
-    {
-        ngx_ssl_error(NGX_LOG_EMERG, cf->log, 0,
-                      "SSL_CTX_set_alpn_protos() failed");
+    if (ngx_http_grpc_set_alpn(cf, glcf->upstream.ssl) != NGX_OK) {
         return NGX_ERROR;
     }
 
-#endif
-
     if (ngx_ssl_conf_commands(cf, glcf->upstream.ssl, glcf->ssl_conf_commands)
         != NGX_OK)
     {
@@ -5040,4 +6778,21 @@ ngx_http_grpc_set_ssl(ngx_conf_t *cf, ngx_http_grpc_loc_conf_t *glcf)
     return NGX_OK;
 }
 
+
+ngx_int_t
+ngx_http_grpc_set_alpn(ngx_conf_t *cf, ngx_ssl_t *ssl)
+{
+#ifdef TLSEXT_TYPE_application_layer_protocol_negotiation
+
+    if (SSL_CTX_set_alpn_protos(ssl->ctx, (u_char *) "\x02h2", 3) != 0) {
+        ngx_ssl_error(NGX_LOG_EMERG, cf->log, 0,
+                      "SSL_CTX_set_alpn_protos() failed");
+        return NGX_ERROR;
+    }
+
+#endif
+
+    return NGX_OK;
+}
+
 #endif
@@ -0,0 +1,53 @@
+
+/*
+ * Copyright (C) Maxim Dounin
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#ifndef _NGX_HTTP_GRPC_MODULE_H_INCLUDED_
+#define _NGX_HTTP_GRPC_MODULE_H_INCLUDED_
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+typedef struct {
+    ngx_array_t               *flushes;
+    ngx_array_t               *lengths;
+    ngx_array_t               *values;
+    ngx_hash_t                 hash;
+} ngx_http_grpc_headers_t;
+
+
+/*
+ * an HTTP/2 request to be sent by the grpc module on behalf of another
+ * upstream module: "host" is sent as ":authority" unless "host_set",
+ * empty "method" and "uri" mean the ones of the client request
+ */
+
+typedef struct {
+    ngx_http_grpc_headers_t   *headers;
+    ngx_str_t                  host;
+    ngx_str_t                  method;
+    ngx_str_t                  uri;
+    ngx_uint_t                 host_set;
+} ngx_http_grpc_request_t;
+
+
+ngx_int_t ngx_http_grpc_init_upstream(ngx_http_request_t *r,
+    ngx_http_grpc_request_t *gr);
+ngx_int_t ngx_http_grpc_init_headers(ngx_conf_t *cf,
+    ngx_array_t *headers_source, ngx_http_grpc_headers_t *headers,
+    ngx_keyval_t *default_headers, ngx_uint_t *host_set);
+#if (NGX_HTTP_SSL)
+ngx_int_t ngx_http_grpc_set_alpn(ngx_conf_t *cf, ngx_ssl_t *ssl);
+#endif
+
+
+extern ngx_module_t  ngx_http_grpc_module;
+
+
+#endif /* _NGX_HTTP_GRPC_MODULE_H_INCLUDED_ */
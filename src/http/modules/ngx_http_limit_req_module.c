@@ -16,6 +16,18 @@
 #define NGX_HTTP_LIMIT_REQ_DELAYED_DRY_RUN   4
 #define NGX_HTTP_LIMIT_REQ_REJECTED_DRY_RUN  5
 
+#define NGX_HTTP_LIMIT_REQ_LEAKY_BUCKET      0
+#define NGX_HTTP_LIMIT_REQ_GCRA              1
+#define NGX_HTTP_LIMIT_REQ_SLIDING_WINDOW    2
+
+#define NGX_HTTP_LIMIT_REQ_PROBES            8
+#define NGX_HTTP_LIMIT_REQ_LEASES            256
+#define NGX_HTTP_LIMIT_REQ_COUNT_MASK        0x3fffff
+
+
+#define ngx_http_limit_req_state(excess, last)                                \
+    ((ngx_atomic_uint_t) ((uint64_t) (excess) << 32 | (uint32_t) (last)))
+
 
 typedef struct {
     u_char                       color;
@@ -37,6 +49,32 @@ typedef struct {
 } ngx_http_limit_req_shctx_t;
 
 
+/*
+ * a lockfree zone is an open addressing table of fixed size slots,
+ * the key is identified by its 64-bit fingerprint, and the state fits
+ * in a single word, so it can be updated with a single CAS; for the
+ * leaky bucket it keeps the excess in its high 32 bits and the low
+ * 32 bits of the last access time in its low 32 bits
+ */
+
+typedef struct {
+    ngx_atomic_t                 key;
+    ngx_atomic_t                 state;
+} ngx_http_limit_req_slot_t;
+
+
+typedef struct {
+    ngx_uint_t                   number;
+    ngx_http_limit_req_slot_t    slot[1];
+} ngx_http_limit_req_table_t;
+
+
+typedef struct {
+    uint64_t                     key;
+    ngx_uint_t                   tokens;
+} ngx_http_limit_req_lease_t;
+
+
 typedef struct {
     ngx_http_limit_req_shctx_t  *sh;
     ngx_slab_pool_t             *shpool;
@@ -44,6 +82,17 @@ typedef struct {
     ngx_uint_t                   rate;
     ngx_http_complex_value_t     key;
     ngx_http_limit_req_node_t   *node;
+    ngx_http_limit_req_table_t  *table;
+    ngx_http_limit_req_slot_t   *slot;
+    ngx_http_limit_req_lease_t  *leases;
+    ngx_uint_t                   lease;
+    ngx_flag_t                   lockfree;
+    ngx_uint_t                   algorithm;
+    /* GCRA emission interval in microseconds */
+    uint64_t                     interval;
+    /* sliding window length in milliseconds and requests allowed in it */
+    ngx_msec_t                   window;
+    ngx_uint_t                   quota;
 } ngx_http_limit_req_ctx_t;
 
 
@@ -67,8 +116,22 @@ typedef struct {
 static void ngx_http_limit_req_delay(ngx_http_request_t *r);
 static ngx_int_t ngx_http_limit_req_lookup(ngx_http_limit_req_limit_t *limit,
     ngx_uint_t hash, ngx_str_t *key, ngx_uint_t *ep, ngx_uint_t account);
+static ngx_int_t ngx_http_limit_req_lookup_slot(
+    ngx_http_limit_req_limit_t *limit, ngx_uint_t hash, ngx_str_t *key,
+    ngx_uint_t *ep, ngx_uint_t account);
+static ngx_http_limit_req_slot_t *ngx_http_limit_req_find_slot(
+    ngx_http_limit_req_ctx_t *ctx, ngx_atomic_uint_t key, ngx_msec_t now,
+    ngx_uint_t *new, ngx_atomic_uint_t *sp);
+static ngx_int_t ngx_http_limit_req_slot_update(ngx_http_limit_req_ctx_t *ctx,
+    ngx_atomic_uint_t state, ngx_msec_t now, ngx_atomic_uint_t *sp);
+static ngx_msec_t ngx_http_limit_req_excess_delay(ngx_http_limit_req_ctx_t *ctx,
+    ngx_uint_t excess);
+static ngx_msec_int_t ngx_http_limit_req_slot_idle(
+    ngx_http_limit_req_ctx_t *ctx, ngx_atomic_uint_t state, ngx_msec_t now);
 static ngx_msec_t ngx_http_limit_req_account(ngx_http_limit_req_limit_t *limits,
     ngx_uint_t n, ngx_uint_t *ep, ngx_http_limit_req_limit_t **limit);
+static ngx_int_t ngx_http_limit_req_account_slot(
+    ngx_http_limit_req_ctx_t *ctx);
 static void ngx_http_limit_req_unlock(ngx_http_limit_req_limit_t *limits,
     ngx_uint_t n);
 static void ngx_http_limit_req_expire(ngx_http_limit_req_ctx_t *ctx,
@@ -96,6 +159,14 @@ static ngx_conf_enum_t  ngx_http_limit_req_log_levels[] = {
 };
 
 
+static ngx_str_t  ngx_http_limit_req_algorithms[] = {
+    ngx_string("leaky_bucket"),
+    ngx_string("gcra"),
+    ngx_string("sliding_window"),
+    ngx_null_string
+};
+
+
 static ngx_conf_num_bounds_t  ngx_http_limit_req_status_bounds = {
     ngx_conf_check_num_bounds, 400, 599
 };
@@ -104,7 +175,7 @@ static ngx_conf_num_bounds_t  ngx_http_limit_req_status_bounds = {
 static ngx_command_t  ngx_http_limit_req_commands[] = {
 
     { ngx_string("limit_req_zone"),
-      NGX_HTTP_MAIN_CONF|NGX_CONF_TAKE3,
+      NGX_HTTP_MAIN_CONF|NGX_CONF_2MORE,
       ngx_http_limit_req_zone,
       0,
       0,
@@ -243,12 +314,18 @@ ngx_http_limit_req_handler(ngx_http_request_t *r)
 
         hash = ngx_crc32_short(key.data, key.len);
 
-        ngx_shmtx_lock(&ctx->shpool->mutex);
+        if (ctx->lockfree) {
+            rc = ngx_http_limit_req_lookup_slot(limit, hash, &key, &excess,
+                                                (n == lrcf->limits.nelts - 1));
 
-        rc = ngx_http_limit_req_lookup(limit, hash, &key, &excess,
-                                       (n == lrcf->limits.nelts - 1));
+        } else {
+            ngx_shmtx_lock(&ctx->shpool->mutex);
 
-        ngx_shmtx_unlock(&ctx->shpool->mutex);
+            rc = ngx_http_limit_req_lookup(limit, hash, &key, &excess,
+                                           (n == lrcf->limits.nelts - 1));
+
+            ngx_shmtx_unlock(&ctx->shpool->mutex);
+        }
 
         ngx_log_debug4(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
                        "limit_req[%ui]: %i %ui.%03ui",
@@ -532,6 +609,337 @@ ngx_http_limit_req_lookup(ngx_http_limit_req_limit_t *limit, ngx_uint_t hash,
 }
 
 
+static ngx_int_t
+ngx_http_limit_req_lookup_slot(ngx_http_limit_req_limit_t *limit,
+    ngx_uint_t hash, ngx_str_t *key, ngx_uint_t *ep, ngx_uint_t account)
+{
+    uint64_t                     fp;
+    ngx_int_t                    excess;
+    ngx_uint_t                   new, tokens;
+    ngx_msec_t                   now;
+    ngx_atomic_uint_t            old, state;
+    ngx_http_limit_req_ctx_t    *ctx;
+    ngx_http_limit_req_slot_t   *slot;
+    ngx_http_limit_req_lease_t  *lease;
+
+    now = ngx_current_msec;
+
+    ctx = limit->shm_zone->data;
+    ctx->slot = NULL;
+
+    fp = (uint64_t) hash << 32 | ngx_murmur_hash2(key->data, key->len);
+
+    if (fp == 0) {
+        fp = 1;
+    }
+
+    lease = NULL;
+
+    /*
+     * leases are only used by the last limit, as the excess of other
+     * limits is not committed until all of them are checked
+     */
+
+    if (ctx->lease && account) {
+        lease = &ctx->leases[fp % NGX_HTTP_LIMIT_REQ_LEASES];
+
+        if (lease->key == fp && lease->tokens) {
+            lease->tokens--;
+            *ep = 0;
+            return account ? NGX_OK : NGX_AGAIN;
+        }
+    }
+
+    slot = ngx_http_limit_req_find_slot(ctx, (ngx_atomic_uint_t) fp, now,
+                                        &new, &old);
+
+    if (new) {
+
+        /*
+         * the state left by the previous key is reset unless another
+         * worker has already updated it since the slot was claimed
+         */
+
+        if (ctx->algorithm == NGX_HTTP_LIMIT_REQ_LEAKY_BUCKET) {
+            if (ngx_atomic_cmp_set(&slot->state, old,
+                                   ngx_http_limit_req_state(0, now)))
+            {
+                *ep = 0;
+                return account ? NGX_OK : NGX_AGAIN;
+            }
+
+        } else {
+
+            /* other algorithms account the first request as any other */
+
+            (void) ngx_atomic_cmp_set(&slot->state, old, 0);
+        }
+    }
+
+    for ( ;; ) {
+        old = slot->state;
+
+        excess = ngx_http_limit_req_slot_update(ctx, old, now, &state);
+
+        *ep = excess;
+
+        if ((ngx_uint_t) excess > limit->burst) {
+            return NGX_BUSY;
+        }
+
+        if (!account) {
+
+            /* the state is committed by ngx_http_limit_req_account() */
+
+            ctx->slot = slot;
+            return NGX_AGAIN;
+        }
+
+        /*
+         * in the lease mode, the tokens left in the burst are taken
+         * in advance, up to "lease", and are spent without touching
+         * the shared slot
+         */
+
+        tokens = 0;
+
+        if (lease) {
+            tokens = ngx_min(ctx->lease - 1,
+                             (limit->burst - excess) / 1000);
+
+            state += (ngx_atomic_uint_t) ((uint64_t) tokens * 1000 << 32);
+        }
+
+        if (ngx_atomic_cmp_set(&slot->state, old, state)) {
+            break;
+        }
+    }
+
+    if (tokens) {
+        lease->key = fp;
+        lease->tokens = tokens;
+    }
+
+    return account ? NGX_OK : NGX_AGAIN;
+}
+
+
+static ngx_http_limit_req_slot_t *
+ngx_http_limit_req_find_slot(ngx_http_limit_req_ctx_t *ctx,
+    ngx_atomic_uint_t key, ngx_msec_t now, ngx_uint_t *new,
+    ngx_atomic_uint_t *sp)
+{
+    ngx_uint_t                   i, n;
+    ngx_msec_int_t               idle, max;
+    ngx_atomic_uint_t            k, state, stale_key, stale_state;
+    ngx_http_limit_req_slot_t   *slot, *stale;
+    ngx_http_limit_req_table_t  *table;
+
+    table = ctx->table;
+
+    n = key % table->number;
+
+    *new = 1;
+
+    for ( ;; ) {
+
+        stale = NULL;
+        stale_key = 0;
+        stale_state = 0;
+        max = 0;
+
+        for (i = 0; i < NGX_HTTP_LIMIT_REQ_PROBES; i++) {
+
+            slot = &table->slot[(n + i) % table->number];
+            k = slot->key;
+
+            if (k == key) {
+                *new = 0;
+                return slot;
+            }
+
+            /* the state is read before the slot is claimed */
+
+            state = slot->state;
+
+            if (k == 0) {
+                if (ngx_atomic_cmp_set(&slot->key, 0, key)) {
+                    *sp = state;
+                    return slot;
+                }
+
+                if (slot->key == key) {
+                    *new = 0;
+                    return slot;
+                }
+
+                continue;
+            }
+
+            idle = ngx_http_limit_req_slot_idle(ctx, state, now);
+
+            if (stale == NULL || idle > max) {
+                max = idle;
+                stale = slot;
+                stale_key = k;
+                stale_state = state;
+            }
+        }
+
+        if (stale == NULL) {
+            continue;
+        }
+
+        /*
+         * there are no free slots among the probed ones, so the least
+         * recently used one is taken over, much like the oldest node
+         * is expired by force when the rbtree zone is out of memory
+         */
+
+        if (ngx_atomic_cmp_set(&stale->key, stale_key, key)) {
+            *sp = stale_state;
+            return stale;
+        }
+    }
+}
+
+
+static ngx_int_t
+ngx_http_limit_req_slot_update(ngx_http_limit_req_ctx_t *ctx,
+    ngx_atomic_uint_t state, ngx_msec_t now, ngx_atomic_uint_t *sp)
+{
+    uint64_t        us, tat, window, prev, cur;
+    ngx_int_t       excess;
+    ngx_msec_int_t  ms;
+
+    switch (ctx->algorithm) {
+
+    case NGX_HTTP_LIMIT_REQ_GCRA:
+
+        /* the state is the theoretical arrival time in microseconds */
+
+        us = (uint64_t) now * 1000;
+        tat = ngx_max((uint64_t) state, us);
+
+        *sp = (ngx_atomic_uint_t) (tat + ctx->interval);
+
+        return (ngx_int_t) ((tat - us) * 1000 / ctx->interval);
+
+    case NGX_HTTP_LIMIT_REQ_SLIDING_WINDOW:
+
+        /*
+         * the state keeps the window number in its high 20 bits,
+         * and the counters of the previous and the current windows
+         * in the next 22 bits each
+         */
+
+        window = now / ctx->window;
+        prev = ((uint64_t) state >> 22) & NGX_HTTP_LIMIT_REQ_COUNT_MASK;
+        cur = (uint64_t) state & NGX_HTTP_LIMIT_REQ_COUNT_MASK;
+
+        switch ((window - ((uint64_t) state >> 44)) & 0xfffff) {
+
+        case 0:
+            break;
+
+        case 1:
+            prev = cur;
+            cur = 0;
+            break;
+
+        default:
+            prev = 0;
+            cur = 0;
+        }
+
+        /* the previous window is weighted by its part still in the window */
+
+        excess = (ngx_int_t) (prev * (ctx->window - now % ctx->window) * 1000
+                              / ctx->window + cur * 1000 + 1000)
+                 - (ngx_int_t) ctx->quota * 1000;
+
+        if (cur < NGX_HTTP_LIMIT_REQ_COUNT_MASK) {
+            cur++;
+        }
+
+        *sp = (ngx_atomic_uint_t) ((window & 0xfffff) << 44 | prev << 22 | cur);
+
+        return excess < 0 ? 0 : excess;
+
+    default: /* NGX_HTTP_LIMIT_REQ_LEAKY_BUCKET */
+
+        ms = (ngx_msec_int_t) (int32_t) ((uint32_t) now - (uint32_t) state);
+
+        if (ms < -60000) {
+            ms = 1;
+
+        } else if (ms < 0) {
+            ms = 0;
+        }
+
+        excess = (ngx_int_t) ((uint64_t) state >> 32) - ctx->rate * ms / 1000
+                 + 1000;
+
+        if (excess < 0) {
+            excess = 0;
+        }
+
+        /* the excess is kept in 32 bits */
+
+        excess = ngx_min((uint64_t) excess, 0xffffffff);
+
+        *sp = ngx_http_limit_req_state(excess, ms ? now : (ngx_msec_t) state);
+
+        return excess;
+    }
+}
+
+
+static ngx_msec_t
+ngx_http_limit_req_excess_delay(ngx_http_limit_req_ctx_t *ctx,
+    ngx_uint_t excess)
+{
+    switch (ctx->algorithm) {
+
+    case NGX_HTTP_LIMIT_REQ_GCRA:
+        return (ngx_msec_t) ((uint64_t) excess * ctx->interval / 1000000);
+
+    case NGX_HTTP_LIMIT_REQ_SLIDING_WINDOW:
+
+        /* the window is assumed to drain evenly */
+
+        return (ngx_msec_t) ((uint64_t) excess * ctx->window
+                             / (ctx->quota * 1000));
+
+    default: /* NGX_HTTP_LIMIT_REQ_LEAKY_BUCKET */
+        return (ngx_msec_t) (excess * 1000 / ctx->rate);
+    }
+}
+
+
+static ngx_msec_int_t
+ngx_http_limit_req_slot_idle(ngx_http_limit_req_ctx_t *ctx,
+    ngx_atomic_uint_t state, ngx_msec_t now)
+{
+    uint64_t        window;
+    ngx_msec_int_t  ms;
+
+    switch (ctx->algorithm) {
+
+    case NGX_HTTP_LIMIT_REQ_GCRA:
+        return (ngx_msec_int_t) (now - (ngx_msec_t) ((uint64_t) state / 1000));
+
+    case NGX_HTTP_LIMIT_REQ_SLIDING_WINDOW:
+        window = (now / ctx->window - ((uint64_t) state >> 44)) & 0xfffff;
+        return (ngx_msec_int_t) (window * ctx->window);
+
+    default: /* NGX_HTTP_LIMIT_REQ_LEAKY_BUCKET */
+        ms = (ngx_msec_int_t) (int32_t) ((uint32_t) now - (uint32_t) state);
+        return ngx_abs(ms);
+    }
+}
+
+
 static ngx_msec_t
 ngx_http_limit_req_account(ngx_http_limit_req_limit_t *limits, ngx_uint_t n,
     ngx_uint_t *ep, ngx_http_limit_req_limit_t **limit)
@@ -549,51 +957,59 @@ ngx_http_limit_req_account(ngx_http_limit_req_limit_t *limits, ngx_uint_t n,
 
     } else {
         ctx = (*limit)->shm_zone->data;
-        max_delay = (excess - (*limit)->delay) * 1000 / ctx->rate;
+        max_delay = ngx_http_limit_req_excess_delay(ctx,
+                                                    excess - (*limit)->delay);
     }
 
     while (n--) {
         ctx = limits[n].shm_zone->data;
-        lr = ctx->node;
 
-        if (lr == NULL) {
-            continue;
-        }
+        if (ctx->slot) {
+            excess = ngx_http_limit_req_account_slot(ctx);
 
-        ngx_shmtx_lock(&ctx->shpool->mutex);
+        } else {
+            lr = ctx->node;
 
-        now = ngx_current_msec;
-        ms = (ngx_msec_int_t) (now - lr->last);
+            if (lr == NULL) {
+                continue;
+            }
 
-        if (ms < -60000) {
-            ms = 1;
+            ngx_shmtx_lock(&ctx->shpool->mutex);
 
-        } else if (ms < 0) {
-            ms = 0;
-        }
+            now = ngx_current_msec;
+            ms = (ngx_msec_int_t) (now - lr->last);
 
-        excess = lr->excess - ctx->rate * ms / 1000 + 1000;
+            if (ms < -60000) {
+                ms = 1;
 
-        if (excess < 0) {
-            excess = 0;
-        }
+            } else if (ms < 0) {
+                ms = 0;
+            }
 
-        if (ms) {
-            lr->last = now;
-        }
+            excess = lr->excess - ctx->rate * ms / 1000 + 1000;
 
-        lr->excess = excess;
-        lr->count--;
+            if (excess < 0) {
+                excess = 0;
+            }
 
-        ngx_shmtx_unlock(&ctx->shpool->mutex);
+            if (ms) {
+                lr->last = now;
+            }
 
-        ctx->node = NULL;
+            lr->excess = excess;
+            lr->count--;
+
+            ngx_shmtx_unlock(&ctx->shpool->mutex);
+
+            ctx->node = NULL;
+        }
 
         if ((ngx_uint_t) excess <= limits[n].delay) {
             continue;
         }
 
-        delay = (excess - limits[n].delay) * 1000 / ctx->rate;
+        delay = ngx_http_limit_req_excess_delay(ctx,
+                                                excess - limits[n].delay);
 
         if (delay > max_delay) {
             max_delay = delay;
@@ -606,6 +1022,30 @@ ngx_http_limit_req_account(ngx_http_limit_req_limit_t *limits, ngx_uint_t n,
 }
 
 
+static ngx_int_t
+ngx_http_limit_req_account_slot(ngx_http_limit_req_ctx_t *ctx)
+{
+    ngx_int_t                   excess;
+    ngx_msec_t                  now;
+    ngx_atomic_uint_t           old, state;
+    ngx_http_limit_req_slot_t  *slot;
+
+    now = ngx_current_msec;
+    slot = ctx->slot;
+
+    do {
+        old = slot->state;
+
+        excess = ngx_http_limit_req_slot_update(ctx, old, now, &state);
+
+    } while (!ngx_atomic_cmp_set(&slot->state, old, state));
+
+    ctx->slot = NULL;
+
+    return excess;
+}
+
+
 static void
 ngx_http_limit_req_unlock(ngx_http_limit_req_limit_t *limits, ngx_uint_t n)
 {
@@ -614,6 +1054,8 @@ ngx_http_limit_req_unlock(ngx_http_limit_req_limit_t *limits, ngx_uint_t n)
     while (n--) {
         ctx = limits[n].shm_zone->data;
 
+        ctx->slot = NULL;
+
         if (ctx->node == NULL) {
             continue;
         }
@@ -700,7 +1142,8 @@ ngx_http_limit_req_init_zone(ngx_shm_zone_t *shm_zone, void *data)
 {
     ngx_http_limit_req_ctx_t  *octx = data;
 
-    size_t                     len;
+    size_t                     len, size;
+    ngx_uint_t                 n;
     ngx_http_limit_req_ctx_t  *ctx;
 
     ctx = shm_zone->data;
@@ -719,8 +1162,27 @@ ngx_http_limit_req_init_zone(ngx_shm_zone_t *shm_zone, void *data)
             return NGX_ERROR;
         }
 
+        if (ctx->algorithm != octx->algorithm) {
+            ngx_log_error(NGX_LOG_EMERG, shm_zone->shm.log, 0,
+                          "limit_req \"%V\" uses the \"%V\" algorithm "
+                          "while previously it used the \"%V\" algorithm",
+                          &shm_zone->shm.name,
+                          &ngx_http_limit_req_algorithms[ctx->algorithm],
+                          &ngx_http_limit_req_algorithms[octx->algorithm]);
+            return NGX_ERROR;
+        }
+
+        if (ctx->lockfree != octx->lockfree) {
+            ngx_log_error(NGX_LOG_EMERG, shm_zone->shm.log, 0,
+                          "limit_req \"%V\" cannot be switched "
+                          "%s lockfree mode",
+                          &shm_zone->shm.name, ctx->lockfree ? "to" : "from");
+            return NGX_ERROR;
+        }
+
         ctx->sh = octx->sh;
         ctx->shpool = octx->shpool;
+        ctx->table = octx->table;
 
         return NGX_OK;
     }
@@ -728,11 +1190,35 @@ ngx_http_limit_req_init_zone(ngx_shm_zone_t *shm_zone, void *data)
     ctx->shpool = (ngx_slab_pool_t *) shm_zone->shm.addr;
 
     if (shm_zone->shm.exists) {
-        ctx->sh = ctx->shpool->data;
+        if (ctx->lockfree) {
+            ctx->table = ctx->shpool->data;
+
+        } else {
+            ctx->sh = ctx->shpool->data;
+        }
 
         return NGX_OK;
     }
 
+    if (ctx->lockfree) {
+
+        /* the table takes all free pages but the ones for log_ctx */
+
+        size = (ctx->shpool->pfree - 2) * ngx_pagesize;
+        n = (size - offsetof(ngx_http_limit_req_table_t, slot))
+            / sizeof(ngx_http_limit_req_slot_t);
+
+        ctx->table = ngx_slab_calloc(ctx->shpool, size);
+        if (ctx->table == NULL) {
+            return NGX_ERROR;
+        }
+
+        ctx->table->number = n;
+        ctx->shpool->data = ctx->table;
+
+        goto done;
+    }
+
     ctx->sh = ngx_slab_alloc(ctx->shpool, sizeof(ngx_http_limit_req_shctx_t));
     if (ctx->sh == NULL) {
         return NGX_ERROR;
@@ -745,6 +1231,8 @@ ngx_http_limit_req_init_zone(ngx_shm_zone_t *shm_zone, void *data)
 
     ngx_queue_init(&ctx->sh->queue);
 
+done:
+
     len = sizeof(" in limit_req zone \"\"") + shm_zone->shm.name.len;
 
     ctx->shpool->log_ctx = ngx_slab_alloc(ctx->shpool, len);
@@ -836,8 +1324,8 @@ ngx_http_limit_req_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     size_t                             len;
     ssize_t                            size;
     ngx_str_t                         *value, name, s;
-    ngx_int_t                          rate, scale;
-    ngx_uint_t                         i;
+    ngx_int_t                          rate, scale, lease;
+    ngx_uint_t                         i, n;
     ngx_shm_zone_t                    *shm_zone;
     ngx_http_limit_req_ctx_t          *ctx;
     ngx_http_compile_complex_value_t   ccv;
@@ -862,6 +1350,7 @@ ngx_http_limit_req_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     size = 0;
     rate = 1;
     scale = 1;
+    lease = 0;
     name.len = 0;
 
     for (i = 2; i < cf->args->nelts; i++) {
@@ -912,6 +1401,10 @@ ngx_http_limit_req_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
             } else if (ngx_strncmp(p, "r/m", 3) == 0) {
                 scale = 60;
                 len -= 3;
+
+            } else if (ngx_strncmp(p, "r/h", 3) == 0) {
+                scale = 3600;
+                len -= 3;
             }
 
             rate = ngx_atoi(value[i].data + 5, len - 5);
@@ -924,6 +1417,50 @@ ngx_http_limit_req_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
             continue;
         }
 
+        if (ngx_strncmp(value[i].data, "algorithm=", 10) == 0) {
+
+            s.data = value[i].data + 10;
+            s.len = value[i].len - 10;
+
+            for (n = 0; ngx_http_limit_req_algorithms[n].len; n++) {
+                if (s.len == ngx_http_limit_req_algorithms[n].len
+                    && ngx_strncmp(s.data,
+                                   ngx_http_limit_req_algorithms[n].data,
+                                   s.len)
+                       == 0)
+                {
+                    break;
+                }
+            }
+
+            if (ngx_http_limit_req_algorithms[n].len == 0) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid algorithm \"%V\"", &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            ctx->algorithm = n;
+
+            continue;
+        }
+
+        if (ngx_strcmp(value[i].data, "lockfree") == 0) {
+            ctx->lockfree = 1;
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "lease=", 6) == 0) {
+
+            lease = ngx_atoi(value[i].data + 6, value[i].len - 6);
+            if (lease <= 0) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid lease value \"%V\"", &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            continue;
+        }
+
         ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
                            "invalid parameter \"%V\"", &value[i]);
         return NGX_CONF_ERROR;
@@ -936,8 +1473,76 @@ ngx_http_limit_req_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
         return NGX_CONF_ERROR;
     }
 
+    /* other algorithms are only implemented with the slots table */
+
+    if (ctx->algorithm != NGX_HTTP_LIMIT_REQ_LEAKY_BUCKET) {
+        ctx->lockfree = 1;
+    }
+
+    if (ctx->lockfree && sizeof(ngx_atomic_uint_t) < sizeof(uint64_t)) {
+        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "\"lockfree\" is not supported on this platform");
+        return NGX_CONF_ERROR;
+    }
+
+    if (lease
+        && (!ctx->lockfree
+            || ctx->algorithm != NGX_HTTP_LIMIT_REQ_LEAKY_BUCKET))
+    {
+        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "\"lease\" requires \"lockfree\" "
+                           "with the \"leaky_bucket\" algorithm");
+        return NGX_CONF_ERROR;
+    }
+
+    /*
+     * the leaky bucket keeps the rate in requests per 1000 seconds,
+     * which is too coarse for hourly rates
+     */
+
+    if (scale == 3600
+        && ctx->algorithm == NGX_HTTP_LIMIT_REQ_LEAKY_BUCKET)
+    {
+        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "\"r/h\" rate requires the \"gcra\" "
+                           "or \"sliding_window\" algorithm");
+        return NGX_CONF_ERROR;
+    }
+
+    if (ctx->algorithm == NGX_HTTP_LIMIT_REQ_SLIDING_WINDOW
+        && rate > NGX_HTTP_LIMIT_REQ_COUNT_MASK)
+    {
+        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "rate is too big for the \"sliding_window\" "
+                           "algorithm");
+        return NGX_CONF_ERROR;
+    }
+
+    if (lease > 1) {
+        ctx->lease = lease;
+
+        ctx->leases = ngx_pcalloc(cf->pool, NGX_HTTP_LIMIT_REQ_LEASES
+                                         * sizeof(ngx_http_limit_req_lease_t));
+        if (ctx->leases == NULL) {
+            return NGX_CONF_ERROR;
+        }
+    }
+
     ctx->rate = rate * 1000 / scale;
 
+    if (ctx->rate == 0) {
+        ctx->rate = 1;
+    }
+
+    ctx->interval = (uint64_t) scale * 1000000 / rate;
+
+    if (ctx->interval == 0) {
+        ctx->interval = 1;
+    }
+
+    ctx->window = scale * 1000;
+    ctx->quota = rate;
+
     shm_zone = ngx_shared_memory_add(cf, &name, size,
                                      &ngx_http_limit_req_module);
     if (shm_zone == NULL) {
@@ -91,6 +91,10 @@ typedef struct {
     ngx_http_proxy_headers_t       headers_cache;
 #endif
     ngx_array_t                   *headers_source;
+#if (NGX_HTTP_GRPC)
+    ngx_http_grpc_headers_t        headers_v2;
+    ngx_uint_t                     host_set_v2;
+#endif
 
     ngx_array_t                   *proxy_lengths;
     ngx_array_t                   *proxy_values;
@@ -146,6 +150,10 @@ typedef struct {
 
 static ngx_int_t ngx_http_proxy_eval(ngx_http_request_t *r,
     ngx_http_proxy_ctx_t *ctx, ngx_http_proxy_loc_conf_t *plcf);
+#if (NGX_HTTP_GRPC)
+static ngx_int_t ngx_http_proxy_init_v2(ngx_http_request_t *r,
+    ngx_http_proxy_ctx_t *ctx, ngx_http_proxy_loc_conf_t *plcf);
+#endif
 #if (NGX_HTTP_CACHE)
 static ngx_int_t ngx_http_proxy_create_key(ngx_http_request_t *r);
 #endif
@@ -284,9 +292,17 @@ static ngx_conf_post_t  ngx_http_proxy_ssl_conf_command_post =
 #endif
 
 
+static ngx_conf_num_bounds_t  ngx_http_proxy_hedge_budget_bounds = {
+    ngx_conf_check_num_bounds, 0, 100
+};
+
+
 static ngx_conf_enum_t  ngx_http_proxy_http_version[] = {
     { ngx_string("1.0"), NGX_HTTP_VERSION_10 },
     { ngx_string("1.1"), NGX_HTTP_VERSION_11 },
+#if (NGX_HTTP_GRPC)
+    { ngx_string("2"), NGX_HTTP_VERSION_20 },
+#endif
     { ngx_null_string, 0 }
 };
 
@@ -657,6 +673,20 @@ static ngx_command_t  ngx_http_proxy_commands[] = {
       offsetof(ngx_http_proxy_loc_conf_t, upstream.next_upstream_timeout),
       NULL },
 
+    { ngx_string("proxy_hedge_after"),
+      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_msec_slot,
+      NGX_HTTP_LOC_CONF_OFFSET,
+      offsetof(ngx_http_proxy_loc_conf_t, upstream.hedge_after),
+      NULL },
+
+    { ngx_string("proxy_hedge_budget"),
+      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_num_slot,
+      NGX_HTTP_LOC_CONF_OFFSET,
+      offsetof(ngx_http_proxy_loc_conf_t, upstream.hedge_budget),
+      &ngx_http_proxy_hedge_budget_bounds },
+
     { ngx_string("proxy_pass_header"),
       NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_TAKE1,
       ngx_conf_set_str_array_slot,
@@ -832,6 +862,23 @@ static ngx_keyval_t  ngx_http_proxy_headers[] = {
 };
 
 
+#if (NGX_HTTP_GRPC)
+
+static ngx_keyval_t  ngx_http_proxy_headers_v2[] = {
+    { ngx_string("Content-Length"), ngx_string("$content_length") },
+    { ngx_string("Host"), ngx_string("") },
+    { ngx_string("Connection"), ngx_string("") },
+    { ngx_string("Transfer-Encoding"), ngx_string("") },
+    { ngx_string("TE"), ngx_string("") },
+    { ngx_string("Keep-Alive"), ngx_string("") },
+    { ngx_string("Expect"), ngx_string("") },
+    { ngx_string("Upgrade"), ngx_string("") },
+    { ngx_null_string, ngx_null_string }
+};
+
+#endif
+
+
 static ngx_str_t  ngx_http_proxy_hide_headers[] = {
     ngx_string("Date"),
     ngx_string("Server"),
@@ -1012,6 +1059,30 @@ ngx_http_proxy_handler(ngx_http_request_t *r)
 
     u->accel = 1;
 
+#if (NGX_HTTP_GRPC)
+
+    if (plcf->http_version == NGX_HTTP_VERSION_20) {
+        if (ngx_http_proxy_init_v2(r, ctx, plcf) != NGX_OK) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+
+        if (!plcf->upstream.request_buffering
+            && plcf->upstream.pass_request_body)
+        {
+            r->request_body_no_buffering = 1;
+        }
+
+        rc = ngx_http_read_client_request_body(r, ngx_http_upstream_init);
+
+        if (rc >= NGX_HTTP_SPECIAL_RESPONSE) {
+            return rc;
+        }
+
+        return NGX_DONE;
+    }
+
+#endif
+
     if (!plcf->upstream.request_buffering
         && plcf->body_values == NULL && plcf->upstream.pass_request_body
         && (!r->headers_in.chunked
@@ -1132,6 +1203,99 @@ ngx_http_proxy_eval(ngx_http_request_t *r, ngx_http_proxy_ctx_t *ctx,
 }
 
 
+#if (NGX_HTTP_GRPC)
+
+static ngx_int_t
+ngx_http_proxy_init_v2(ngx_http_request_t *r, ngx_http_proxy_ctx_t *ctx,
+    ngx_http_proxy_loc_conf_t *plcf)
+{
+    u_char                   *p;
+    size_t                    loc_len;
+    uintptr_t                 escape;
+    ngx_http_upstream_t      *u;
+    ngx_http_grpc_request_t   gr;
+
+    /*
+     * the request is sent by the grpc module, which owns the HTTP/2 framing
+     * and may multiplex it over a connection shared with other requests
+     */
+
+    u = r->upstream;
+
+    ngx_memzero(&gr, sizeof(ngx_http_grpc_request_t));
+
+    gr.headers = &plcf->headers_v2;
+    gr.host_set = plcf->host_set_v2;
+    gr.host = ctx->vars.host_header;
+
+    if (plcf->method) {
+        if (ngx_http_complex_value(r, plcf->method, &gr.method) != NGX_OK) {
+            return NGX_ERROR;
+        }
+    }
+
+    if (plcf->proxy_lengths && ctx->vars.uri.len) {
+        gr.uri = ctx->vars.uri;
+
+    } else if (ctx->vars.uri.len == 0 && r->valid_unparsed_uri) {
+        gr.uri = r->unparsed_uri;
+
+    } else {
+        loc_len = (r->valid_location && ctx->vars.uri.len) ?
+                      plcf->location.len : 0;
+
+        escape = 0;
+
+        if (r->quoted_uri || r->internal) {
+            escape = 2 * ngx_escape_uri(NULL, r->uri.data + loc_len,
+                                        r->uri.len - loc_len, NGX_ESCAPE_URI);
+        }
+
+        gr.uri.len = ctx->vars.uri.len + r->uri.len - loc_len + escape
+                     + sizeof("?") - 1 + r->args.len;
+
+        gr.uri.data = ngx_pnalloc(r->pool, gr.uri.len);
+        if (gr.uri.data == NULL) {
+            return NGX_ERROR;
+        }
+
+        p = gr.uri.data;
+
+        if (r->valid_location) {
+            p = ngx_copy(p, ctx->vars.uri.data, ctx->vars.uri.len);
+        }
+
+        if (escape) {
+            ngx_escape_uri(p, r->uri.data + loc_len,
+                           r->uri.len - loc_len, NGX_ESCAPE_URI);
+            p += r->uri.len - loc_len + escape;
+
+        } else {
+            p = ngx_copy(p, r->uri.data + loc_len, r->uri.len - loc_len);
+        }
+
+        if (r->args.len > 0) {
+            *p++ = '?';
+            p = ngx_copy(p, r->args.data, r->args.len);
+        }
+
+        gr.uri.len = p - gr.uri.data;
+    }
+
+    if (gr.uri.len == 0) {
+        ngx_log_error(NGX_LOG_ERR, r->connection->log, 0,
+                      "zero length URI to proxy");
+        return NGX_ERROR;
+    }
+
+    u->uri = gr.uri;
+
+    return ngx_http_grpc_init_upstream(r, &gr);
+}
+
+#endif
+
+
 #if (NGX_HTTP_CACHE)
 
 static ngx_int_t
@@ -3356,6 +3520,7 @@ ngx_http_proxy_create_loc_conf(ngx_conf_t *cf)
     conf->upstream.store = NGX_CONF_UNSET;
     conf->upstream.store_access = NGX_CONF_UNSET_UINT;
     conf->upstream.next_upstream_tries = NGX_CONF_UNSET_UINT;
+    conf->upstream.hedge_budget = NGX_CONF_UNSET_UINT;
     conf->upstream.buffering = NGX_CONF_UNSET;
     conf->upstream.request_buffering = NGX_CONF_UNSET;
     conf->upstream.ignore_client_abort = NGX_CONF_UNSET;
@@ -3368,6 +3533,7 @@ ngx_http_proxy_create_loc_conf(ngx_conf_t *cf)
     conf->upstream.send_timeout = NGX_CONF_UNSET_MSEC;
     conf->upstream.read_timeout = NGX_CONF_UNSET_MSEC;
     conf->upstream.next_upstream_timeout = NGX_CONF_UNSET_MSEC;
+    conf->upstream.hedge_after = NGX_CONF_UNSET_MSEC;
 
     conf->upstream.send_lowat = NGX_CONF_UNSET_SIZE;
     conf->upstream.buffer_size = NGX_CONF_UNSET_SIZE;
@@ -3508,6 +3674,12 @@ ngx_http_proxy_merge_loc_conf(ngx_conf_t *cf, void *parent, void *child)
     ngx_conf_merge_msec_value(conf->upstream.next_upstream_timeout,
                               prev->upstream.next_upstream_timeout, 0);
 
+    ngx_conf_merge_msec_value(conf->upstream.hedge_after,
+                              prev->upstream.hedge_after, 0);
+
+    ngx_conf_merge_uint_value(conf->upstream.hedge_budget,
+                              prev->upstream.hedge_budget, 10);
+
     ngx_conf_merge_size_value(conf->upstream.send_lowat,
                               prev->upstream.send_lowat, 0);
 
@@ -3724,6 +3896,43 @@ ngx_http_proxy_merge_loc_conf(ngx_conf_t *cf, void *parent, void *child)
     ngx_conf_merge_value(conf->upstream.intercept_errors,
                               prev->upstream.intercept_errors, 0);
 
+    ngx_conf_merge_uint_value(conf->http_version, prev->http_version,
+                              NGX_HTTP_VERSION_10);
+
+#if (NGX_HTTP_GRPC)
+
+    if (conf->http_version == NGX_HTTP_VERSION_20) {
+
+#if (NGX_HTTP_CACHE)
+        if (conf->upstream.cache) {
+            ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                               "\"proxy_http_version 2\" is incompatible "
+                               "with \"proxy_cache\"");
+            return NGX_CONF_ERROR;
+        }
+#endif
+
+        if (conf->upstream.store) {
+            ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                               "\"proxy_http_version 2\" is incompatible "
+                               "with \"proxy_store\"");
+            return NGX_CONF_ERROR;
+        }
+
+        /* responses are passed to the client as HTTP/2 frames are read */
+
+        conf->upstream.buffering = 0;
+        conf->upstream.change_buffering = 0;
+        conf->upstream.preserve_output = 1;
+        conf->upstream.send_lowat = 0;
+
+        /* streams are not hedged */
+
+        conf->upstream.hedge_after = 0;
+    }
+
+#endif
+
 #if (NGX_HTTP_SSL)
 
     if (ngx_http_proxy_merge_ssl(cf, conf, prev) != NGX_OK) {
@@ -3828,9 +4037,6 @@ ngx_http_proxy_merge_loc_conf(ngx_conf_t *cf, void *parent, void *child)
 
     ngx_conf_merge_ptr_value(conf->cookie_flags, prev->cookie_flags, NULL);
 
-    ngx_conf_merge_uint_value(conf->http_version, prev->http_version,
-                              NGX_HTTP_VERSION_10);
-
     ngx_conf_merge_uint_value(conf->headers_hash_max_size,
                               prev->headers_hash_max_size, 512);
 
@@ -3898,12 +4104,27 @@ ngx_http_proxy_merge_loc_conf(ngx_conf_t *cf, void *parent, void *child)
         }
     }
 
+#if (NGX_HTTP_GRPC)
+
+    if (conf->http_version == NGX_HTTP_VERSION_20 && conf->body_source.data) {
+        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "\"proxy_http_version 2\" is incompatible "
+                           "with \"proxy_set_body\"");
+        return NGX_CONF_ERROR;
+    }
+
+#endif
+
     ngx_conf_merge_ptr_value(conf->headers_source, prev->headers_source, NULL);
 
     if (conf->headers_source == prev->headers_source) {
         conf->headers = prev->headers;
 #if (NGX_HTTP_CACHE)
         conf->headers_cache = prev->headers_cache;
+#endif
+#if (NGX_HTTP_GRPC)
+        conf->headers_v2 = prev->headers_v2;
+        conf->host_set_v2 = prev->host_set_v2;
 #endif
     }
 
@@ -3923,6 +4144,20 @@ ngx_http_proxy_merge_loc_conf(ngx_conf_t *cf, void *parent, void *child)
         }
     }
 
+#endif
+
+#if (NGX_HTTP_GRPC)
+
+    if (conf->http_version == NGX_HTTP_VERSION_20) {
+        rc = ngx_http_grpc_init_headers(cf, conf->headers_source,
+                                        &conf->headers_v2,
+                                        ngx_http_proxy_headers_v2,
+                                        &conf->host_set_v2);
+        if (rc != NGX_OK) {
+            return NGX_CONF_ERROR;
+        }
+    }
+
 #endif
 
     /*
@@ -3936,6 +4171,10 @@ ngx_http_proxy_merge_loc_conf(ngx_conf_t *cf, void *parent, void *child)
         prev->headers = conf->headers;
 #if (NGX_HTTP_CACHE)
         prev->headers_cache = conf->headers_cache;
+#endif
+#if (NGX_HTTP_GRPC)
+        prev->headers_v2 = conf->headers_v2;
+        prev->host_set_v2 = conf->host_set_v2;
 #endif
     }
 
@@ -5067,6 +5306,16 @@ ngx_http_proxy_set_ssl(ngx_conf_t *cf, ngx_http_proxy_loc_conf_t *plcf)
         return NGX_ERROR;
     }
 
+#if (NGX_HTTP_GRPC)
+
+    if (plcf->http_version == NGX_HTTP_VERSION_20
+        && ngx_http_grpc_set_alpn(cf, plcf->upstream.ssl) != NGX_OK)
+    {
+        return NGX_ERROR;
+    }
+
+#endif
+
     if (ngx_ssl_conf_commands(cf, plcf->upstream.ssl, plcf->ssl_conf_commands)
         != NGX_OK)
     {
@@ -0,0 +1,254 @@
+
+/*
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+static ngx_int_t ngx_http_shm_status_handler(ngx_http_request_t *r);
+static ngx_buf_t *ngx_http_shm_status_zone(ngx_http_request_t *r,
+    ngx_shm_zone_t *zone);
+static char *ngx_http_set_shm_status(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf);
+
+
+static ngx_command_t  ngx_http_shm_status_commands[] = {
+
+    { ngx_string("shm_status"),
+      NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_NOARGS,
+      ngx_http_set_shm_status,
+      0,
+      0,
+      NULL },
+
+      ngx_null_command
+};
+
+
+static ngx_http_module_t  ngx_http_shm_status_module_ctx = {
+    NULL,                                  /* preconfiguration */
+    NULL,                                  /* postconfiguration */
+
+    NULL,                                  /* create main configuration */
+    NULL,                                  /* init main configuration */
+
+    NULL,                                  /* create server configuration */
+    NULL,                                  /* merge server configuration */
+
+    NULL,                                  /* create location configuration */
+    NULL                                   /* merge location configuration */
+};
+
+
+ngx_module_t  ngx_http_shm_status_module = {
+    NGX_MODULE_V1,
+    &ngx_http_shm_status_module_ctx,       /* module context */
+    ngx_http_shm_status_commands,          /* module directives */
+    NGX_HTTP_MODULE,                       /* module type */
+    NULL,                                  /* init master */
+    NULL,                                  /* init module */
+    NULL,                                  /* init process */
+    NULL,                                  /* init thread */
+    NULL,                                  /* exit thread */
+    NULL,                                  /* exit process */
+    NULL,                                  /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+static ngx_int_t
+ngx_http_shm_status_handler(ngx_http_request_t *r)
+{
+    off_t             len;
+    ngx_int_t         rc;
+    ngx_buf_t        *b;
+    ngx_uint_t        i;
+    ngx_chain_t      *cl, *out, **ll;
+    ngx_list_part_t  *part;
+    ngx_shm_zone_t   *zone;
+
+    if (!(r->method & (NGX_HTTP_GET|NGX_HTTP_HEAD))) {
+        return NGX_HTTP_NOT_ALLOWED;
+    }
+
+    rc = ngx_http_discard_request_body(r);
+
+    if (rc != NGX_OK) {
+        return rc;
+    }
+
+    r->headers_out.content_type_len = sizeof("text/plain") - 1;
+    ngx_str_set(&r->headers_out.content_type, "text/plain");
+    r->headers_out.content_type_lowcase = NULL;
+
+    cl = NULL;
+    out = NULL;
+    ll = &out;
+    len = 0;
+
+    part = (ngx_list_part_t *) &ngx_cycle->shared_memory.part;
+    zone = part->elts;
+
+    for (i = 0; /* void */ ; i++) {
+
+        if (i >= part->nelts) {
+            if (part->next == NULL) {
+                break;
+            }
+            part = part->next;
+            zone = part->elts;
+            i = 0;
+        }
+
+        if (zone[i].shm.addr == NULL) {
+            continue;
+        }
+
+        b = ngx_http_shm_status_zone(r, &zone[i]);
+        if (b == NULL) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+
+        cl = ngx_alloc_chain_link(r->pool);
+        if (cl == NULL) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+
+        cl->buf = b;
+        *ll = cl;
+        ll = &cl->next;
+
+        len += b->last - b->pos;
+    }
+
+    if (out == NULL) {
+        b = ngx_calloc_buf(r->pool);
+        if (b == NULL) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+
+        cl = ngx_alloc_chain_link(r->pool);
+        if (cl == NULL) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+
+        cl->buf = b;
+        out = cl;
+        ll = &cl->next;
+    }
+
+    *ll = NULL;
+
+    b = cl->buf;
+    b->last_buf = (r == r->main) ? 1 : 0;
+    b->last_in_chain = 1;
+
+    r->headers_out.status = NGX_HTTP_OK;
+    r->headers_out.content_length_n = len;
+
+    rc = ngx_http_send_header(r);
+
+    if (rc == NGX_ERROR || rc > NGX_OK || r->header_only) {
+        return rc;
+    }
+
+    return ngx_http_output_filter(r, out);
+}
+
+
+static ngx_buf_t *
+ngx_http_shm_status_zone(ngx_http_request_t *r, ngx_shm_zone_t *zone)
+{
+    size_t                       size;
+    ngx_buf_t                   *b;
+    ngx_uint_t                   i;
+    ngx_slab_pool_t             *pool;
+    ngx_slab_pool_stat_t         stat;
+#if (NGX_HTTP_CACHE)
+    ngx_int_t                    rc;
+    ngx_http_file_cache_stat_t   cstat;
+#endif
+
+    pool = (ngx_slab_pool_t *) zone->shm.addr;
+
+    if (ngx_slab_pool_stat(pool, &stat, r->pool) != NGX_OK) {
+        return NULL;
+    }
+
+    size = sizeof("zone  size: pages: free: runs: largest:\n") - 1
+           + zone->shm.name.len + 5 * NGX_INT_T_LEN
+           + stat.nslots * (sizeof("   total: used: reqs: fails:\n") - 1
+                            + 5 * NGX_INT_T_LEN)
+           + sizeof("  magazines hits: misses: flushes: cached:\n") - 1
+           + 4 * NGX_INT_T_LEN;
+
+#if (NGX_HTTP_CACHE)
+
+    rc = ngx_http_file_cache_stat(zone, &cstat);
+
+    if (rc == NGX_OK) {
+        size += sizeof("  cache hits: misses: evicted: expired: rejected:\n")
+                - 1 + 5 * NGX_INT_T_LEN;
+    }
+
+#endif
+
+    b = ngx_create_temp_buf(r->pool, size);
+    if (b == NULL) {
+        return NULL;
+    }
+
+    b->last = ngx_sprintf(b->last,
+                          "zone %V size:%uz pages:%ui free:%ui runs:%ui "
+                          "largest:%ui\n",
+                          &zone->shm.name, zone->shm.size, stat.pages,
+                          stat.free, stat.runs, stat.largest);
+
+    for (i = 0; i < stat.nslots; i++) {
+        if (stat.slots[i].total == 0 && stat.slots[i].reqs == 0) {
+            continue;
+        }
+
+        b->last = ngx_sprintf(b->last,
+                              "  %uz total:%ui used:%ui reqs:%ui fails:%ui\n",
+                              (size_t) 1 << (pool->min_shift + i),
+                              stat.slots[i].total, stat.slots[i].used,
+                              stat.slots[i].reqs, stat.slots[i].fails);
+    }
+
+    b->last = ngx_sprintf(b->last,
+                          "  magazines hits:%ui misses:%ui flushes:%ui "
+                          "cached:%ui\n",
+                          stat.magazines.hits, stat.magazines.misses,
+                          stat.magazines.flushes, stat.magazines.cached);
+
+#if (NGX_HTTP_CACHE)
+
+    if (rc == NGX_OK) {
+        b->last = ngx_sprintf(b->last,
+                              "  cache hits:%ui misses:%ui evicted:%ui "
+                              "expired:%ui rejected:%ui\n",
+                              cstat.hits, cstat.misses, cstat.evicted,
+                              cstat.expired, cstat.rejected);
+    }
+
+#endif
+
+    return b;
+}
+
+
+static char *
+ngx_http_set_shm_status(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
+{
+    ngx_http_core_loc_conf_t  *clcf;
+
+    clcf = ngx_http_conf_get_module_loc_conf(cf, ngx_http_core_module);
+    clcf->handler = ngx_http_shm_status_handler;
+
+    return NGX_CONF_OK;
+}
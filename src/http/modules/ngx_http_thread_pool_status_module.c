@@ -0,0 +1,178 @@
+
+/*
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+#include <ngx_thread_pool.h>
+
+
+static ngx_int_t ngx_http_thread_pool_status_handler(ngx_http_request_t *r);
+static u_char *ngx_http_thread_pool_status_bucket(u_char *p, ngx_uint_t n,
+    ngx_uint_t value);
+static char *ngx_http_set_thread_pool_status(ngx_conf_t *cf,
+    ngx_command_t *cmd, void *conf);
+
+
+static ngx_command_t  ngx_http_thread_pool_status_commands[] = {
+
+    { ngx_string("thread_pool_status"),
+      NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_NOARGS,
+      ngx_http_set_thread_pool_status,
+      0,
+      0,
+      NULL },
+
+      ngx_null_command
+};
+
+
+static ngx_http_module_t  ngx_http_thread_pool_status_module_ctx = {
+    NULL,                                  /* preconfiguration */
+    NULL,                                  /* postconfiguration */
+
+    NULL,                                  /* create main configuration */
+    NULL,                                  /* init main configuration */
+
+    NULL,                                  /* create server configuration */
+    NULL,                                  /* merge server configuration */
+
+    NULL,                                  /* create location configuration */
+    NULL                                   /* merge location configuration */
+};
+
+
+ngx_module_t  ngx_http_thread_pool_status_module = {
+    NGX_MODULE_V1,
+    &ngx_http_thread_pool_status_module_ctx, /* module context */
+    ngx_http_thread_pool_status_commands,  /* module directives */
+    NGX_HTTP_MODULE,                       /* module type */
+    NULL,                                  /* init master */
+    NULL,                                  /* init module */
+    NULL,                                  /* init process */
+    NULL,                                  /* init thread */
+    NULL,                                  /* exit thread */
+    NULL,                                  /* exit process */
+    NULL,                                  /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+static ngx_int_t
+ngx_http_thread_pool_status_handler(ngx_http_request_t *r)
+{
+    size_t                   size;
+    ngx_int_t                rc;
+    ngx_buf_t               *b;
+    ngx_uint_t               i, n;
+    ngx_chain_t              out;
+    ngx_array_t             *stats;
+    ngx_thread_pool_stat_t  *st;
+
+    if (!(r->method & (NGX_HTTP_GET|NGX_HTTP_HEAD))) {
+        return NGX_HTTP_NOT_ALLOWED;
+    }
+
+    rc = ngx_http_discard_request_body(r);
+
+    if (rc != NGX_OK) {
+        return rc;
+    }
+
+    r->headers_out.content_type_len = sizeof("text/plain") - 1;
+    ngx_str_set(&r->headers_out.content_type, "text/plain");
+    r->headers_out.content_type_lowcase = NULL;
+
+    stats = ngx_thread_pool_stats((ngx_cycle_t *) ngx_cycle, r->pool);
+    if (stats == NULL) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+
+    st = stats->elts;
+
+    size = sizeof("pid \n") - 1 + NGX_INT64_LEN;
+
+    for (i = 0; i < stats->nelts; i++) {
+        size += sizeof("pool  threads: queue:/ tasks:\n") - 1
+                + st[i].name->len + 4 * NGX_INT_T_LEN
+                + 2 * (sizeof("  wait\n") - 1
+                       + NGX_THREAD_POOL_BUCKETS
+                         * (sizeof("  :") - 1 + 2 * NGX_INT_T_LEN));
+    }
+
+    b = ngx_create_temp_buf(r->pool, size);
+    if (b == NULL) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+
+    out.buf = b;
+    out.next = NULL;
+
+    /* thread pools are per worker, so are the numbers */
+
+    b->last = ngx_sprintf(b->last, "pid %P\n", ngx_pid);
+
+    for (i = 0; i < stats->nelts; i++) {
+        b->last = ngx_sprintf(b->last,
+                              "pool %V threads:%ui queue:%ui/%ui tasks:%ui\n",
+                              st[i].name, st[i].threads, st[i].queue,
+                              st[i].max_queue, st[i].tasks);
+
+        b->last = ngx_cpymem(b->last, "  wait", sizeof("  wait") - 1);
+
+        for (n = 0; n < NGX_THREAD_POOL_BUCKETS; n++) {
+            b->last = ngx_http_thread_pool_status_bucket(b->last, n,
+                                                         st[i].wait[n]);
+        }
+
+        b->last = ngx_cpymem(b->last, "\n  exec", sizeof("\n  exec") - 1);
+
+        for (n = 0; n < NGX_THREAD_POOL_BUCKETS; n++) {
+            b->last = ngx_http_thread_pool_status_bucket(b->last, n,
+                                                         st[i].exec[n]);
+        }
+
+        *b->last++ = '\n';
+    }
+
+    r->headers_out.status = NGX_HTTP_OK;
+    r->headers_out.content_length_n = b->last - b->pos;
+
+    b->last_buf = (r == r->main) ? 1 : 0;
+    b->last_in_chain = 1;
+
+    rc = ngx_http_send_header(r);
+
+    if (rc == NGX_ERROR || rc > NGX_OK || r->header_only) {
+        return rc;
+    }
+
+    return ngx_http_output_filter(r, &out);
+}
+
+
+static u_char *
+ngx_http_thread_pool_status_bucket(u_char *p, ngx_uint_t n, ngx_uint_t value)
+{
+    if (n == NGX_THREAD_POOL_BUCKETS - 1) {
+        return ngx_sprintf(p, " inf:%ui", value);
+    }
+
+    return ngx_sprintf(p, " %uL:%ui", (uint64_t) 16 << (2 * n), value);
+}
+
+
+static char *
+ngx_http_set_thread_pool_status(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf)
+{
+    ngx_http_core_loc_conf_t  *clcf;
+
+    clcf = ngx_http_conf_get_module_loc_conf(cf, ngx_http_core_module);
+    clcf->handler = ngx_http_thread_pool_status_handler;
+
+    return NGX_CONF_OK;
+}
@@ -22,9 +22,21 @@ typedef struct {
 } ngx_http_upstream_chash_points_t;
 
 
+typedef struct {
+    ngx_uint_t                          number;
+    uint16_t                            entry[1];
+} ngx_http_upstream_maglev_t;
+
+
 typedef struct {
     ngx_http_complex_value_t            key;
     ngx_http_upstream_chash_points_t   *points;
+    ngx_http_upstream_maglev_t         *maglev;
+    ngx_uint_t                          bounded;
+
+    /* per worker index of the peers referenced by the maglev table */
+    ngx_http_upstream_rr_peers_t       *peers;
+    ngx_http_upstream_rr_peer_t       **peer;
 } ngx_http_upstream_hash_srv_conf_t;
 
 
@@ -58,6 +70,19 @@ static ngx_int_t ngx_http_upstream_init_chash_peer(ngx_http_request_t *r,
 static ngx_int_t ngx_http_upstream_get_chash_peer(ngx_peer_connection_t *pc,
     void *data);
 
+static ngx_int_t ngx_http_upstream_init_maglev(ngx_conf_t *cf,
+    ngx_http_upstream_srv_conf_t *us);
+static ngx_int_t ngx_http_upstream_init_maglev_peer(ngx_http_request_t *r,
+    ngx_http_upstream_srv_conf_t *us);
+static ngx_int_t ngx_http_upstream_get_maglev_peer(ngx_peer_connection_t *pc,
+    void *data);
+
+static ngx_uint_t ngx_http_upstream_hash_conns(
+    ngx_http_upstream_rr_peers_t *peers);
+static ngx_uint_t ngx_http_upstream_hash_overloaded(
+    ngx_http_upstream_hash_peer_data_t *hp, ngx_http_upstream_rr_peer_t *peer,
+    ngx_uint_t conns);
+
 static void *ngx_http_upstream_hash_create_conf(ngx_conf_t *cf);
 static char *ngx_http_upstream_hash(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
@@ -66,7 +91,7 @@ static char *ngx_http_upstream_hash(ngx_conf_t *cf, ngx_command_t *cmd,
 static ngx_command_t  ngx_http_upstream_hash_commands[] = {
 
     { ngx_string("hash"),
-      NGX_HTTP_UPS_CONF|NGX_CONF_TAKE12,
+      NGX_HTTP_UPS_CONF|NGX_CONF_TAKE123,
       ngx_http_upstream_hash,
       NGX_HTTP_SRV_CONF_OFFSET,
       0,
@@ -498,7 +523,7 @@ ngx_http_upstream_get_chash_peer(ngx_peer_connection_t *pc, void *data)
     intptr_t                            m;
     ngx_str_t                          *server;
     ngx_int_t                           total;
-    ngx_uint_t                          i, n, best_i;
+    ngx_uint_t                          i, n, best_i, conns;
     ngx_http_upstream_rr_peer_t        *peer, *best;
     ngx_http_upstream_chash_point_t    *point;
     ngx_http_upstream_chash_points_t   *points;
@@ -523,6 +548,8 @@ ngx_http_upstream_get_chash_peer(ngx_peer_connection_t *pc, void *data)
     points = hcf->points;
     point = &points->point[0];
 
+    conns = hcf->bounded ? ngx_http_upstream_hash_conns(hp->rrp.peers) : 0;
+
     for ( ;; ) {
         server = point[hp->hash % points->number].server;
 
@@ -560,6 +587,12 @@ ngx_http_upstream_get_chash_peer(ngx_peer_connection_t *pc, void *data)
                 continue;
             }
 
+            if (hcf->bounded
+                && ngx_http_upstream_hash_overloaded(hp, peer, conns))
+            {
+                continue;
+            }
+
             if (peer->server.len != server->len
                 || ngx_strncmp(peer->server.data, server->data, server->len)
                    != 0)
@@ -619,6 +652,299 @@ found:
 }
 
 
+static ngx_int_t
+ngx_http_upstream_init_maglev(ngx_conf_t *cf, ngx_http_upstream_srv_conf_t *us)
+{
+    size_t                              size;
+    uint32_t                           *offset, *skip, *next;
+    ngx_uint_t                          i, j, k, w, n, number, filled;
+    ngx_http_upstream_rr_peer_t        *peer;
+    ngx_http_upstream_rr_peers_t       *peers;
+    ngx_http_upstream_maglev_t         *maglev;
+    ngx_http_upstream_hash_srv_conf_t  *hcf;
+
+    if (ngx_http_upstream_init_round_robin(cf, us) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    us->peer.init = ngx_http_upstream_init_maglev_peer;
+
+    peers = us->peer.data;
+    n = peers->number;
+
+    if (n > 0xffff) {
+        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "too many servers for maglev in upstream \"%V\"",
+                           &us->host);
+        return NGX_ERROR;
+    }
+
+    /*
+     * the table size is the first prime not less than 100 entries
+     * per weight unit, which keeps the load imbalance within about 1%
+     */
+
+    for (number = ngx_max(peers->total_weight * 100, 101); /* void */;
+         number++)
+    {
+        for (k = 2; k * k <= number; k++) {
+            if (number % k == 0) {
+                break;
+            }
+        }
+
+        if (k * k > number) {
+            break;
+        }
+    }
+
+    size = sizeof(ngx_http_upstream_maglev_t) + sizeof(uint16_t) * (number - 1);
+
+    maglev = ngx_palloc(cf->pool, size);
+    if (maglev == NULL) {
+        return NGX_ERROR;
+    }
+
+    maglev->number = number;
+
+    offset = ngx_palloc(cf->temp_pool, 3 * n * sizeof(uint32_t));
+    if (offset == NULL) {
+        return NGX_ERROR;
+    }
+
+    skip = offset + n;
+    next = skip + n;
+
+    for (peer = peers->peer, i = 0; peer; peer = peer->next, i++) {
+        offset[i] = ngx_crc32_long(peer->server.data, peer->server.len)
+                    % number;
+        skip[i] = ngx_murmur_hash2(peer->server.data, peer->server.len)
+                  % (number - 1) + 1;
+        next[i] = 0;
+    }
+
+    /*
+     * each peer takes its next preferred free entry in turn,
+     * "weight" entries per round
+     */
+
+    ngx_memset(maglev->entry, 0xff, sizeof(uint16_t) * number);
+
+    filled = 0;
+
+    for ( ;; ) {
+        for (peer = peers->peer, i = 0; peer; peer = peer->next, i++) {
+
+            for (w = 0; w < (ngx_uint_t) peer->weight; w++) {
+
+                do {
+                    j = (offset[i] + (uint64_t) next[i] * skip[i]) % number;
+                    next[i]++;
+                } while (maglev->entry[j] != 0xffff);
+
+                maglev->entry[j] = (uint16_t) i;
+
+                if (++filled == number) {
+                    goto done;
+                }
+            }
+        }
+    }
+
+done:
+
+    hcf = ngx_http_conf_upstream_srv_conf(us, ngx_http_upstream_hash_module);
+    hcf->maglev = maglev;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_init_maglev_peer(ngx_http_request_t *r,
+    ngx_http_upstream_srv_conf_t *us)
+{
+    ngx_http_upstream_hash_peer_data_t  *hp;
+
+    if (ngx_http_upstream_init_hash_peer(r, us) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    r->upstream->peer.get = ngx_http_upstream_get_maglev_peer;
+
+    hp = r->upstream->peer.data;
+
+    hp->hash = ngx_crc32_long(hp->key.data, hp->key.len);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_get_maglev_peer(ngx_peer_connection_t *pc, void *data)
+{
+    ngx_http_upstream_hash_peer_data_t  *hp = data;
+
+    time_t                              now;
+    uintptr_t                           m;
+    ngx_uint_t                          i, n, conns;
+    ngx_http_upstream_rr_peer_t        *peer;
+    ngx_http_upstream_rr_peers_t       *peers;
+    ngx_http_upstream_maglev_t         *maglev;
+    ngx_http_upstream_hash_srv_conf_t  *hcf;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                   "get maglev hash peer, try: %ui", pc->tries);
+
+    ngx_http_upstream_rr_peers_rlock(hp->rrp.peers);
+
+    if (hp->tries > 20 || hp->rrp.peers->single || hp->key.len == 0) {
+        ngx_http_upstream_rr_peers_unlock(hp->rrp.peers);
+        return hp->get_rr_peer(pc, &hp->rrp);
+    }
+
+    hcf = hp->conf;
+    peers = hp->rrp.peers;
+
+    if (hcf->peers != peers) {
+
+        /*
+         * peers are moved to shared memory with the zone,
+         * so the index is built by each worker on first use
+         */
+
+        hcf->peer = ngx_palloc(ngx_cycle->pool,
+                               peers->number * sizeof(void *));
+        if (hcf->peer == NULL) {
+            hcf->peers = NULL;
+            ngx_http_upstream_rr_peers_unlock(peers);
+            return hp->get_rr_peer(pc, &hp->rrp);
+        }
+
+        for (peer = peers->peer, i = 0; peer; peer = peer->next, i++) {
+            hcf->peer[i] = peer;
+        }
+
+        hcf->peers = peers;
+    }
+
+    pc->cached = 0;
+    pc->connection = NULL;
+
+    now = ngx_time();
+    maglev = hcf->maglev;
+
+    conns = hcf->bounded ? ngx_http_upstream_hash_conns(peers) : 0;
+
+    for ( ;; ) {
+        i = maglev->entry[hp->hash % maglev->number];
+        peer = hcf->peer[i];
+
+        ngx_log_debug2(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                       "maglev hash peer:%uD, peer:%ui", hp->hash, i);
+
+        n = i / (8 * sizeof(uintptr_t));
+        m = (uintptr_t) 1 << i % (8 * sizeof(uintptr_t));
+
+        if (hp->rrp.tried[n] & m) {
+            goto next;
+        }
+
+        ngx_http_upstream_rr_peer_lock(peers, peer);
+
+        if (peer->down) {
+            ngx_http_upstream_rr_peer_unlock(peers, peer);
+            goto next;
+        }
+
+        if (peer->max_fails
+            && peer->fails >= peer->max_fails
+            && now - peer->checked <= peer->fail_timeout)
+        {
+            ngx_http_upstream_rr_peer_unlock(peers, peer);
+            goto next;
+        }
+
+        if (peer->max_conns && peer->conns >= peer->max_conns) {
+            ngx_http_upstream_rr_peer_unlock(peers, peer);
+            goto next;
+        }
+
+        if (hcf->bounded
+            && ngx_http_upstream_hash_overloaded(hp, peer, conns))
+        {
+            ngx_http_upstream_rr_peer_unlock(peers, peer);
+            goto next;
+        }
+
+        break;
+
+    next:
+
+        /* neighbouring entries belong to unrelated peers */
+
+        hp->hash++;
+
+        if (++hp->tries > 20) {
+            ngx_http_upstream_rr_peers_unlock(peers);
+            return hp->get_rr_peer(pc, &hp->rrp);
+        }
+    }
+
+    hp->rrp.current = peer;
+
+    pc->sockaddr = peer->sockaddr;
+    pc->socklen = peer->socklen;
+    pc->name = &peer->name;
+
+    peer->conns++;
+
+    if (now - peer->checked > peer->fail_timeout) {
+        peer->checked = now;
+    }
+
+    ngx_http_upstream_rr_peer_unlock(peers, peer);
+    ngx_http_upstream_rr_peers_unlock(peers);
+
+    hp->rrp.tried[n] |= m;
+
+    return NGX_OK;
+}
+
+
+static ngx_uint_t
+ngx_http_upstream_hash_conns(ngx_http_upstream_rr_peers_t *peers)
+{
+    ngx_uint_t                    conns;
+    ngx_http_upstream_rr_peer_t  *peer;
+
+    /* an approximation, the peers are not locked */
+
+    conns = 0;
+
+    for (peer = peers->peer; peer; peer = peer->next) {
+        conns += peer->conns;
+    }
+
+    return conns;
+}
+
+
+static ngx_uint_t
+ngx_http_upstream_hash_overloaded(ngx_http_upstream_hash_peer_data_t *hp,
+    ngx_http_upstream_rr_peer_t *peer, ngx_uint_t conns)
+{
+    /*
+     * consistent hashing with bounded loads: a peer may have at most
+     * "bounded" times its weighted share of all active connections,
+     * including the one being selected
+     */
+
+    return (uint64_t) peer->conns * hp->rrp.peers->total_weight * 100
+           >= (uint64_t) hp->conf->bounded * (conns + 1) * peer->weight;
+}
+
+
 static void *
 ngx_http_upstream_hash_create_conf(ngx_conf_t *cf)
 {
@@ -630,6 +956,10 @@ ngx_http_upstream_hash_create_conf(ngx_conf_t *cf)
     }
 
     conf->points = NULL;
+    conf->maglev = NULL;
+    conf->bounded = 0;
+    conf->peers = NULL;
+    conf->peer = NULL;
 
     return conf;
 }
@@ -640,7 +970,9 @@ ngx_http_upstream_hash(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 {
     ngx_http_upstream_hash_srv_conf_t  *hcf = conf;
 
+    ngx_int_t                          bounded;
     ngx_str_t                         *value;
+    ngx_uint_t                         i;
     ngx_http_upstream_srv_conf_t      *uscf;
     ngx_http_compile_complex_value_t   ccv;
 
@@ -670,15 +1002,45 @@ ngx_http_upstream_hash(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
                   |NGX_HTTP_UPSTREAM_FAIL_TIMEOUT
                   |NGX_HTTP_UPSTREAM_DOWN;
 
-    if (cf->args->nelts == 2) {
-        uscf->peer.init_upstream = ngx_http_upstream_init_hash;
+    uscf->peer.init_upstream = ngx_http_upstream_init_hash;
 
-    } else if (ngx_strcmp(value[2].data, "consistent") == 0) {
-        uscf->peer.init_upstream = ngx_http_upstream_init_chash;
+    for (i = 2; i < cf->args->nelts; i++) {
 
-    } else {
+        if (i == 2 && ngx_strcmp(value[i].data, "consistent") == 0) {
+            uscf->peer.init_upstream = ngx_http_upstream_init_chash;
+            continue;
+        }
+
+        if (i == 2 && ngx_strcmp(value[i].data, "maglev") == 0) {
+            uscf->peer.init_upstream = ngx_http_upstream_init_maglev;
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "bounded=", 8) == 0) {
+
+            bounded = ngx_atofp(value[i].data + 8, value[i].len - 8, 2);
+
+            if (bounded == NGX_ERROR || bounded < 100) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid load bound \"%V\"", &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            hcf->bounded = bounded;
+            continue;
+        }
+
+        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "invalid parameter \"%V\"", &value[i]);
+        return NGX_CONF_ERROR;
+    }
+
+    if (hcf->bounded
+        && uscf->peer.init_upstream == ngx_http_upstream_init_hash)
+    {
         ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
-                           "invalid parameter \"%V\"", &value[2]);
+                           "\"bounded\" requires \"consistent\" "
+                           "or \"maglev\"");
         return NGX_CONF_ERROR;
     }
 
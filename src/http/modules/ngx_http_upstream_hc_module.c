@@ -0,0 +1,786 @@
+
+/*
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+#define NGX_HTTP_UPSTREAM_HC_TCP   0
+#define NGX_HTTP_UPSTREAM_HC_HTTP  1
+
+#define NGX_HTTP_UPSTREAM_HC_BUFFER  64
+
+
+typedef struct {
+    ngx_msec_t                        interval;
+    ngx_msec_t                        timeout;
+    ngx_uint_t                        fails;
+    ngx_uint_t                        passes;
+    ngx_uint_t                        concurrency;
+    ngx_uint_t                        type;
+    ngx_str_t                         request;
+} ngx_http_upstream_hc_srv_conf_t;
+
+
+typedef struct ngx_http_upstream_hc_s  ngx_http_upstream_hc_t;
+
+typedef struct {
+    ngx_http_upstream_hc_t           *hc;
+    ngx_http_upstream_rr_peers_t     *peers;
+    ngx_http_upstream_rr_peer_t      *peer;
+
+    ngx_peer_connection_t             pc;
+    ngx_buf_t                         buffer;
+    size_t                            sent;
+
+    ngx_uint_t                        fails;
+    ngx_uint_t                        passes;
+} ngx_http_upstream_hc_peer_t;
+
+
+struct ngx_http_upstream_hc_s {
+    ngx_http_upstream_hc_srv_conf_t  *conf;
+    ngx_str_t                        *upstream;
+
+    ngx_event_t                       event;
+    ngx_event_t                       post;
+    ngx_log_t                         log;
+
+    ngx_http_upstream_hc_peer_t      *peers;
+    ngx_uint_t                        npeers;
+    ngx_uint_t                        next;
+    ngx_uint_t                        running;
+};
+
+
+static ngx_int_t ngx_http_upstream_hc_init_process(ngx_cycle_t *cycle);
+static ngx_int_t ngx_http_upstream_hc_init_upstream(ngx_cycle_t *cycle,
+    ngx_http_upstream_srv_conf_t *uscf);
+static void ngx_http_upstream_hc_handler(ngx_event_t *ev);
+static void ngx_http_upstream_hc_post_handler(ngx_event_t *ev);
+static void ngx_http_upstream_hc_next(ngx_http_upstream_hc_t *hc);
+static void ngx_http_upstream_hc_start(ngx_http_upstream_hc_peer_t *hp);
+static void ngx_http_upstream_hc_write_handler(ngx_event_t *wev);
+static void ngx_http_upstream_hc_read_handler(ngx_event_t *rev);
+static void ngx_http_upstream_hc_dummy_handler(ngx_event_t *ev);
+static void ngx_http_upstream_hc_done(ngx_http_upstream_hc_peer_t *hp,
+    ngx_uint_t ok);
+static ngx_int_t ngx_http_upstream_hc_postconfiguration(ngx_conf_t *cf);
+static void *ngx_http_upstream_hc_create_conf(ngx_conf_t *cf);
+static char *ngx_http_upstream_hc(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf);
+
+
+static ngx_command_t  ngx_http_upstream_hc_commands[] = {
+
+    { ngx_string("health_check"),
+      NGX_HTTP_UPS_CONF|NGX_CONF_ANY,
+      ngx_http_upstream_hc,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      0,
+      NULL },
+
+      ngx_null_command
+};
+
+
+static ngx_http_module_t  ngx_http_upstream_hc_module_ctx = {
+    NULL,                                  /* preconfiguration */
+    ngx_http_upstream_hc_postconfiguration, /* postconfiguration */
+
+    NULL,                                  /* create main configuration */
+    NULL,                                  /* init main configuration */
+
+    ngx_http_upstream_hc_create_conf,      /* create server configuration */
+    NULL,                                  /* merge server configuration */
+
+    NULL,                                  /* create location configuration */
+    NULL                                   /* merge location configuration */
+};
+
+
+ngx_module_t  ngx_http_upstream_hc_module = {
+    NGX_MODULE_V1,
+    &ngx_http_upstream_hc_module_ctx,      /* module context */
+    ngx_http_upstream_hc_commands,         /* module directives */
+    NGX_HTTP_MODULE,                       /* module type */
+    NULL,                                  /* init master */
+    NULL,                                  /* init module */
+    ngx_http_upstream_hc_init_process,     /* init process */
+    NULL,                                  /* init thread */
+    NULL,                                  /* exit thread */
+    NULL,                                  /* exit process */
+    NULL,                                  /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+static ngx_int_t
+ngx_http_upstream_hc_init_process(ngx_cycle_t *cycle)
+{
+    ngx_uint_t                        i;
+    ngx_http_upstream_srv_conf_t    **uscfp;
+    ngx_http_upstream_main_conf_t    *umcf;
+    ngx_http_upstream_hc_srv_conf_t  *hccf;
+
+    /* checks are run by a single worker, results are kept in the zone */
+
+    if (ngx_process != NGX_PROCESS_WORKER
+        && ngx_process != NGX_PROCESS_SINGLE)
+    {
+        return NGX_OK;
+    }
+
+    if (ngx_worker != 0) {
+        return NGX_OK;
+    }
+
+    umcf = ngx_http_cycle_get_module_main_conf(cycle, ngx_http_upstream_module);
+    if (umcf == NULL) {
+        return NGX_OK;
+    }
+
+    uscfp = umcf->upstreams.elts;
+
+    for (i = 0; i < umcf->upstreams.nelts; i++) {
+
+        if (uscfp[i]->srv_conf == NULL || uscfp[i]->shm_zone == NULL) {
+            continue;
+        }
+
+        hccf = ngx_http_conf_upstream_srv_conf(uscfp[i],
+                                               ngx_http_upstream_hc_module);
+
+        if (hccf->interval == NGX_CONF_UNSET_MSEC) {
+            continue;
+        }
+
+        if (ngx_http_upstream_hc_init_upstream(cycle, uscfp[i]) != NGX_OK) {
+            return NGX_ERROR;
+        }
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_hc_init_upstream(ngx_cycle_t *cycle,
+    ngx_http_upstream_srv_conf_t *uscf)
+{
+    u_char                        *p;
+    ngx_uint_t                     n;
+    ngx_http_upstream_hc_t        *hc;
+    ngx_http_upstream_rr_peer_t   *peer;
+    ngx_http_upstream_rr_peers_t  *peers, *pp;
+    ngx_http_upstream_hc_peer_t   *hp;
+
+    peers = uscf->peer.data;
+
+    n = 0;
+
+    for (pp = peers; pp; pp = pp->next) {
+        for (peer = pp->peer; peer; peer = peer->next) {
+            if (!peer->down) {
+                n++;
+            }
+        }
+    }
+
+    if (n == 0) {
+        return NGX_OK;
+    }
+
+    hc = ngx_pcalloc(cycle->pool, sizeof(ngx_http_upstream_hc_t));
+    if (hc == NULL) {
+        return NGX_ERROR;
+    }
+
+    hp = ngx_pcalloc(cycle->pool, n * sizeof(ngx_http_upstream_hc_peer_t));
+    if (hp == NULL) {
+        return NGX_ERROR;
+    }
+
+    p = ngx_palloc(cycle->pool, n * NGX_HTTP_UPSTREAM_HC_BUFFER);
+    if (p == NULL) {
+        return NGX_ERROR;
+    }
+
+    hc->conf = ngx_http_conf_upstream_srv_conf(uscf,
+                                               ngx_http_upstream_hc_module);
+    hc->upstream = &uscf->host;
+    hc->peers = hp;
+    hc->npeers = n;
+
+    hc->log = *cycle->log;
+    hc->log.action = "checking upstream health";
+
+    for (pp = peers; pp; pp = pp->next) {
+        for (peer = pp->peer; peer; peer = peer->next) {
+            if (peer->down) {
+                continue;
+            }
+
+            hp->hc = hc;
+            hp->peers = pp;
+            hp->peer = peer;
+
+            hp->buffer.start = p;
+            hp->buffer.end = p + NGX_HTTP_UPSTREAM_HC_BUFFER;
+            p += NGX_HTTP_UPSTREAM_HC_BUFFER;
+
+            hp++;
+        }
+    }
+
+    hc->event.handler = ngx_http_upstream_hc_handler;
+    hc->event.data = hc;
+    hc->event.log = &hc->log;
+    hc->event.cancelable = 1;
+
+    hc->post.handler = ngx_http_upstream_hc_post_handler;
+    hc->post.data = hc;
+    hc->post.log = &hc->log;
+
+    ngx_add_timer(&hc->event, 0);
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_http_upstream_hc_handler(ngx_event_t *ev)
+{
+    ngx_http_upstream_hc_t  *hc;
+
+    hc = ev->data;
+
+    if (ngx_exiting || ngx_terminate || ngx_quit) {
+        return;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ev->log, 0,
+                   "health check upstream \"%V\"", hc->upstream);
+
+    hc->next = 0;
+
+    ngx_http_upstream_hc_next(hc);
+}
+
+
+static void
+ngx_http_upstream_hc_post_handler(ngx_event_t *ev)
+{
+    ngx_http_upstream_hc_next(ev->data);
+}
+
+
+static void
+ngx_http_upstream_hc_next(ngx_http_upstream_hc_t *hc)
+{
+    while (hc->running < hc->conf->concurrency && hc->next < hc->npeers) {
+
+        if (ngx_exiting || ngx_terminate || ngx_quit) {
+            return;
+        }
+
+        ngx_http_upstream_hc_start(&hc->peers[hc->next++]);
+    }
+
+    if (hc->running == 0 && hc->next == hc->npeers
+        && !(ngx_exiting || ngx_terminate || ngx_quit))
+    {
+        ngx_add_timer(&hc->event, hc->conf->interval);
+    }
+}
+
+
+static void
+ngx_http_upstream_hc_start(ngx_http_upstream_hc_peer_t *hp)
+{
+    ngx_int_t                 rc;
+    ngx_connection_t         *c;
+    ngx_http_upstream_hc_t   *hc;
+
+    hc = hp->hc;
+
+    ngx_memzero(&hp->pc, sizeof(ngx_peer_connection_t));
+
+    hp->pc.sockaddr = hp->peer->sockaddr;
+    hp->pc.socklen = hp->peer->socklen;
+    hp->pc.name = &hp->peer->name;
+    hp->pc.get = ngx_event_get_peer;
+    hp->pc.log = &hc->log;
+    hp->pc.log_error = NGX_ERROR_ERR;
+
+    hp->buffer.pos = hp->buffer.start;
+    hp->buffer.last = hp->buffer.start;
+    hp->sent = 0;
+
+    hc->running++;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, &hc->log, 0,
+                   "health check peer %V", hp->pc.name);
+
+    rc = ngx_event_connect_peer(&hp->pc);
+
+    if (rc == NGX_ERROR || rc == NGX_BUSY || rc == NGX_DECLINED) {
+        ngx_http_upstream_hc_done(hp, 0);
+        return;
+    }
+
+    c = hp->pc.connection;
+
+    c->data = hp;
+    c->idle = 1;
+    c->read->cancelable = 1;
+    c->write->cancelable = 1;
+    c->read->handler = ngx_http_upstream_hc_read_handler;
+    c->write->handler = ngx_http_upstream_hc_write_handler;
+
+    if (rc == NGX_AGAIN) {
+        ngx_add_timer(c->write, hc->conf->timeout);
+        return;
+    }
+
+    ngx_http_upstream_hc_write_handler(c->write);
+}
+
+
+static void
+ngx_http_upstream_hc_write_handler(ngx_event_t *wev)
+{
+    ssize_t                       n;
+    ngx_str_t                    *request;
+    ngx_connection_t             *c;
+    ngx_http_upstream_hc_peer_t  *hp;
+
+    c = wev->data;
+    hp = c->data;
+
+    if (wev->timedout) {
+        ngx_log_error(NGX_LOG_ERR, c->log, NGX_ETIMEDOUT,
+                      "health check of %V timed out", hp->pc.name);
+        ngx_http_upstream_hc_done(hp, 0);
+        return;
+    }
+
+    if (hp->sent == 0 && ngx_http_upstream_test_connect(c) != NGX_OK) {
+        ngx_http_upstream_hc_done(hp, 0);
+        return;
+    }
+
+    if (hp->hc->conf->type == NGX_HTTP_UPSTREAM_HC_TCP) {
+        ngx_http_upstream_hc_done(hp, 1);
+        return;
+    }
+
+    request = &hp->hc->conf->request;
+
+    while (hp->sent < request->len) {
+        n = c->send(c, request->data + hp->sent, request->len - hp->sent);
+
+        if (n == NGX_ERROR) {
+            ngx_http_upstream_hc_done(hp, 0);
+            return;
+        }
+
+        if (n == NGX_AGAIN) {
+            if (!wev->timer_set) {
+                ngx_add_timer(wev, hp->hc->conf->timeout);
+            }
+
+            if (ngx_handle_write_event(wev, 0) != NGX_OK) {
+                ngx_http_upstream_hc_done(hp, 0);
+            }
+
+            return;
+        }
+
+        hp->sent += n;
+    }
+
+    if (wev->timer_set) {
+        ngx_del_timer(wev);
+    }
+
+    wev->handler = ngx_http_upstream_hc_dummy_handler;
+
+    ngx_add_timer(c->read, hp->hc->conf->timeout);
+
+    if (c->read->ready) {
+        ngx_http_upstream_hc_read_handler(c->read);
+        return;
+    }
+
+    if (ngx_handle_read_event(c->read, 0) != NGX_OK) {
+        ngx_http_upstream_hc_done(hp, 0);
+    }
+}
+
+
+static void
+ngx_http_upstream_hc_read_handler(ngx_event_t *rev)
+{
+    u_char                       *p;
+    ssize_t                       n;
+    ngx_int_t                     status;
+    ngx_buf_t                    *b;
+    ngx_connection_t             *c;
+    ngx_http_upstream_hc_peer_t  *hp;
+
+    c = rev->data;
+    hp = c->data;
+    b = &hp->buffer;
+
+    if (c->close) {
+        /* graceful shutdown, see ngx_close_idle_connections() */
+        ngx_close_connection(c);
+        hp->pc.connection = NULL;
+        hp->hc->running--;
+        return;
+    }
+
+    if (rev->timedout) {
+        ngx_log_error(NGX_LOG_ERR, c->log, NGX_ETIMEDOUT,
+                      "health check of %V timed out", hp->pc.name);
+        ngx_http_upstream_hc_done(hp, 0);
+        return;
+    }
+
+    while (b->last - b->pos < (ssize_t) sizeof("HTTP/1.x 200") - 1) {
+
+        n = c->recv(c, b->last, b->end - b->last);
+
+        if (n == NGX_AGAIN) {
+            if (ngx_handle_read_event(rev, 0) != NGX_OK) {
+                ngx_http_upstream_hc_done(hp, 0);
+            }
+
+            return;
+        }
+
+        if (n == NGX_ERROR || n == 0) {
+            ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                          "health check of %V: upstream prematurely closed "
+                          "connection", hp->pc.name);
+            ngx_http_upstream_hc_done(hp, 0);
+            return;
+        }
+
+        b->last += n;
+    }
+
+    p = b->pos;
+
+    if (ngx_strncmp(p, "HTTP/1.", sizeof("HTTP/1.") - 1) != 0
+        || p[8] != ' ')
+    {
+        ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                      "health check of %V: upstream sent invalid status line",
+                      hp->pc.name);
+        ngx_http_upstream_hc_done(hp, 0);
+        return;
+    }
+
+    status = ngx_atoi(p + 9, 3);
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "health check peer %V status %i", hp->pc.name, status);
+
+    if (status < 200 || status >= 400) {
+        ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                      "health check of %V: upstream returned status %i",
+                      hp->pc.name, status);
+        ngx_http_upstream_hc_done(hp, 0);
+        return;
+    }
+
+    ngx_http_upstream_hc_done(hp, 1);
+}
+
+
+static void
+ngx_http_upstream_hc_dummy_handler(ngx_event_t *ev)
+{
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, ev->log, 0,
+                   "health check dummy handler");
+}
+
+
+static void
+ngx_http_upstream_hc_done(ngx_http_upstream_hc_peer_t *hp, ngx_uint_t ok)
+{
+    ngx_http_upstream_hc_t        *hc;
+    ngx_http_upstream_rr_peer_t   *peer;
+    ngx_http_upstream_rr_peers_t  *peers;
+
+    hc = hp->hc;
+    peer = hp->peer;
+    peers = hp->peers;
+
+    if (hp->pc.connection) {
+        ngx_close_connection(hp->pc.connection);
+        hp->pc.connection = NULL;
+    }
+
+    ngx_http_upstream_rr_peers_rlock(peers);
+    ngx_http_upstream_rr_peer_lock(peers, peer);
+
+    if (ok) {
+        hp->fails = 0;
+
+        if ((peer->down & NGX_HTTP_UPSTREAM_RR_UNHEALTHY)
+            && ++hp->passes >= hc->conf->passes)
+        {
+            peer->down &= ~NGX_HTTP_UPSTREAM_RR_UNHEALTHY;
+            peer->fails = 0;
+
+            ngx_log_error(NGX_LOG_NOTICE, &hc->log, 0,
+                          "upstream server %V in upstream \"%V\" is healthy",
+                          &peer->name, hc->upstream);
+        }
+
+    } else {
+        hp->passes = 0;
+
+        if (!(peer->down & NGX_HTTP_UPSTREAM_RR_UNHEALTHY)
+            && ++hp->fails >= hc->conf->fails)
+        {
+            peer->down |= NGX_HTTP_UPSTREAM_RR_UNHEALTHY;
+
+            ngx_log_error(NGX_LOG_WARN, &hc->log, 0,
+                          "upstream server %V in upstream \"%V\" is unhealthy",
+                          &peer->name, hc->upstream);
+        }
+    }
+
+    ngx_http_upstream_rr_peer_unlock(peers, peer);
+    ngx_http_upstream_rr_peers_unlock(peers);
+
+    hc->running--;
+
+    /*
+     * the next probe is started from a posted event: a probe which
+     * fails right in ngx_http_upstream_hc_start() would otherwise recurse
+     */
+
+    ngx_post_event(&hc->post, &ngx_posted_events);
+}
+
+
+static ngx_int_t
+ngx_http_upstream_hc_postconfiguration(ngx_conf_t *cf)
+{
+    ngx_uint_t                        i;
+    ngx_http_upstream_srv_conf_t    **uscfp;
+    ngx_http_upstream_main_conf_t    *umcf;
+    ngx_http_upstream_hc_srv_conf_t  *hccf;
+
+    umcf = ngx_http_conf_get_module_main_conf(cf, ngx_http_upstream_module);
+
+    uscfp = umcf->upstreams.elts;
+
+    for (i = 0; i < umcf->upstreams.nelts; i++) {
+
+        if (uscfp[i]->srv_conf == NULL) {
+            continue;
+        }
+
+        hccf = ngx_http_conf_upstream_srv_conf(uscfp[i],
+                                               ngx_http_upstream_hc_module);
+
+        if (hccf->interval != NGX_CONF_UNSET_MSEC
+            && uscfp[i]->shm_zone == NULL)
+        {
+            ngx_log_error(NGX_LOG_EMERG, cf->log, 0,
+                          "health check requires \"zone\" in upstream \"%V\" "
+                          "in %s:%ui", &uscfp[i]->host,
+                          uscfp[i]->file_name, uscfp[i]->line);
+            return NGX_ERROR;
+        }
+    }
+
+    return NGX_OK;
+}
+
+
+static void *
+ngx_http_upstream_hc_create_conf(ngx_conf_t *cf)
+{
+    ngx_http_upstream_hc_srv_conf_t  *conf;
+
+    conf = ngx_pcalloc(cf->pool, sizeof(ngx_http_upstream_hc_srv_conf_t));
+    if (conf == NULL) {
+        return NULL;
+    }
+
+    /*
+     * set by ngx_pcalloc():
+     *
+     *     conf->request = { 0, NULL };
+     */
+
+    conf->interval = NGX_CONF_UNSET_MSEC;
+
+    return conf;
+}
+
+
+static char *
+ngx_http_upstream_hc(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
+{
+    ngx_http_upstream_hc_srv_conf_t  *hccf = conf;
+
+    u_char                        *p;
+    ngx_int_t                      n;
+    ngx_str_t                     *value, s, uri;
+    ngx_uint_t                     i;
+    ngx_http_upstream_srv_conf_t  *uscf;
+
+    if (hccf->interval != NGX_CONF_UNSET_MSEC) {
+        return "is duplicate";
+    }
+
+    uscf = ngx_http_conf_get_module_srv_conf(cf, ngx_http_upstream_module);
+
+    hccf->interval = 5000;
+    hccf->timeout = 1000;
+    hccf->fails = 1;
+    hccf->passes = 1;
+    hccf->concurrency = 16;
+    hccf->type = NGX_HTTP_UPSTREAM_HC_HTTP;
+
+    ngx_str_set(&uri, "/");
+
+    value = cf->args->elts;
+
+    for (i = 1; i < cf->args->nelts; i++) {
+
+        if (ngx_strncmp(value[i].data, "interval=", 9) == 0) {
+
+            s.len = value[i].len - 9;
+            s.data = &value[i].data[9];
+
+            hccf->interval = ngx_parse_time(&s, 0);
+            if (hccf->interval == (ngx_msec_t) NGX_ERROR
+                || hccf->interval == 0)
+            {
+                goto invalid;
+            }
+
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "timeout=", 8) == 0) {
+
+            s.len = value[i].len - 8;
+            s.data = &value[i].data[8];
+
+            hccf->timeout = ngx_parse_time(&s, 0);
+            if (hccf->timeout == (ngx_msec_t) NGX_ERROR
+                || hccf->timeout == 0)
+            {
+                goto invalid;
+            }
+
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "fails=", 6) == 0) {
+
+            n = ngx_atoi(&value[i].data[6], value[i].len - 6);
+            if (n == NGX_ERROR || n == 0) {
+                goto invalid;
+            }
+
+            hccf->fails = n;
+
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "passes=", 7) == 0) {
+
+            n = ngx_atoi(&value[i].data[7], value[i].len - 7);
+            if (n == NGX_ERROR || n == 0) {
+                goto invalid;
+            }
+
+            hccf->passes = n;
+
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "concurrency=", 12) == 0) {
+
+            n = ngx_atoi(&value[i].data[12], value[i].len - 12);
+            if (n == NGX_ERROR || n == 0) {
+                goto invalid;
+            }
+
+            hccf->concurrency = n;
+
+            continue;
+        }
+
+        if (ngx_strcmp(value[i].data, "type=tcp") == 0) {
+            hccf->type = NGX_HTTP_UPSTREAM_HC_TCP;
+            continue;
+        }
+
+        if (ngx_strcmp(value[i].data, "type=http") == 0) {
+            hccf->type = NGX_HTTP_UPSTREAM_HC_HTTP;
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "uri=", 4) == 0) {
+
+            uri.len = value[i].len - 4;
+            uri.data = &value[i].data[4];
+
+            if (uri.len == 0 || uri.data[0] != '/') {
+                goto invalid;
+            }
+
+            continue;
+        }
+
+        goto invalid;
+    }
+
+    if (hccf->type == NGX_HTTP_UPSTREAM_HC_TCP) {
+        return NGX_CONF_OK;
+    }
+
+    hccf->request.len = sizeof("GET  HTTP/1.0" CRLF "Host: " CRLF
+                               "Connection: close" CRLF CRLF) - 1
+                        + uri.len + uscf->host.len;
+
+    p = ngx_pnalloc(cf->pool, hccf->request.len);
+    if (p == NULL) {
+        return NGX_CONF_ERROR;
+    }
+
+    hccf->request.data = p;
+
+    p = ngx_cpymem(p, "GET ", sizeof("GET ") - 1);
+    p = ngx_cpymem(p, uri.data, uri.len);
+    p = ngx_cpymem(p, " HTTP/1.0" CRLF "Host: ",
+                   sizeof(" HTTP/1.0" CRLF "Host: ") - 1);
+    p = ngx_cpymem(p, uscf->host.data, uscf->host.len);
+    ngx_memcpy(p, CRLF "Connection: close" CRLF CRLF,
+               sizeof(CRLF "Connection: close" CRLF CRLF) - 1);
+
+    return NGX_CONF_OK;
+
+invalid:
+
+    ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                       "invalid parameter \"%V\"", &value[i]);
+
+    return NGX_CONF_ERROR;
+}
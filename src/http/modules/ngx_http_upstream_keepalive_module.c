@@ -10,8 +10,34 @@
 #include <ngx_http.h>
 
 
+#define NGX_HTTP_UPSTREAM_KEEPALIVE_PREWARM  1000
+#define NGX_HTTP_UPSTREAM_KEEPALIVE_CONNECT  5000
+
+
+typedef struct {
+    ngx_queue_t                        cache;
+    ngx_uint_t                         cached;
+    ngx_uint_t                         connecting;
+    time_t                             failed;
+
+    ngx_uint_t                         reused;
+    ngx_uint_t                         created;
+    ngx_uint_t                         prewarmed;
+    ngx_uint_t                         evicted;
+    ngx_uint_t                         closed;
+
+    ngx_str_t                          name;
+    socklen_t                          socklen;
+    ngx_sockaddr_t                     sockaddr;
+
+} ngx_http_upstream_keepalive_node_t;
+
+
 typedef struct {
     ngx_uint_t                         max_cached;
+    ngx_uint_t                         per_peer;
+    ngx_uint_t                         min_idle;
+    ngx_uint_t                         prewarm;
     ngx_uint_t                         requests;
     ngx_msec_t                         time;
     ngx_msec_t                         timeout;
@@ -19,6 +45,13 @@ typedef struct {
     ngx_queue_t                        cache;
     ngx_queue_t                        free;
 
+    ngx_http_upstream_keepalive_node_t **nodes;
+    ngx_uint_t                         nnodes;
+    ngx_uint_t                         mask;
+
+    ngx_http_upstream_srv_conf_t      *upstream;
+    ngx_event_t                        prewarm_event;
+
     ngx_http_upstream_init_pt          original_init_upstream;
     ngx_http_upstream_init_peer_pt     original_init_peer;
 
@@ -27,16 +60,21 @@ typedef struct {
 
 typedef struct {
     ngx_http_upstream_keepalive_srv_conf_t  *conf;
+    ngx_http_upstream_keepalive_node_t      *node;
 
     ngx_queue_t                        queue;
+    ngx_queue_t                        node_queue;
     ngx_connection_t                  *connection;
 
-    socklen_t                          socklen;
-    ngx_sockaddr_t                     sockaddr;
-
 } ngx_http_upstream_keepalive_cache_t;
 
 
+typedef struct {
+    ngx_http_upstream_keepalive_srv_conf_t  *conf;
+    ngx_http_upstream_keepalive_node_t      *node;
+} ngx_http_upstream_keepalive_prewarm_t;
+
+
 typedef struct {
     ngx_http_upstream_keepalive_srv_conf_t  *conf;
 
@@ -62,10 +100,29 @@ static ngx_int_t ngx_http_upstream_get_keepalive_peer(ngx_peer_connection_t *pc,
 static void ngx_http_upstream_free_keepalive_peer(ngx_peer_connection_t *pc,
     void *data, ngx_uint_t state);
 
+static ngx_http_upstream_keepalive_node_t *ngx_http_upstream_keepalive_node(
+    ngx_http_upstream_keepalive_srv_conf_t *kcf, struct sockaddr *sockaddr,
+    socklen_t socklen, ngx_str_t *name, ngx_uint_t create);
+static void ngx_http_upstream_keepalive_save(
+    ngx_http_upstream_keepalive_srv_conf_t *kcf,
+    ngx_http_upstream_keepalive_node_t *node, ngx_connection_t *c);
+static void ngx_http_upstream_keepalive_evict(
+    ngx_http_upstream_keepalive_cache_t *item);
+
+static ngx_int_t ngx_http_upstream_keepalive_init_process(ngx_cycle_t *cycle);
+static void ngx_http_upstream_keepalive_prewarm_handler(ngx_event_t *ev);
+static ngx_int_t ngx_http_upstream_keepalive_prewarm(
+    ngx_http_upstream_keepalive_srv_conf_t *kcf,
+    ngx_http_upstream_keepalive_node_t *node);
+static void ngx_http_upstream_keepalive_connect_handler(ngx_event_t *ev);
+
 static void ngx_http_upstream_keepalive_dummy_handler(ngx_event_t *ev);
 static void ngx_http_upstream_keepalive_close_handler(ngx_event_t *ev);
 static void ngx_http_upstream_keepalive_close(ngx_connection_t *c);
 
+static ngx_int_t ngx_http_upstream_keepalive_status_handler(
+    ngx_http_request_t *r);
+
 #if (NGX_HTTP_SSL)
 static ngx_int_t ngx_http_upstream_keepalive_set_session(
     ngx_peer_connection_t *pc, void *data);
@@ -76,6 +133,8 @@ static void ngx_http_upstream_keepalive_save_session(ngx_peer_connection_t *pc,
 static void *ngx_http_upstream_keepalive_create_conf(ngx_conf_t *cf);
 static char *ngx_http_upstream_keepalive(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
+static char *ngx_http_upstream_keepalive_status(ngx_conf_t *cf,
+    ngx_command_t *cmd, void *conf);
 
 
 static ngx_command_t  ngx_http_upstream_keepalive_commands[] = {
@@ -108,6 +167,34 @@ static ngx_command_t  ngx_http_upstream_keepalive_commands[] = {
       offsetof(ngx_http_upstream_keepalive_srv_conf_t, requests),
       NULL },
 
+    { ngx_string("keepalive_per_peer"),
+      NGX_HTTP_UPS_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_num_slot,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      offsetof(ngx_http_upstream_keepalive_srv_conf_t, per_peer),
+      NULL },
+
+    { ngx_string("keepalive_min_idle"),
+      NGX_HTTP_UPS_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_num_slot,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      offsetof(ngx_http_upstream_keepalive_srv_conf_t, min_idle),
+      NULL },
+
+    { ngx_string("keepalive_prewarm"),
+      NGX_HTTP_UPS_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_num_slot,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      offsetof(ngx_http_upstream_keepalive_srv_conf_t, prewarm),
+      NULL },
+
+    { ngx_string("upstream_keepalive_status"),
+      NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_NOARGS,
+      ngx_http_upstream_keepalive_status,
+      0,
+      0,
+      NULL },
+
       ngx_null_command
 };
 
@@ -134,7 +221,7 @@ ngx_module_t  ngx_http_upstream_keepalive_module = {
     NGX_HTTP_MODULE,                       /* module type */
     NULL,                                  /* init master */
     NULL,                                  /* init module */
-    NULL,                                  /* init process */
+    ngx_http_upstream_keepalive_init_process, /* init process */
     NULL,                                  /* init thread */
     NULL,                                  /* exit thread */
     NULL,                                  /* exit process */
@@ -147,7 +234,8 @@ static ngx_int_t
 ngx_http_upstream_init_keepalive(ngx_conf_t *cf,
     ngx_http_upstream_srv_conf_t *us)
 {
-    ngx_uint_t                               i;
+    ngx_uint_t                               i, n;
+    ngx_http_upstream_server_t              *server;
     ngx_http_upstream_keepalive_srv_conf_t  *kcf;
     ngx_http_upstream_keepalive_cache_t     *cached;
 
@@ -160,6 +248,17 @@ ngx_http_upstream_init_keepalive(ngx_conf_t *cf,
     ngx_conf_init_msec_value(kcf->time, 3600000);
     ngx_conf_init_msec_value(kcf->timeout, 60000);
     ngx_conf_init_uint_value(kcf->requests, 1000);
+    ngx_conf_init_uint_value(kcf->per_peer, kcf->max_cached);
+    ngx_conf_init_uint_value(kcf->min_idle, 0);
+    ngx_conf_init_uint_value(kcf->prewarm, 0);
+
+    if (kcf->per_peer == 0 || kcf->per_peer > kcf->max_cached) {
+        kcf->per_peer = kcf->max_cached;
+    }
+
+    if (kcf->prewarm > kcf->per_peer) {
+        kcf->prewarm = kcf->per_peer;
+    }
 
     if (kcf->original_init_upstream(cf, us) != NGX_OK) {
         return NGX_ERROR;
@@ -185,6 +284,32 @@ ngx_http_upstream_init_keepalive(ngx_conf_t *cf,
         cached[i].conf = kcf;
     }
 
+    /*
+     * per-peer nodes are looked up by address in an open addressing
+     * table sized for the configured servers, nodes are created on demand
+     */
+
+    n = 0;
+
+    if (us->servers) {
+        server = us->servers->elts;
+
+        for (i = 0; i < us->servers->nelts; i++) {
+            n += server[i].naddrs;
+        }
+    }
+
+    for (i = 16; i < 2 * n; i <<= 1) { /* void */ }
+
+    kcf->nodes = ngx_pcalloc(cf->pool,
+                       sizeof(ngx_http_upstream_keepalive_node_t *) * i);
+    if (kcf->nodes == NULL) {
+        return NGX_ERROR;
+    }
+
+    kcf->mask = i - 1;
+    kcf->upstream = us;
+
     return NGX_OK;
 }
 
@@ -237,9 +362,10 @@ ngx_http_upstream_get_keepalive_peer(ngx_peer_connection_t *pc, void *data)
 {
     ngx_http_upstream_keepalive_peer_data_t  *kp = data;
     ngx_http_upstream_keepalive_cache_t      *item;
+    ngx_http_upstream_keepalive_node_t       *node;
 
     ngx_int_t          rc;
-    ngx_queue_t       *q, *cache;
+    ngx_queue_t       *q;
     ngx_connection_t  *c;
 
     ngx_log_debug0(NGX_LOG_DEBUG_HTTP, pc->log, 0,
@@ -253,31 +379,31 @@ ngx_http_upstream_get_keepalive_peer(ngx_peer_connection_t *pc, void *data)
         return rc;
     }
 
-    /* search cache for suitable connection */
+    /* take the most recently used connection to the peer */
 
-    cache = &kp->conf->cache;
+    node = ngx_http_upstream_keepalive_node(kp->conf, pc->sockaddr,
+                                            pc->socklen, pc->name, 1);
 
-    for (q = ngx_queue_head(cache);
-         q != ngx_queue_sentinel(cache);
-         q = ngx_queue_next(q))
-    {
-        item = ngx_queue_data(q, ngx_http_upstream_keepalive_cache_t, queue);
-        c = item->connection;
-
-        if (ngx_memn2cmp((u_char *) &item->sockaddr, (u_char *) pc->sockaddr,
-                         item->socklen, pc->socklen)
-            == 0)
-        {
-            ngx_queue_remove(q);
-            ngx_queue_insert_head(&kp->conf->free, q);
+    if (node == NULL) {
+        return NGX_OK;
+    }
 
-            goto found;
-        }
+    if (ngx_queue_empty(&node->cache)) {
+        node->created++;
+        return NGX_OK;
     }
 
-    return NGX_OK;
+    q = ngx_queue_head(&node->cache);
+    ngx_queue_remove(q);
+
+    item = ngx_queue_data(q, ngx_http_upstream_keepalive_cache_t, node_queue);
+    c = item->connection;
 
-found:
+    ngx_queue_remove(&item->queue);
+    ngx_queue_insert_head(&kp->conf->free, &item->queue);
+
+    node->cached--;
+    node->reused++;
 
     ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
                    "get keepalive peer: using connection %p", c);
@@ -306,9 +432,8 @@ ngx_http_upstream_free_keepalive_peer(ngx_peer_connection_t *pc, void *data,
     ngx_uint_t state)
 {
     ngx_http_upstream_keepalive_peer_data_t  *kp = data;
-    ngx_http_upstream_keepalive_cache_t      *item;
+    ngx_http_upstream_keepalive_node_t       *node;
 
-    ngx_queue_t          *q;
     ngx_connection_t     *c;
     ngx_http_upstream_t  *u;
 
@@ -331,6 +456,12 @@ ngx_http_upstream_free_keepalive_peer(ngx_peer_connection_t *pc, void *data,
         goto invalid;
     }
 
+    /* streams of multiplexed http2 connections */
+
+    if (c->shared) {
+        goto invalid;
+    }
+
     if (c->requests >= kp->conf->requests) {
         goto invalid;
     }
@@ -351,6 +482,13 @@ ngx_http_upstream_free_keepalive_peer(ngx_peer_connection_t *pc, void *data,
         goto invalid;
     }
 
+    node = ngx_http_upstream_keepalive_node(kp->conf, pc->sockaddr,
+                                            pc->socklen, pc->name, 1);
+
+    if (node == NULL) {
+        goto invalid;
+    }
+
     if (ngx_handle_read_event(c->read, 0) != NGX_OK) {
         goto invalid;
     }
@@ -358,30 +496,112 @@ ngx_http_upstream_free_keepalive_peer(ngx_peer_connection_t *pc, void *data,
     ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
                    "free keepalive peer: saving connection %p", c);
 
-    if (ngx_queue_empty(&kp->conf->free)) {
+    pc->connection = NULL;
+
+    ngx_http_upstream_keepalive_save(kp->conf, node, c);
 
-        q = ngx_queue_last(&kp->conf->cache);
-        ngx_queue_remove(q);
+invalid:
 
+    kp->original_free_peer(pc, kp->data, state);
+}
+
+
+static ngx_http_upstream_keepalive_node_t *
+ngx_http_upstream_keepalive_node(ngx_http_upstream_keepalive_srv_conf_t *kcf,
+    struct sockaddr *sockaddr, socklen_t socklen, ngx_str_t *name,
+    ngx_uint_t create)
+{
+    uint32_t                             hash;
+    ngx_uint_t                           i;
+    ngx_http_upstream_keepalive_node_t  *node;
+
+    if (socklen > sizeof(ngx_sockaddr_t)) {
+        return NULL;
+    }
+
+    hash = ngx_crc32_short((u_char *) sockaddr, socklen);
+
+    for (i = hash & kcf->mask; kcf->nodes[i]; i = (i + 1) & kcf->mask) {
+        node = kcf->nodes[i];
+
+        if (ngx_memn2cmp((u_char *) &node->sockaddr, (u_char *) sockaddr,
+                         node->socklen, socklen)
+            == 0)
+        {
+            return node;
+        }
+    }
+
+    /* keep the table at most half full */
+
+    if (!create || 2 * (kcf->nnodes + 1) > kcf->mask + 1) {
+        return NULL;
+    }
+
+    node = ngx_pcalloc(ngx_cycle->pool,
+                       sizeof(ngx_http_upstream_keepalive_node_t)
+                       + name->len);
+    if (node == NULL) {
+        return NULL;
+    }
+
+    ngx_queue_init(&node->cache);
+
+    node->name.len = name->len;
+    node->name.data = (u_char *) node
+                      + sizeof(ngx_http_upstream_keepalive_node_t);
+    ngx_memcpy(node->name.data, name->data, name->len);
+
+    node->socklen = socklen;
+    ngx_memcpy(&node->sockaddr, sockaddr, socklen);
+
+    kcf->nodes[i] = node;
+    kcf->nnodes++;
+
+    return node;
+}
+
+
+static void
+ngx_http_upstream_keepalive_save(ngx_http_upstream_keepalive_srv_conf_t *kcf,
+    ngx_http_upstream_keepalive_node_t *node, ngx_connection_t *c)
+{
+    ngx_queue_t                          *q;
+    ngx_http_upstream_keepalive_cache_t  *item;
+
+    if (node->cached >= kcf->per_peer) {
+
+        /* replace the least recently used connection to the peer */
+
+        q = ngx_queue_last(&node->cache);
+        item = ngx_queue_data(q, ngx_http_upstream_keepalive_cache_t,
+                              node_queue);
+
+        ngx_http_upstream_keepalive_evict(item);
+
+    } else if (ngx_queue_empty(&kcf->free)) {
+
+        q = ngx_queue_last(&kcf->cache);
         item = ngx_queue_data(q, ngx_http_upstream_keepalive_cache_t, queue);
 
-        ngx_http_upstream_keepalive_close(item->connection);
+        ngx_http_upstream_keepalive_evict(item);
 
     } else {
-        q = ngx_queue_head(&kp->conf->free);
-        ngx_queue_remove(q);
-
+        q = ngx_queue_head(&kcf->free);
         item = ngx_queue_data(q, ngx_http_upstream_keepalive_cache_t, queue);
     }
 
-    ngx_queue_insert_head(&kp->conf->cache, q);
+    ngx_queue_remove(&item->queue);
+    ngx_queue_insert_head(&kcf->cache, &item->queue);
+    ngx_queue_insert_head(&node->cache, &item->node_queue);
 
-    item->connection = c;
+    node->cached++;
 
-    pc->connection = NULL;
+    item->node = node;
+    item->connection = c;
 
     c->read->delayed = 0;
-    ngx_add_timer(c->read, kp->conf->timeout);
+    ngx_add_timer(c->read, kcf->timeout);
 
     if (c->write->timer_set) {
         ngx_del_timer(c->write);
@@ -397,16 +617,24 @@ ngx_http_upstream_free_keepalive_peer(ngx_peer_connection_t *pc, void *data,
     c->write->log = ngx_cycle->log;
     c->pool->log = ngx_cycle->log;
 
-    item->socklen = pc->socklen;
-    ngx_memcpy(&item->sockaddr, pc->sockaddr, pc->socklen);
-
     if (c->read->ready) {
         ngx_http_upstream_keepalive_close_handler(c->read);
     }
+}
 
-invalid:
 
-    kp->original_free_peer(pc, kp->data, state);
+static void
+ngx_http_upstream_keepalive_evict(ngx_http_upstream_keepalive_cache_t *item)
+{
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
+                   "keepalive evict connection %p", item->connection);
+
+    ngx_queue_remove(&item->node_queue);
+
+    item->node->cached--;
+    item->node->evicted++;
+
+    ngx_http_upstream_keepalive_close(item->connection);
 }
 
 
@@ -433,10 +661,26 @@ ngx_http_upstream_keepalive_close_handler(ngx_event_t *ev)
 
     c = ev->data;
 
-    if (c->close || c->read->timedout) {
+    if (c->close) {
         goto close;
     }
 
+    if (c->read->timedout) {
+        item = c->data;
+        conf = item->conf;
+
+        /* keep a minimum number of idle connections to the peer warm */
+
+        if (item->node->cached > conf->min_idle
+            || ngx_current_msec - c->start_time > conf->time)
+        {
+            goto close;
+        }
+
+        c->read->timedout = 0;
+        ngx_add_timer(c->read, conf->timeout);
+    }
+
     n = recv(c->fd, buf, 1, MSG_PEEK);
 
     if (n == -1 && ngx_socket_errno == NGX_EAGAIN) {
@@ -456,6 +700,11 @@ close:
 
     ngx_http_upstream_keepalive_close(c);
 
+    ngx_queue_remove(&item->node_queue);
+
+    item->node->cached--;
+    item->node->closed++;
+
     ngx_queue_remove(&item->queue);
     ngx_queue_insert_head(&conf->free, &item->queue);
 }
@@ -484,6 +733,380 @@ ngx_http_upstream_keepalive_close(ngx_connection_t *c)
 }
 
 
+static ngx_int_t
+ngx_http_upstream_keepalive_init_process(ngx_cycle_t *cycle)
+{
+    ngx_uint_t                               i;
+    ngx_event_t                             *ev;
+    ngx_http_upstream_srv_conf_t           **uscfp;
+    ngx_http_upstream_main_conf_t           *umcf;
+    ngx_http_upstream_keepalive_srv_conf_t  *kcf;
+
+    if (ngx_process != NGX_PROCESS_WORKER
+        && ngx_process != NGX_PROCESS_SINGLE)
+    {
+        return NGX_OK;
+    }
+
+    umcf = ngx_http_cycle_get_module_main_conf(cycle, ngx_http_upstream_module);
+    if (umcf == NULL) {
+        return NGX_OK;
+    }
+
+    uscfp = umcf->upstreams.elts;
+
+    for (i = 0; i < umcf->upstreams.nelts; i++) {
+
+        if (uscfp[i]->srv_conf == NULL) {
+            continue;
+        }
+
+        kcf = ngx_http_conf_upstream_srv_conf(uscfp[i],
+                                          ngx_http_upstream_keepalive_module);
+
+        if (kcf->max_cached == 0 || kcf->prewarm == 0) {
+            continue;
+        }
+
+        ev = &kcf->prewarm_event;
+
+        ev->handler = ngx_http_upstream_keepalive_prewarm_handler;
+        ev->data = kcf;
+        ev->log = cycle->log;
+        ev->cancelable = 1;
+
+        ngx_add_timer(ev, 0);
+    }
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_http_upstream_keepalive_prewarm_handler(ngx_event_t *ev)
+{
+    time_t                                   now;
+    ngx_uint_t                               n;
+    ngx_http_upstream_rr_peer_t             *peer;
+    ngx_http_upstream_rr_peers_t            *peers;
+    ngx_http_upstream_keepalive_node_t      *node;
+    ngx_http_upstream_keepalive_srv_conf_t  *kcf;
+
+    if (ngx_exiting || ngx_terminate || ngx_quit) {
+        return;
+    }
+
+    kcf = ev->data;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ev->log, 0,
+                   "keepalive prewarm upstream \"%V\"", &kcf->upstream->host);
+
+    /*
+     * top up idle connections to primary peers which are neither down
+     * nor failed, so a peer recovered by health checks is refilled too
+     */
+
+    now = ngx_time();
+    peers = kcf->upstream->peer.data;
+
+    ngx_http_upstream_rr_peers_rlock(peers);
+
+    for (peer = peers->peer; peer; peer = peer->next) {
+
+        if (ngx_queue_empty(&kcf->free)) {
+            break;
+        }
+
+        if (peer->down) {
+            continue;
+        }
+
+        if (peer->max_fails
+            && peer->fails >= peer->max_fails
+            && now - peer->checked <= peer->fail_timeout)
+        {
+            continue;
+        }
+
+        node = ngx_http_upstream_keepalive_node(kcf, peer->sockaddr,
+                                                peer->socklen, &peer->name, 1);
+
+        if (node == NULL || now - node->failed < peer->fail_timeout) {
+            continue;
+        }
+
+        for (n = node->cached + node->connecting; n < kcf->prewarm; n++) {
+
+            if (ngx_queue_empty(&kcf->free)) {
+                break;
+            }
+
+            if (ngx_http_upstream_keepalive_prewarm(kcf, node) != NGX_OK) {
+                node->failed = now;
+                break;
+            }
+        }
+    }
+
+    ngx_http_upstream_rr_peers_unlock(peers);
+
+    ngx_add_timer(ev, NGX_HTTP_UPSTREAM_KEEPALIVE_PREWARM);
+}
+
+
+static ngx_int_t
+ngx_http_upstream_keepalive_prewarm(ngx_http_upstream_keepalive_srv_conf_t *kcf,
+    ngx_http_upstream_keepalive_node_t *node)
+{
+    ngx_int_t                               rc;
+    ngx_connection_t                       *c;
+    ngx_peer_connection_t                   pc;
+    ngx_http_upstream_keepalive_prewarm_t  *pw;
+
+    ngx_memzero(&pc, sizeof(ngx_peer_connection_t));
+
+    pc.sockaddr = (struct sockaddr *) &node->sockaddr;
+    pc.socklen = node->socklen;
+    pc.name = &node->name;
+    pc.get = ngx_event_get_peer;
+    pc.log = ngx_cycle->log;
+    pc.log_error = NGX_ERROR_ERR;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
+                   "keepalive prewarm peer %V", &node->name);
+
+    rc = ngx_event_connect_peer(&pc);
+
+    if (rc == NGX_ERROR || rc == NGX_BUSY || rc == NGX_DECLINED) {
+        if (pc.connection) {
+            ngx_close_connection(pc.connection);
+        }
+
+        return NGX_ERROR;
+    }
+
+    c = pc.connection;
+
+    c->pool = ngx_create_pool(128, ngx_cycle->log);
+    if (c->pool == NULL) {
+        ngx_close_connection(c);
+        return NGX_ERROR;
+    }
+
+    pw = ngx_palloc(c->pool, sizeof(ngx_http_upstream_keepalive_prewarm_t));
+    if (pw == NULL) {
+        ngx_destroy_pool(c->pool);
+        ngx_close_connection(c);
+        return NGX_ERROR;
+    }
+
+    pw->conf = kcf;
+    pw->node = node;
+
+    /* let a graceful shutdown close connections still in progress */
+
+    c->idle = 1;
+    c->data = pw;
+    c->read->handler = ngx_http_upstream_keepalive_connect_handler;
+    c->write->handler = ngx_http_upstream_keepalive_connect_handler;
+
+    node->connecting++;
+
+    if (rc == NGX_AGAIN) {
+        ngx_add_timer(c->write, NGX_HTTP_UPSTREAM_KEEPALIVE_CONNECT);
+        return NGX_OK;
+    }
+
+    ngx_http_upstream_keepalive_connect_handler(c->write);
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_http_upstream_keepalive_connect_handler(ngx_event_t *ev)
+{
+    ngx_connection_t                        *c;
+    ngx_http_upstream_keepalive_node_t      *node;
+    ngx_http_upstream_keepalive_prewarm_t   *pw;
+    ngx_http_upstream_keepalive_srv_conf_t  *kcf;
+
+    c = ev->data;
+    pw = c->data;
+
+    kcf = pw->conf;
+    node = pw->node;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ev->log, 0,
+                   "keepalive prewarm connect %V", &node->name);
+
+    node->connecting--;
+
+    if (c->close || ngx_exiting || ngx_terminate) {
+        goto close;
+    }
+
+    if (ev->timedout) {
+        ngx_log_error(NGX_LOG_ERR, ev->log, NGX_ETIMEDOUT,
+                      "upstream timed out while prewarming connection to %V",
+                      &node->name);
+        node->failed = ngx_time();
+        goto close;
+    }
+
+    if (ngx_http_upstream_test_connect(c) != NGX_OK) {
+        node->failed = ngx_time();
+        goto close;
+    }
+
+    /* do not displace connections returned by requests */
+
+    if (node->cached >= kcf->per_peer || ngx_queue_empty(&kcf->free)) {
+        goto close;
+    }
+
+    if (ngx_handle_read_event(c->read, 0) != NGX_OK) {
+        goto close;
+    }
+
+    node->prewarmed++;
+
+    ngx_http_upstream_keepalive_save(kcf, node, c);
+
+    return;
+
+close:
+
+    ngx_http_upstream_keepalive_close(c);
+}
+
+
+static ngx_int_t
+ngx_http_upstream_keepalive_status_handler(ngx_http_request_t *r)
+{
+    size_t                                    size;
+    ngx_int_t                                 rc;
+    ngx_buf_t                                *b;
+    ngx_uint_t                                i, n, idle;
+    ngx_chain_t                               out;
+    ngx_http_upstream_srv_conf_t            **uscfp;
+    ngx_http_upstream_main_conf_t            *umcf;
+    ngx_http_upstream_keepalive_node_t       *node;
+    ngx_http_upstream_keepalive_srv_conf_t   *kcf;
+
+    if (!(r->method & (NGX_HTTP_GET|NGX_HTTP_HEAD))) {
+        return NGX_HTTP_NOT_ALLOWED;
+    }
+
+    rc = ngx_http_discard_request_body(r);
+
+    if (rc != NGX_OK) {
+        return rc;
+    }
+
+    r->headers_out.content_type_len = sizeof("text/plain") - 1;
+    ngx_str_set(&r->headers_out.content_type, "text/plain");
+    r->headers_out.content_type_lowcase = NULL;
+
+    umcf = ngx_http_get_module_main_conf(r, ngx_http_upstream_module);
+    uscfp = umcf->upstreams.elts;
+
+    size = sizeof("pid \n") - 1 + NGX_INT64_LEN;
+
+    for (i = 0; i < umcf->upstreams.nelts; i++) {
+
+        if (uscfp[i]->srv_conf == NULL) {
+            continue;
+        }
+
+        kcf = ngx_http_conf_upstream_srv_conf(uscfp[i],
+                                          ngx_http_upstream_keepalive_module);
+
+        if (kcf->max_cached == 0 || kcf->nodes == NULL) {
+            continue;
+        }
+
+        size += sizeof("upstream  idle:/\n") - 1
+                + kcf->upstream->host.len + 2 * NGX_INT_T_LEN;
+
+        for (n = 0; n <= kcf->mask; n++) {
+            if (kcf->nodes[n]) {
+                size += sizeof("  server  idle: reused: created:"
+                               " prewarmed: evicted: closed:\n") - 1
+                        + kcf->nodes[n]->name.len + 6 * NGX_INT_T_LEN;
+            }
+        }
+    }
+
+    b = ngx_create_temp_buf(r->pool, size);
+    if (b == NULL) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+
+    out.buf = b;
+    out.next = NULL;
+
+    /* connection caches are per worker, so are the numbers */
+
+    b->last = ngx_sprintf(b->last, "pid %P\n", ngx_pid);
+
+    for (i = 0; i < umcf->upstreams.nelts; i++) {
+
+        if (uscfp[i]->srv_conf == NULL) {
+            continue;
+        }
+
+        kcf = ngx_http_conf_upstream_srv_conf(uscfp[i],
+                                          ngx_http_upstream_keepalive_module);
+
+        if (kcf->max_cached == 0 || kcf->nodes == NULL) {
+            continue;
+        }
+
+        idle = 0;
+
+        for (n = 0; n <= kcf->mask; n++) {
+            if (kcf->nodes[n]) {
+                idle += kcf->nodes[n]->cached;
+            }
+        }
+
+        b->last = ngx_sprintf(b->last, "upstream %V idle:%ui/%ui\n",
+                              &kcf->upstream->host, idle, kcf->max_cached);
+
+        for (n = 0; n <= kcf->mask; n++) {
+            node = kcf->nodes[n];
+
+            if (node == NULL) {
+                continue;
+            }
+
+            b->last = ngx_sprintf(b->last,
+                                  "  server %V idle:%ui reused:%ui "
+                                  "created:%ui prewarmed:%ui evicted:%ui "
+                                  "closed:%ui\n",
+                                  &node->name, node->cached, node->reused,
+                                  node->created, node->prewarmed,
+                                  node->evicted, node->closed);
+        }
+    }
+
+    b->last_buf = (r == r->main) ? 1 : 0;
+    b->last_in_chain = 1;
+
+    r->headers_out.status = NGX_HTTP_OK;
+    r->headers_out.content_length_n = b->last - b->pos;
+
+    rc = ngx_http_send_header(r);
+
+    if (rc == NGX_ERROR || rc > NGX_OK || r->header_only) {
+        return rc;
+    }
+
+    return ngx_http_output_filter(r, &out);
+}
+
+
 #if (NGX_HTTP_SSL)
 
 static ngx_int_t
@@ -524,11 +1147,16 @@ ngx_http_upstream_keepalive_create_conf(ngx_conf_t *cf)
      *     conf->original_init_upstream = NULL;
      *     conf->original_init_peer = NULL;
      *     conf->max_cached = 0;
+     *     conf->nodes = NULL;
+     *     conf->nnodes = 0;
      */
 
     conf->time = NGX_CONF_UNSET_MSEC;
     conf->timeout = NGX_CONF_UNSET_MSEC;
     conf->requests = NGX_CONF_UNSET_UINT;
+    conf->per_peer = NGX_CONF_UNSET_UINT;
+    conf->min_idle = NGX_CONF_UNSET_UINT;
+    conf->prewarm = NGX_CONF_UNSET_UINT;
 
     return conf;
 }
@@ -574,3 +1202,16 @@ ngx_http_upstream_keepalive(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 
     return NGX_CONF_OK;
 }
+
+
+static char *
+ngx_http_upstream_keepalive_status(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf)
+{
+    ngx_http_core_loc_conf_t  *clcf;
+
+    clcf = ngx_http_conf_get_module_loc_conf(cf, ngx_http_core_module);
+    clcf->handler = ngx_http_upstream_keepalive_status_handler;
+
+    return NGX_CONF_OK;
+}
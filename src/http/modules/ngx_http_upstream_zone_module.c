@@ -16,6 +16,8 @@ static ngx_int_t ngx_http_upstream_init_zone(ngx_shm_zone_t *shm_zone,
     void *data);
 static ngx_http_upstream_rr_peers_t *ngx_http_upstream_zone_copy_peers(
     ngx_slab_pool_t *shpool, ngx_http_upstream_srv_conf_t *uscf);
+static ngx_int_t ngx_http_upstream_zone_copy_index(ngx_slab_pool_t *shpool,
+    ngx_http_upstream_rr_peers_t *peers);
 static ngx_http_upstream_rr_peer_t *ngx_http_upstream_zone_copy_peer(
     ngx_http_upstream_rr_peers_t *peers, ngx_http_upstream_rr_peer_t *src);
 
@@ -225,6 +227,10 @@ ngx_http_upstream_zone_copy_peers(ngx_slab_pool_t *shpool,
         *peerp = peer;
     }
 
+    if (ngx_http_upstream_zone_copy_index(shpool, peers) != NGX_OK) {
+        return NULL;
+    }
+
     if (peers->next == NULL) {
         goto done;
     }
@@ -250,6 +256,10 @@ ngx_http_upstream_zone_copy_peers(ngx_slab_pool_t *shpool,
         *peerp = peer;
     }
 
+    if (ngx_http_upstream_zone_copy_index(shpool, backup) != NGX_OK) {
+        return NULL;
+    }
+
     peers->next = backup;
 
 done:
@@ -260,6 +270,37 @@ done:
 }
 
 
+static ngx_int_t
+ngx_http_upstream_zone_copy_index(ngx_slab_pool_t *shpool,
+    ngx_http_upstream_rr_peers_t *peers)
+{
+    size_t                         size;
+    ngx_uint_t                     i;
+    ngx_http_upstream_rr_peer_t   *peer, **index;
+
+    /* the schedule itself is read only and stays in the configuration pool */
+
+    if (peers->schedule == NULL) {
+        return NGX_OK;
+    }
+
+    size = peers->number * sizeof(ngx_http_upstream_rr_peer_t *);
+
+    index = ngx_slab_alloc(shpool, size);
+    if (index == NULL) {
+        return NGX_ERROR;
+    }
+
+    for (peer = peers->peer, i = 0; peer; peer = peer->next, i++) {
+        index[i] = peer;
+    }
+
+    peers->index = index;
+
+    return NGX_OK;
+}
+
+
 static ngx_http_upstream_rr_peer_t *
 ngx_http_upstream_zone_copy_peer(ngx_http_upstream_rr_peers_t *peers,
     ngx_http_upstream_rr_peer_t *src)
@@ -29,6 +29,18 @@
 
 #define NGX_HTTP_CACHE_VERSION       5
 
+#define NGX_HTTP_CACHE_EVICT_LRU     0
+#define NGX_HTTP_CACHE_EVICT_TINYLFU 1
+
+#define NGX_HTTP_CACHE_SKETCH_DEPTH  4
+#define NGX_HTTP_CACHE_SKETCH_AGING  256
+
+#define NGX_HTTP_CACHE_INDEX_VERSION 2
+#define NGX_HTTP_CACHE_INDEX_BATCH   512
+
+#define NGX_HTTP_CACHE_INDEX_TRIED   1
+#define NGX_HTTP_CACHE_INDEX_LOADED  2
+
 
 typedef struct {
     ngx_uint_t                       status;
@@ -51,7 +63,8 @@ typedef struct {
     unsigned                         updating:1;
     unsigned                         deleting:1;
     unsigned                         purged:1;
-                                     /* 10 unused bits */
+    unsigned                         epoch:8;
+                                     /* 2 unused bits */
 
     ngx_file_uniq_t                  uniq;
     time_t                           expire;
@@ -59,9 +72,43 @@ typedef struct {
     size_t                           body_start;
     off_t                            fs_size;
     ngx_msec_t                       lock_time;
+    uint64_t                         waiters;
 } ngx_http_file_cache_node_t;
 
 
+/*
+ * shards are allocated as an array, the padding keeps fields
+ * of neighbouring shards, modified under different locks,
+ * in different cache lines
+ */
+
+typedef struct {
+    ngx_shmtx_sh_t                   lock;
+    ngx_shmtx_t                      mutex;
+
+    ngx_rbtree_t                     rbtree;
+    ngx_rbtree_node_t                sentinel;
+    ngx_queue_t                      queue;
+    off_t                            size;
+    ngx_uint_t                       count;
+    ngx_uint_t                       watermark;
+    ngx_queue_t                     *cursor;
+
+    u_char                          *sketch;
+    ngx_uint_t                       sketch_shift;
+    ngx_uint_t                       samples;
+    ngx_uint_t                       aging;
+
+    ngx_atomic_uint_t                hits;
+    ngx_atomic_uint_t                misses;
+    ngx_atomic_uint_t                evicted;
+    ngx_atomic_uint_t                expired;
+    ngx_atomic_uint_t                rejected;
+
+    u_char                           pad[NGX_CPU_CACHE_LINE];
+} ngx_http_file_cache_shard_t;
+
+
 struct ngx_http_cache_s {
     ngx_file_t                       file;
     ngx_array_t                      keys;
@@ -95,6 +142,7 @@ struct ngx_http_cache_s {
 
     ngx_http_file_cache_t           *file_cache;
     ngx_http_file_cache_node_t      *node;
+    ngx_http_file_cache_shard_t     *shard;
 
 #if (NGX_THREADS || NGX_COMPAT)
     ngx_thread_task_t               *thread_task;
@@ -106,6 +154,7 @@ struct ngx_http_cache_s {
     ngx_msec_t                       wait_time;
 
     ngx_event_t                      wait_event;
+    ngx_queue_t                      wait_queue;
 
     unsigned                         lock:1;
     unsigned                         waiting:1;
@@ -122,6 +171,8 @@ struct ngx_http_cache_s {
 
     unsigned                         stale_updating:1;
     unsigned                         stale_error:1;
+
+    unsigned                         memory:1;
 };
 
 
@@ -144,16 +195,67 @@ typedef struct {
 } ngx_http_file_cache_header_t;
 
 
+typedef struct {
+    u_char                           magic[8];
+    uint32_t                         version;
+    uint32_t                         crc32;
+    uint64_t                         count;
+    uint64_t                         bsize;
+    int64_t                          time;
+} ngx_http_file_cache_index_header_t;
+
+
+typedef struct {
+    u_char                           key[NGX_HTTP_CACHE_KEY_LEN];
+    uint64_t                         uniq;
+    int64_t                          expire;
+    uint64_t                         fs_size;
+    uint32_t                         body_start;
+    uint32_t                         reserved;
+} ngx_http_file_cache_index_entry_t;
+
+
+typedef struct {
+    ngx_http_file_cache_shard_t     *shards;
+    ngx_uint_t                       nshards;
+    ngx_atomic_t                     cold;
+    ngx_atomic_t                     loading;
+    ngx_atomic_t                     indexed;
+} ngx_http_file_cache_sh_t;
+
+
+typedef struct {
+    ngx_rbtree_node_t                node;
+    ngx_queue_t                      queue;
+
+    u_char                           key[NGX_HTTP_CACHE_KEY_LEN
+                                         - sizeof(ngx_rbtree_key_t)];
+
+    ngx_uint_t                       uses;
+    ngx_file_uniq_t                  uniq;
+    size_t                           len;
+    u_char                           data[1];
+} ngx_http_file_cache_memory_node_t;
+
+
 typedef struct {
     ngx_rbtree_t                     rbtree;
     ngx_rbtree_node_t                sentinel;
     ngx_queue_t                      queue;
-    ngx_atomic_t                     cold;
-    ngx_atomic_t                     loading;
-    off_t                            size;
+    size_t                           size;
     ngx_uint_t                       count;
-    ngx_uint_t                       watermark;
-} ngx_http_file_cache_sh_t;
+    ngx_uint_t                       attempts;
+    ngx_uint_t                       epoch;
+} ngx_http_file_cache_memory_sh_t;
+
+
+typedef struct {
+    ngx_uint_t                       hits;
+    ngx_uint_t                       misses;
+    ngx_uint_t                       evicted;
+    ngx_uint_t                       expired;
+    ngx_uint_t                       rejected;
+} ngx_http_file_cache_stat_t;
 
 
 struct ngx_http_file_cache_s {
@@ -166,10 +268,18 @@ struct ngx_http_file_cache_s {
     off_t                            max_size;
     size_t                           bsize;
 
+    ngx_uint_t                       shards;
+    ngx_uint_t                       expire_shard;
+    ngx_uint_t                       eviction;
+
     time_t                           inactive;
 
     time_t                           fail_time;
 
+    time_t                           index;
+    time_t                           index_time;
+    ngx_str_t                        index_name;
+
     ngx_uint_t                       files;
     ngx_uint_t                       loader_files;
     ngx_msec_t                       last;
@@ -182,6 +292,10 @@ struct ngx_http_file_cache_s {
 
     ngx_shm_zone_t                  *shm_zone;
 
+    ngx_http_file_cache_memory_sh_t *memory;
+    ngx_slab_pool_t                 *mpool;
+    ngx_shm_zone_t                  *memory_zone;
+
     ngx_uint_t                       use_temp_path;
                                      /* unsigned use_temp_path:1 */
 };
@@ -197,6 +311,8 @@ void ngx_http_file_cache_update_header(ngx_http_request_t *r);
 ngx_int_t ngx_http_cache_send(ngx_http_request_t *);
 void ngx_http_file_cache_free(ngx_http_cache_t *c, ngx_temp_file_t *tf);
 time_t ngx_http_file_cache_valid(ngx_array_t *cache_valid, ngx_uint_t status);
+ngx_int_t ngx_http_file_cache_stat(ngx_shm_zone_t *shm_zone,
+    ngx_http_file_cache_stat_t *stat);
 
 char *ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
@@ -10,12 +10,19 @@
 #include <ngx_http.h>
 #include <ngx_md5.h>
 
+#if !(NGX_WIN32)
+#include <ngx_channel.h>
+#endif
+
 
 static ngx_int_t ngx_http_file_cache_lock(ngx_http_request_t *r,
     ngx_http_cache_t *c);
 static void ngx_http_file_cache_lock_wait_handler(ngx_event_t *ev);
 static ngx_int_t ngx_http_file_cache_lock_wait(ngx_http_request_t *r,
     ngx_http_cache_t *c);
+static void ngx_http_file_cache_wait(ngx_http_cache_t *c);
+static void ngx_http_file_cache_wake_handler(ngx_event_t *ev);
+static void ngx_http_file_cache_notify(uint64_t waiters, ngx_log_t *log);
 static ngx_int_t ngx_http_file_cache_read(ngx_http_request_t *r,
     ngx_http_cache_t *c);
 static ssize_t ngx_http_file_cache_aio_read(ngx_http_request_t *r,
@@ -32,8 +39,19 @@ static ngx_int_t ngx_http_file_cache_exists(ngx_http_file_cache_t *cache,
     ngx_http_cache_t *c);
 static ngx_int_t ngx_http_file_cache_name(ngx_http_request_t *r,
     ngx_path_t *path);
+static ngx_http_file_cache_shard_t *
+    ngx_http_file_cache_shard(ngx_http_file_cache_t *cache, u_char *key);
+static ngx_int_t ngx_http_file_cache_init_sketch(ngx_shm_zone_t *shm_zone,
+    ngx_http_file_cache_t *cache);
+static void ngx_http_file_cache_sketch_add(ngx_http_file_cache_shard_t *shard,
+    u_char *key);
+static ngx_uint_t ngx_http_file_cache_sketch_estimate(
+    ngx_http_file_cache_shard_t *shard, u_char *key);
+static ngx_int_t ngx_http_file_cache_admit(ngx_http_file_cache_t *cache,
+    ngx_http_cache_t *c);
 static ngx_http_file_cache_node_t *
-    ngx_http_file_cache_lookup(ngx_http_file_cache_t *cache, u_char *key);
+    ngx_http_file_cache_lookup(ngx_http_file_cache_shard_t *shard,
+    u_char *key);
 static void ngx_http_file_cache_rbtree_insert_value(ngx_rbtree_node_t *temp,
     ngx_rbtree_node_t *node, ngx_rbtree_node_t *sentinel);
 static void ngx_http_file_cache_vary(ngx_http_request_t *r, u_char *vary,
@@ -45,10 +63,17 @@ static ngx_int_t ngx_http_file_cache_reopen(ngx_http_request_t *r,
 static ngx_int_t ngx_http_file_cache_update_variant(ngx_http_request_t *r,
     ngx_http_cache_t *c);
 static void ngx_http_file_cache_cleanup(void *data);
-static time_t ngx_http_file_cache_forced_expire(ngx_http_file_cache_t *cache);
+static time_t ngx_http_file_cache_forced_expire(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_shard_t *shard);
 static time_t ngx_http_file_cache_expire(ngx_http_file_cache_t *cache);
 static void ngx_http_file_cache_delete(ngx_http_file_cache_t *cache,
-    ngx_queue_t *q, u_char *name);
+    ngx_http_file_cache_shard_t *shard, ngx_queue_t *q, u_char *name);
+static ngx_http_file_cache_shard_t *
+    ngx_http_file_cache_manager_shard(ngx_http_file_cache_t *cache);
+static void ngx_http_file_cache_index_load(ngx_http_file_cache_t *cache);
+static ngx_int_t ngx_http_file_cache_index_read(ngx_http_file_cache_t *cache,
+    ngx_file_t *file, ngx_http_file_cache_index_header_t *h, ngx_uint_t add);
+static void ngx_http_file_cache_index_save(ngx_http_file_cache_t *cache);
 static void ngx_http_file_cache_loader_sleep(ngx_http_file_cache_t *cache);
 static ngx_int_t ngx_http_file_cache_noop(ngx_tree_ctx_t *ctx,
     ngx_str_t *path);
@@ -62,7 +87,23 @@ static ngx_int_t ngx_http_file_cache_add(ngx_http_file_cache_t *cache,
     ngx_http_cache_t *c);
 static ngx_int_t ngx_http_file_cache_delete_file(ngx_tree_ctx_t *ctx,
     ngx_str_t *path);
-static void ngx_http_file_cache_set_watermark(ngx_http_file_cache_t *cache);
+static void ngx_http_file_cache_set_watermark(
+    ngx_http_file_cache_shard_t *shard);
+static void ngx_http_file_cache_queue_remove(
+    ngx_http_file_cache_shard_t *shard, ngx_queue_t *q);
+static ngx_int_t ngx_http_file_cache_memory_init(ngx_shm_zone_t *shm_zone,
+    void *data);
+static ngx_int_t ngx_http_file_cache_memory_open(ngx_http_request_t *r,
+    ngx_http_cache_t *c);
+static void ngx_http_file_cache_memory_admit(ngx_http_request_t *r,
+    ngx_http_cache_t *c);
+static ngx_http_file_cache_memory_node_t *
+    ngx_http_file_cache_memory_lookup(ngx_http_file_cache_memory_sh_t *sh,
+    u_char *key);
+static void ngx_http_file_cache_memory_delete(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_memory_node_t *mn);
+static void ngx_http_file_cache_memory_remove(ngx_http_file_cache_t *cache,
+    u_char *key);
 
 
 ngx_str_t  ngx_http_cache_status[] = {
@@ -78,15 +119,39 @@ ngx_str_t  ngx_http_cache_status[] = {
 
 static u_char  ngx_http_file_cache_key[] = { LF, 'K', 'E', 'Y', ':', ' ' };
 
+static u_char  ngx_http_file_cache_index_magic[] = "NGXCIDX";
+
+
+/*
+ * requests waiting for a cache lock in this process, they are woken up
+ * when a process which held the lock notifies this one through the channel
+ */
+
+static ngx_queue_t  ngx_http_file_cache_waiters;
+static ngx_event_t  ngx_http_file_cache_wake_event;
+
+
+#if (NGX_WIN32)
+#define ngx_http_file_cache_waiter(slot)   1
+#else
+#define ngx_http_file_cache_waiter(slot)   ((uint64_t) 1 << ((slot) & 63))
+#endif
+
+
+#define ngx_http_file_cache_epoch(cache)                                      \
+    ((cache)->memory ? (cache)->memory->epoch & 0xff : 0)
+
 
 static ngx_int_t
 ngx_http_file_cache_init(ngx_shm_zone_t *shm_zone, void *data)
 {
     ngx_http_file_cache_t  *ocache = data;
 
-    size_t                  len;
-    ngx_uint_t              n;
-    ngx_http_file_cache_t  *cache;
+    u_char                       *file;
+    size_t                        len;
+    ngx_uint_t                    n;
+    ngx_http_file_cache_t        *cache;
+    ngx_http_file_cache_shard_t  *shard;
 
     cache = shm_zone->data;
 
@@ -110,6 +175,20 @@ ngx_http_file_cache_init(ngx_shm_zone_t *shm_zone, void *data)
             }
         }
 
+        if (cache->shards != ocache->shards) {
+            ngx_log_error(NGX_LOG_EMERG, shm_zone->shm.log, 0,
+                          "cache \"%V\" had previously different shards",
+                          &shm_zone->shm.name);
+            return NGX_ERROR;
+        }
+
+        if (ocache->shpool != (ngx_slab_pool_t *) shm_zone->shm.addr) {
+            ngx_log_error(NGX_LOG_EMERG, shm_zone->shm.log, 0,
+                          "cache keys zone \"%V\" was previously used "
+                          "as a memory zone", &shm_zone->shm.name);
+            return NGX_ERROR;
+        }
+
         cache->sh = ocache->sh;
 
         cache->shpool = ocache->shpool;
@@ -121,7 +200,7 @@ ngx_http_file_cache_init(ngx_shm_zone_t *shm_zone, void *data)
             cache->path->loader = NULL;
         }
 
-        return NGX_OK;
+        return ngx_http_file_cache_init_sketch(shm_zone, cache);
     }
 
     cache->shpool = (ngx_slab_pool_t *) shm_zone->shm.addr;
@@ -141,16 +220,58 @@ ngx_http_file_cache_init(ngx_shm_zone_t *shm_zone, void *data)
 
     cache->shpool->data = cache->sh;
 
-    ngx_rbtree_init(&cache->sh->rbtree, &cache->sh->sentinel,
-                    ngx_http_file_cache_rbtree_insert_value);
+    len = cache->shards * sizeof(ngx_http_file_cache_shard_t);
+
+    cache->sh->shards = ngx_slab_calloc(cache->shpool, len);
+    if (cache->sh->shards == NULL) {
+        return NGX_ERROR;
+    }
 
-    ngx_queue_init(&cache->sh->queue);
+    cache->sh->nshards = cache->shards;
+
+    for (n = 0; n < cache->shards; n++) {
+        shard = &cache->sh->shards[n];
+
+        ngx_rbtree_init(&shard->rbtree, &shard->sentinel,
+                        ngx_http_file_cache_rbtree_insert_value);
+
+        ngx_queue_init(&shard->queue);
+
+        shard->size = 0;
+        shard->count = 0;
+        shard->watermark = (ngx_uint_t) -1;
+
+#if (NGX_HAVE_ATOMIC_OPS)
+
+        file = NULL;
+
+#else
+
+        len = ngx_cycle->lock_file.len + shm_zone->shm.name.len + NGX_INT_T_LEN
+              + 2;
+
+        file = ngx_slab_alloc(cache->shpool, len);
+        if (file == NULL) {
+            return NGX_ERROR;
+        }
+
+        (void) ngx_sprintf(file, "%V%V:%ui%Z", &ngx_cycle->lock_file,
+                           &shm_zone->shm.name, n);
+
+#endif
+
+        if (ngx_shmtx_create(&shard->mutex, &shard->lock, file) != NGX_OK) {
+            return NGX_ERROR;
+        }
+    }
+
+    if (ngx_http_file_cache_init_sketch(shm_zone, cache) != NGX_OK) {
+        return NGX_ERROR;
+    }
 
     cache->sh->cold = 1;
     cache->sh->loading = 0;
-    cache->sh->size = 0;
-    cache->sh->count = 0;
-    cache->sh->watermark = (ngx_uint_t) -1;
+    cache->sh->indexed = 0;
 
     cache->bsize = ngx_fs_bsize(cache->path->name.data);
 
@@ -172,6 +293,121 @@ ngx_http_file_cache_init(ngx_shm_zone_t *shm_zone, void *data)
 }
 
 
+static ngx_int_t
+ngx_http_file_cache_init_sketch(ngx_shm_zone_t *shm_zone,
+    ngx_http_file_cache_t *cache)
+{
+    size_t                        n, width;
+    ngx_uint_t                    i, shift;
+    ngx_http_file_cache_shard_t  *shard;
+
+    if (cache->eviction != NGX_HTTP_CACHE_EVICT_TINYLFU
+        || cache->sh->shards[0].sketch)
+    {
+        return NGX_OK;
+    }
+
+    /*
+     * a sketch row has a counter per every 256 bytes of the zone,
+     * which is about twice the number of nodes the zone can hold
+     */
+
+    n = shm_zone->shm.size / 256 / cache->sh->nshards;
+
+    width = 64;
+    shift = 32 - 6;
+
+    while (width < n && shift > 1) {
+        width <<= 1;
+        shift--;
+    }
+
+    for (i = 0; i < cache->sh->nshards; i++) {
+        shard = &cache->sh->shards[i];
+
+        shard->sketch = ngx_slab_calloc(cache->shpool,
+                                        NGX_HTTP_CACHE_SKETCH_DEPTH * width);
+        if (shard->sketch == NULL) {
+            return NGX_ERROR;
+        }
+
+        shard->sketch_shift = shift;
+        shard->samples = 0;
+        shard->aging = 0;
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_file_cache_memory_init(ngx_shm_zone_t *shm_zone, void *data)
+{
+    ngx_http_file_cache_t  *ocache = data;
+
+    size_t                  len;
+    ngx_http_file_cache_t  *cache;
+
+    cache = shm_zone->data;
+
+    if (ocache) {
+        if (ocache->mpool != (ngx_slab_pool_t *) shm_zone->shm.addr) {
+            ngx_log_error(NGX_LOG_EMERG, shm_zone->shm.log, 0,
+                          "cache memory zone \"%V\" was previously used "
+                          "as a keys zone", &shm_zone->shm.name);
+            return NGX_ERROR;
+        }
+
+        cache->memory = ocache->memory;
+        cache->mpool = ocache->mpool;
+
+        return NGX_OK;
+    }
+
+    cache->mpool = (ngx_slab_pool_t *) shm_zone->shm.addr;
+
+    if (shm_zone->shm.exists) {
+        cache->memory = cache->mpool->data;
+
+        return NGX_OK;
+    }
+
+    cache->memory = ngx_slab_alloc(cache->mpool,
+                                   sizeof(ngx_http_file_cache_memory_sh_t));
+    if (cache->memory == NULL) {
+        return NGX_ERROR;
+    }
+
+    cache->mpool->data = cache->memory;
+
+    /* memory nodes start with the same rbtree node, queue and key */
+
+    ngx_rbtree_init(&cache->memory->rbtree, &cache->memory->sentinel,
+                    ngx_http_file_cache_rbtree_insert_value);
+
+    ngx_queue_init(&cache->memory->queue);
+
+    cache->memory->size = 0;
+    cache->memory->count = 0;
+    cache->memory->attempts = 0;
+    cache->memory->epoch = 0;
+
+    len = sizeof(" in cache memory zone \"\"") + shm_zone->shm.name.len;
+
+    cache->mpool->log_ctx = ngx_slab_alloc(cache->mpool, len);
+    if (cache->mpool->log_ctx == NULL) {
+        return NGX_ERROR;
+    }
+
+    ngx_sprintf(cache->mpool->log_ctx, " in cache memory zone \"%V\"%Z",
+                &shm_zone->shm.name);
+
+    cache->mpool->log_nomem = 0;
+
+    return NGX_OK;
+}
+
+
 ngx_int_t
 ngx_http_file_cache_new(ngx_http_request_t *r)
 {
@@ -309,6 +545,15 @@ ngx_http_file_cache_open(ngx_http_request_t *r)
         return NGX_HTTP_CACHE_SCARCE;
     }
 
+    if (cache->eviction == NGX_HTTP_CACHE_EVICT_TINYLFU
+        && !c->exists
+        && !c->error
+        && !cache->sh->cold
+        && ngx_http_file_cache_admit(cache, c) != NGX_OK)
+    {
+        return NGX_HTTP_CACHE_SCARCE;
+    }
+
     if (rc == NGX_OK) {
 
         if (c->error) {
@@ -345,6 +590,19 @@ ngx_http_file_cache_open(ngx_http_request_t *r)
         goto done;
     }
 
+    c->buf = NULL;
+
+    if (cache->memory && c->exists) {
+        c->buf = ngx_create_temp_buf(r->pool, c->buffer_size);
+        if (c->buf == NULL) {
+            return NGX_ERROR;
+        }
+
+        if (ngx_http_file_cache_memory_open(r, c) == NGX_OK) {
+            return ngx_http_file_cache_read(r, c);
+        }
+    }
+
     clcf = ngx_http_get_module_loc_conf(r, ngx_http_core_module);
 
     ngx_memzero(&of, sizeof(ngx_open_file_info_t));
@@ -381,12 +639,37 @@ ngx_http_file_cache_open(ngx_http_request_t *r)
     c->file.fd = of.fd;
     c->file.log = r->connection->log;
     c->uniq = of.uniq;
+
+    if (cache->memory && c->node->uniq == 0) {
+
+        /*
+         * nodes added by the cache loader do not know the file uniq,
+         * while memory entries are checked against it
+         */
+
+        ngx_shmtx_lock(&c->shard->mutex);
+
+        if (c->node->exists && c->node->uniq == 0) {
+            c->node->uniq = of.uniq;
+        }
+
+        ngx_shmtx_unlock(&c->shard->mutex);
+    }
+
     c->length = of.size;
     c->fs_size = (of.fs_size + cache->bsize - 1) / cache->bsize;
 
-    c->buf = ngx_create_temp_buf(r->pool, c->body_start);
-    if (c->buf == NULL) {
-        return NGX_ERROR;
+    if (c->buf == NULL || c->body_start > c->buffer_size) {
+        c->buf = ngx_create_temp_buf(r->pool, c->body_start);
+        if (c->buf == NULL) {
+            return NGX_ERROR;
+        }
+
+    } else if (of.size <= (off_t) c->buffer_size) {
+
+        /* small files are read entirely to be admitted to the memory zone */
+
+        c->body_start = (size_t) of.size;
     }
 
     return ngx_http_file_cache_read(r, c);
@@ -404,8 +687,7 @@ done:
 static ngx_int_t
 ngx_http_file_cache_lock(ngx_http_request_t *r, ngx_http_cache_t *c)
 {
-    ngx_msec_t                 now, timer;
-    ngx_http_file_cache_t     *cache;
+    ngx_msec_t  now, timer;
 
     if (!c->lock) {
         return NGX_DECLINED;
@@ -413,9 +695,7 @@ ngx_http_file_cache_lock(ngx_http_request_t *r, ngx_http_cache_t *c)
 
     now = ngx_current_msec;
 
-    cache = c->file_cache;
-
-    ngx_shmtx_lock(&cache->shpool->mutex);
+    ngx_shmtx_lock(&c->shard->mutex);
 
     timer = c->node->lock_time - now;
 
@@ -424,9 +704,12 @@ ngx_http_file_cache_lock(ngx_http_request_t *r, ngx_http_cache_t *c)
         c->node->lock_time = now + c->lock_age;
         c->updating = 1;
         c->lock_time = c->node->lock_time;
+
+    } else if (c->lock_timeout) {
+        c->node->waiters |= ngx_http_file_cache_waiter(ngx_process_slot);
     }
 
-    ngx_shmtx_unlock(&cache->shpool->mutex);
+    ngx_shmtx_unlock(&c->shard->mutex);
 
     ngx_log_debug2(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
                    "http file cache lock u:%d wt:%M",
@@ -452,8 +735,12 @@ ngx_http_file_cache_lock(ngx_http_request_t *r, ngx_http_cache_t *c)
 
     timer = c->wait_time - now;
 
+    /* the timer is a fallback in case a notification is lost */
+
     ngx_add_timer(&c->wait_event, (timer > 500) ? 500 : timer);
 
+    ngx_http_file_cache_wait(c);
+
     r->main->blocked++;
 
     return NGX_AGAIN;
@@ -481,6 +768,8 @@ ngx_http_file_cache_lock_wait_handler(ngx_event_t *ev)
         return;
     }
 
+    ngx_queue_remove(&r->cache->wait_queue);
+
     r->cache->waiting = 0;
     r->main->blocked--;
 
@@ -502,9 +791,8 @@ ngx_http_file_cache_lock_wait_handler(ngx_event_t *ev)
 static ngx_int_t
 ngx_http_file_cache_lock_wait(ngx_http_request_t *r, ngx_http_cache_t *c)
 {
-    ngx_uint_t              wait;
-    ngx_msec_t              now, timer;
-    ngx_http_file_cache_t  *cache;
+    ngx_uint_t  wait;
+    ngx_msec_t  now, timer;
 
     now = ngx_current_msec;
 
@@ -517,18 +805,18 @@ ngx_http_file_cache_lock_wait(ngx_http_request_t *r, ngx_http_cache_t *c)
         return NGX_OK;
     }
 
-    cache = c->file_cache;
     wait = 0;
 
-    ngx_shmtx_lock(&cache->shpool->mutex);
+    ngx_shmtx_lock(&c->shard->mutex);
 
     timer = c->node->lock_time - now;
 
     if (c->node->updating && (ngx_msec_int_t) timer > 0) {
+        c->node->waiters |= ngx_http_file_cache_waiter(ngx_process_slot);
         wait = 1;
     }
 
-    ngx_shmtx_unlock(&cache->shpool->mutex);
+    ngx_shmtx_unlock(&c->shard->mutex);
 
     if (wait) {
         ngx_add_timer(&c->wait_event, (timer > 500) ? 500 : timer);
@@ -539,6 +827,112 @@ ngx_http_file_cache_lock_wait(ngx_http_request_t *r, ngx_http_cache_t *c)
 }
 
 
+static void
+ngx_http_file_cache_wait(ngx_http_cache_t *c)
+{
+    ngx_event_t  *ev;
+
+    ev = &ngx_http_file_cache_wake_event;
+
+    if (ev->handler == NULL) {
+        ngx_queue_init(&ngx_http_file_cache_waiters);
+
+        ev->handler = ngx_http_file_cache_wake_handler;
+        ev->log = ngx_cycle->log;
+
+#if !(NGX_WIN32)
+        ngx_channel_notify_event = ev;
+#endif
+    }
+
+    ngx_queue_insert_tail(&ngx_http_file_cache_waiters, &c->wait_queue);
+}
+
+
+static void
+ngx_http_file_cache_wake_handler(ngx_event_t *ev)
+{
+    ngx_queue_t       *q;
+    ngx_http_cache_t  *c;
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, ev->log, 0, "http file cache wake");
+
+    /*
+     * all waiters of this process are woken up, the ones
+     * whose lock is still held will wait again
+     */
+
+    for (q = ngx_queue_head(&ngx_http_file_cache_waiters);
+         q != ngx_queue_sentinel(&ngx_http_file_cache_waiters);
+         q = ngx_queue_next(q))
+    {
+        c = ngx_queue_data(q, ngx_http_cache_t, wait_queue);
+
+        if (c->wait_event.timer_set) {
+            ngx_del_timer(&c->wait_event);
+        }
+
+        if (!c->wait_event.posted) {
+            ngx_post_event(&c->wait_event, &ngx_posted_events);
+        }
+    }
+}
+
+
+static void
+ngx_http_file_cache_notify(uint64_t waiters, ngx_log_t *log)
+{
+#if !(NGX_WIN32)
+    ngx_int_t      s;
+    ngx_channel_t  ch;
+#endif
+
+    if (waiters == 0) {
+        return;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, log, 0,
+                   "http file cache notify: %uL", waiters);
+
+    if ((waiters & ngx_http_file_cache_waiter(ngx_process_slot))
+        && ngx_http_file_cache_wake_event.handler)
+    {
+        ngx_post_event(&ngx_http_file_cache_wake_event, &ngx_posted_events);
+    }
+
+#if !(NGX_WIN32)
+
+    if (ngx_process != NGX_PROCESS_WORKER) {
+        return;
+    }
+
+    ngx_memzero(&ch, sizeof(ngx_channel_t));
+
+    ch.command = NGX_CMD_NOTIFY;
+    ch.pid = ngx_pid;
+    ch.slot = ngx_process_slot;
+    ch.fd = -1;
+
+    for (s = 0; s < ngx_last_process; s++) {
+
+        if (s == ngx_process_slot
+            || ngx_processes[s].pid == -1
+            || ngx_processes[s].channel[0] == -1
+            || !(waiters & ngx_http_file_cache_waiter(s)))
+        {
+            continue;
+        }
+
+        /* a failed write is covered by the waiters' timers */
+
+        (void) ngx_write_channel(ngx_processes[s].channel[0], &ch,
+                                 sizeof(ngx_channel_t), log);
+    }
+
+#endif
+}
+
+
 static ngx_int_t
 ngx_http_file_cache_read(ngx_http_request_t *r, ngx_http_cache_t *c)
 {
@@ -551,10 +945,15 @@ ngx_http_file_cache_read(ngx_http_request_t *r, ngx_http_cache_t *c)
     ngx_http_file_cache_t         *cache;
     ngx_http_file_cache_header_t  *h;
 
-    n = ngx_http_file_cache_aio_read(r, c);
+    if (c->memory) {
+        n = (ssize_t) c->length;
 
-    if (n < 0) {
-        return n;
+    } else {
+        n = ngx_http_file_cache_aio_read(r, c);
+
+        if (n < 0) {
+            return n;
+        }
     }
 
     if ((size_t) n < c->header_start) {
@@ -634,7 +1033,7 @@ ngx_http_file_cache_read(ngx_http_request_t *r, ngx_http_cache_t *c)
 
     if (cache->sh->cold) {
 
-        ngx_shmtx_lock(&cache->shpool->mutex);
+        ngx_shmtx_lock(&c->shard->mutex);
 
         if (!c->node->exists) {
             c->node->uses = 1;
@@ -643,10 +1042,10 @@ ngx_http_file_cache_read(ngx_http_request_t *r, ngx_http_cache_t *c)
             c->node->uniq = c->uniq;
             c->node->fs_size = c->fs_size;
 
-            cache->sh->size += c->fs_size;
+            c->shard->size += c->fs_size;
         }
 
-        ngx_shmtx_unlock(&cache->shpool->mutex);
+        ngx_shmtx_unlock(&c->shard->mutex);
     }
 
     now = ngx_time();
@@ -655,7 +1054,7 @@ ngx_http_file_cache_read(ngx_http_request_t *r, ngx_http_cache_t *c)
         c->stale_updating = c->valid_sec + c->updating_sec >= now;
         c->stale_error = c->valid_sec + c->error_sec >= now;
 
-        ngx_shmtx_lock(&cache->shpool->mutex);
+        ngx_shmtx_lock(&c->shard->mutex);
 
         if (c->node->updating) {
             rc = NGX_HTTP_CACHE_UPDATING;
@@ -667,7 +1066,7 @@ ngx_http_file_cache_read(ngx_http_request_t *r, ngx_http_cache_t *c)
             rc = NGX_HTTP_CACHE_STALE;
         }
 
-        ngx_shmtx_unlock(&cache->shpool->mutex);
+        ngx_shmtx_unlock(&c->shard->mutex);
 
         ngx_log_debug3(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
                        "http file cache expired: %i %T %T",
@@ -676,6 +1075,13 @@ ngx_http_file_cache_read(ngx_http_request_t *r, ngx_http_cache_t *c)
         return rc;
     }
 
+    if (cache->memory
+        && !c->memory
+        && (off_t) (c->buf->last - c->buf->pos) == c->length)
+    {
+        ngx_http_file_cache_memory_admit(r, c);
+    }
+
     return NGX_OK;
 }
 
@@ -880,19 +1286,34 @@ ngx_http_cache_thread_event_handler(ngx_event_t *ev)
 static ngx_int_t
 ngx_http_file_cache_exists(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
 {
-    ngx_int_t                    rc;
-    ngx_http_file_cache_node_t  *fcn;
+    ngx_int_t                     rc;
+    ngx_uint_t                    i, n;
+    ngx_http_file_cache_node_t   *fcn;
+    ngx_http_file_cache_shard_t  *shard, *victim;
 
-    ngx_shmtx_lock(&cache->shpool->mutex);
+    shard = ngx_http_file_cache_shard(cache, c->key);
+
+    ngx_shmtx_lock(&shard->mutex);
 
     fcn = c->node;
 
     if (fcn == NULL) {
-        fcn = ngx_http_file_cache_lookup(cache, c->key);
+        fcn = ngx_http_file_cache_lookup(shard, c->key);
+
+        if (fcn && fcn->exists) {
+            shard->hits++;
+
+        } else {
+            shard->misses++;
+        }
+
+        if (cache->eviction == NGX_HTTP_CACHE_EVICT_TINYLFU) {
+            ngx_http_file_cache_sketch_add(shard, c->key);
+        }
     }
 
     if (fcn) {
-        ngx_queue_remove(&fcn->queue);
+        ngx_http_file_cache_queue_remove(shard, &fcn->queue);
 
         if (c->node == NULL) {
             fcn->uses++;
@@ -927,19 +1348,31 @@ ngx_http_file_cache_exists(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
         goto done;
     }
 
-    fcn = ngx_slab_calloc_locked(cache->shpool,
-                                 sizeof(ngx_http_file_cache_node_t));
+    fcn = ngx_slab_calloc(cache->shpool, sizeof(ngx_http_file_cache_node_t));
     if (fcn == NULL) {
-        ngx_http_file_cache_set_watermark(cache);
+        ngx_http_file_cache_set_watermark(shard);
+
+        ngx_shmtx_unlock(&shard->mutex);
+
+        /*
+         * all shards allocate from the same zone, so if nothing can be
+         * expired in this shard, the other ones are tried in turn
+         */
+
+        n = shard - cache->sh->shards;
 
-        ngx_shmtx_unlock(&cache->shpool->mutex);
+        for (i = 0; i < cache->sh->nshards; i++) {
+            victim = &cache->sh->shards[(n + i) % cache->sh->nshards];
 
-        (void) ngx_http_file_cache_forced_expire(cache);
+            if (ngx_http_file_cache_forced_expire(cache, victim) == 0) {
+                break;
+            }
+        }
 
-        ngx_shmtx_lock(&cache->shpool->mutex);
+        ngx_shmtx_lock(&shard->mutex);
 
-        fcn = ngx_slab_calloc_locked(cache->shpool,
-                                     sizeof(ngx_http_file_cache_node_t));
+        fcn = ngx_slab_calloc(cache->shpool,
+                              sizeof(ngx_http_file_cache_node_t));
         if (fcn == NULL) {
             ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, 0,
                           "could not allocate node%s", cache->shpool->log_ctx);
@@ -948,17 +1381,18 @@ ngx_http_file_cache_exists(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
         }
     }
 
-    cache->sh->count++;
+    shard->count++;
 
     ngx_memcpy((u_char *) &fcn->node.key, c->key, sizeof(ngx_rbtree_key_t));
 
     ngx_memcpy(fcn->key, &c->key[sizeof(ngx_rbtree_key_t)],
                NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t));
 
-    ngx_rbtree_insert(&cache->sh->rbtree, &fcn->node);
+    ngx_rbtree_insert(&shard->rbtree, &fcn->node);
 
     fcn->uses = 1;
     fcn->count = 1;
+    fcn->epoch = ngx_http_file_cache_epoch(cache);
 
 renew:
 
@@ -976,15 +1410,16 @@ done:
 
     fcn->expire = ngx_time() + cache->inactive;
 
-    ngx_queue_insert_head(&cache->sh->queue, &fcn->queue);
+    ngx_queue_insert_head(&shard->queue, &fcn->queue);
 
     c->uniq = fcn->uniq;
     c->error = fcn->error;
     c->node = fcn;
+    c->shard = shard;
 
 failed:
 
-    ngx_shmtx_unlock(&cache->shpool->mutex);
+    ngx_shmtx_unlock(&shard->mutex);
 
     return rc;
 }
@@ -1025,27 +1460,181 @@ ngx_http_file_cache_name(ngx_http_request_t *r, ngx_path_t *path)
 }
 
 
-static ngx_http_file_cache_node_t *
-ngx_http_file_cache_lookup(ngx_http_file_cache_t *cache, u_char *key)
+static ngx_http_file_cache_shard_t *
+ngx_http_file_cache_shard(ngx_http_file_cache_t *cache, u_char *key)
 {
-    ngx_int_t                    rc;
-    ngx_rbtree_key_t             node_key;
-    ngx_rbtree_node_t           *node, *sentinel;
-    ngx_http_file_cache_node_t  *fcn;
+    ngx_uint_t  n;
 
-    ngx_memcpy((u_char *) &node_key, key, sizeof(ngx_rbtree_key_t));
+    /*
+     * the leading key bytes are used for the rbtree key,
+     * so the shard is selected by the trailing ones
+     */
 
-    node = cache->sh->rbtree.root;
-    sentinel = cache->sh->rbtree.sentinel;
+    n = key[NGX_HTTP_CACHE_KEY_LEN - 2] << 8 | key[NGX_HTTP_CACHE_KEY_LEN - 1];
 
-    while (node != sentinel) {
+    return &cache->sh->shards[n % cache->sh->nshards];
+}
 
-        if (node_key < node->key) {
-            node = node->left;
-            continue;
-        }
 
-        if (node_key > node->key) {
+static void
+ngx_http_file_cache_sketch_add(ngx_http_file_cache_shard_t *shard,
+    u_char *key)
+{
+    u_char      *row, *p;
+    uint32_t     h;
+    ngx_uint_t   i, n, width;
+
+    width = (ngx_uint_t) 1 << (32 - shard->sketch_shift);
+
+    for (i = 0; i < NGX_HTTP_CACHE_SKETCH_DEPTH; i++) {
+        ngx_memcpy(&h, &key[i * 4], 4);
+
+        h = (uint32_t) (h * 0x9e3779b1) >> shard->sketch_shift;
+        row = shard->sketch + i * width;
+
+        if (row[h] < 255) {
+            row[h]++;
+        }
+    }
+
+    /*
+     * aging: all counters are halved after every 10 * width samples,
+     * a few hundred of them per sample to keep the shard lock hold short
+     */
+
+    if (shard->aging) {
+        n = ngx_min(shard->aging, NGX_HTTP_CACHE_SKETCH_AGING);
+        p = shard->sketch + NGX_HTTP_CACHE_SKETCH_DEPTH * width - shard->aging;
+
+        for (i = 0; i < n; i++) {
+            p[i] >>= 1;
+        }
+
+        shard->aging -= n;
+    }
+
+    if (++shard->samples < 10 * width) {
+        return;
+    }
+
+    shard->samples = 0;
+    shard->aging = NGX_HTTP_CACHE_SKETCH_DEPTH * width;
+}
+
+
+static ngx_uint_t
+ngx_http_file_cache_sketch_estimate(ngx_http_file_cache_shard_t *shard,
+    u_char *key)
+{
+    u_char      *row;
+    uint32_t     h;
+    ngx_uint_t   i, width, min;
+
+    width = (ngx_uint_t) 1 << (32 - shard->sketch_shift);
+    min = 255;
+
+    for (i = 0; i < NGX_HTTP_CACHE_SKETCH_DEPTH; i++) {
+        ngx_memcpy(&h, &key[i * 4], 4);
+
+        h = (uint32_t) (h * 0x9e3779b1) >> shard->sketch_shift;
+        row = shard->sketch + i * width;
+
+        if (row[h] < min) {
+            min = row[h];
+        }
+    }
+
+    return min;
+}
+
+
+static ngx_int_t
+ngx_http_file_cache_admit(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
+{
+    off_t                         limit;
+    ngx_int_t                     rc;
+    ngx_uint_t                    freq, vfreq, watermark;
+    ngx_queue_t                  *q;
+    ngx_http_file_cache_node_t   *fcn;
+    ngx_http_file_cache_shard_t  *shard;
+    u_char                        key[NGX_HTTP_CACHE_KEY_LEN];
+
+    shard = c->shard;
+
+    limit = cache->max_size / cache->sh->nshards;
+
+    ngx_shmtx_lock(&shard->mutex);
+
+    watermark = shard->watermark;
+
+    /*
+     * while the shard is not close to its limits, everything is admitted;
+     * otherwise a new entry has to be more frequently requested than
+     * the least recently used one, which is going to be evicted for it
+     */
+
+    if (shard->size < limit - limit / 8
+        && shard->count < watermark - watermark / 8)
+    {
+        rc = NGX_OK;
+        goto done;
+    }
+
+    q = ngx_queue_last(&shard->queue);
+    fcn = ngx_queue_data(q, ngx_http_file_cache_node_t, queue);
+
+    if (fcn == c->node) {
+        rc = NGX_OK;
+        goto done;
+    }
+
+    ngx_memcpy(key, &fcn->node.key, sizeof(ngx_rbtree_key_t));
+    ngx_memcpy(&key[sizeof(ngx_rbtree_key_t)], fcn->key,
+               NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t));
+
+    freq = ngx_http_file_cache_sketch_estimate(shard, c->key);
+    vfreq = ngx_http_file_cache_sketch_estimate(shard, key);
+
+    if (freq > vfreq) {
+        rc = NGX_OK;
+
+    } else {
+        shard->rejected++;
+        rc = NGX_DECLINED;
+    }
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, c->file.log, 0,
+                   "http file cache admit: %ui, victim: %ui", freq, vfreq);
+
+done:
+
+    ngx_shmtx_unlock(&shard->mutex);
+
+    return rc;
+}
+
+
+static ngx_http_file_cache_node_t *
+ngx_http_file_cache_lookup(ngx_http_file_cache_shard_t *shard, u_char *key)
+{
+    ngx_int_t                    rc;
+    ngx_rbtree_key_t             node_key;
+    ngx_rbtree_node_t           *node, *sentinel;
+    ngx_http_file_cache_node_t  *fcn;
+
+    ngx_memcpy((u_char *) &node_key, key, sizeof(ngx_rbtree_key_t));
+
+    node = shard->rbtree.root;
+    sentinel = shard->rbtree.sentinel;
+
+    while (node != sentinel) {
+
+        if (node_key < node->key) {
+            node = node->left;
+            continue;
+        }
+
+        if (node_key > node->key) {
             node = node->right;
             continue;
         }
@@ -1113,6 +1702,260 @@ ngx_http_file_cache_rbtree_insert_value(ngx_rbtree_node_t *temp,
 }
 
 
+static ngx_int_t
+ngx_http_file_cache_memory_open(ngx_http_request_t *r, ngx_http_cache_t *c)
+{
+    ngx_http_file_cache_t              *cache;
+    ngx_http_file_cache_memory_node_t  *mn;
+
+    cache = c->file_cache;
+
+    ngx_shmtx_lock(&cache->mpool->mutex);
+
+    mn = ngx_http_file_cache_memory_lookup(cache->memory, c->key);
+
+    if (mn == NULL) {
+        ngx_shmtx_unlock(&cache->mpool->mutex);
+        return NGX_DECLINED;
+    }
+
+    if (mn->uniq != c->uniq) {
+
+        /* the cache file was replaced */
+
+        ngx_http_file_cache_memory_delete(cache, mn);
+        ngx_shmtx_unlock(&cache->mpool->mutex);
+        return NGX_DECLINED;
+    }
+
+    if (mn->len > c->buffer_size) {
+        ngx_shmtx_unlock(&cache->mpool->mutex);
+        return NGX_DECLINED;
+    }
+
+    ngx_memcpy(c->buf->pos, mn->data, mn->len);
+
+    c->length = mn->len;
+    c->memory = 1;
+
+    mn->uses++;
+
+    ngx_queue_remove(&mn->queue);
+    ngx_queue_insert_head(&cache->memory->queue, &mn->queue);
+
+    ngx_shmtx_unlock(&cache->mpool->mutex);
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "http file cache memory hit: %O", c->length);
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_http_file_cache_memory_admit(ngx_http_request_t *r, ngx_http_cache_t *c)
+{
+    size_t                              size;
+    ngx_uint_t                          uses, tries, epoch, n;
+    ngx_queue_t                        *q;
+    ngx_http_file_cache_t              *cache;
+    ngx_http_file_cache_memory_node_t  *mn, *victim;
+
+    cache = c->file_cache;
+
+    ngx_shmtx_lock(&c->shard->mutex);
+
+    /*
+     * the uses of the candidate are halved lazily as many times
+     * as the frequencies of the memory entries were halved since
+     * it was last seen here, so they are compared on equal terms
+     */
+
+    epoch = cache->memory->epoch & 0xff;
+    n = (epoch - c->node->epoch) & 0xff;
+
+    if (n) {
+        c->node->uses = (n < 10) ? c->node->uses >> n : 0;
+        c->node->epoch = epoch;
+    }
+
+    uses = c->node->uses;
+
+    if (c->node->uniq != c->uniq) {
+
+        /* the cache file was replaced after it was read */
+
+        uses = 0;
+    }
+
+    ngx_shmtx_unlock(&c->shard->mutex);
+
+    /* a doorkeeper: one-hit wonders are never admitted */
+
+    if (uses < 2) {
+        return;
+    }
+
+    size = offsetof(ngx_http_file_cache_memory_node_t, data) + c->length;
+
+    ngx_shmtx_lock(&cache->mpool->mutex);
+
+    if (ngx_http_file_cache_memory_lookup(cache->memory, c->key)) {
+        goto done;
+    }
+
+    /*
+     * TinyLFU aging: once the number of admission attempts exceeds
+     * ten times the number of entries, all frequencies are halved
+     */
+
+    if (++cache->memory->attempts > 10 * cache->memory->count) {
+        cache->memory->attempts = 0;
+        cache->memory->epoch++;
+
+        for (q = ngx_queue_head(&cache->memory->queue);
+             q != ngx_queue_sentinel(&cache->memory->queue);
+             q = ngx_queue_next(q))
+        {
+            mn = ngx_queue_data(q, ngx_http_file_cache_memory_node_t, queue);
+            mn->uses /= 2;
+        }
+    }
+
+    for (tries = 0; /* void */ ; tries++) {
+
+        mn = ngx_slab_alloc_locked(cache->mpool, size);
+        if (mn) {
+            break;
+        }
+
+        if (tries == 8 || ngx_queue_empty(&cache->memory->queue)) {
+            goto done;
+        }
+
+        /*
+         * TinyLFU: an entry is admitted only if it is used more often
+         * than the least recently used one it would replace
+         */
+
+        q = ngx_queue_last(&cache->memory->queue);
+        victim = ngx_queue_data(q, ngx_http_file_cache_memory_node_t, queue);
+
+        if (victim->uses >= uses) {
+            goto done;
+        }
+
+        ngx_http_file_cache_memory_delete(cache, victim);
+    }
+
+    ngx_memcpy((u_char *) &mn->node.key, c->key, sizeof(ngx_rbtree_key_t));
+
+    ngx_memcpy(mn->key, &c->key[sizeof(ngx_rbtree_key_t)],
+               NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t));
+
+    mn->uses = uses;
+    mn->uniq = c->uniq;
+    mn->len = (size_t) c->length;
+
+    ngx_memcpy(mn->data, c->buf->pos, mn->len);
+
+    ngx_rbtree_insert(&cache->memory->rbtree, &mn->node);
+    ngx_queue_insert_head(&cache->memory->queue, &mn->queue);
+
+    cache->memory->size += mn->len;
+    cache->memory->count++;
+
+    ngx_log_debug3(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "http file cache memory admit: %uz u:%ui c:%ui",
+                   mn->len, uses, cache->memory->count);
+
+done:
+
+    ngx_shmtx_unlock(&cache->mpool->mutex);
+}
+
+
+static ngx_http_file_cache_memory_node_t *
+ngx_http_file_cache_memory_lookup(ngx_http_file_cache_memory_sh_t *sh,
+    u_char *key)
+{
+    ngx_int_t                           rc;
+    ngx_rbtree_key_t                    node_key;
+    ngx_rbtree_node_t                  *node, *sentinel;
+    ngx_http_file_cache_memory_node_t  *mn;
+
+    ngx_memcpy((u_char *) &node_key, key, sizeof(ngx_rbtree_key_t));
+
+    node = sh->rbtree.root;
+    sentinel = sh->rbtree.sentinel;
+
+    while (node != sentinel) {
+
+        if (node_key < node->key) {
+            node = node->left;
+            continue;
+        }
+
+        if (node_key > node->key) {
+            node = node->right;
+            continue;
+        }
+
+        /* node_key == node->key */
+
+        mn = (ngx_http_file_cache_memory_node_t *) node;
+
+        rc = ngx_memcmp(&key[sizeof(ngx_rbtree_key_t)], mn->key,
+                        NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t));
+
+        if (rc == 0) {
+            return mn;
+        }
+
+        node = (rc < 0) ? node->left : node->right;
+    }
+
+    /* not found */
+
+    return NULL;
+}
+
+
+static void
+ngx_http_file_cache_memory_delete(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_memory_node_t *mn)
+{
+    ngx_queue_remove(&mn->queue);
+    ngx_rbtree_delete(&cache->memory->rbtree, &mn->node);
+
+    cache->memory->size -= mn->len;
+    cache->memory->count--;
+
+    ngx_slab_free_locked(cache->mpool, mn);
+}
+
+
+static void
+ngx_http_file_cache_memory_remove(ngx_http_file_cache_t *cache, u_char *key)
+{
+    ngx_http_file_cache_memory_node_t  *mn;
+
+    if (cache->memory == NULL) {
+        return;
+    }
+
+    ngx_shmtx_lock(&cache->mpool->mutex);
+
+    mn = ngx_http_file_cache_memory_lookup(cache->memory, key);
+
+    if (mn) {
+        ngx_http_file_cache_memory_delete(cache, mn);
+    }
+
+    ngx_shmtx_unlock(&cache->mpool->mutex);
+}
+
+
 static void
 ngx_http_file_cache_vary(ngx_http_request_t *r, u_char *vary, size_t len,
     u_char *hash)
@@ -1268,8 +2111,6 @@ ngx_http_file_cache_vary_header(ngx_http_request_t *r, ngx_md5_t *md5,
 static ngx_int_t
 ngx_http_file_cache_reopen(ngx_http_request_t *r, ngx_http_cache_t *c)
 {
-    ngx_http_file_cache_t  *cache;
-
     ngx_log_debug0(NGX_LOG_DEBUG_HTTP, c->file.log, 0,
                    "http file cache reopen");
 
@@ -1280,16 +2121,15 @@ ngx_http_file_cache_reopen(ngx_http_request_t *r, ngx_http_cache_t *c)
         return NGX_DECLINED;
     }
 
-    cache = c->file_cache;
-
-    ngx_shmtx_lock(&cache->shpool->mutex);
+    ngx_shmtx_lock(&c->shard->mutex);
 
     c->node->count--;
     c->node = NULL;
 
-    ngx_shmtx_unlock(&cache->shpool->mutex);
+    ngx_shmtx_unlock(&c->shard->mutex);
 
     c->secondary = 1;
+    c->memory = 0;
     c->file.name.len = 0;
     c->body_start = c->buffer_size;
 
@@ -1367,6 +2207,7 @@ ngx_http_file_cache_set_header(ngx_http_request_t *r, u_char *buf)
 static ngx_int_t
 ngx_http_file_cache_update_variant(ngx_http_request_t *r, ngx_http_cache_t *c)
 {
+    uint64_t                waiters;
     ngx_http_file_cache_t  *cache;
 
     if (!c->secondary) {
@@ -1389,13 +2230,19 @@ ngx_http_file_cache_update_variant(ngx_http_request_t *r, ngx_http_cache_t *c)
     ngx_log_debug0(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
                    "http file cache main key");
 
-    ngx_shmtx_lock(&cache->shpool->mutex);
+    ngx_shmtx_lock(&c->shard->mutex);
 
     c->node->count--;
     c->node->updating = 0;
+
+    waiters = c->node->waiters;
+    c->node->waiters = 0;
+
     c->node = NULL;
 
-    ngx_shmtx_unlock(&cache->shpool->mutex);
+    ngx_shmtx_unlock(&c->shard->mutex);
+
+    ngx_http_file_cache_notify(waiters, r->connection->log);
 
     c->file.name.len = 0;
     c->update_variant = 1;
@@ -1418,6 +2265,7 @@ void
 ngx_http_file_cache_update(ngx_http_request_t *r, ngx_temp_file_t *tf)
 {
     off_t                   fs_size;
+    uint64_t                waiters;
     ngx_int_t               rc;
     ngx_file_uniq_t         uniq;
     ngx_file_info_t         fi;
@@ -1469,14 +2317,14 @@ ngx_http_file_cache_update(ngx_http_request_t *r, ngx_temp_file_t *tf)
         }
     }
 
-    ngx_shmtx_lock(&cache->shpool->mutex);
+    ngx_shmtx_lock(&c->shard->mutex);
 
     c->node->count--;
     c->node->error = 0;
     c->node->uniq = uniq;
     c->node->body_start = c->body_start;
 
-    cache->sh->size += fs_size - c->node->fs_size;
+    c->shard->size += fs_size - c->node->fs_size;
     c->node->fs_size = fs_size;
 
     if (rc == NGX_OK) {
@@ -1485,7 +2333,14 @@ ngx_http_file_cache_update(ngx_http_request_t *r, ngx_temp_file_t *tf)
 
     c->node->updating = 0;
 
-    ngx_shmtx_unlock(&cache->shpool->mutex);
+    waiters = c->node->waiters;
+    c->node->waiters = 0;
+
+    ngx_shmtx_unlock(&c->shard->mutex);
+
+    ngx_http_file_cache_memory_remove(cache, c->key);
+
+    ngx_http_file_cache_notify(waiters, r->connection->log);
 }
 
 
@@ -1612,6 +2467,10 @@ ngx_http_file_cache_update_header(ngx_http_request_t *r)
     (void) ngx_write_file(&file, (u_char *) &h,
                           sizeof(ngx_http_file_cache_header_t), 0);
 
+    /* the memory copy still has the old header */
+
+    ngx_http_file_cache_memory_remove(c->file_cache, c->key);
+
 done:
 
     if (ngx_close_file(file.fd) == NGX_FILE_ERROR) {
@@ -1652,17 +2511,25 @@ ngx_http_cache_send(ngx_http_request_t *r)
         return rc;
     }
 
-    b->file_pos = c->body_start;
-    b->file_last = c->length;
+    if (c->memory) {
+        b->pos = c->buf->pos + c->body_start;
+        b->last = c->buf->pos + c->length;
+        b->memory = (b->last - b->pos) ? 1 : 0;
+
+    } else {
+        b->file_pos = c->body_start;
+        b->file_last = c->length;
+
+        b->in_file = (c->length - c->body_start) ? 1 : 0;
+
+        b->file->fd = c->file.fd;
+        b->file->name = c->file.name;
+        b->file->log = r->connection->log;
+    }
 
-    b->in_file = (c->length - c->body_start) ? 1 : 0;
     b->last_buf = (r == r->main) ? 1 : 0;
     b->last_in_chain = 1;
-    b->sync = (b->last_buf || b->in_file) ? 0 : 1;
-
-    b->file->fd = c->file.fd;
-    b->file->name = c->file.name;
-    b->file->log = r->connection->log;
+    b->sync = (b->last_buf || b->in_file || b->memory) ? 0 : 1;
 
     out.buf = b;
     out.next = NULL;
@@ -1674,8 +2541,10 @@ ngx_http_cache_send(ngx_http_request_t *r)
 void
 ngx_http_file_cache_free(ngx_http_cache_t *c, ngx_temp_file_t *tf)
 {
-    ngx_http_file_cache_t       *cache;
-    ngx_http_file_cache_node_t  *fcn;
+    uint64_t                      waiters;
+    ngx_http_file_cache_t        *cache;
+    ngx_http_file_cache_node_t   *fcn;
+    ngx_http_file_cache_shard_t  *shard;
 
     if (c->updated || c->node == NULL) {
         return;
@@ -1686,13 +2555,20 @@ ngx_http_file_cache_free(ngx_http_cache_t *c, ngx_temp_file_t *tf)
     ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->file.log, 0,
                    "http file cache free, fd: %d", c->file.fd);
 
-    ngx_shmtx_lock(&cache->shpool->mutex);
+    shard = c->shard;
+
+    ngx_shmtx_lock(&shard->mutex);
 
     fcn = c->node;
     fcn->count--;
 
+    waiters = 0;
+
     if (c->updating && fcn->lock_time == c->lock_time) {
         fcn->updating = 0;
+
+        waiters = fcn->waiters;
+        fcn->waiters = 0;
     }
 
     if (c->error) {
@@ -1704,14 +2580,16 @@ ngx_http_file_cache_free(ngx_http_cache_t *c, ngx_temp_file_t *tf)
         }
 
     } else if (!fcn->exists && fcn->count == 0 && c->min_uses == 1) {
-        ngx_queue_remove(&fcn->queue);
-        ngx_rbtree_delete(&cache->sh->rbtree, &fcn->node);
-        ngx_slab_free_locked(cache->shpool, fcn);
-        cache->sh->count--;
+        ngx_http_file_cache_queue_remove(shard, &fcn->queue);
+        ngx_rbtree_delete(&shard->rbtree, &fcn->node);
+        ngx_slab_free(cache->shpool, fcn);
+        shard->count--;
         c->node = NULL;
     }
 
-    ngx_shmtx_unlock(&cache->shpool->mutex);
+    ngx_shmtx_unlock(&shard->mutex);
+
+    ngx_http_file_cache_notify(waiters, c->file.log);
 
     c->updated = 1;
     c->updating = 0;
@@ -1733,6 +2611,15 @@ ngx_http_file_cache_free(ngx_http_cache_t *c, ngx_temp_file_t *tf)
     if (c->wait_event.timer_set) {
         ngx_del_timer(&c->wait_event);
     }
+
+    if (c->wait_event.posted) {
+        ngx_delete_posted_event(&c->wait_event);
+    }
+
+    if (c->waiting) {
+        ngx_queue_remove(&c->wait_queue);
+        c->waiting = 0;
+    }
 }
 
 
@@ -1758,7 +2645,8 @@ ngx_http_file_cache_cleanup(void *data)
 
 
 static time_t
-ngx_http_file_cache_forced_expire(ngx_http_file_cache_t *cache)
+ngx_http_file_cache_forced_expire(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_shard_t *shard)
 {
     u_char                      *name, *p;
     size_t                       len;
@@ -1786,14 +2674,14 @@ ngx_http_file_cache_forced_expire(ngx_http_file_cache_t *cache)
     tries = 20;
     sentinel = NULL;
 
-    ngx_shmtx_lock(&cache->shpool->mutex);
+    ngx_shmtx_lock(&shard->mutex);
 
     for ( ;; ) {
-        if (ngx_queue_empty(&cache->sh->queue)) {
+        if (ngx_queue_empty(&shard->queue)) {
             break;
         }
 
-        q = ngx_queue_last(&cache->sh->queue);
+        q = ngx_queue_last(&shard->queue);
 
         if (q == sentinel) {
             break;
@@ -1807,7 +2695,8 @@ ngx_http_file_cache_forced_expire(ngx_http_file_cache_t *cache)
                   fcn->key[0], fcn->key[1], fcn->key[2], fcn->key[3]);
 
         if (fcn->count == 0) {
-            ngx_http_file_cache_delete(cache, q, name);
+            ngx_http_file_cache_delete(cache, shard, q, name);
+            shard->evicted++;
             wait = 0;
             break;
         }
@@ -1828,9 +2717,9 @@ ngx_http_file_cache_forced_expire(ngx_http_file_cache_t *cache)
          * we prefer to just move them to the top of the inactive queue
          */
 
-        ngx_queue_remove(q);
+        ngx_http_file_cache_queue_remove(shard, q);
         fcn->expire = ngx_time() + cache->inactive;
-        ngx_queue_insert_head(&cache->sh->queue, &fcn->queue);
+        ngx_queue_insert_head(&shard->queue, &fcn->queue);
 
         ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, 0,
                       "ignore long locked inactive cache entry %*s, count:%d",
@@ -1848,7 +2737,7 @@ ngx_http_file_cache_forced_expire(ngx_http_file_cache_t *cache)
         break;
     }
 
-    ngx_shmtx_unlock(&cache->shpool->mutex);
+    ngx_shmtx_unlock(&shard->mutex);
 
     ngx_free(name);
 
@@ -1859,14 +2748,16 @@ ngx_http_file_cache_forced_expire(ngx_http_file_cache_t *cache)
 static time_t
 ngx_http_file_cache_expire(ngx_http_file_cache_t *cache)
 {
-    u_char                      *name, *p;
-    size_t                       len;
-    time_t                       now, wait;
-    ngx_path_t                  *path;
-    ngx_msec_t                   elapsed;
-    ngx_queue_t                 *q;
-    ngx_http_file_cache_node_t  *fcn;
-    u_char                       key[2 * NGX_HTTP_CACHE_KEY_LEN];
+    u_char                       *name, *p;
+    size_t                        len;
+    time_t                        now, wait, min_wait;
+    ngx_uint_t                    i, n;
+    ngx_path_t                   *path;
+    ngx_msec_t                    elapsed;
+    ngx_queue_t                  *q;
+    ngx_http_file_cache_node_t   *fcn;
+    ngx_http_file_cache_shard_t  *shard;
+    u_char                        key[2 * NGX_HTTP_CACHE_KEY_LEN];
 
     ngx_log_debug0(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
                    "http file cache expire");
@@ -1882,104 +2773,135 @@ ngx_http_file_cache_expire(ngx_http_file_cache_t *cache)
     ngx_memcpy(name, path->name.data, path->name.len);
 
     now = ngx_time();
+    min_wait = 10;
 
-    ngx_shmtx_lock(&cache->shpool->mutex);
+    /*
+     * the manager limits may stop the scan early, so it starts
+     * with the shard next to the one it was stopped at last time
+     */
 
-    for ( ;; ) {
+    for (i = 0; i < cache->sh->nshards; i++) {
 
-        if (ngx_quit || ngx_terminate) {
-            wait = 1;
-            break;
-        }
+        n = (cache->expire_shard + i) % cache->sh->nshards;
+        shard = &cache->sh->shards[n];
 
-        if (ngx_queue_empty(&cache->sh->queue)) {
-            wait = 10;
-            break;
-        }
+        ngx_shmtx_lock(&shard->mutex);
 
-        q = ngx_queue_last(&cache->sh->queue);
+        for ( ;; ) {
 
-        fcn = ngx_queue_data(q, ngx_http_file_cache_node_t, queue);
+            if (ngx_quit || ngx_terminate) {
+                wait = 1;
+                break;
+            }
 
-        wait = fcn->expire - now;
+            if (ngx_queue_empty(&shard->queue)) {
+                wait = 10;
+                break;
+            }
 
-        if (wait > 0) {
-            wait = wait > 10 ? 10 : wait;
-            break;
-        }
+            q = ngx_queue_last(&shard->queue);
 
-        ngx_log_debug6(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
-                       "http file cache expire: #%d %d %02xd%02xd%02xd%02xd",
-                       fcn->count, fcn->exists,
-                       fcn->key[0], fcn->key[1], fcn->key[2], fcn->key[3]);
+            fcn = ngx_queue_data(q, ngx_http_file_cache_node_t, queue);
 
-        if (fcn->count == 0) {
-            ngx_http_file_cache_delete(cache, q, name);
-            goto next;
-        }
+            wait = fcn->expire - now;
 
-        if (fcn->deleting) {
-            wait = 1;
-            break;
-        }
+            if (wait > 0) {
+                wait = wait > 10 ? 10 : wait;
+                break;
+            }
 
-        p = ngx_hex_dump(key, (u_char *) &fcn->node.key,
-                         sizeof(ngx_rbtree_key_t));
-        len = NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t);
-        (void) ngx_hex_dump(p, fcn->key, len);
+            ngx_log_debug6(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
+                           "http file cache expire: #%d %d "
+                           "%02xd%02xd%02xd%02xd",
+                           fcn->count, fcn->exists,
+                           fcn->key[0], fcn->key[1], fcn->key[2], fcn->key[3]);
 
-        /*
-         * abnormally exited workers may leave locked cache entries,
-         * and although it may be safe to remove them completely,
-         * we prefer to just move them to the top of the inactive queue
-         */
+            if (fcn->count == 0) {
+                ngx_http_file_cache_delete(cache, shard, q, name);
+                shard->expired++;
+                goto next;
+            }
 
-        ngx_queue_remove(q);
-        fcn->expire = ngx_time() + cache->inactive;
-        ngx_queue_insert_head(&cache->sh->queue, &fcn->queue);
+            if (fcn->deleting) {
+                wait = 1;
+                break;
+            }
 
-        ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, 0,
-                      "ignore long locked inactive cache entry %*s, count:%d",
-                      (size_t) 2 * NGX_HTTP_CACHE_KEY_LEN, key, fcn->count);
+            p = ngx_hex_dump(key, (u_char *) &fcn->node.key,
+                             sizeof(ngx_rbtree_key_t));
+            len = NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t);
+            (void) ngx_hex_dump(p, fcn->key, len);
+
+            /*
+             * abnormally exited workers may leave locked cache entries,
+             * and although it may be safe to remove them completely,
+             * we prefer to just move them to the top of the inactive queue
+             */
+
+            ngx_http_file_cache_queue_remove(shard, q);
+            fcn->expire = ngx_time() + cache->inactive;
+            ngx_queue_insert_head(&shard->queue, &fcn->queue);
+
+            ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, 0,
+                          "ignore long locked inactive cache entry %*s, "
+                          "count:%d",
+                          (size_t) 2 * NGX_HTTP_CACHE_KEY_LEN, key,
+                          fcn->count);
 
 next:
 
-        if (++cache->files >= cache->manager_files) {
-            wait = 0;
-            break;
+            if (++cache->files >= cache->manager_files) {
+                wait = 0;
+                break;
+            }
+
+            ngx_time_update();
+
+            elapsed = ngx_abs((ngx_msec_int_t)
+                              (ngx_current_msec - cache->last));
+
+            if (elapsed >= cache->manager_threshold) {
+                wait = 0;
+                break;
+            }
         }
 
-        ngx_time_update();
+        ngx_shmtx_unlock(&shard->mutex);
 
-        elapsed = ngx_abs((ngx_msec_int_t) (ngx_current_msec - cache->last));
+        if (wait < min_wait) {
+            min_wait = wait;
+        }
 
-        if (elapsed >= cache->manager_threshold) {
-            wait = 0;
+        if (min_wait == 0 || ngx_quit || ngx_terminate) {
+            cache->expire_shard = (n + 1) % cache->sh->nshards;
             break;
         }
     }
 
-    ngx_shmtx_unlock(&cache->shpool->mutex);
-
     ngx_free(name);
 
-    return wait;
+    return min_wait;
 }
 
 
 static void
-ngx_http_file_cache_delete(ngx_http_file_cache_t *cache, ngx_queue_t *q,
-    u_char *name)
+ngx_http_file_cache_delete(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_shard_t *shard, ngx_queue_t *q, u_char *name)
 {
     u_char                      *p;
     size_t                       len;
     ngx_path_t                  *path;
     ngx_http_file_cache_node_t  *fcn;
+    u_char                       key[NGX_HTTP_CACHE_KEY_LEN];
 
     fcn = ngx_queue_data(q, ngx_http_file_cache_node_t, queue);
 
     if (fcn->exists) {
-        cache->sh->size -= fcn->fs_size;
+        shard->size -= fcn->fs_size;
+
+        ngx_memcpy(key, &fcn->node.key, sizeof(ngx_rbtree_key_t));
+        ngx_memcpy(&key[sizeof(ngx_rbtree_key_t)], fcn->key,
+                   NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t));
 
         path = cache->path;
         p = name + path->name.len + 1 + path->len;
@@ -1991,7 +2913,7 @@ ngx_http_file_cache_delete(ngx_http_file_cache_t *cache, ngx_queue_t *q,
 
         fcn->count++;
         fcn->deleting = 1;
-        ngx_shmtx_unlock(&cache->shpool->mutex);
+        ngx_shmtx_unlock(&shard->mutex);
 
         len = path->name.len + 1 + path->len + 2 * NGX_HTTP_CACHE_KEY_LEN;
         ngx_create_hashed_filename(path, name, len);
@@ -2004,16 +2926,18 @@ ngx_http_file_cache_delete(ngx_http_file_cache_t *cache, ngx_queue_t *q,
                           ngx_delete_file_n " \"%s\" failed", name);
         }
 
-        ngx_shmtx_lock(&cache->shpool->mutex);
+        ngx_http_file_cache_memory_remove(cache, key);
+
+        ngx_shmtx_lock(&shard->mutex);
         fcn->count--;
         fcn->deleting = 0;
     }
 
     if (fcn->count == 0) {
-        ngx_queue_remove(q);
-        ngx_rbtree_delete(&cache->sh->rbtree, &fcn->node);
-        ngx_slab_free_locked(cache->shpool, fcn);
-        cache->sh->count--;
+        ngx_http_file_cache_queue_remove(shard, q);
+        ngx_rbtree_delete(&shard->rbtree, &fcn->node);
+        ngx_slab_free(cache->shpool, fcn);
+        shard->count--;
     }
 }
 
@@ -2023,10 +2947,24 @@ ngx_http_file_cache_manager(void *data)
 {
     ngx_http_file_cache_t  *cache = data;
 
-    off_t       size, free;
-    time_t      wait;
-    ngx_msec_t  elapsed, next;
-    ngx_uint_t  count, watermark;
+    time_t                        wait;
+    ngx_msec_t                    elapsed, next;
+    ngx_http_file_cache_shard_t  *shard;
+
+    if (cache->index) {
+        if (!cache->sh->indexed
+            && cache->sh->cold
+            && ngx_atomic_cmp_set(&cache->sh->indexed, 0,
+                                  NGX_HTTP_CACHE_INDEX_TRIED))
+        {
+            ngx_http_file_cache_index_load(cache);
+        }
+
+        if (ngx_time() >= cache->index_time && !cache->sh->cold) {
+            ngx_http_file_cache_index_save(cache);
+            cache->index_time = ngx_time() + cache->index;
+        }
+    }
 
     cache->last = ngx_current_msec;
     cache->files = 0;
@@ -2039,35 +2977,13 @@ ngx_http_file_cache_manager(void *data)
     }
 
     for ( ;; ) {
-        ngx_shmtx_lock(&cache->shpool->mutex);
-
-        size = cache->sh->size;
-        count = cache->sh->count;
-        watermark = cache->sh->watermark;
-
-        ngx_shmtx_unlock(&cache->shpool->mutex);
-
-        ngx_log_debug3(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
-                       "http file cache size: %O c:%ui w:%i",
-                       size, count, (ngx_int_t) watermark);
-
-        if (size < cache->max_size && count < watermark) {
-
-            if (!cache->min_free) {
-                break;
-            }
-
-            free = ngx_fs_available(cache->path->name.data);
+        shard = ngx_http_file_cache_manager_shard(cache);
 
-            ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
-                           "http file cache free: %O", free);
-
-            if (free > cache->min_free) {
-                break;
-            }
+        if (shard == NULL) {
+            break;
         }
 
-        wait = ngx_http_file_cache_forced_expire(cache);
+        wait = ngx_http_file_cache_forced_expire(cache, shard);
 
         if (wait > 0) {
             next = (ngx_msec_t) wait * 1000;
@@ -2105,11 +3021,82 @@ done:
 }
 
 
+static ngx_http_file_cache_shard_t *
+ngx_http_file_cache_manager_shard(ngx_http_file_cache_t *cache)
+{
+    off_t                         size, total, max_size, largest, free;
+    ngx_uint_t                    i, count, watermark;
+    ngx_http_file_cache_shard_t  *shard, *victim;
+
+    /*
+     * max_size is split evenly between shards, so a shard which
+     * exceeds its part is trimmed even if others are below theirs;
+     * min_free shortage is resolved by trimming the largest shard
+     */
+
+    max_size = cache->max_size / cache->sh->nshards;
+
+    total = 0;
+    largest = -1;
+    victim = NULL;
+
+    for (i = 0; i < cache->sh->nshards; i++) {
+        shard = &cache->sh->shards[i];
+
+        ngx_shmtx_lock(&shard->mutex);
+
+        size = shard->size;
+        count = shard->count;
+        watermark = shard->watermark;
+
+        ngx_shmtx_unlock(&shard->mutex);
+
+        ngx_log_debug4(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
+                       "http file cache size: %O c:%ui w:%i s:%ui",
+                       size, count, (ngx_int_t) watermark, i);
+
+        ngx_log_debug5(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
+                       "http file cache stats: hit:%uA miss:%uA "
+                       "evicted:%uA expired:%uA rejected:%uA",
+                       shard->hits, shard->misses, shard->evicted,
+                       shard->expired, shard->rejected);
+
+        if (size >= max_size || count >= watermark) {
+            return shard;
+        }
+
+        total += size;
+
+        if (size > largest) {
+            largest = size;
+            victim = shard;
+        }
+    }
+
+    if (!cache->min_free) {
+        return NULL;
+    }
+
+    free = ngx_fs_available(cache->path->name.data);
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
+                   "http file cache free: %O, size: %O", free, total);
+
+    if (free > cache->min_free) {
+        return NULL;
+    }
+
+    return victim;
+}
+
+
 static void
 ngx_http_file_cache_loader(void *data)
 {
     ngx_http_file_cache_t  *cache = data;
 
+    off_t           size;
+    ngx_uint_t      i;
     ngx_tree_ctx_t  tree;
 
     if (!cache->sh->cold || cache->sh->loading) {
@@ -2143,11 +3130,394 @@ ngx_http_file_cache_loader(void *data)
     cache->sh->cold = 0;
     cache->sh->loading = 0;
 
+    size = 0;
+
+    for (i = 0; i < cache->sh->nshards; i++) {
+        ngx_shmtx_lock(&cache->sh->shards[i].mutex);
+        size += cache->sh->shards[i].size;
+        ngx_shmtx_unlock(&cache->sh->shards[i].mutex);
+    }
+
+    ngx_log_error(NGX_LOG_NOTICE, ngx_cycle->log, 0,
+                  "http file cache: %V %.3fM, bsize: %uz, shards: %ui",
+                  &cache->path->name,
+                  ((double) size * cache->bsize) / (1024 * 1024),
+                  cache->bsize, cache->sh->nshards);
+}
+
+
+static void
+ngx_http_file_cache_index_load(ngx_http_file_cache_t *cache)
+{
+    off_t                                size;
+    ssize_t                              n;
+    ngx_uint_t                           i;
+    ngx_file_t                           file;
+    ngx_file_info_t                      fi;
+    ngx_http_file_cache_index_header_t   h;
+
+    ngx_memzero(&file, sizeof(ngx_file_t));
+
+    file.name = cache->index_name;
+    file.log = ngx_cycle->log;
+
+    file.fd = ngx_open_file(file.name.data, NGX_FILE_RDONLY, NGX_FILE_OPEN, 0);
+
+    if (file.fd == NGX_INVALID_FILE) {
+        if (ngx_errno != NGX_ENOENT) {
+            ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                          ngx_open_file_n " \"%s\" failed", file.name.data);
+        }
+
+        return;
+    }
+
+    if (ngx_fd_info(file.fd, &fi) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                      ngx_fd_info_n " \"%s\" failed", file.name.data);
+        goto done;
+    }
+
+    n = ngx_read_file(&file, (u_char *) &h, sizeof(h), 0);
+
+    if (n == NGX_ERROR) {
+        goto done;
+    }
+
+    if (n != sizeof(h)
+        || ngx_memcmp(h.magic, ngx_http_file_cache_index_magic,
+                      sizeof(ngx_http_file_cache_index_magic)) != 0
+        || h.version != NGX_HTTP_CACHE_INDEX_VERSION
+        || h.bsize != cache->bsize
+        || (uint64_t) ngx_file_size(&fi) != sizeof(h)
+                       + h.count * sizeof(ngx_http_file_cache_index_entry_t))
+    {
+        ngx_log_error(NGX_LOG_WARN, ngx_cycle->log, 0,
+                      "cache index \"%s\" is invalid, ignored",
+                      file.name.data);
+        goto done;
+    }
+
+    /* the first pass checks the crc, the second one fills the zone */
+
+    if (ngx_http_file_cache_index_read(cache, &file, &h, 0) != NGX_OK) {
+        ngx_log_error(NGX_LOG_WARN, ngx_cycle->log, 0,
+                      "cache index \"%s\" is corrupted, ignored",
+                      file.name.data);
+        goto done;
+    }
+
+    if (ngx_http_file_cache_index_read(cache, &file, &h, 1) != NGX_OK) {
+        goto done;
+    }
+
+    /* the loader keeps the restored nodes only after a successful load */
+
+    cache->sh->indexed = NGX_HTTP_CACHE_INDEX_LOADED;
+
+    size = 0;
+
+    for (i = 0; i < cache->sh->nshards; i++) {
+        ngx_shmtx_lock(&cache->sh->shards[i].mutex);
+        size += cache->sh->shards[i].size;
+        ngx_shmtx_unlock(&cache->sh->shards[i].mutex);
+    }
+
     ngx_log_error(NGX_LOG_NOTICE, ngx_cycle->log, 0,
-                  "http file cache: %V %.3fM, bsize: %uz",
+                  "http file cache: %V %.3fM loaded from index, entries: %uL",
                   &cache->path->name,
-                  ((double) cache->sh->size * cache->bsize) / (1024 * 1024),
-                  cache->bsize);
+                  ((double) size * cache->bsize) / (1024 * 1024), h.count);
+
+done:
+
+    if (ngx_close_file(file.fd) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, ngx_errno,
+                      ngx_close_file_n " \"%s\" failed", file.name.data);
+    }
+}
+
+
+static ngx_int_t
+ngx_http_file_cache_index_read(ngx_http_file_cache_t *cache, ngx_file_t *file,
+    ngx_http_file_cache_index_header_t *h, ngx_uint_t add)
+{
+    off_t                               offset;
+    size_t                              size;
+    ssize_t                             n;
+    time_t                              now;
+    uint32_t                            crc;
+    uint64_t                            left;
+    ngx_uint_t                          i, count;
+    ngx_http_file_cache_node_t         *fcn;
+    ngx_http_file_cache_shard_t        *shard;
+    ngx_http_file_cache_index_entry_t  *e, buf[NGX_HTTP_CACHE_INDEX_BATCH];
+
+    ngx_crc32_init(crc);
+
+    now = ngx_time();
+
+    offset = sizeof(ngx_http_file_cache_index_header_t);
+    left = h->count;
+
+    while (left) {
+        count = ngx_min(left, NGX_HTTP_CACHE_INDEX_BATCH);
+        size = count * sizeof(ngx_http_file_cache_index_entry_t);
+
+        n = ngx_read_file(file, (u_char *) buf, size, offset);
+
+        if (n != (ssize_t) size) {
+            return NGX_ERROR;
+        }
+
+        offset += size;
+        left -= count;
+
+        if (!add) {
+            ngx_crc32_update(&crc, (u_char *) buf, size);
+            continue;
+        }
+
+        /* entries are stored from the least recently used ones */
+
+        for (i = 0; i < count; i++) {
+            e = &buf[i];
+
+            shard = ngx_http_file_cache_shard(cache, e->key);
+
+            ngx_shmtx_lock(&shard->mutex);
+
+            if (ngx_http_file_cache_lookup(shard, e->key)) {
+                ngx_shmtx_unlock(&shard->mutex);
+                continue;
+            }
+
+            fcn = ngx_slab_calloc(cache->shpool,
+                                  sizeof(ngx_http_file_cache_node_t));
+            if (fcn == NULL) {
+                ngx_http_file_cache_set_watermark(shard);
+                ngx_shmtx_unlock(&shard->mutex);
+
+                ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, 0,
+                              "could not allocate node%s",
+                              cache->shpool->log_ctx);
+                return NGX_ERROR;
+            }
+
+            ngx_memcpy((u_char *) &fcn->node.key, e->key,
+                       sizeof(ngx_rbtree_key_t));
+
+            ngx_memcpy(fcn->key, &e->key[sizeof(ngx_rbtree_key_t)],
+                       NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t));
+
+            ngx_rbtree_insert(&shard->rbtree, &fcn->node);
+
+            fcn->uses = 1;
+            fcn->epoch = ngx_http_file_cache_epoch(cache);
+            fcn->exists = 1;
+            fcn->uniq = (ngx_file_uniq_t) e->uniq;
+
+            /*
+             * the inactivity left at the time of the save is preserved,
+             * so the time nginx was not running does not count
+             */
+
+            fcn->expire = now + (time_t) (e->expire - h->time);
+
+            if (fcn->expire > now + cache->inactive) {
+                fcn->expire = now + cache->inactive;
+            }
+
+            fcn->body_start = e->body_start;
+            fcn->fs_size = (off_t) e->fs_size;
+
+            ngx_queue_insert_head(&shard->queue, &fcn->queue);
+
+            shard->count++;
+            shard->size += fcn->fs_size;
+
+            ngx_shmtx_unlock(&shard->mutex);
+        }
+    }
+
+    ngx_crc32_final(crc);
+
+    if (!add && crc != h->crc32) {
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_http_file_cache_index_save(ngx_http_file_cache_t *cache)
+{
+    u_char                              *name;
+    size_t                               size;
+    uint32_t                             crc;
+    uint64_t                             total;
+    ngx_uint_t                           i, n;
+    ngx_file_t                           file;
+    ngx_queue_t                         *q;
+    ngx_http_file_cache_node_t          *fcn;
+    ngx_http_file_cache_shard_t         *shard;
+    ngx_http_file_cache_index_entry_t   *e;
+    ngx_http_file_cache_index_header_t   h;
+    ngx_http_file_cache_index_entry_t    buf[NGX_HTTP_CACHE_INDEX_BATCH];
+
+    name = cache->index_name.data;
+
+    ngx_memzero(&file, sizeof(ngx_file_t));
+
+    file.name.len = cache->index_name.len + sizeof(".tmp") - 1;
+    file.name.data = ngx_alloc(file.name.len + 1, ngx_cycle->log);
+    if (file.name.data == NULL) {
+        return;
+    }
+
+    ngx_sprintf(file.name.data, "%V.tmp%Z", &cache->index_name);
+
+    file.log = ngx_cycle->log;
+
+    file.fd = ngx_open_file(file.name.data, NGX_FILE_WRONLY,
+                            NGX_FILE_TRUNCATE, NGX_FILE_DEFAULT_ACCESS);
+
+    if (file.fd == NGX_INVALID_FILE) {
+        ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                      ngx_open_file_n " \"%s\" failed", file.name.data);
+        ngx_free(file.name.data);
+        return;
+    }
+
+    ngx_crc32_init(crc);
+
+    total = 0;
+
+    for (i = 0; i < cache->sh->nshards; i++) {
+        shard = &cache->sh->shards[i];
+
+        /*
+         * nodes are copied in batches under the lock and written without
+         * it, starting from the least recently used ones; the node to
+         * continue from is kept in the shard, where it is moved on
+         * if the node is removed from the queue while the lock is released
+         */
+
+        ngx_shmtx_lock(&shard->mutex);
+        shard->cursor = ngx_queue_last(&shard->queue);
+        ngx_shmtx_unlock(&shard->mutex);
+
+        for ( ;; ) {
+            n = 0;
+
+            ngx_shmtx_lock(&shard->mutex);
+
+            for (q = shard->cursor;
+                 q != ngx_queue_sentinel(&shard->queue)
+                 && n < NGX_HTTP_CACHE_INDEX_BATCH;
+                 q = ngx_queue_prev(q))
+            {
+                fcn = ngx_queue_data(q, ngx_http_file_cache_node_t, queue);
+
+                if (!fcn->exists || fcn->deleting) {
+                    continue;
+                }
+
+                e = &buf[n++];
+
+                ngx_memcpy(e->key, &fcn->node.key, sizeof(ngx_rbtree_key_t));
+                ngx_memcpy(&e->key[sizeof(ngx_rbtree_key_t)], fcn->key,
+                           NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t));
+
+                e->uniq = (uint64_t) fcn->uniq;
+                e->expire = (int64_t) fcn->expire;
+                e->fs_size = (uint64_t) fcn->fs_size;
+                e->body_start = (uint32_t) fcn->body_start;
+                e->reserved = 0;
+            }
+
+            if (q == ngx_queue_sentinel(&shard->queue)) {
+                shard->cursor = NULL;
+
+            } else {
+                shard->cursor = q;
+            }
+
+            ngx_shmtx_unlock(&shard->mutex);
+
+            if (n) {
+                size = n * sizeof(ngx_http_file_cache_index_entry_t);
+
+                ngx_crc32_update(&crc, (u_char *) buf, size);
+
+                if (ngx_write_file(&file, (u_char *) buf, size,
+                                   sizeof(ngx_http_file_cache_index_header_t)
+                                   + total
+                                     * sizeof(ngx_http_file_cache_index_entry_t))
+                    == NGX_ERROR)
+                {
+                    ngx_shmtx_lock(&shard->mutex);
+                    shard->cursor = NULL;
+                    ngx_shmtx_unlock(&shard->mutex);
+
+                    goto failed;
+                }
+
+                total += n;
+            }
+
+            if (q == ngx_queue_sentinel(&shard->queue)) {
+                break;
+            }
+        }
+    }
+
+    ngx_crc32_final(crc);
+
+    ngx_memzero(&h, sizeof(ngx_http_file_cache_index_header_t));
+
+    ngx_memcpy(h.magic, ngx_http_file_cache_index_magic,
+               sizeof(ngx_http_file_cache_index_magic));
+    h.version = NGX_HTTP_CACHE_INDEX_VERSION;
+    h.crc32 = crc;
+    h.count = total;
+    h.bsize = cache->bsize;
+    h.time = ngx_time();
+
+    if (ngx_write_file(&file, (u_char *) &h, sizeof(h), 0) == NGX_ERROR) {
+        goto failed;
+    }
+
+    if (ngx_close_file(file.fd) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, ngx_errno,
+                      ngx_close_file_n " \"%s\" failed", file.name.data);
+    }
+
+    if (ngx_rename_file(file.name.data, name) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_CRIT, ngx_cycle->log, ngx_errno,
+                      ngx_rename_file_n " \"%s\" to \"%s\" failed",
+                      file.name.data, name);
+        (void) ngx_delete_file(file.name.data);
+    }
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
+                   "http file cache index: \"%s\" %uL entries",
+                   name, total);
+
+    ngx_free(file.name.data);
+
+    return;
+
+failed:
+
+    if (ngx_close_file(file.fd) == NGX_FILE_ERROR) {
+        ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, ngx_errno,
+                      ngx_close_file_n " \"%s\" failed", file.name.data);
+    }
+
+    (void) ngx_delete_file(file.name.data);
+
+    ngx_free(file.name.data);
 }
 
 
@@ -2166,6 +3536,14 @@ ngx_http_file_cache_manage_file(ngx_tree_ctx_t *ctx, ngx_str_t *path)
 
     cache = ctx->data;
 
+    if (cache->index_name.len
+        && path->len >= cache->index_name.len
+        && ngx_strncmp(path->data, cache->index_name.data,
+                       cache->index_name.len) == 0)
+    {
+        return NGX_OK;
+    }
+
     if (ngx_http_file_cache_add_file(ctx, path) != NGX_OK) {
         (void) ngx_http_file_cache_delete_file(ctx, path);
     }
@@ -2272,18 +3650,21 @@ ngx_http_file_cache_add_file(ngx_tree_ctx_t *ctx, ngx_str_t *name)
 static ngx_int_t
 ngx_http_file_cache_add(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
 {
-    ngx_http_file_cache_node_t  *fcn;
+    ngx_http_file_cache_node_t   *fcn;
+    ngx_http_file_cache_shard_t  *shard;
+
+    shard = ngx_http_file_cache_shard(cache, c->key);
 
-    ngx_shmtx_lock(&cache->shpool->mutex);
+    ngx_shmtx_lock(&shard->mutex);
 
-    fcn = ngx_http_file_cache_lookup(cache, c->key);
+    fcn = ngx_http_file_cache_lookup(shard, c->key);
 
     if (fcn == NULL) {
 
-        fcn = ngx_slab_calloc_locked(cache->shpool,
-                                     sizeof(ngx_http_file_cache_node_t));
+        fcn = ngx_slab_calloc(cache->shpool,
+                              sizeof(ngx_http_file_cache_node_t));
         if (fcn == NULL) {
-            ngx_http_file_cache_set_watermark(cache);
+            ngx_http_file_cache_set_watermark(shard);
 
             if (cache->fail_time != ngx_time()) {
                 cache->fail_time = ngx_time();
@@ -2291,34 +3672,42 @@ ngx_http_file_cache_add(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
                            "could not allocate node%s", cache->shpool->log_ctx);
             }
 
-            ngx_shmtx_unlock(&cache->shpool->mutex);
+            ngx_shmtx_unlock(&shard->mutex);
             return NGX_ERROR;
         }
 
-        cache->sh->count++;
+        shard->count++;
 
         ngx_memcpy((u_char *) &fcn->node.key, c->key, sizeof(ngx_rbtree_key_t));
 
         ngx_memcpy(fcn->key, &c->key[sizeof(ngx_rbtree_key_t)],
                    NGX_HTTP_CACHE_KEY_LEN - sizeof(ngx_rbtree_key_t));
 
-        ngx_rbtree_insert(&cache->sh->rbtree, &fcn->node);
+        ngx_rbtree_insert(&shard->rbtree, &fcn->node);
 
         fcn->uses = 1;
+        fcn->epoch = ngx_http_file_cache_epoch(cache);
         fcn->exists = 1;
         fcn->fs_size = c->fs_size;
 
-        cache->sh->size += c->fs_size;
+        shard->size += c->fs_size;
+
+    } else if (cache->sh->indexed == NGX_HTTP_CACHE_INDEX_LOADED) {
+
+        /* keep the position and expiration restored from the index */
+
+        ngx_shmtx_unlock(&shard->mutex);
+        return NGX_OK;
 
     } else {
-        ngx_queue_remove(&fcn->queue);
+        ngx_http_file_cache_queue_remove(shard, &fcn->queue);
     }
 
     fcn->expire = ngx_time() + cache->inactive;
 
-    ngx_queue_insert_head(&cache->sh->queue, &fcn->queue);
+    ngx_queue_insert_head(&shard->queue, &fcn->queue);
 
-    ngx_shmtx_unlock(&cache->shpool->mutex);
+    ngx_shmtx_unlock(&shard->mutex);
 
     return NGX_OK;
 }
@@ -2340,12 +3729,26 @@ ngx_http_file_cache_delete_file(ngx_tree_ctx_t *ctx, ngx_str_t *path)
 
 
 static void
-ngx_http_file_cache_set_watermark(ngx_http_file_cache_t *cache)
+ngx_http_file_cache_set_watermark(ngx_http_file_cache_shard_t *shard)
 {
-    cache->sh->watermark = cache->sh->count - cache->sh->count / 8;
+    shard->watermark = shard->count - shard->count / 8;
 
     ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
-                   "http file cache watermark: %ui", cache->sh->watermark);
+                   "http file cache watermark: %ui", shard->watermark);
+}
+
+
+static void
+ngx_http_file_cache_queue_remove(ngx_http_file_cache_shard_t *shard,
+    ngx_queue_t *q)
+{
+    /* the index save cursor is moved to the next node to be saved */
+
+    if (shard->cursor == q) {
+        shard->cursor = ngx_queue_prev(q);
+    }
+
+    ngx_queue_remove(q);
 }
 
 
@@ -2375,6 +3778,36 @@ ngx_http_file_cache_valid(ngx_array_t *cache_valid, ngx_uint_t status)
 }
 
 
+ngx_int_t
+ngx_http_file_cache_stat(ngx_shm_zone_t *shm_zone,
+    ngx_http_file_cache_stat_t *stat)
+{
+    ngx_uint_t                    i;
+    ngx_http_file_cache_t        *cache;
+    ngx_http_file_cache_shard_t  *shard;
+
+    if (shm_zone->init != ngx_http_file_cache_init) {
+        return NGX_DECLINED;
+    }
+
+    cache = shm_zone->data;
+
+    ngx_memzero(stat, sizeof(ngx_http_file_cache_stat_t));
+
+    for (i = 0; i < cache->sh->nshards; i++) {
+        shard = &cache->sh->shards[i];
+
+        stat->hits += shard->hits;
+        stat->misses += shard->misses;
+        stat->evicted += shard->evicted;
+        stat->expired += shard->expired;
+        stat->rejected += shard->rejected;
+    }
+
+    return NGX_OK;
+}
+
+
 char *
 ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 {
@@ -2382,13 +3815,13 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 
     off_t                   max_size, min_free;
     u_char                 *last, *p;
-    time_t                  inactive;
-    ssize_t                 size;
-    ngx_str_t               s, name, *value;
-    ngx_int_t               loader_files, manager_files;
+    time_t                  inactive, index;
+    ssize_t                 size, msize;
+    ngx_str_t               s, name, mname, *value;
+    ngx_int_t               loader_files, manager_files, shards;
     ngx_msec_t              loader_sleep, manager_sleep, loader_threshold,
                             manager_threshold;
-    ngx_uint_t              i, n, use_temp_path;
+    ngx_uint_t              i, n, use_temp_path, eviction;
     ngx_array_t            *caches;
     ngx_http_file_cache_t  *cache, **ce;
 
@@ -2405,6 +3838,7 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     use_temp_path = 1;
 
     inactive = 600;
+    index = 0;
 
     loader_files = 100;
     loader_sleep = 50;
@@ -2416,8 +3850,12 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 
     name.len = 0;
     size = 0;
+    mname.len = 0;
+    msize = 0;
     max_size = NGX_MAX_OFF_T_VALUE;
     min_free = 0;
+    shards = 1;
+    eviction = NGX_HTTP_CACHE_EVICT_LRU;
 
     value = cf->args->elts;
 
@@ -2523,6 +3961,43 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
             continue;
         }
 
+        if (ngx_strncmp(value[i].data, "memory_zone=", 12) == 0) {
+
+            mname.data = value[i].data + 12;
+
+            p = (u_char *) ngx_strchr(mname.data, ':');
+
+            if (p == NULL) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid memory zone size \"%V\"",
+                                   &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            mname.len = p - mname.data;
+
+            s.data = p + 1;
+            s.len = value[i].data + value[i].len - s.data;
+
+            msize = ngx_parse_size(&s);
+
+            if (msize == NGX_ERROR) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid memory zone size \"%V\"",
+                                   &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            if (msize < (ssize_t) (8 * ngx_pagesize)) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "memory zone \"%V\" is too small",
+                                   &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            continue;
+        }
+
         if (ngx_strncmp(value[i].data, "inactive=", 9) == 0) {
 
             s.len = value[i].len - 9;
@@ -2538,6 +4013,26 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
             continue;
         }
 
+        if (ngx_strncmp(value[i].data, "index=", 6) == 0) {
+
+            if (ngx_strcmp(&value[i].data[6], "off") == 0) {
+                index = 0;
+                continue;
+            }
+
+            s.len = value[i].len - 6;
+            s.data = value[i].data + 6;
+
+            index = ngx_parse_time(&s, 1);
+            if (index == (time_t) NGX_ERROR || index == 0) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid index value \"%V\"", &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            continue;
+        }
+
         if (ngx_strncmp(value[i].data, "max_size=", 9) == 0) {
 
             s.len = value[i].len - 9;
@@ -2576,6 +4071,37 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
             continue;
         }
 
+        if (ngx_strncmp(value[i].data, "shards=", 7) == 0) {
+
+            shards = ngx_atoi(value[i].data + 7, value[i].len - 7);
+            if (shards == NGX_ERROR || shards == 0 || shards > 256) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid shards value \"%V\"", &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "eviction=", 9) == 0) {
+
+            if (ngx_strcmp(&value[i].data[9], "lru") == 0) {
+                eviction = NGX_HTTP_CACHE_EVICT_LRU;
+
+            } else if (ngx_strcmp(&value[i].data[9], "tinylfu") == 0) {
+                eviction = NGX_HTTP_CACHE_EVICT_TINYLFU;
+
+            } else {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid eviction value \"%V\", "
+                                   "it must be \"lru\" or \"tinylfu\"",
+                                   &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            continue;
+        }
+
         if (ngx_strncmp(value[i].data, "loader_files=", 13) == 0) {
 
             loader_files = ngx_atoi(value[i].data + 13, value[i].len - 13);
@@ -2703,11 +4229,44 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     cache->shm_zone->init = ngx_http_file_cache_init;
     cache->shm_zone->data = cache;
 
+    if (mname.len) {
+        cache->memory_zone = ngx_shared_memory_add(cf, &mname, msize,
+                                                   cmd->post);
+        if (cache->memory_zone == NULL) {
+            return NGX_CONF_ERROR;
+        }
+
+        if (cache->memory_zone->data) {
+            ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                               "duplicate zone \"%V\"", &mname);
+            return NGX_CONF_ERROR;
+        }
+
+        cache->memory_zone->init = ngx_http_file_cache_memory_init;
+        cache->memory_zone->data = cache;
+    }
+
     cache->use_temp_path = use_temp_path;
 
     cache->inactive = inactive;
     cache->max_size = max_size;
     cache->min_free = min_free;
+    cache->shards = shards;
+    cache->eviction = eviction;
+
+    if (index) {
+        cache->index = index;
+
+        cache->index_name.len = cache->path->name.len + sizeof("/index") - 1;
+        cache->index_name.data = ngx_pnalloc(cf->pool,
+                                             cache->index_name.len
+                                             + sizeof(".tmp"));
+        if (cache->index_name.data == NULL) {
+            return NGX_CONF_ERROR;
+        }
+
+        ngx_sprintf(cache->index_name.data, "%V/index%Z", &cache->path->name);
+    }
 
     caches = (ngx_array_t *) (confp + cmd->offset);
 
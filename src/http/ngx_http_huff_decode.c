@@ -18,8 +18,27 @@ typedef struct {
 } ngx_http_huff_decode_code_t;
 
 
+typedef struct {
+    u_char  len;
+    u_char  emit;
+    u_char  sym1;
+    u_char  sym2;
+} ngx_http_huff_decode_fast_t;
+
+
+#define NGX_HTTP_HUFF_DECODE_FAST_BITS  11
+
+/* can be disabled for comparison, see misc/ngx_http_huff_bench.c */
+
+#ifndef NGX_HTTP_HUFF_DECODE_FAST
+#define NGX_HTTP_HUFF_DECODE_FAST       1
+#endif
+
+
 static ngx_inline ngx_int_t ngx_http_huff_decode_bits(u_char *state,
     u_char *ending, ngx_uint_t bits, u_char **dst);
+static ngx_inline ngx_int_t ngx_http_huff_decode_bit(u_char *state,
+    u_char *ending, ngx_uint_t bit, u_char **dst);
 
 
 static ngx_http_huff_decode_code_t  ngx_http_huff_decode_codes[256][16] =
@@ -2639,41 +2658,1452 @@ static ngx_http_huff_decode_code_t  ngx_http_huff_decode_codes[256][16] =
 };
 
 
+/*
+ * the codes below are generated from the same code tree as the table
+ * above and use the same state numbers:
+ *
+ * ngx_http_huff_decode_bit_codes[] is the per-bit transition table, used
+ * to consume the bits left over after the last whole nibble of input;
+ *
+ * ngx_http_huff_decode_fast_codes[] is indexed by the next 11 bits of
+ * input starting at a code boundary (state 0), and yields up to two
+ * symbols along with the number of bits consumed, or 0 for the codes
+ * longer than 11 bits
+ */
+
+static ngx_http_huff_decode_code_t  ngx_http_huff_decode_bit_codes[256][2] =
+{
+    /* 0 */
+    {{0x01, 0x00, 0x00, 0x00}, {0x16, 0x00, 0x00, 0x01}},
+    {{0x02, 0x00, 0x00, 0x00}, {0x09, 0x00, 0x00, 0x00}},
+    {{0x03, 0x00, 0x00, 0x00}, {0x06, 0x00, 0x00, 0x00}},
+    {{0x04, 0x00, 0x00, 0x00}, {0x05, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x30, 0x01}, {0x00, 0x01, 0x31, 0x01}},
+    {{0x00, 0x01, 0x32, 0x01}, {0x00, 0x01, 0x61, 0x01}},
+    {{0x07, 0x00, 0x00, 0x00}, {0x08, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x63, 0x01}, {0x00, 0x01, 0x65, 0x01}},
+    {{0x00, 0x01, 0x69, 0x01}, {0x00, 0x01, 0x6f, 0x01}},
+    {{0x0a, 0x00, 0x00, 0x00}, {0x0f, 0x00, 0x00, 0x00}},
+    {{0x0b, 0x00, 0x00, 0x00}, {0x0c, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x73, 0x01}, {0x00, 0x01, 0x74, 0x01}},
+    {{0x0d, 0x00, 0x00, 0x00}, {0x0e, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x20, 0x01}, {0x00, 0x01, 0x25, 0x01}},
+    {{0x00, 0x01, 0x2d, 0x01}, {0x00, 0x01, 0x2e, 0x01}},
+    {{0x10, 0x00, 0x00, 0x00}, {0x13, 0x00, 0x00, 0x00}},
+    /* 16 */
+    {{0x11, 0x00, 0x00, 0x00}, {0x12, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x2f, 0x01}, {0x00, 0x01, 0x33, 0x01}},
+    {{0x00, 0x01, 0x34, 0x01}, {0x00, 0x01, 0x35, 0x01}},
+    {{0x14, 0x00, 0x00, 0x00}, {0x15, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x36, 0x01}, {0x00, 0x01, 0x37, 0x01}},
+    {{0x00, 0x01, 0x38, 0x01}, {0x00, 0x01, 0x39, 0x01}},
+    {{0x17, 0x00, 0x00, 0x00}, {0x28, 0x00, 0x00, 0x01}},
+    {{0x18, 0x00, 0x00, 0x00}, {0x1f, 0x00, 0x00, 0x00}},
+    {{0x19, 0x00, 0x00, 0x00}, {0x1c, 0x00, 0x00, 0x00}},
+    {{0x1a, 0x00, 0x00, 0x00}, {0x1b, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x3d, 0x01}, {0x00, 0x01, 0x41, 0x01}},
+    {{0x00, 0x01, 0x5f, 0x01}, {0x00, 0x01, 0x62, 0x01}},
+    {{0x1d, 0x00, 0x00, 0x00}, {0x1e, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x64, 0x01}, {0x00, 0x01, 0x66, 0x01}},
+    {{0x00, 0x01, 0x67, 0x01}, {0x00, 0x01, 0x68, 0x01}},
+    {{0x20, 0x00, 0x00, 0x00}, {0x23, 0x00, 0x00, 0x00}},
+    /* 32 */
+    {{0x21, 0x00, 0x00, 0x00}, {0x22, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x6c, 0x01}, {0x00, 0x01, 0x6d, 0x01}},
+    {{0x00, 0x01, 0x6e, 0x01}, {0x00, 0x01, 0x70, 0x01}},
+    {{0x24, 0x00, 0x00, 0x00}, {0x25, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x72, 0x01}, {0x00, 0x01, 0x75, 0x01}},
+    {{0x26, 0x00, 0x00, 0x00}, {0x27, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x3a, 0x01}, {0x00, 0x01, 0x42, 0x01}},
+    {{0x00, 0x01, 0x43, 0x01}, {0x00, 0x01, 0x44, 0x01}},
+    {{0x29, 0x00, 0x00, 0x00}, {0x38, 0x00, 0x00, 0x01}},
+    {{0x2a, 0x00, 0x00, 0x00}, {0x31, 0x00, 0x00, 0x00}},
+    {{0x2b, 0x00, 0x00, 0x00}, {0x2e, 0x00, 0x00, 0x00}},
+    {{0x2c, 0x00, 0x00, 0x00}, {0x2d, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x45, 0x01}, {0x00, 0x01, 0x46, 0x01}},
+    {{0x00, 0x01, 0x47, 0x01}, {0x00, 0x01, 0x48, 0x01}},
+    {{0x2f, 0x00, 0x00, 0x00}, {0x30, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x49, 0x01}, {0x00, 0x01, 0x4a, 0x01}},
+    /* 48 */
+    {{0x00, 0x01, 0x4b, 0x01}, {0x00, 0x01, 0x4c, 0x01}},
+    {{0x32, 0x00, 0x00, 0x00}, {0x35, 0x00, 0x00, 0x00}},
+    {{0x33, 0x00, 0x00, 0x00}, {0x34, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x4d, 0x01}, {0x00, 0x01, 0x4e, 0x01}},
+    {{0x00, 0x01, 0x4f, 0x01}, {0x00, 0x01, 0x50, 0x01}},
+    {{0x36, 0x00, 0x00, 0x00}, {0x37, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x51, 0x01}, {0x00, 0x01, 0x52, 0x01}},
+    {{0x00, 0x01, 0x53, 0x01}, {0x00, 0x01, 0x54, 0x01}},
+    {{0x39, 0x00, 0x00, 0x00}, {0x40, 0x00, 0x00, 0x01}},
+    {{0x3a, 0x00, 0x00, 0x00}, {0x3d, 0x00, 0x00, 0x00}},
+    {{0x3b, 0x00, 0x00, 0x00}, {0x3c, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x55, 0x01}, {0x00, 0x01, 0x56, 0x01}},
+    {{0x00, 0x01, 0x57, 0x01}, {0x00, 0x01, 0x59, 0x01}},
+    {{0x3e, 0x00, 0x00, 0x00}, {0x3f, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x6a, 0x01}, {0x00, 0x01, 0x6b, 0x01}},
+    {{0x00, 0x01, 0x71, 0x01}, {0x00, 0x01, 0x76, 0x01}},
+    /* 64 */
+    {{0x41, 0x00, 0x00, 0x00}, {0x44, 0x00, 0x00, 0x01}},
+    {{0x42, 0x00, 0x00, 0x00}, {0x43, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x77, 0x01}, {0x00, 0x01, 0x78, 0x01}},
+    {{0x00, 0x01, 0x79, 0x01}, {0x00, 0x01, 0x7a, 0x01}},
+    {{0x45, 0x00, 0x00, 0x00}, {0x48, 0x00, 0x00, 0x01}},
+    {{0x46, 0x00, 0x00, 0x00}, {0x47, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x26, 0x01}, {0x00, 0x01, 0x2a, 0x01}},
+    {{0x00, 0x01, 0x2c, 0x01}, {0x00, 0x01, 0x3b, 0x01}},
+    {{0x49, 0x00, 0x00, 0x00}, {0x4a, 0x00, 0x00, 0x01}},
+    {{0x00, 0x01, 0x58, 0x01}, {0x00, 0x01, 0x5a, 0x01}},
+    {{0x4b, 0x00, 0x00, 0x00}, {0x4e, 0x00, 0x00, 0x01}},
+    {{0x4c, 0x00, 0x00, 0x00}, {0x4d, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x21, 0x01}, {0x00, 0x01, 0x22, 0x01}},
+    {{0x00, 0x01, 0x28, 0x01}, {0x00, 0x01, 0x29, 0x01}},
+    {{0x4f, 0x00, 0x00, 0x00}, {0x51, 0x00, 0x00, 0x01}},
+    {{0x00, 0x01, 0x3f, 0x01}, {0x50, 0x00, 0x00, 0x00}},
+    /* 80 */
+    {{0x00, 0x01, 0x27, 0x01}, {0x00, 0x01, 0x2b, 0x01}},
+    {{0x52, 0x00, 0x00, 0x00}, {0x54, 0x00, 0x00, 0x01}},
+    {{0x00, 0x01, 0x7c, 0x01}, {0x53, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x23, 0x01}, {0x00, 0x01, 0x3e, 0x01}},
+    {{0x55, 0x00, 0x00, 0x00}, {0x58, 0x00, 0x00, 0x01}},
+    {{0x56, 0x00, 0x00, 0x00}, {0x57, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x00, 0x01}, {0x00, 0x01, 0x24, 0x01}},
+    {{0x00, 0x01, 0x40, 0x01}, {0x00, 0x01, 0x5b, 0x01}},
+    {{0x59, 0x00, 0x00, 0x00}, {0x5a, 0x00, 0x00, 0x01}},
+    {{0x00, 0x01, 0x5d, 0x01}, {0x00, 0x01, 0x7e, 0x01}},
+    {{0x5b, 0x00, 0x00, 0x00}, {0x5c, 0x00, 0x00, 0x01}},
+    {{0x00, 0x01, 0x5e, 0x01}, {0x00, 0x01, 0x7d, 0x01}},
+    {{0x5d, 0x00, 0x00, 0x00}, {0x5e, 0x00, 0x00, 0x01}},
+    {{0x00, 0x01, 0x3c, 0x01}, {0x00, 0x01, 0x60, 0x01}},
+    {{0x00, 0x01, 0x7b, 0x01}, {0x5f, 0x00, 0x00, 0x01}},
+    {{0x60, 0x00, 0x00, 0x00}, {0x6e, 0x00, 0x00, 0x01}},
+    /* 96 */
+    {{0x61, 0x00, 0x00, 0x00}, {0x65, 0x00, 0x00, 0x00}},
+    {{0x62, 0x00, 0x00, 0x00}, {0x63, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x5c, 0x01}, {0x00, 0x01, 0xc3, 0x01}},
+    {{0x00, 0x01, 0xd0, 0x01}, {0x64, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x80, 0x01}, {0x00, 0x01, 0x82, 0x01}},
+    {{0x66, 0x00, 0x00, 0x00}, {0x69, 0x00, 0x00, 0x00}},
+    {{0x67, 0x00, 0x00, 0x00}, {0x68, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x83, 0x01}, {0x00, 0x01, 0xa2, 0x01}},
+    {{0x00, 0x01, 0xb8, 0x01}, {0x00, 0x01, 0xc2, 0x01}},
+    {{0x6a, 0x00, 0x00, 0x00}, {0x6b, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xe0, 0x01}, {0x00, 0x01, 0xe2, 0x01}},
+    {{0x6c, 0x00, 0x00, 0x00}, {0x6d, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x99, 0x01}, {0x00, 0x01, 0xa1, 0x01}},
+    {{0x00, 0x01, 0xa7, 0x01}, {0x00, 0x01, 0xac, 0x01}},
+    {{0x6f, 0x00, 0x00, 0x00}, {0x85, 0x00, 0x00, 0x01}},
+    {{0x70, 0x00, 0x00, 0x00}, {0x77, 0x00, 0x00, 0x00}},
+    /* 112 */
+    {{0x71, 0x00, 0x00, 0x00}, {0x74, 0x00, 0x00, 0x00}},
+    {{0x72, 0x00, 0x00, 0x00}, {0x73, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xb0, 0x01}, {0x00, 0x01, 0xb1, 0x01}},
+    {{0x00, 0x01, 0xb3, 0x01}, {0x00, 0x01, 0xd1, 0x01}},
+    {{0x75, 0x00, 0x00, 0x00}, {0x76, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xd8, 0x01}, {0x00, 0x01, 0xd9, 0x01}},
+    {{0x00, 0x01, 0xe3, 0x01}, {0x00, 0x01, 0xe5, 0x01}},
+    {{0x78, 0x00, 0x00, 0x00}, {0x7e, 0x00, 0x00, 0x00}},
+    {{0x79, 0x00, 0x00, 0x00}, {0x7b, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xe6, 0x01}, {0x7a, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x81, 0x01}, {0x00, 0x01, 0x84, 0x01}},
+    {{0x7c, 0x00, 0x00, 0x00}, {0x7d, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x85, 0x01}, {0x00, 0x01, 0x86, 0x01}},
+    {{0x00, 0x01, 0x88, 0x01}, {0x00, 0x01, 0x92, 0x01}},
+    {{0x7f, 0x00, 0x00, 0x00}, {0x82, 0x00, 0x00, 0x00}},
+    {{0x80, 0x00, 0x00, 0x00}, {0x81, 0x00, 0x00, 0x00}},
+    /* 128 */
+    {{0x00, 0x01, 0x9a, 0x01}, {0x00, 0x01, 0x9c, 0x01}},
+    {{0x00, 0x01, 0xa0, 0x01}, {0x00, 0x01, 0xa3, 0x01}},
+    {{0x83, 0x00, 0x00, 0x00}, {0x84, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xa4, 0x01}, {0x00, 0x01, 0xa9, 0x01}},
+    {{0x00, 0x01, 0xaa, 0x01}, {0x00, 0x01, 0xad, 0x01}},
+    {{0x86, 0x00, 0x00, 0x00}, {0x99, 0x00, 0x00, 0x01}},
+    {{0x87, 0x00, 0x00, 0x00}, {0x8e, 0x00, 0x00, 0x00}},
+    {{0x88, 0x00, 0x00, 0x00}, {0x8b, 0x00, 0x00, 0x00}},
+    {{0x89, 0x00, 0x00, 0x00}, {0x8a, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xb2, 0x01}, {0x00, 0x01, 0xb5, 0x01}},
+    {{0x00, 0x01, 0xb9, 0x01}, {0x00, 0x01, 0xba, 0x01}},
+    {{0x8c, 0x00, 0x00, 0x00}, {0x8d, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xbb, 0x01}, {0x00, 0x01, 0xbd, 0x01}},
+    {{0x00, 0x01, 0xbe, 0x01}, {0x00, 0x01, 0xc4, 0x01}},
+    {{0x8f, 0x00, 0x00, 0x00}, {0x92, 0x00, 0x00, 0x00}},
+    {{0x90, 0x00, 0x00, 0x00}, {0x91, 0x00, 0x00, 0x00}},
+    /* 144 */
+    {{0x00, 0x01, 0xc6, 0x01}, {0x00, 0x01, 0xe4, 0x01}},
+    {{0x00, 0x01, 0xe8, 0x01}, {0x00, 0x01, 0xe9, 0x01}},
+    {{0x93, 0x00, 0x00, 0x00}, {0x96, 0x00, 0x00, 0x00}},
+    {{0x94, 0x00, 0x00, 0x00}, {0x95, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x01, 0x01}, {0x00, 0x01, 0x87, 0x01}},
+    {{0x00, 0x01, 0x89, 0x01}, {0x00, 0x01, 0x8a, 0x01}},
+    {{0x97, 0x00, 0x00, 0x00}, {0x98, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x8b, 0x01}, {0x00, 0x01, 0x8c, 0x01}},
+    {{0x00, 0x01, 0x8d, 0x01}, {0x00, 0x01, 0x8f, 0x01}},
+    {{0x9a, 0x00, 0x00, 0x00}, {0xa9, 0x00, 0x00, 0x01}},
+    {{0x9b, 0x00, 0x00, 0x00}, {0xa2, 0x00, 0x00, 0x00}},
+    {{0x9c, 0x00, 0x00, 0x00}, {0x9f, 0x00, 0x00, 0x00}},
+    {{0x9d, 0x00, 0x00, 0x00}, {0x9e, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x93, 0x01}, {0x00, 0x01, 0x95, 0x01}},
+    {{0x00, 0x01, 0x96, 0x01}, {0x00, 0x01, 0x97, 0x01}},
+    {{0xa0, 0x00, 0x00, 0x00}, {0xa1, 0x00, 0x00, 0x00}},
+    /* 160 */
+    {{0x00, 0x01, 0x98, 0x01}, {0x00, 0x01, 0x9b, 0x01}},
+    {{0x00, 0x01, 0x9d, 0x01}, {0x00, 0x01, 0x9e, 0x01}},
+    {{0xa3, 0x00, 0x00, 0x00}, {0xa6, 0x00, 0x00, 0x00}},
+    {{0xa4, 0x00, 0x00, 0x00}, {0xa5, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xa5, 0x01}, {0x00, 0x01, 0xa6, 0x01}},
+    {{0x00, 0x01, 0xa8, 0x01}, {0x00, 0x01, 0xae, 0x01}},
+    {{0xa7, 0x00, 0x00, 0x00}, {0xa8, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xaf, 0x01}, {0x00, 0x01, 0xb4, 0x01}},
+    {{0x00, 0x01, 0xb6, 0x01}, {0x00, 0x01, 0xb7, 0x01}},
+    {{0xaa, 0x00, 0x00, 0x00}, {0xb4, 0x00, 0x00, 0x01}},
+    {{0xab, 0x00, 0x00, 0x00}, {0xae, 0x00, 0x00, 0x00}},
+    {{0xac, 0x00, 0x00, 0x00}, {0xad, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xbc, 0x01}, {0x00, 0x01, 0xbf, 0x01}},
+    {{0x00, 0x01, 0xc5, 0x01}, {0x00, 0x01, 0xe7, 0x01}},
+    {{0xaf, 0x00, 0x00, 0x00}, {0xb1, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xef, 0x01}, {0xb0, 0x00, 0x00, 0x00}},
+    /* 176 */
+    {{0x00, 0x01, 0x09, 0x01}, {0x00, 0x01, 0x8e, 0x01}},
+    {{0xb2, 0x00, 0x00, 0x00}, {0xb3, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x90, 0x01}, {0x00, 0x01, 0x91, 0x01}},
+    {{0x00, 0x01, 0x94, 0x01}, {0x00, 0x01, 0x9f, 0x01}},
+    {{0xb5, 0x00, 0x00, 0x00}, {0xbe, 0x00, 0x00, 0x01}},
+    {{0xb6, 0x00, 0x00, 0x00}, {0xb9, 0x00, 0x00, 0x00}},
+    {{0xb7, 0x00, 0x00, 0x00}, {0xb8, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xab, 0x01}, {0x00, 0x01, 0xce, 0x01}},
+    {{0x00, 0x01, 0xd7, 0x01}, {0x00, 0x01, 0xe1, 0x01}},
+    {{0xba, 0x00, 0x00, 0x00}, {0xbb, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xec, 0x01}, {0x00, 0x01, 0xed, 0x01}},
+    {{0xbc, 0x00, 0x00, 0x00}, {0xbd, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xc7, 0x01}, {0x00, 0x01, 0xcf, 0x01}},
+    {{0x00, 0x01, 0xea, 0x01}, {0x00, 0x01, 0xeb, 0x01}},
+    {{0xbf, 0x00, 0x00, 0x00}, {0xcf, 0x00, 0x00, 0x01}},
+    {{0xc0, 0x00, 0x00, 0x00}, {0xc7, 0x00, 0x00, 0x00}},
+    /* 192 */
+    {{0xc1, 0x00, 0x00, 0x00}, {0xc4, 0x00, 0x00, 0x00}},
+    {{0xc2, 0x00, 0x00, 0x00}, {0xc3, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xc0, 0x01}, {0x00, 0x01, 0xc1, 0x01}},
+    {{0x00, 0x01, 0xc8, 0x01}, {0x00, 0x01, 0xc9, 0x01}},
+    {{0xc5, 0x00, 0x00, 0x00}, {0xc6, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xca, 0x01}, {0x00, 0x01, 0xcd, 0x01}},
+    {{0x00, 0x01, 0xd2, 0x01}, {0x00, 0x01, 0xd5, 0x01}},
+    {{0xc8, 0x00, 0x00, 0x00}, {0xcb, 0x00, 0x00, 0x00}},
+    {{0xc9, 0x00, 0x00, 0x00}, {0xca, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xda, 0x01}, {0x00, 0x01, 0xdb, 0x01}},
+    {{0x00, 0x01, 0xee, 0x01}, {0x00, 0x01, 0xf0, 0x01}},
+    {{0xcc, 0x00, 0x00, 0x00}, {0xcd, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xf2, 0x01}, {0x00, 0x01, 0xf3, 0x01}},
+    {{0x00, 0x01, 0xff, 0x01}, {0xce, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xcb, 0x01}, {0x00, 0x01, 0xcc, 0x01}},
+    {{0xd0, 0x00, 0x00, 0x00}, {0xdf, 0x00, 0x00, 0x01}},
+    /* 208 */
+    {{0xd1, 0x00, 0x00, 0x00}, {0xd8, 0x00, 0x00, 0x00}},
+    {{0xd2, 0x00, 0x00, 0x00}, {0xd5, 0x00, 0x00, 0x00}},
+    {{0xd3, 0x00, 0x00, 0x00}, {0xd4, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xd3, 0x01}, {0x00, 0x01, 0xd4, 0x01}},
+    {{0x00, 0x01, 0xd6, 0x01}, {0x00, 0x01, 0xdd, 0x01}},
+    {{0xd6, 0x00, 0x00, 0x00}, {0xd7, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xde, 0x01}, {0x00, 0x01, 0xdf, 0x01}},
+    {{0x00, 0x01, 0xf1, 0x01}, {0x00, 0x01, 0xf4, 0x01}},
+    {{0xd9, 0x00, 0x00, 0x00}, {0xdc, 0x00, 0x00, 0x00}},
+    {{0xda, 0x00, 0x00, 0x00}, {0xdb, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xf5, 0x01}, {0x00, 0x01, 0xf6, 0x01}},
+    {{0x00, 0x01, 0xf7, 0x01}, {0x00, 0x01, 0xf8, 0x01}},
+    {{0xdd, 0x00, 0x00, 0x00}, {0xde, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xfa, 0x01}, {0x00, 0x01, 0xfb, 0x01}},
+    {{0x00, 0x01, 0xfc, 0x01}, {0x00, 0x01, 0xfd, 0x01}},
+    {{0xe0, 0x00, 0x00, 0x00}, {0xee, 0x00, 0x00, 0x01}},
+    /* 224 */
+    {{0xe1, 0x00, 0x00, 0x00}, {0xe7, 0x00, 0x00, 0x00}},
+    {{0xe2, 0x00, 0x00, 0x00}, {0xe4, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0xfe, 0x01}, {0xe3, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x02, 0x01}, {0x00, 0x01, 0x03, 0x01}},
+    {{0xe5, 0x00, 0x00, 0x00}, {0xe6, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x04, 0x01}, {0x00, 0x01, 0x05, 0x01}},
+    {{0x00, 0x01, 0x06, 0x01}, {0x00, 0x01, 0x07, 0x01}},
+    {{0xe8, 0x00, 0x00, 0x00}, {0xeb, 0x00, 0x00, 0x00}},
+    {{0xe9, 0x00, 0x00, 0x00}, {0xea, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x08, 0x01}, {0x00, 0x01, 0x0b, 0x01}},
+    {{0x00, 0x01, 0x0c, 0x01}, {0x00, 0x01, 0x0e, 0x01}},
+    {{0xec, 0x00, 0x00, 0x00}, {0xed, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x0f, 0x01}, {0x00, 0x01, 0x10, 0x01}},
+    {{0x00, 0x01, 0x11, 0x01}, {0x00, 0x01, 0x12, 0x01}},
+    {{0xef, 0x00, 0x00, 0x00}, {0xf6, 0x00, 0x00, 0x01}},
+    {{0xf0, 0x00, 0x00, 0x00}, {0xf3, 0x00, 0x00, 0x00}},
+    /* 240 */
+    {{0xf1, 0x00, 0x00, 0x00}, {0xf2, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x13, 0x01}, {0x00, 0x01, 0x14, 0x01}},
+    {{0x00, 0x01, 0x15, 0x01}, {0x00, 0x01, 0x17, 0x01}},
+    {{0xf4, 0x00, 0x00, 0x00}, {0xf5, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x18, 0x01}, {0x00, 0x01, 0x19, 0x01}},
+    {{0x00, 0x01, 0x1a, 0x01}, {0x00, 0x01, 0x1b, 0x01}},
+    {{0xf7, 0x00, 0x00, 0x00}, {0xfa, 0x00, 0x00, 0x01}},
+    {{0xf8, 0x00, 0x00, 0x00}, {0xf9, 0x00, 0x00, 0x00}},
+    {{0x00, 0x01, 0x1c, 0x01}, {0x00, 0x01, 0x1d, 0x01}},
+    {{0x00, 0x01, 0x1e, 0x01}, {0x00, 0x01, 0x1f, 0x01}},
+    {{0xfb, 0x00, 0x00, 0x00}, {0xfc, 0x00, 0x00, 0x01}},
+    {{0x00, 0x01, 0x7f, 0x01}, {0x00, 0x01, 0xdc, 0x01}},
+    {{0x00, 0x01, 0xf9, 0x01}, {0xfd, 0x00, 0x00, 0x01}},
+    {{0xfe, 0x00, 0x00, 0x00}, {0xff, 0x00, 0x00, 0x01}},
+    {{0x00, 0x01, 0x0a, 0x01}, {0x00, 0x01, 0x0d, 0x01}},
+    {{0x00, 0x01, 0x16, 0x01}, {0xff, 0x00, 0x00, 0x00}}
+};
+
+
+#if (NGX_HTTP_HUFF_DECODE_FAST)
+
+static ngx_http_huff_decode_fast_t  ngx_http_huff_decode_fast_codes[2048] =
+{
+    /* 0x000 */
+    {0x0a, 0x02, 0x30, 0x30}, {0x0a, 0x02, 0x30, 0x30},
+    {0x0a, 0x02, 0x30, 0x31}, {0x0a, 0x02, 0x30, 0x31},
+    {0x0a, 0x02, 0x30, 0x32}, {0x0a, 0x02, 0x30, 0x32},
+    {0x0a, 0x02, 0x30, 0x61}, {0x0a, 0x02, 0x30, 0x61},
+    {0x0a, 0x02, 0x30, 0x63}, {0x0a, 0x02, 0x30, 0x63},
+    {0x0a, 0x02, 0x30, 0x65}, {0x0a, 0x02, 0x30, 0x65},
+    {0x0a, 0x02, 0x30, 0x69}, {0x0a, 0x02, 0x30, 0x69},
+    {0x0a, 0x02, 0x30, 0x6f}, {0x0a, 0x02, 0x30, 0x6f},
+    {0x0a, 0x02, 0x30, 0x73}, {0x0a, 0x02, 0x30, 0x73},
+    {0x0a, 0x02, 0x30, 0x74}, {0x0a, 0x02, 0x30, 0x74},
+    {0x0b, 0x02, 0x30, 0x20}, {0x0b, 0x02, 0x30, 0x25},
+    {0x0b, 0x02, 0x30, 0x2d}, {0x0b, 0x02, 0x30, 0x2e},
+    {0x0b, 0x02, 0x30, 0x2f}, {0x0b, 0x02, 0x30, 0x33},
+    {0x0b, 0x02, 0x30, 0x34}, {0x0b, 0x02, 0x30, 0x35},
+    {0x0b, 0x02, 0x30, 0x36}, {0x0b, 0x02, 0x30, 0x37},
+    {0x0b, 0x02, 0x30, 0x38}, {0x0b, 0x02, 0x30, 0x39},
+    {0x0b, 0x02, 0x30, 0x3d}, {0x0b, 0x02, 0x30, 0x41},
+    {0x0b, 0x02, 0x30, 0x5f}, {0x0b, 0x02, 0x30, 0x62},
+    {0x0b, 0x02, 0x30, 0x64}, {0x0b, 0x02, 0x30, 0x66},
+    {0x0b, 0x02, 0x30, 0x67}, {0x0b, 0x02, 0x30, 0x68},
+    {0x0b, 0x02, 0x30, 0x6c}, {0x0b, 0x02, 0x30, 0x6d},
+    {0x0b, 0x02, 0x30, 0x6e}, {0x0b, 0x02, 0x30, 0x70},
+    {0x0b, 0x02, 0x30, 0x72}, {0x0b, 0x02, 0x30, 0x75},
+    {0x05, 0x01, 0x30, 0x00}, {0x05, 0x01, 0x30, 0x00},
+    {0x05, 0x01, 0x30, 0x00}, {0x05, 0x01, 0x30, 0x00},
+    {0x05, 0x01, 0x30, 0x00}, {0x05, 0x01, 0x30, 0x00},
+    {0x05, 0x01, 0x30, 0x00}, {0x05, 0x01, 0x30, 0x00},
+    {0x05, 0x01, 0x30, 0x00}, {0x05, 0x01, 0x30, 0x00},
+    {0x05, 0x01, 0x30, 0x00}, {0x05, 0x01, 0x30, 0x00},
+    {0x05, 0x01, 0x30, 0x00}, {0x05, 0x01, 0x30, 0x00},
+    {0x05, 0x01, 0x30, 0x00}, {0x05, 0x01, 0x30, 0x00},
+    {0x05, 0x01, 0x30, 0x00}, {0x05, 0x01, 0x30, 0x00},
+    /* 0x040 */
+    {0x0a, 0x02, 0x31, 0x30}, {0x0a, 0x02, 0x31, 0x30},
+    {0x0a, 0x02, 0x31, 0x31}, {0x0a, 0x02, 0x31, 0x31},
+    {0x0a, 0x02, 0x31, 0x32}, {0x0a, 0x02, 0x31, 0x32},
+    {0x0a, 0x02, 0x31, 0x61}, {0x0a, 0x02, 0x31, 0x61},
+    {0x0a, 0x02, 0x31, 0x63}, {0x0a, 0x02, 0x31, 0x63},
+    {0x0a, 0x02, 0x31, 0x65}, {0x0a, 0x02, 0x31, 0x65},
+    {0x0a, 0x02, 0x31, 0x69}, {0x0a, 0x02, 0x31, 0x69},
+    {0x0a, 0x02, 0x31, 0x6f}, {0x0a, 0x02, 0x31, 0x6f},
+    {0x0a, 0x02, 0x31, 0x73}, {0x0a, 0x02, 0x31, 0x73},
+    {0x0a, 0x02, 0x31, 0x74}, {0x0a, 0x02, 0x31, 0x74},
+    {0x0b, 0x02, 0x31, 0x20}, {0x0b, 0x02, 0x31, 0x25},
+    {0x0b, 0x02, 0x31, 0x2d}, {0x0b, 0x02, 0x31, 0x2e},
+    {0x0b, 0x02, 0x31, 0x2f}, {0x0b, 0x02, 0x31, 0x33},
+    {0x0b, 0x02, 0x31, 0x34}, {0x0b, 0x02, 0x31, 0x35},
+    {0x0b, 0x02, 0x31, 0x36}, {0x0b, 0x02, 0x31, 0x37},
+    {0x0b, 0x02, 0x31, 0x38}, {0x0b, 0x02, 0x31, 0x39},
+    {0x0b, 0x02, 0x31, 0x3d}, {0x0b, 0x02, 0x31, 0x41},
+    {0x0b, 0x02, 0x31, 0x5f}, {0x0b, 0x02, 0x31, 0x62},
+    {0x0b, 0x02, 0x31, 0x64}, {0x0b, 0x02, 0x31, 0x66},
+    {0x0b, 0x02, 0x31, 0x67}, {0x0b, 0x02, 0x31, 0x68},
+    {0x0b, 0x02, 0x31, 0x6c}, {0x0b, 0x02, 0x31, 0x6d},
+    {0x0b, 0x02, 0x31, 0x6e}, {0x0b, 0x02, 0x31, 0x70},
+    {0x0b, 0x02, 0x31, 0x72}, {0x0b, 0x02, 0x31, 0x75},
+    {0x05, 0x01, 0x31, 0x00}, {0x05, 0x01, 0x31, 0x00},
+    {0x05, 0x01, 0x31, 0x00}, {0x05, 0x01, 0x31, 0x00},
+    {0x05, 0x01, 0x31, 0x00}, {0x05, 0x01, 0x31, 0x00},
+    {0x05, 0x01, 0x31, 0x00}, {0x05, 0x01, 0x31, 0x00},
+    {0x05, 0x01, 0x31, 0x00}, {0x05, 0x01, 0x31, 0x00},
+    {0x05, 0x01, 0x31, 0x00}, {0x05, 0x01, 0x31, 0x00},
+    {0x05, 0x01, 0x31, 0x00}, {0x05, 0x01, 0x31, 0x00},
+    {0x05, 0x01, 0x31, 0x00}, {0x05, 0x01, 0x31, 0x00},
+    {0x05, 0x01, 0x31, 0x00}, {0x05, 0x01, 0x31, 0x00},
+    /* 0x080 */
+    {0x0a, 0x02, 0x32, 0x30}, {0x0a, 0x02, 0x32, 0x30},
+    {0x0a, 0x02, 0x32, 0x31}, {0x0a, 0x02, 0x32, 0x31},
+    {0x0a, 0x02, 0x32, 0x32}, {0x0a, 0x02, 0x32, 0x32},
+    {0x0a, 0x02, 0x32, 0x61}, {0x0a, 0x02, 0x32, 0x61},
+    {0x0a, 0x02, 0x32, 0x63}, {0x0a, 0x02, 0x32, 0x63},
+    {0x0a, 0x02, 0x32, 0x65}, {0x0a, 0x02, 0x32, 0x65},
+    {0x0a, 0x02, 0x32, 0x69}, {0x0a, 0x02, 0x32, 0x69},
+    {0x0a, 0x02, 0x32, 0x6f}, {0x0a, 0x02, 0x32, 0x6f},
+    {0x0a, 0x02, 0x32, 0x73}, {0x0a, 0x02, 0x32, 0x73},
+    {0x0a, 0x02, 0x32, 0x74}, {0x0a, 0x02, 0x32, 0x74},
+    {0x0b, 0x02, 0x32, 0x20}, {0x0b, 0x02, 0x32, 0x25},
+    {0x0b, 0x02, 0x32, 0x2d}, {0x0b, 0x02, 0x32, 0x2e},
+    {0x0b, 0x02, 0x32, 0x2f}, {0x0b, 0x02, 0x32, 0x33},
+    {0x0b, 0x02, 0x32, 0x34}, {0x0b, 0x02, 0x32, 0x35},
+    {0x0b, 0x02, 0x32, 0x36}, {0x0b, 0x02, 0x32, 0x37},
+    {0x0b, 0x02, 0x32, 0x38}, {0x0b, 0x02, 0x32, 0x39},
+    {0x0b, 0x02, 0x32, 0x3d}, {0x0b, 0x02, 0x32, 0x41},
+    {0x0b, 0x02, 0x32, 0x5f}, {0x0b, 0x02, 0x32, 0x62},
+    {0x0b, 0x02, 0x32, 0x64}, {0x0b, 0x02, 0x32, 0x66},
+    {0x0b, 0x02, 0x32, 0x67}, {0x0b, 0x02, 0x32, 0x68},
+    {0x0b, 0x02, 0x32, 0x6c}, {0x0b, 0x02, 0x32, 0x6d},
+    {0x0b, 0x02, 0x32, 0x6e}, {0x0b, 0x02, 0x32, 0x70},
+    {0x0b, 0x02, 0x32, 0x72}, {0x0b, 0x02, 0x32, 0x75},
+    {0x05, 0x01, 0x32, 0x00}, {0x05, 0x01, 0x32, 0x00},
+    {0x05, 0x01, 0x32, 0x00}, {0x05, 0x01, 0x32, 0x00},
+    {0x05, 0x01, 0x32, 0x00}, {0x05, 0x01, 0x32, 0x00},
+    {0x05, 0x01, 0x32, 0x00}, {0x05, 0x01, 0x32, 0x00},
+    {0x05, 0x01, 0x32, 0x00}, {0x05, 0x01, 0x32, 0x00},
+    {0x05, 0x01, 0x32, 0x00}, {0x05, 0x01, 0x32, 0x00},
+    {0x05, 0x01, 0x32, 0x00}, {0x05, 0x01, 0x32, 0x00},
+    {0x05, 0x01, 0x32, 0x00}, {0x05, 0x01, 0x32, 0x00},
+    {0x05, 0x01, 0x32, 0x00}, {0x05, 0x01, 0x32, 0x00},
+    /* 0x0c0 */
+    {0x0a, 0x02, 0x61, 0x30}, {0x0a, 0x02, 0x61, 0x30},
+    {0x0a, 0x02, 0x61, 0x31}, {0x0a, 0x02, 0x61, 0x31},
+    {0x0a, 0x02, 0x61, 0x32}, {0x0a, 0x02, 0x61, 0x32},
+    {0x0a, 0x02, 0x61, 0x61}, {0x0a, 0x02, 0x61, 0x61},
+    {0x0a, 0x02, 0x61, 0x63}, {0x0a, 0x02, 0x61, 0x63},
+    {0x0a, 0x02, 0x61, 0x65}, {0x0a, 0x02, 0x61, 0x65},
+    {0x0a, 0x02, 0x61, 0x69}, {0x0a, 0x02, 0x61, 0x69},
+    {0x0a, 0x02, 0x61, 0x6f}, {0x0a, 0x02, 0x61, 0x6f},
+    {0x0a, 0x02, 0x61, 0x73}, {0x0a, 0x02, 0x61, 0x73},
+    {0x0a, 0x02, 0x61, 0x74}, {0x0a, 0x02, 0x61, 0x74},
+    {0x0b, 0x02, 0x61, 0x20}, {0x0b, 0x02, 0x61, 0x25},
+    {0x0b, 0x02, 0x61, 0x2d}, {0x0b, 0x02, 0x61, 0x2e},
+    {0x0b, 0x02, 0x61, 0x2f}, {0x0b, 0x02, 0x61, 0x33},
+    {0x0b, 0x02, 0x61, 0x34}, {0x0b, 0x02, 0x61, 0x35},
+    {0x0b, 0x02, 0x61, 0x36}, {0x0b, 0x02, 0x61, 0x37},
+    {0x0b, 0x02, 0x61, 0x38}, {0x0b, 0x02, 0x61, 0x39},
+    {0x0b, 0x02, 0x61, 0x3d}, {0x0b, 0x02, 0x61, 0x41},
+    {0x0b, 0x02, 0x61, 0x5f}, {0x0b, 0x02, 0x61, 0x62},
+    {0x0b, 0x02, 0x61, 0x64}, {0x0b, 0x02, 0x61, 0x66},
+    {0x0b, 0x02, 0x61, 0x67}, {0x0b, 0x02, 0x61, 0x68},
+    {0x0b, 0x02, 0x61, 0x6c}, {0x0b, 0x02, 0x61, 0x6d},
+    {0x0b, 0x02, 0x61, 0x6e}, {0x0b, 0x02, 0x61, 0x70},
+    {0x0b, 0x02, 0x61, 0x72}, {0x0b, 0x02, 0x61, 0x75},
+    {0x05, 0x01, 0x61, 0x00}, {0x05, 0x01, 0x61, 0x00},
+    {0x05, 0x01, 0x61, 0x00}, {0x05, 0x01, 0x61, 0x00},
+    {0x05, 0x01, 0x61, 0x00}, {0x05, 0x01, 0x61, 0x00},
+    {0x05, 0x01, 0x61, 0x00}, {0x05, 0x01, 0x61, 0x00},
+    {0x05, 0x01, 0x61, 0x00}, {0x05, 0x01, 0x61, 0x00},
+    {0x05, 0x01, 0x61, 0x00}, {0x05, 0x01, 0x61, 0x00},
+    {0x05, 0x01, 0x61, 0x00}, {0x05, 0x01, 0x61, 0x00},
+    {0x05, 0x01, 0x61, 0x00}, {0x05, 0x01, 0x61, 0x00},
+    {0x05, 0x01, 0x61, 0x00}, {0x05, 0x01, 0x61, 0x00},
+    /* 0x100 */
+    {0x0a, 0x02, 0x63, 0x30}, {0x0a, 0x02, 0x63, 0x30},
+    {0x0a, 0x02, 0x63, 0x31}, {0x0a, 0x02, 0x63, 0x31},
+    {0x0a, 0x02, 0x63, 0x32}, {0x0a, 0x02, 0x63, 0x32},
+    {0x0a, 0x02, 0x63, 0x61}, {0x0a, 0x02, 0x63, 0x61},
+    {0x0a, 0x02, 0x63, 0x63}, {0x0a, 0x02, 0x63, 0x63},
+    {0x0a, 0x02, 0x63, 0x65}, {0x0a, 0x02, 0x63, 0x65},
+    {0x0a, 0x02, 0x63, 0x69}, {0x0a, 0x02, 0x63, 0x69},
+    {0x0a, 0x02, 0x63, 0x6f}, {0x0a, 0x02, 0x63, 0x6f},
+    {0x0a, 0x02, 0x63, 0x73}, {0x0a, 0x02, 0x63, 0x73},
+    {0x0a, 0x02, 0x63, 0x74}, {0x0a, 0x02, 0x63, 0x74},
+    {0x0b, 0x02, 0x63, 0x20}, {0x0b, 0x02, 0x63, 0x25},
+    {0x0b, 0x02, 0x63, 0x2d}, {0x0b, 0x02, 0x63, 0x2e},
+    {0x0b, 0x02, 0x63, 0x2f}, {0x0b, 0x02, 0x63, 0x33},
+    {0x0b, 0x02, 0x63, 0x34}, {0x0b, 0x02, 0x63, 0x35},
+    {0x0b, 0x02, 0x63, 0x36}, {0x0b, 0x02, 0x63, 0x37},
+    {0x0b, 0x02, 0x63, 0x38}, {0x0b, 0x02, 0x63, 0x39},
+    {0x0b, 0x02, 0x63, 0x3d}, {0x0b, 0x02, 0x63, 0x41},
+    {0x0b, 0x02, 0x63, 0x5f}, {0x0b, 0x02, 0x63, 0x62},
+    {0x0b, 0x02, 0x63, 0x64}, {0x0b, 0x02, 0x63, 0x66},
+    {0x0b, 0x02, 0x63, 0x67}, {0x0b, 0x02, 0x63, 0x68},
+    {0x0b, 0x02, 0x63, 0x6c}, {0x0b, 0x02, 0x63, 0x6d},
+    {0x0b, 0x02, 0x63, 0x6e}, {0x0b, 0x02, 0x63, 0x70},
+    {0x0b, 0x02, 0x63, 0x72}, {0x0b, 0x02, 0x63, 0x75},
+    {0x05, 0x01, 0x63, 0x00}, {0x05, 0x01, 0x63, 0x00},
+    {0x05, 0x01, 0x63, 0x00}, {0x05, 0x01, 0x63, 0x00},
+    {0x05, 0x01, 0x63, 0x00}, {0x05, 0x01, 0x63, 0x00},
+    {0x05, 0x01, 0x63, 0x00}, {0x05, 0x01, 0x63, 0x00},
+    {0x05, 0x01, 0x63, 0x00}, {0x05, 0x01, 0x63, 0x00},
+    {0x05, 0x01, 0x63, 0x00}, {0x05, 0x01, 0x63, 0x00},
+    {0x05, 0x01, 0x63, 0x00}, {0x05, 0x01, 0x63, 0x00},
+    {0x05, 0x01, 0x63, 0x00}, {0x05, 0x01, 0x63, 0x00},
+    {0x05, 0x01, 0x63, 0x00}, {0x05, 0x01, 0x63, 0x00},
+    /* 0x140 */
+    {0x0a, 0x02, 0x65, 0x30}, {0x0a, 0x02, 0x65, 0x30},
+    {0x0a, 0x02, 0x65, 0x31}, {0x0a, 0x02, 0x65, 0x31},
+    {0x0a, 0x02, 0x65, 0x32}, {0x0a, 0x02, 0x65, 0x32},
+    {0x0a, 0x02, 0x65, 0x61}, {0x0a, 0x02, 0x65, 0x61},
+    {0x0a, 0x02, 0x65, 0x63}, {0x0a, 0x02, 0x65, 0x63},
+    {0x0a, 0x02, 0x65, 0x65}, {0x0a, 0x02, 0x65, 0x65},
+    {0x0a, 0x02, 0x65, 0x69}, {0x0a, 0x02, 0x65, 0x69},
+    {0x0a, 0x02, 0x65, 0x6f}, {0x0a, 0x02, 0x65, 0x6f},
+    {0x0a, 0x02, 0x65, 0x73}, {0x0a, 0x02, 0x65, 0x73},
+    {0x0a, 0x02, 0x65, 0x74}, {0x0a, 0x02, 0x65, 0x74},
+    {0x0b, 0x02, 0x65, 0x20}, {0x0b, 0x02, 0x65, 0x25},
+    {0x0b, 0x02, 0x65, 0x2d}, {0x0b, 0x02, 0x65, 0x2e},
+    {0x0b, 0x02, 0x65, 0x2f}, {0x0b, 0x02, 0x65, 0x33},
+    {0x0b, 0x02, 0x65, 0x34}, {0x0b, 0x02, 0x65, 0x35},
+    {0x0b, 0x02, 0x65, 0x36}, {0x0b, 0x02, 0x65, 0x37},
+    {0x0b, 0x02, 0x65, 0x38}, {0x0b, 0x02, 0x65, 0x39},
+    {0x0b, 0x02, 0x65, 0x3d}, {0x0b, 0x02, 0x65, 0x41},
+    {0x0b, 0x02, 0x65, 0x5f}, {0x0b, 0x02, 0x65, 0x62},
+    {0x0b, 0x02, 0x65, 0x64}, {0x0b, 0x02, 0x65, 0x66},
+    {0x0b, 0x02, 0x65, 0x67}, {0x0b, 0x02, 0x65, 0x68},
+    {0x0b, 0x02, 0x65, 0x6c}, {0x0b, 0x02, 0x65, 0x6d},
+    {0x0b, 0x02, 0x65, 0x6e}, {0x0b, 0x02, 0x65, 0x70},
+    {0x0b, 0x02, 0x65, 0x72}, {0x0b, 0x02, 0x65, 0x75},
+    {0x05, 0x01, 0x65, 0x00}, {0x05, 0x01, 0x65, 0x00},
+    {0x05, 0x01, 0x65, 0x00}, {0x05, 0x01, 0x65, 0x00},
+    {0x05, 0x01, 0x65, 0x00}, {0x05, 0x01, 0x65, 0x00},
+    {0x05, 0x01, 0x65, 0x00}, {0x05, 0x01, 0x65, 0x00},
+    {0x05, 0x01, 0x65, 0x00}, {0x05, 0x01, 0x65, 0x00},
+    {0x05, 0x01, 0x65, 0x00}, {0x05, 0x01, 0x65, 0x00},
+    {0x05, 0x01, 0x65, 0x00}, {0x05, 0x01, 0x65, 0x00},
+    {0x05, 0x01, 0x65, 0x00}, {0x05, 0x01, 0x65, 0x00},
+    {0x05, 0x01, 0x65, 0x00}, {0x05, 0x01, 0x65, 0x00},
+    /* 0x180 */
+    {0x0a, 0x02, 0x69, 0x30}, {0x0a, 0x02, 0x69, 0x30},
+    {0x0a, 0x02, 0x69, 0x31}, {0x0a, 0x02, 0x69, 0x31},
+    {0x0a, 0x02, 0x69, 0x32}, {0x0a, 0x02, 0x69, 0x32},
+    {0x0a, 0x02, 0x69, 0x61}, {0x0a, 0x02, 0x69, 0x61},
+    {0x0a, 0x02, 0x69, 0x63}, {0x0a, 0x02, 0x69, 0x63},
+    {0x0a, 0x02, 0x69, 0x65}, {0x0a, 0x02, 0x69, 0x65},
+    {0x0a, 0x02, 0x69, 0x69}, {0x0a, 0x02, 0x69, 0x69},
+    {0x0a, 0x02, 0x69, 0x6f}, {0x0a, 0x02, 0x69, 0x6f},
+    {0x0a, 0x02, 0x69, 0x73}, {0x0a, 0x02, 0x69, 0x73},
+    {0x0a, 0x02, 0x69, 0x74}, {0x0a, 0x02, 0x69, 0x74},
+    {0x0b, 0x02, 0x69, 0x20}, {0x0b, 0x02, 0x69, 0x25},
+    {0x0b, 0x02, 0x69, 0x2d}, {0x0b, 0x02, 0x69, 0x2e},
+    {0x0b, 0x02, 0x69, 0x2f}, {0x0b, 0x02, 0x69, 0x33},
+    {0x0b, 0x02, 0x69, 0x34}, {0x0b, 0x02, 0x69, 0x35},
+    {0x0b, 0x02, 0x69, 0x36}, {0x0b, 0x02, 0x69, 0x37},
+    {0x0b, 0x02, 0x69, 0x38}, {0x0b, 0x02, 0x69, 0x39},
+    {0x0b, 0x02, 0x69, 0x3d}, {0x0b, 0x02, 0x69, 0x41},
+    {0x0b, 0x02, 0x69, 0x5f}, {0x0b, 0x02, 0x69, 0x62},
+    {0x0b, 0x02, 0x69, 0x64}, {0x0b, 0x02, 0x69, 0x66},
+    {0x0b, 0x02, 0x69, 0x67}, {0x0b, 0x02, 0x69, 0x68},
+    {0x0b, 0x02, 0x69, 0x6c}, {0x0b, 0x02, 0x69, 0x6d},
+    {0x0b, 0x02, 0x69, 0x6e}, {0x0b, 0x02, 0x69, 0x70},
+    {0x0b, 0x02, 0x69, 0x72}, {0x0b, 0x02, 0x69, 0x75},
+    {0x05, 0x01, 0x69, 0x00}, {0x05, 0x01, 0x69, 0x00},
+    {0x05, 0x01, 0x69, 0x00}, {0x05, 0x01, 0x69, 0x00},
+    {0x05, 0x01, 0x69, 0x00}, {0x05, 0x01, 0x69, 0x00},
+    {0x05, 0x01, 0x69, 0x00}, {0x05, 0x01, 0x69, 0x00},
+    {0x05, 0x01, 0x69, 0x00}, {0x05, 0x01, 0x69, 0x00},
+    {0x05, 0x01, 0x69, 0x00}, {0x05, 0x01, 0x69, 0x00},
+    {0x05, 0x01, 0x69, 0x00}, {0x05, 0x01, 0x69, 0x00},
+    {0x05, 0x01, 0x69, 0x00}, {0x05, 0x01, 0x69, 0x00},
+    {0x05, 0x01, 0x69, 0x00}, {0x05, 0x01, 0x69, 0x00},
+    /* 0x1c0 */
+    {0x0a, 0x02, 0x6f, 0x30}, {0x0a, 0x02, 0x6f, 0x30},
+    {0x0a, 0x02, 0x6f, 0x31}, {0x0a, 0x02, 0x6f, 0x31},
+    {0x0a, 0x02, 0x6f, 0x32}, {0x0a, 0x02, 0x6f, 0x32},
+    {0x0a, 0x02, 0x6f, 0x61}, {0x0a, 0x02, 0x6f, 0x61},
+    {0x0a, 0x02, 0x6f, 0x63}, {0x0a, 0x02, 0x6f, 0x63},
+    {0x0a, 0x02, 0x6f, 0x65}, {0x0a, 0x02, 0x6f, 0x65},
+    {0x0a, 0x02, 0x6f, 0x69}, {0x0a, 0x02, 0x6f, 0x69},
+    {0x0a, 0x02, 0x6f, 0x6f}, {0x0a, 0x02, 0x6f, 0x6f},
+    {0x0a, 0x02, 0x6f, 0x73}, {0x0a, 0x02, 0x6f, 0x73},
+    {0x0a, 0x02, 0x6f, 0x74}, {0x0a, 0x02, 0x6f, 0x74},
+    {0x0b, 0x02, 0x6f, 0x20}, {0x0b, 0x02, 0x6f, 0x25},
+    {0x0b, 0x02, 0x6f, 0x2d}, {0x0b, 0x02, 0x6f, 0x2e},
+    {0x0b, 0x02, 0x6f, 0x2f}, {0x0b, 0x02, 0x6f, 0x33},
+    {0x0b, 0x02, 0x6f, 0x34}, {0x0b, 0x02, 0x6f, 0x35},
+    {0x0b, 0x02, 0x6f, 0x36}, {0x0b, 0x02, 0x6f, 0x37},
+    {0x0b, 0x02, 0x6f, 0x38}, {0x0b, 0x02, 0x6f, 0x39},
+    {0x0b, 0x02, 0x6f, 0x3d}, {0x0b, 0x02, 0x6f, 0x41},
+    {0x0b, 0x02, 0x6f, 0x5f}, {0x0b, 0x02, 0x6f, 0x62},
+    {0x0b, 0x02, 0x6f, 0x64}, {0x0b, 0x02, 0x6f, 0x66},
+    {0x0b, 0x02, 0x6f, 0x67}, {0x0b, 0x02, 0x6f, 0x68},
+    {0x0b, 0x02, 0x6f, 0x6c}, {0x0b, 0x02, 0x6f, 0x6d},
+    {0x0b, 0x02, 0x6f, 0x6e}, {0x0b, 0x02, 0x6f, 0x70},
+    {0x0b, 0x02, 0x6f, 0x72}, {0x0b, 0x02, 0x6f, 0x75},
+    {0x05, 0x01, 0x6f, 0x00}, {0x05, 0x01, 0x6f, 0x00},
+    {0x05, 0x01, 0x6f, 0x00}, {0x05, 0x01, 0x6f, 0x00},
+    {0x05, 0x01, 0x6f, 0x00}, {0x05, 0x01, 0x6f, 0x00},
+    {0x05, 0x01, 0x6f, 0x00}, {0x05, 0x01, 0x6f, 0x00},
+    {0x05, 0x01, 0x6f, 0x00}, {0x05, 0x01, 0x6f, 0x00},
+    {0x05, 0x01, 0x6f, 0x00}, {0x05, 0x01, 0x6f, 0x00},
+    {0x05, 0x01, 0x6f, 0x00}, {0x05, 0x01, 0x6f, 0x00},
+    {0x05, 0x01, 0x6f, 0x00}, {0x05, 0x01, 0x6f, 0x00},
+    {0x05, 0x01, 0x6f, 0x00}, {0x05, 0x01, 0x6f, 0x00},
+    /* 0x200 */
+    {0x0a, 0x02, 0x73, 0x30}, {0x0a, 0x02, 0x73, 0x30},
+    {0x0a, 0x02, 0x73, 0x31}, {0x0a, 0x02, 0x73, 0x31},
+    {0x0a, 0x02, 0x73, 0x32}, {0x0a, 0x02, 0x73, 0x32},
+    {0x0a, 0x02, 0x73, 0x61}, {0x0a, 0x02, 0x73, 0x61},
+    {0x0a, 0x02, 0x73, 0x63}, {0x0a, 0x02, 0x73, 0x63},
+    {0x0a, 0x02, 0x73, 0x65}, {0x0a, 0x02, 0x73, 0x65},
+    {0x0a, 0x02, 0x73, 0x69}, {0x0a, 0x02, 0x73, 0x69},
+    {0x0a, 0x02, 0x73, 0x6f}, {0x0a, 0x02, 0x73, 0x6f},
+    {0x0a, 0x02, 0x73, 0x73}, {0x0a, 0x02, 0x73, 0x73},
+    {0x0a, 0x02, 0x73, 0x74}, {0x0a, 0x02, 0x73, 0x74},
+    {0x0b, 0x02, 0x73, 0x20}, {0x0b, 0x02, 0x73, 0x25},
+    {0x0b, 0x02, 0x73, 0x2d}, {0x0b, 0x02, 0x73, 0x2e},
+    {0x0b, 0x02, 0x73, 0x2f}, {0x0b, 0x02, 0x73, 0x33},
+    {0x0b, 0x02, 0x73, 0x34}, {0x0b, 0x02, 0x73, 0x35},
+    {0x0b, 0x02, 0x73, 0x36}, {0x0b, 0x02, 0x73, 0x37},
+    {0x0b, 0x02, 0x73, 0x38}, {0x0b, 0x02, 0x73, 0x39},
+    {0x0b, 0x02, 0x73, 0x3d}, {0x0b, 0x02, 0x73, 0x41},
+    {0x0b, 0x02, 0x73, 0x5f}, {0x0b, 0x02, 0x73, 0x62},
+    {0x0b, 0x02, 0x73, 0x64}, {0x0b, 0x02, 0x73, 0x66},
+    {0x0b, 0x02, 0x73, 0x67}, {0x0b, 0x02, 0x73, 0x68},
+    {0x0b, 0x02, 0x73, 0x6c}, {0x0b, 0x02, 0x73, 0x6d},
+    {0x0b, 0x02, 0x73, 0x6e}, {0x0b, 0x02, 0x73, 0x70},
+    {0x0b, 0x02, 0x73, 0x72}, {0x0b, 0x02, 0x73, 0x75},
+    {0x05, 0x01, 0x73, 0x00}, {0x05, 0x01, 0x73, 0x00},
+    {0x05, 0x01, 0x73, 0x00}, {0x05, 0x01, 0x73, 0x00},
+    {0x05, 0x01, 0x73, 0x00}, {0x05, 0x01, 0x73, 0x00},
+    {0x05, 0x01, 0x73, 0x00}, {0x05, 0x01, 0x73, 0x00},
+    {0x05, 0x01, 0x73, 0x00}, {0x05, 0x01, 0x73, 0x00},
+    {0x05, 0x01, 0x73, 0x00}, {0x05, 0x01, 0x73, 0x00},
+    {0x05, 0x01, 0x73, 0x00}, {0x05, 0x01, 0x73, 0x00},
+    {0x05, 0x01, 0x73, 0x00}, {0x05, 0x01, 0x73, 0x00},
+    {0x05, 0x01, 0x73, 0x00}, {0x05, 0x01, 0x73, 0x00},
+    /* 0x240 */
+    {0x0a, 0x02, 0x74, 0x30}, {0x0a, 0x02, 0x74, 0x30},
+    {0x0a, 0x02, 0x74, 0x31}, {0x0a, 0x02, 0x74, 0x31},
+    {0x0a, 0x02, 0x74, 0x32}, {0x0a, 0x02, 0x74, 0x32},
+    {0x0a, 0x02, 0x74, 0x61}, {0x0a, 0x02, 0x74, 0x61},
+    {0x0a, 0x02, 0x74, 0x63}, {0x0a, 0x02, 0x74, 0x63},
+    {0x0a, 0x02, 0x74, 0x65}, {0x0a, 0x02, 0x74, 0x65},
+    {0x0a, 0x02, 0x74, 0x69}, {0x0a, 0x02, 0x74, 0x69},
+    {0x0a, 0x02, 0x74, 0x6f}, {0x0a, 0x02, 0x74, 0x6f},
+    {0x0a, 0x02, 0x74, 0x73}, {0x0a, 0x02, 0x74, 0x73},
+    {0x0a, 0x02, 0x74, 0x74}, {0x0a, 0x02, 0x74, 0x74},
+    {0x0b, 0x02, 0x74, 0x20}, {0x0b, 0x02, 0x74, 0x25},
+    {0x0b, 0x02, 0x74, 0x2d}, {0x0b, 0x02, 0x74, 0x2e},
+    {0x0b, 0x02, 0x74, 0x2f}, {0x0b, 0x02, 0x74, 0x33},
+    {0x0b, 0x02, 0x74, 0x34}, {0x0b, 0x02, 0x74, 0x35},
+    {0x0b, 0x02, 0x74, 0x36}, {0x0b, 0x02, 0x74, 0x37},
+    {0x0b, 0x02, 0x74, 0x38}, {0x0b, 0x02, 0x74, 0x39},
+    {0x0b, 0x02, 0x74, 0x3d}, {0x0b, 0x02, 0x74, 0x41},
+    {0x0b, 0x02, 0x74, 0x5f}, {0x0b, 0x02, 0x74, 0x62},
+    {0x0b, 0x02, 0x74, 0x64}, {0x0b, 0x02, 0x74, 0x66},
+    {0x0b, 0x02, 0x74, 0x67}, {0x0b, 0x02, 0x74, 0x68},
+    {0x0b, 0x02, 0x74, 0x6c}, {0x0b, 0x02, 0x74, 0x6d},
+    {0x0b, 0x02, 0x74, 0x6e}, {0x0b, 0x02, 0x74, 0x70},
+    {0x0b, 0x02, 0x74, 0x72}, {0x0b, 0x02, 0x74, 0x75},
+    {0x05, 0x01, 0x74, 0x00}, {0x05, 0x01, 0x74, 0x00},
+    {0x05, 0x01, 0x74, 0x00}, {0x05, 0x01, 0x74, 0x00},
+    {0x05, 0x01, 0x74, 0x00}, {0x05, 0x01, 0x74, 0x00},
+    {0x05, 0x01, 0x74, 0x00}, {0x05, 0x01, 0x74, 0x00},
+    {0x05, 0x01, 0x74, 0x00}, {0x05, 0x01, 0x74, 0x00},
+    {0x05, 0x01, 0x74, 0x00}, {0x05, 0x01, 0x74, 0x00},
+    {0x05, 0x01, 0x74, 0x00}, {0x05, 0x01, 0x74, 0x00},
+    {0x05, 0x01, 0x74, 0x00}, {0x05, 0x01, 0x74, 0x00},
+    {0x05, 0x01, 0x74, 0x00}, {0x05, 0x01, 0x74, 0x00},
+    /* 0x280 */
+    {0x0b, 0x02, 0x20, 0x30}, {0x0b, 0x02, 0x20, 0x31},
+    {0x0b, 0x02, 0x20, 0x32}, {0x0b, 0x02, 0x20, 0x61},
+    {0x0b, 0x02, 0x20, 0x63}, {0x0b, 0x02, 0x20, 0x65},
+    {0x0b, 0x02, 0x20, 0x69}, {0x0b, 0x02, 0x20, 0x6f},
+    {0x0b, 0x02, 0x20, 0x73}, {0x0b, 0x02, 0x20, 0x74},
+    {0x06, 0x01, 0x20, 0x00}, {0x06, 0x01, 0x20, 0x00},
+    {0x06, 0x01, 0x20, 0x00}, {0x06, 0x01, 0x20, 0x00},
+    {0x06, 0x01, 0x20, 0x00}, {0x06, 0x01, 0x20, 0x00},
+    {0x06, 0x01, 0x20, 0x00}, {0x06, 0x01, 0x20, 0x00},
+    {0x06, 0x01, 0x20, 0x00}, {0x06, 0x01, 0x20, 0x00},
+    {0x06, 0x01, 0x20, 0x00}, {0x06, 0x01, 0x20, 0x00},
+    {0x06, 0x01, 0x20, 0x00}, {0x06, 0x01, 0x20, 0x00},
+    {0x06, 0x01, 0x20, 0x00}, {0x06, 0x01, 0x20, 0x00},
+    {0x06, 0x01, 0x20, 0x00}, {0x06, 0x01, 0x20, 0x00},
+    {0x06, 0x01, 0x20, 0x00}, {0x06, 0x01, 0x20, 0x00},
+    {0x06, 0x01, 0x20, 0x00}, {0x06, 0x01, 0x20, 0x00},
+    {0x0b, 0x02, 0x25, 0x30}, {0x0b, 0x02, 0x25, 0x31},
+    {0x0b, 0x02, 0x25, 0x32}, {0x0b, 0x02, 0x25, 0x61},
+    {0x0b, 0x02, 0x25, 0x63}, {0x0b, 0x02, 0x25, 0x65},
+    {0x0b, 0x02, 0x25, 0x69}, {0x0b, 0x02, 0x25, 0x6f},
+    {0x0b, 0x02, 0x25, 0x73}, {0x0b, 0x02, 0x25, 0x74},
+    {0x06, 0x01, 0x25, 0x00}, {0x06, 0x01, 0x25, 0x00},
+    {0x06, 0x01, 0x25, 0x00}, {0x06, 0x01, 0x25, 0x00},
+    {0x06, 0x01, 0x25, 0x00}, {0x06, 0x01, 0x25, 0x00},
+    {0x06, 0x01, 0x25, 0x00}, {0x06, 0x01, 0x25, 0x00},
+    {0x06, 0x01, 0x25, 0x00}, {0x06, 0x01, 0x25, 0x00},
+    {0x06, 0x01, 0x25, 0x00}, {0x06, 0x01, 0x25, 0x00},
+    {0x06, 0x01, 0x25, 0x00}, {0x06, 0x01, 0x25, 0x00},
+    {0x06, 0x01, 0x25, 0x00}, {0x06, 0x01, 0x25, 0x00},
+    {0x06, 0x01, 0x25, 0x00}, {0x06, 0x01, 0x25, 0x00},
+    {0x06, 0x01, 0x25, 0x00}, {0x06, 0x01, 0x25, 0x00},
+    {0x06, 0x01, 0x25, 0x00}, {0x06, 0x01, 0x25, 0x00},
+    /* 0x2c0 */
+    {0x0b, 0x02, 0x2d, 0x30}, {0x0b, 0x02, 0x2d, 0x31},
+    {0x0b, 0x02, 0x2d, 0x32}, {0x0b, 0x02, 0x2d, 0x61},
+    {0x0b, 0x02, 0x2d, 0x63}, {0x0b, 0x02, 0x2d, 0x65},
+    {0x0b, 0x02, 0x2d, 0x69}, {0x0b, 0x02, 0x2d, 0x6f},
+    {0x0b, 0x02, 0x2d, 0x73}, {0x0b, 0x02, 0x2d, 0x74},
+    {0x06, 0x01, 0x2d, 0x00}, {0x06, 0x01, 0x2d, 0x00},
+    {0x06, 0x01, 0x2d, 0x00}, {0x06, 0x01, 0x2d, 0x00},
+    {0x06, 0x01, 0x2d, 0x00}, {0x06, 0x01, 0x2d, 0x00},
+    {0x06, 0x01, 0x2d, 0x00}, {0x06, 0x01, 0x2d, 0x00},
+    {0x06, 0x01, 0x2d, 0x00}, {0x06, 0x01, 0x2d, 0x00},
+    {0x06, 0x01, 0x2d, 0x00}, {0x06, 0x01, 0x2d, 0x00},
+    {0x06, 0x01, 0x2d, 0x00}, {0x06, 0x01, 0x2d, 0x00},
+    {0x06, 0x01, 0x2d, 0x00}, {0x06, 0x01, 0x2d, 0x00},
+    {0x06, 0x01, 0x2d, 0x00}, {0x06, 0x01, 0x2d, 0x00},
+    {0x06, 0x01, 0x2d, 0x00}, {0x06, 0x01, 0x2d, 0x00},
+    {0x06, 0x01, 0x2d, 0x00}, {0x06, 0x01, 0x2d, 0x00},
+    {0x0b, 0x02, 0x2e, 0x30}, {0x0b, 0x02, 0x2e, 0x31},
+    {0x0b, 0x02, 0x2e, 0x32}, {0x0b, 0x02, 0x2e, 0x61},
+    {0x0b, 0x02, 0x2e, 0x63}, {0x0b, 0x02, 0x2e, 0x65},
+    {0x0b, 0x02, 0x2e, 0x69}, {0x0b, 0x02, 0x2e, 0x6f},
+    {0x0b, 0x02, 0x2e, 0x73}, {0x0b, 0x02, 0x2e, 0x74},
+    {0x06, 0x01, 0x2e, 0x00}, {0x06, 0x01, 0x2e, 0x00},
+    {0x06, 0x01, 0x2e, 0x00}, {0x06, 0x01, 0x2e, 0x00},
+    {0x06, 0x01, 0x2e, 0x00}, {0x06, 0x01, 0x2e, 0x00},
+    {0x06, 0x01, 0x2e, 0x00}, {0x06, 0x01, 0x2e, 0x00},
+    {0x06, 0x01, 0x2e, 0x00}, {0x06, 0x01, 0x2e, 0x00},
+    {0x06, 0x01, 0x2e, 0x00}, {0x06, 0x01, 0x2e, 0x00},
+    {0x06, 0x01, 0x2e, 0x00}, {0x06, 0x01, 0x2e, 0x00},
+    {0x06, 0x01, 0x2e, 0x00}, {0x06, 0x01, 0x2e, 0x00},
+    {0x06, 0x01, 0x2e, 0x00}, {0x06, 0x01, 0x2e, 0x00},
+    {0x06, 0x01, 0x2e, 0x00}, {0x06, 0x01, 0x2e, 0x00},
+    {0x06, 0x01, 0x2e, 0x00}, {0x06, 0x01, 0x2e, 0x00},
+    /* 0x300 */
+    {0x0b, 0x02, 0x2f, 0x30}, {0x0b, 0x02, 0x2f, 0x31},
+    {0x0b, 0x02, 0x2f, 0x32}, {0x0b, 0x02, 0x2f, 0x61},
+    {0x0b, 0x02, 0x2f, 0x63}, {0x0b, 0x02, 0x2f, 0x65},
+    {0x0b, 0x02, 0x2f, 0x69}, {0x0b, 0x02, 0x2f, 0x6f},
+    {0x0b, 0x02, 0x2f, 0x73}, {0x0b, 0x02, 0x2f, 0x74},
+    {0x06, 0x01, 0x2f, 0x00}, {0x06, 0x01, 0x2f, 0x00},
+    {0x06, 0x01, 0x2f, 0x00}, {0x06, 0x01, 0x2f, 0x00},
+    {0x06, 0x01, 0x2f, 0x00}, {0x06, 0x01, 0x2f, 0x00},
+    {0x06, 0x01, 0x2f, 0x00}, {0x06, 0x01, 0x2f, 0x00},
+    {0x06, 0x01, 0x2f, 0x00}, {0x06, 0x01, 0x2f, 0x00},
+    {0x06, 0x01, 0x2f, 0x00}, {0x06, 0x01, 0x2f, 0x00},
+    {0x06, 0x01, 0x2f, 0x00}, {0x06, 0x01, 0x2f, 0x00},
+    {0x06, 0x01, 0x2f, 0x00}, {0x06, 0x01, 0x2f, 0x00},
+    {0x06, 0x01, 0x2f, 0x00}, {0x06, 0x01, 0x2f, 0x00},
+    {0x06, 0x01, 0x2f, 0x00}, {0x06, 0x01, 0x2f, 0x00},
+    {0x06, 0x01, 0x2f, 0x00}, {0x06, 0x01, 0x2f, 0x00},
+    {0x0b, 0x02, 0x33, 0x30}, {0x0b, 0x02, 0x33, 0x31},
+    {0x0b, 0x02, 0x33, 0x32}, {0x0b, 0x02, 0x33, 0x61},
+    {0x0b, 0x02, 0x33, 0x63}, {0x0b, 0x02, 0x33, 0x65},
+    {0x0b, 0x02, 0x33, 0x69}, {0x0b, 0x02, 0x33, 0x6f},
+    {0x0b, 0x02, 0x33, 0x73}, {0x0b, 0x02, 0x33, 0x74},
+    {0x06, 0x01, 0x33, 0x00}, {0x06, 0x01, 0x33, 0x00},
+    {0x06, 0x01, 0x33, 0x00}, {0x06, 0x01, 0x33, 0x00},
+    {0x06, 0x01, 0x33, 0x00}, {0x06, 0x01, 0x33, 0x00},
+    {0x06, 0x01, 0x33, 0x00}, {0x06, 0x01, 0x33, 0x00},
+    {0x06, 0x01, 0x33, 0x00}, {0x06, 0x01, 0x33, 0x00},
+    {0x06, 0x01, 0x33, 0x00}, {0x06, 0x01, 0x33, 0x00},
+    {0x06, 0x01, 0x33, 0x00}, {0x06, 0x01, 0x33, 0x00},
+    {0x06, 0x01, 0x33, 0x00}, {0x06, 0x01, 0x33, 0x00},
+    {0x06, 0x01, 0x33, 0x00}, {0x06, 0x01, 0x33, 0x00},
+    {0x06, 0x01, 0x33, 0x00}, {0x06, 0x01, 0x33, 0x00},
+    {0x06, 0x01, 0x33, 0x00}, {0x06, 0x01, 0x33, 0x00},
+    /* 0x340 */
+    {0x0b, 0x02, 0x34, 0x30}, {0x0b, 0x02, 0x34, 0x31},
+    {0x0b, 0x02, 0x34, 0x32}, {0x0b, 0x02, 0x34, 0x61},
+    {0x0b, 0x02, 0x34, 0x63}, {0x0b, 0x02, 0x34, 0x65},
+    {0x0b, 0x02, 0x34, 0x69}, {0x0b, 0x02, 0x34, 0x6f},
+    {0x0b, 0x02, 0x34, 0x73}, {0x0b, 0x02, 0x34, 0x74},
+    {0x06, 0x01, 0x34, 0x00}, {0x06, 0x01, 0x34, 0x00},
+    {0x06, 0x01, 0x34, 0x00}, {0x06, 0x01, 0x34, 0x00},
+    {0x06, 0x01, 0x34, 0x00}, {0x06, 0x01, 0x34, 0x00},
+    {0x06, 0x01, 0x34, 0x00}, {0x06, 0x01, 0x34, 0x00},
+    {0x06, 0x01, 0x34, 0x00}, {0x06, 0x01, 0x34, 0x00},
+    {0x06, 0x01, 0x34, 0x00}, {0x06, 0x01, 0x34, 0x00},
+    {0x06, 0x01, 0x34, 0x00}, {0x06, 0x01, 0x34, 0x00},
+    {0x06, 0x01, 0x34, 0x00}, {0x06, 0x01, 0x34, 0x00},
+    {0x06, 0x01, 0x34, 0x00}, {0x06, 0x01, 0x34, 0x00},
+    {0x06, 0x01, 0x34, 0x00}, {0x06, 0x01, 0x34, 0x00},
+    {0x06, 0x01, 0x34, 0x00}, {0x06, 0x01, 0x34, 0x00},
+    {0x0b, 0x02, 0x35, 0x30}, {0x0b, 0x02, 0x35, 0x31},
+    {0x0b, 0x02, 0x35, 0x32}, {0x0b, 0x02, 0x35, 0x61},
+    {0x0b, 0x02, 0x35, 0x63}, {0x0b, 0x02, 0x35, 0x65},
+    {0x0b, 0x02, 0x35, 0x69}, {0x0b, 0x02, 0x35, 0x6f},
+    {0x0b, 0x02, 0x35, 0x73}, {0x0b, 0x02, 0x35, 0x74},
+    {0x06, 0x01, 0x35, 0x00}, {0x06, 0x01, 0x35, 0x00},
+    {0x06, 0x01, 0x35, 0x00}, {0x06, 0x01, 0x35, 0x00},
+    {0x06, 0x01, 0x35, 0x00}, {0x06, 0x01, 0x35, 0x00},
+    {0x06, 0x01, 0x35, 0x00}, {0x06, 0x01, 0x35, 0x00},
+    {0x06, 0x01, 0x35, 0x00}, {0x06, 0x01, 0x35, 0x00},
+    {0x06, 0x01, 0x35, 0x00}, {0x06, 0x01, 0x35, 0x00},
+    {0x06, 0x01, 0x35, 0x00}, {0x06, 0x01, 0x35, 0x00},
+    {0x06, 0x01, 0x35, 0x00}, {0x06, 0x01, 0x35, 0x00},
+    {0x06, 0x01, 0x35, 0x00}, {0x06, 0x01, 0x35, 0x00},
+    {0x06, 0x01, 0x35, 0x00}, {0x06, 0x01, 0x35, 0x00},
+    {0x06, 0x01, 0x35, 0x00}, {0x06, 0x01, 0x35, 0x00},
+    /* 0x380 */
+    {0x0b, 0x02, 0x36, 0x30}, {0x0b, 0x02, 0x36, 0x31},
+    {0x0b, 0x02, 0x36, 0x32}, {0x0b, 0x02, 0x36, 0x61},
+    {0x0b, 0x02, 0x36, 0x63}, {0x0b, 0x02, 0x36, 0x65},
+    {0x0b, 0x02, 0x36, 0x69}, {0x0b, 0x02, 0x36, 0x6f},
+    {0x0b, 0x02, 0x36, 0x73}, {0x0b, 0x02, 0x36, 0x74},
+    {0x06, 0x01, 0x36, 0x00}, {0x06, 0x01, 0x36, 0x00},
+    {0x06, 0x01, 0x36, 0x00}, {0x06, 0x01, 0x36, 0x00},
+    {0x06, 0x01, 0x36, 0x00}, {0x06, 0x01, 0x36, 0x00},
+    {0x06, 0x01, 0x36, 0x00}, {0x06, 0x01, 0x36, 0x00},
+    {0x06, 0x01, 0x36, 0x00}, {0x06, 0x01, 0x36, 0x00},
+    {0x06, 0x01, 0x36, 0x00}, {0x06, 0x01, 0x36, 0x00},
+    {0x06, 0x01, 0x36, 0x00}, {0x06, 0x01, 0x36, 0x00},
+    {0x06, 0x01, 0x36, 0x00}, {0x06, 0x01, 0x36, 0x00},
+    {0x06, 0x01, 0x36, 0x00}, {0x06, 0x01, 0x36, 0x00},
+    {0x06, 0x01, 0x36, 0x00}, {0x06, 0x01, 0x36, 0x00},
+    {0x06, 0x01, 0x36, 0x00}, {0x06, 0x01, 0x36, 0x00},
+    {0x0b, 0x02, 0x37, 0x30}, {0x0b, 0x02, 0x37, 0x31},
+    {0x0b, 0x02, 0x37, 0x32}, {0x0b, 0x02, 0x37, 0x61},
+    {0x0b, 0x02, 0x37, 0x63}, {0x0b, 0x02, 0x37, 0x65},
+    {0x0b, 0x02, 0x37, 0x69}, {0x0b, 0x02, 0x37, 0x6f},
+    {0x0b, 0x02, 0x37, 0x73}, {0x0b, 0x02, 0x37, 0x74},
+    {0x06, 0x01, 0x37, 0x00}, {0x06, 0x01, 0x37, 0x00},
+    {0x06, 0x01, 0x37, 0x00}, {0x06, 0x01, 0x37, 0x00},
+    {0x06, 0x01, 0x37, 0x00}, {0x06, 0x01, 0x37, 0x00},
+    {0x06, 0x01, 0x37, 0x00}, {0x06, 0x01, 0x37, 0x00},
+    {0x06, 0x01, 0x37, 0x00}, {0x06, 0x01, 0x37, 0x00},
+    {0x06, 0x01, 0x37, 0x00}, {0x06, 0x01, 0x37, 0x00},
+    {0x06, 0x01, 0x37, 0x00}, {0x06, 0x01, 0x37, 0x00},
+    {0x06, 0x01, 0x37, 0x00}, {0x06, 0x01, 0x37, 0x00},
+    {0x06, 0x01, 0x37, 0x00}, {0x06, 0x01, 0x37, 0x00},
+    {0x06, 0x01, 0x37, 0x00}, {0x06, 0x01, 0x37, 0x00},
+    {0x06, 0x01, 0x37, 0x00}, {0x06, 0x01, 0x37, 0x00},
+    /* 0x3c0 */
+    {0x0b, 0x02, 0x38, 0x30}, {0x0b, 0x02, 0x38, 0x31},
+    {0x0b, 0x02, 0x38, 0x32}, {0x0b, 0x02, 0x38, 0x61},
+    {0x0b, 0x02, 0x38, 0x63}, {0x0b, 0x02, 0x38, 0x65},
+    {0x0b, 0x02, 0x38, 0x69}, {0x0b, 0x02, 0x38, 0x6f},
+    {0x0b, 0x02, 0x38, 0x73}, {0x0b, 0x02, 0x38, 0x74},
+    {0x06, 0x01, 0x38, 0x00}, {0x06, 0x01, 0x38, 0x00},
+    {0x06, 0x01, 0x38, 0x00}, {0x06, 0x01, 0x38, 0x00},
+    {0x06, 0x01, 0x38, 0x00}, {0x06, 0x01, 0x38, 0x00},
+    {0x06, 0x01, 0x38, 0x00}, {0x06, 0x01, 0x38, 0x00},
+    {0x06, 0x01, 0x38, 0x00}, {0x06, 0x01, 0x38, 0x00},
+    {0x06, 0x01, 0x38, 0x00}, {0x06, 0x01, 0x38, 0x00},
+    {0x06, 0x01, 0x38, 0x00}, {0x06, 0x01, 0x38, 0x00},
+    {0x06, 0x01, 0x38, 0x00}, {0x06, 0x01, 0x38, 0x00},
+    {0x06, 0x01, 0x38, 0x00}, {0x06, 0x01, 0x38, 0x00},
+    {0x06, 0x01, 0x38, 0x00}, {0x06, 0x01, 0x38, 0x00},
+    {0x06, 0x01, 0x38, 0x00}, {0x06, 0x01, 0x38, 0x00},
+    {0x0b, 0x02, 0x39, 0x30}, {0x0b, 0x02, 0x39, 0x31},
+    {0x0b, 0x02, 0x39, 0x32}, {0x0b, 0x02, 0x39, 0x61},
+    {0x0b, 0x02, 0x39, 0x63}, {0x0b, 0x02, 0x39, 0x65},
+    {0x0b, 0x02, 0x39, 0x69}, {0x0b, 0x02, 0x39, 0x6f},
+    {0x0b, 0x02, 0x39, 0x73}, {0x0b, 0x02, 0x39, 0x74},
+    {0x06, 0x01, 0x39, 0x00}, {0x06, 0x01, 0x39, 0x00},
+    {0x06, 0x01, 0x39, 0x00}, {0x06, 0x01, 0x39, 0x00},
+    {0x06, 0x01, 0x39, 0x00}, {0x06, 0x01, 0x39, 0x00},
+    {0x06, 0x01, 0x39, 0x00}, {0x06, 0x01, 0x39, 0x00},
+    {0x06, 0x01, 0x39, 0x00}, {0x06, 0x01, 0x39, 0x00},
+    {0x06, 0x01, 0x39, 0x00}, {0x06, 0x01, 0x39, 0x00},
+    {0x06, 0x01, 0x39, 0x00}, {0x06, 0x01, 0x39, 0x00},
+    {0x06, 0x01, 0x39, 0x00}, {0x06, 0x01, 0x39, 0x00},
+    {0x06, 0x01, 0x39, 0x00}, {0x06, 0x01, 0x39, 0x00},
+    {0x06, 0x01, 0x39, 0x00}, {0x06, 0x01, 0x39, 0x00},
+    {0x06, 0x01, 0x39, 0x00}, {0x06, 0x01, 0x39, 0x00},
+    /* 0x400 */
+    {0x0b, 0x02, 0x3d, 0x30}, {0x0b, 0x02, 0x3d, 0x31},
+    {0x0b, 0x02, 0x3d, 0x32}, {0x0b, 0x02, 0x3d, 0x61},
+    {0x0b, 0x02, 0x3d, 0x63}, {0x0b, 0x02, 0x3d, 0x65},
+    {0x0b, 0x02, 0x3d, 0x69}, {0x0b, 0x02, 0x3d, 0x6f},
+    {0x0b, 0x02, 0x3d, 0x73}, {0x0b, 0x02, 0x3d, 0x74},
+    {0x06, 0x01, 0x3d, 0x00}, {0x06, 0x01, 0x3d, 0x00},
+    {0x06, 0x01, 0x3d, 0x00}, {0x06, 0x01, 0x3d, 0x00},
+    {0x06, 0x01, 0x3d, 0x00}, {0x06, 0x01, 0x3d, 0x00},
+    {0x06, 0x01, 0x3d, 0x00}, {0x06, 0x01, 0x3d, 0x00},
+    {0x06, 0x01, 0x3d, 0x00}, {0x06, 0x01, 0x3d, 0x00},
+    {0x06, 0x01, 0x3d, 0x00}, {0x06, 0x01, 0x3d, 0x00},
+    {0x06, 0x01, 0x3d, 0x00}, {0x06, 0x01, 0x3d, 0x00},
+    {0x06, 0x01, 0x3d, 0x00}, {0x06, 0x01, 0x3d, 0x00},
+    {0x06, 0x01, 0x3d, 0x00}, {0x06, 0x01, 0x3d, 0x00},
+    {0x06, 0x01, 0x3d, 0x00}, {0x06, 0x01, 0x3d, 0x00},
+    {0x06, 0x01, 0x3d, 0x00}, {0x06, 0x01, 0x3d, 0x00},
+    {0x0b, 0x02, 0x41, 0x30}, {0x0b, 0x02, 0x41, 0x31},
+    {0x0b, 0x02, 0x41, 0x32}, {0x0b, 0x02, 0x41, 0x61},
+    {0x0b, 0x02, 0x41, 0x63}, {0x0b, 0x02, 0x41, 0x65},
+    {0x0b, 0x02, 0x41, 0x69}, {0x0b, 0x02, 0x41, 0x6f},
+    {0x0b, 0x02, 0x41, 0x73}, {0x0b, 0x02, 0x41, 0x74},
+    {0x06, 0x01, 0x41, 0x00}, {0x06, 0x01, 0x41, 0x00},
+    {0x06, 0x01, 0x41, 0x00}, {0x06, 0x01, 0x41, 0x00},
+    {0x06, 0x01, 0x41, 0x00}, {0x06, 0x01, 0x41, 0x00},
+    {0x06, 0x01, 0x41, 0x00}, {0x06, 0x01, 0x41, 0x00},
+    {0x06, 0x01, 0x41, 0x00}, {0x06, 0x01, 0x41, 0x00},
+    {0x06, 0x01, 0x41, 0x00}, {0x06, 0x01, 0x41, 0x00},
+    {0x06, 0x01, 0x41, 0x00}, {0x06, 0x01, 0x41, 0x00},
+    {0x06, 0x01, 0x41, 0x00}, {0x06, 0x01, 0x41, 0x00},
+    {0x06, 0x01, 0x41, 0x00}, {0x06, 0x01, 0x41, 0x00},
+    {0x06, 0x01, 0x41, 0x00}, {0x06, 0x01, 0x41, 0x00},
+    {0x06, 0x01, 0x41, 0x00}, {0x06, 0x01, 0x41, 0x00},
+    /* 0x440 */
+    {0x0b, 0x02, 0x5f, 0x30}, {0x0b, 0x02, 0x5f, 0x31},
+    {0x0b, 0x02, 0x5f, 0x32}, {0x0b, 0x02, 0x5f, 0x61},
+    {0x0b, 0x02, 0x5f, 0x63}, {0x0b, 0x02, 0x5f, 0x65},
+    {0x0b, 0x02, 0x5f, 0x69}, {0x0b, 0x02, 0x5f, 0x6f},
+    {0x0b, 0x02, 0x5f, 0x73}, {0x0b, 0x02, 0x5f, 0x74},
+    {0x06, 0x01, 0x5f, 0x00}, {0x06, 0x01, 0x5f, 0x00},
+    {0x06, 0x01, 0x5f, 0x00}, {0x06, 0x01, 0x5f, 0x00},
+    {0x06, 0x01, 0x5f, 0x00}, {0x06, 0x01, 0x5f, 0x00},
+    {0x06, 0x01, 0x5f, 0x00}, {0x06, 0x01, 0x5f, 0x00},
+    {0x06, 0x01, 0x5f, 0x00}, {0x06, 0x01, 0x5f, 0x00},
+    {0x06, 0x01, 0x5f, 0x00}, {0x06, 0x01, 0x5f, 0x00},
+    {0x06, 0x01, 0x5f, 0x00}, {0x06, 0x01, 0x5f, 0x00},
+    {0x06, 0x01, 0x5f, 0x00}, {0x06, 0x01, 0x5f, 0x00},
+    {0x06, 0x01, 0x5f, 0x00}, {0x06, 0x01, 0x5f, 0x00},
+    {0x06, 0x01, 0x5f, 0x00}, {0x06, 0x01, 0x5f, 0x00},
+    {0x06, 0x01, 0x5f, 0x00}, {0x06, 0x01, 0x5f, 0x00},
+    {0x0b, 0x02, 0x62, 0x30}, {0x0b, 0x02, 0x62, 0x31},
+    {0x0b, 0x02, 0x62, 0x32}, {0x0b, 0x02, 0x62, 0x61},
+    {0x0b, 0x02, 0x62, 0x63}, {0x0b, 0x02, 0x62, 0x65},
+    {0x0b, 0x02, 0x62, 0x69}, {0x0b, 0x02, 0x62, 0x6f},
+    {0x0b, 0x02, 0x62, 0x73}, {0x0b, 0x02, 0x62, 0x74},
+    {0x06, 0x01, 0x62, 0x00}, {0x06, 0x01, 0x62, 0x00},
+    {0x06, 0x01, 0x62, 0x00}, {0x06, 0x01, 0x62, 0x00},
+    {0x06, 0x01, 0x62, 0x00}, {0x06, 0x01, 0x62, 0x00},
+    {0x06, 0x01, 0x62, 0x00}, {0x06, 0x01, 0x62, 0x00},
+    {0x06, 0x01, 0x62, 0x00}, {0x06, 0x01, 0x62, 0x00},
+    {0x06, 0x01, 0x62, 0x00}, {0x06, 0x01, 0x62, 0x00},
+    {0x06, 0x01, 0x62, 0x00}, {0x06, 0x01, 0x62, 0x00},
+    {0x06, 0x01, 0x62, 0x00}, {0x06, 0x01, 0x62, 0x00},
+    {0x06, 0x01, 0x62, 0x00}, {0x06, 0x01, 0x62, 0x00},
+    {0x06, 0x01, 0x62, 0x00}, {0x06, 0x01, 0x62, 0x00},
+    {0x06, 0x01, 0x62, 0x00}, {0x06, 0x01, 0x62, 0x00},
+    /* 0x480 */
+    {0x0b, 0x02, 0x64, 0x30}, {0x0b, 0x02, 0x64, 0x31},
+    {0x0b, 0x02, 0x64, 0x32}, {0x0b, 0x02, 0x64, 0x61},
+    {0x0b, 0x02, 0x64, 0x63}, {0x0b, 0x02, 0x64, 0x65},
+    {0x0b, 0x02, 0x64, 0x69}, {0x0b, 0x02, 0x64, 0x6f},
+    {0x0b, 0x02, 0x64, 0x73}, {0x0b, 0x02, 0x64, 0x74},
+    {0x06, 0x01, 0x64, 0x00}, {0x06, 0x01, 0x64, 0x00},
+    {0x06, 0x01, 0x64, 0x00}, {0x06, 0x01, 0x64, 0x00},
+    {0x06, 0x01, 0x64, 0x00}, {0x06, 0x01, 0x64, 0x00},
+    {0x06, 0x01, 0x64, 0x00}, {0x06, 0x01, 0x64, 0x00},
+    {0x06, 0x01, 0x64, 0x00}, {0x06, 0x01, 0x64, 0x00},
+    {0x06, 0x01, 0x64, 0x00}, {0x06, 0x01, 0x64, 0x00},
+    {0x06, 0x01, 0x64, 0x00}, {0x06, 0x01, 0x64, 0x00},
+    {0x06, 0x01, 0x64, 0x00}, {0x06, 0x01, 0x64, 0x00},
+    {0x06, 0x01, 0x64, 0x00}, {0x06, 0x01, 0x64, 0x00},
+    {0x06, 0x01, 0x64, 0x00}, {0x06, 0x01, 0x64, 0x00},
+    {0x06, 0x01, 0x64, 0x00}, {0x06, 0x01, 0x64, 0x00},
+    {0x0b, 0x02, 0x66, 0x30}, {0x0b, 0x02, 0x66, 0x31},
+    {0x0b, 0x02, 0x66, 0x32}, {0x0b, 0x02, 0x66, 0x61},
+    {0x0b, 0x02, 0x66, 0x63}, {0x0b, 0x02, 0x66, 0x65},
+    {0x0b, 0x02, 0x66, 0x69}, {0x0b, 0x02, 0x66, 0x6f},
+    {0x0b, 0x02, 0x66, 0x73}, {0x0b, 0x02, 0x66, 0x74},
+    {0x06, 0x01, 0x66, 0x00}, {0x06, 0x01, 0x66, 0x00},
+    {0x06, 0x01, 0x66, 0x00}, {0x06, 0x01, 0x66, 0x00},
+    {0x06, 0x01, 0x66, 0x00}, {0x06, 0x01, 0x66, 0x00},
+    {0x06, 0x01, 0x66, 0x00}, {0x06, 0x01, 0x66, 0x00},
+    {0x06, 0x01, 0x66, 0x00}, {0x06, 0x01, 0x66, 0x00},
+    {0x06, 0x01, 0x66, 0x00}, {0x06, 0x01, 0x66, 0x00},
+    {0x06, 0x01, 0x66, 0x00}, {0x06, 0x01, 0x66, 0x00},
+    {0x06, 0x01, 0x66, 0x00}, {0x06, 0x01, 0x66, 0x00},
+    {0x06, 0x01, 0x66, 0x00}, {0x06, 0x01, 0x66, 0x00},
+    {0x06, 0x01, 0x66, 0x00}, {0x06, 0x01, 0x66, 0x00},
+    {0x06, 0x01, 0x66, 0x00}, {0x06, 0x01, 0x66, 0x00},
+    /* 0x4c0 */
+    {0x0b, 0x02, 0x67, 0x30}, {0x0b, 0x02, 0x67, 0x31},
+    {0x0b, 0x02, 0x67, 0x32}, {0x0b, 0x02, 0x67, 0x61},
+    {0x0b, 0x02, 0x67, 0x63}, {0x0b, 0x02, 0x67, 0x65},
+    {0x0b, 0x02, 0x67, 0x69}, {0x0b, 0x02, 0x67, 0x6f},
+    {0x0b, 0x02, 0x67, 0x73}, {0x0b, 0x02, 0x67, 0x74},
+    {0x06, 0x01, 0x67, 0x00}, {0x06, 0x01, 0x67, 0x00},
+    {0x06, 0x01, 0x67, 0x00}, {0x06, 0x01, 0x67, 0x00},
+    {0x06, 0x01, 0x67, 0x00}, {0x06, 0x01, 0x67, 0x00},
+    {0x06, 0x01, 0x67, 0x00}, {0x06, 0x01, 0x67, 0x00},
+    {0x06, 0x01, 0x67, 0x00}, {0x06, 0x01, 0x67, 0x00},
+    {0x06, 0x01, 0x67, 0x00}, {0x06, 0x01, 0x67, 0x00},
+    {0x06, 0x01, 0x67, 0x00}, {0x06, 0x01, 0x67, 0x00},
+    {0x06, 0x01, 0x67, 0x00}, {0x06, 0x01, 0x67, 0x00},
+    {0x06, 0x01, 0x67, 0x00}, {0x06, 0x01, 0x67, 0x00},
+    {0x06, 0x01, 0x67, 0x00}, {0x06, 0x01, 0x67, 0x00},
+    {0x06, 0x01, 0x67, 0x00}, {0x06, 0x01, 0x67, 0x00},
+    {0x0b, 0x02, 0x68, 0x30}, {0x0b, 0x02, 0x68, 0x31},
+    {0x0b, 0x02, 0x68, 0x32}, {0x0b, 0x02, 0x68, 0x61},
+    {0x0b, 0x02, 0x68, 0x63}, {0x0b, 0x02, 0x68, 0x65},
+    {0x0b, 0x02, 0x68, 0x69}, {0x0b, 0x02, 0x68, 0x6f},
+    {0x0b, 0x02, 0x68, 0x73}, {0x0b, 0x02, 0x68, 0x74},
+    {0x06, 0x01, 0x68, 0x00}, {0x06, 0x01, 0x68, 0x00},
+    {0x06, 0x01, 0x68, 0x00}, {0x06, 0x01, 0x68, 0x00},
+    {0x06, 0x01, 0x68, 0x00}, {0x06, 0x01, 0x68, 0x00},
+    {0x06, 0x01, 0x68, 0x00}, {0x06, 0x01, 0x68, 0x00},
+    {0x06, 0x01, 0x68, 0x00}, {0x06, 0x01, 0x68, 0x00},
+    {0x06, 0x01, 0x68, 0x00}, {0x06, 0x01, 0x68, 0x00},
+    {0x06, 0x01, 0x68, 0x00}, {0x06, 0x01, 0x68, 0x00},
+    {0x06, 0x01, 0x68, 0x00}, {0x06, 0x01, 0x68, 0x00},
+    {0x06, 0x01, 0x68, 0x00}, {0x06, 0x01, 0x68, 0x00},
+    {0x06, 0x01, 0x68, 0x00}, {0x06, 0x01, 0x68, 0x00},
+    {0x06, 0x01, 0x68, 0x00}, {0x06, 0x01, 0x68, 0x00},
+    /* 0x500 */
+    {0x0b, 0x02, 0x6c, 0x30}, {0x0b, 0x02, 0x6c, 0x31},
+    {0x0b, 0x02, 0x6c, 0x32}, {0x0b, 0x02, 0x6c, 0x61},
+    {0x0b, 0x02, 0x6c, 0x63}, {0x0b, 0x02, 0x6c, 0x65},
+    {0x0b, 0x02, 0x6c, 0x69}, {0x0b, 0x02, 0x6c, 0x6f},
+    {0x0b, 0x02, 0x6c, 0x73}, {0x0b, 0x02, 0x6c, 0x74},
+    {0x06, 0x01, 0x6c, 0x00}, {0x06, 0x01, 0x6c, 0x00},
+    {0x06, 0x01, 0x6c, 0x00}, {0x06, 0x01, 0x6c, 0x00},
+    {0x06, 0x01, 0x6c, 0x00}, {0x06, 0x01, 0x6c, 0x00},
+    {0x06, 0x01, 0x6c, 0x00}, {0x06, 0x01, 0x6c, 0x00},
+    {0x06, 0x01, 0x6c, 0x00}, {0x06, 0x01, 0x6c, 0x00},
+    {0x06, 0x01, 0x6c, 0x00}, {0x06, 0x01, 0x6c, 0x00},
+    {0x06, 0x01, 0x6c, 0x00}, {0x06, 0x01, 0x6c, 0x00},
+    {0x06, 0x01, 0x6c, 0x00}, {0x06, 0x01, 0x6c, 0x00},
+    {0x06, 0x01, 0x6c, 0x00}, {0x06, 0x01, 0x6c, 0x00},
+    {0x06, 0x01, 0x6c, 0x00}, {0x06, 0x01, 0x6c, 0x00},
+    {0x06, 0x01, 0x6c, 0x00}, {0x06, 0x01, 0x6c, 0x00},
+    {0x0b, 0x02, 0x6d, 0x30}, {0x0b, 0x02, 0x6d, 0x31},
+    {0x0b, 0x02, 0x6d, 0x32}, {0x0b, 0x02, 0x6d, 0x61},
+    {0x0b, 0x02, 0x6d, 0x63}, {0x0b, 0x02, 0x6d, 0x65},
+    {0x0b, 0x02, 0x6d, 0x69}, {0x0b, 0x02, 0x6d, 0x6f},
+    {0x0b, 0x02, 0x6d, 0x73}, {0x0b, 0x02, 0x6d, 0x74},
+    {0x06, 0x01, 0x6d, 0x00}, {0x06, 0x01, 0x6d, 0x00},
+    {0x06, 0x01, 0x6d, 0x00}, {0x06, 0x01, 0x6d, 0x00},
+    {0x06, 0x01, 0x6d, 0x00}, {0x06, 0x01, 0x6d, 0x00},
+    {0x06, 0x01, 0x6d, 0x00}, {0x06, 0x01, 0x6d, 0x00},
+    {0x06, 0x01, 0x6d, 0x00}, {0x06, 0x01, 0x6d, 0x00},
+    {0x06, 0x01, 0x6d, 0x00}, {0x06, 0x01, 0x6d, 0x00},
+    {0x06, 0x01, 0x6d, 0x00}, {0x06, 0x01, 0x6d, 0x00},
+    {0x06, 0x01, 0x6d, 0x00}, {0x06, 0x01, 0x6d, 0x00},
+    {0x06, 0x01, 0x6d, 0x00}, {0x06, 0x01, 0x6d, 0x00},
+    {0x06, 0x01, 0x6d, 0x00}, {0x06, 0x01, 0x6d, 0x00},
+    {0x06, 0x01, 0x6d, 0x00}, {0x06, 0x01, 0x6d, 0x00},
+    /* 0x540 */
+    {0x0b, 0x02, 0x6e, 0x30}, {0x0b, 0x02, 0x6e, 0x31},
+    {0x0b, 0x02, 0x6e, 0x32}, {0x0b, 0x02, 0x6e, 0x61},
+    {0x0b, 0x02, 0x6e, 0x63}, {0x0b, 0x02, 0x6e, 0x65},
+    {0x0b, 0x02, 0x6e, 0x69}, {0x0b, 0x02, 0x6e, 0x6f},
+    {0x0b, 0x02, 0x6e, 0x73}, {0x0b, 0x02, 0x6e, 0x74},
+    {0x06, 0x01, 0x6e, 0x00}, {0x06, 0x01, 0x6e, 0x00},
+    {0x06, 0x01, 0x6e, 0x00}, {0x06, 0x01, 0x6e, 0x00},
+    {0x06, 0x01, 0x6e, 0x00}, {0x06, 0x01, 0x6e, 0x00},
+    {0x06, 0x01, 0x6e, 0x00}, {0x06, 0x01, 0x6e, 0x00},
+    {0x06, 0x01, 0x6e, 0x00}, {0x06, 0x01, 0x6e, 0x00},
+    {0x06, 0x01, 0x6e, 0x00}, {0x06, 0x01, 0x6e, 0x00},
+    {0x06, 0x01, 0x6e, 0x00}, {0x06, 0x01, 0x6e, 0x00},
+    {0x06, 0x01, 0x6e, 0x00}, {0x06, 0x01, 0x6e, 0x00},
+    {0x06, 0x01, 0x6e, 0x00}, {0x06, 0x01, 0x6e, 0x00},
+    {0x06, 0x01, 0x6e, 0x00}, {0x06, 0x01, 0x6e, 0x00},
+    {0x06, 0x01, 0x6e, 0x00}, {0x06, 0x01, 0x6e, 0x00},
+    {0x0b, 0x02, 0x70, 0x30}, {0x0b, 0x02, 0x70, 0x31},
+    {0x0b, 0x02, 0x70, 0x32}, {0x0b, 0x02, 0x70, 0x61},
+    {0x0b, 0x02, 0x70, 0x63}, {0x0b, 0x02, 0x70, 0x65},
+    {0x0b, 0x02, 0x70, 0x69}, {0x0b, 0x02, 0x70, 0x6f},
+    {0x0b, 0x02, 0x70, 0x73}, {0x0b, 0x02, 0x70, 0x74},
+    {0x06, 0x01, 0x70, 0x00}, {0x06, 0x01, 0x70, 0x00},
+    {0x06, 0x01, 0x70, 0x00}, {0x06, 0x01, 0x70, 0x00},
+    {0x06, 0x01, 0x70, 0x00}, {0x06, 0x01, 0x70, 0x00},
+    {0x06, 0x01, 0x70, 0x00}, {0x06, 0x01, 0x70, 0x00},
+    {0x06, 0x01, 0x70, 0x00}, {0x06, 0x01, 0x70, 0x00},
+    {0x06, 0x01, 0x70, 0x00}, {0x06, 0x01, 0x70, 0x00},
+    {0x06, 0x01, 0x70, 0x00}, {0x06, 0x01, 0x70, 0x00},
+    {0x06, 0x01, 0x70, 0x00}, {0x06, 0x01, 0x70, 0x00},
+    {0x06, 0x01, 0x70, 0x00}, {0x06, 0x01, 0x70, 0x00},
+    {0x06, 0x01, 0x70, 0x00}, {0x06, 0x01, 0x70, 0x00},
+    {0x06, 0x01, 0x70, 0x00}, {0x06, 0x01, 0x70, 0x00},
+    /* 0x580 */
+    {0x0b, 0x02, 0x72, 0x30}, {0x0b, 0x02, 0x72, 0x31},
+    {0x0b, 0x02, 0x72, 0x32}, {0x0b, 0x02, 0x72, 0x61},
+    {0x0b, 0x02, 0x72, 0x63}, {0x0b, 0x02, 0x72, 0x65},
+    {0x0b, 0x02, 0x72, 0x69}, {0x0b, 0x02, 0x72, 0x6f},
+    {0x0b, 0x02, 0x72, 0x73}, {0x0b, 0x02, 0x72, 0x74},
+    {0x06, 0x01, 0x72, 0x00}, {0x06, 0x01, 0x72, 0x00},
+    {0x06, 0x01, 0x72, 0x00}, {0x06, 0x01, 0x72, 0x00},
+    {0x06, 0x01, 0x72, 0x00}, {0x06, 0x01, 0x72, 0x00},
+    {0x06, 0x01, 0x72, 0x00}, {0x06, 0x01, 0x72, 0x00},
+    {0x06, 0x01, 0x72, 0x00}, {0x06, 0x01, 0x72, 0x00},
+    {0x06, 0x01, 0x72, 0x00}, {0x06, 0x01, 0x72, 0x00},
+    {0x06, 0x01, 0x72, 0x00}, {0x06, 0x01, 0x72, 0x00},
+    {0x06, 0x01, 0x72, 0x00}, {0x06, 0x01, 0x72, 0x00},
+    {0x06, 0x01, 0x72, 0x00}, {0x06, 0x01, 0x72, 0x00},
+    {0x06, 0x01, 0x72, 0x00}, {0x06, 0x01, 0x72, 0x00},
+    {0x06, 0x01, 0x72, 0x00}, {0x06, 0x01, 0x72, 0x00},
+    {0x0b, 0x02, 0x75, 0x30}, {0x0b, 0x02, 0x75, 0x31},
+    {0x0b, 0x02, 0x75, 0x32}, {0x0b, 0x02, 0x75, 0x61},
+    {0x0b, 0x02, 0x75, 0x63}, {0x0b, 0x02, 0x75, 0x65},
+    {0x0b, 0x02, 0x75, 0x69}, {0x0b, 0x02, 0x75, 0x6f},
+    {0x0b, 0x02, 0x75, 0x73}, {0x0b, 0x02, 0x75, 0x74},
+    {0x06, 0x01, 0x75, 0x00}, {0x06, 0x01, 0x75, 0x00},
+    {0x06, 0x01, 0x75, 0x00}, {0x06, 0x01, 0x75, 0x00},
+    {0x06, 0x01, 0x75, 0x00}, {0x06, 0x01, 0x75, 0x00},
+    {0x06, 0x01, 0x75, 0x00}, {0x06, 0x01, 0x75, 0x00},
+    {0x06, 0x01, 0x75, 0x00}, {0x06, 0x01, 0x75, 0x00},
+    {0x06, 0x01, 0x75, 0x00}, {0x06, 0x01, 0x75, 0x00},
+    {0x06, 0x01, 0x75, 0x00}, {0x06, 0x01, 0x75, 0x00},
+    {0x06, 0x01, 0x75, 0x00}, {0x06, 0x01, 0x75, 0x00},
+    {0x06, 0x01, 0x75, 0x00}, {0x06, 0x01, 0x75, 0x00},
+    {0x06, 0x01, 0x75, 0x00}, {0x06, 0x01, 0x75, 0x00},
+    {0x06, 0x01, 0x75, 0x00}, {0x06, 0x01, 0x75, 0x00},
+    /* 0x5c0 */
+    {0x07, 0x01, 0x3a, 0x00}, {0x07, 0x01, 0x3a, 0x00},
+    {0x07, 0x01, 0x3a, 0x00}, {0x07, 0x01, 0x3a, 0x00},
+    {0x07, 0x01, 0x3a, 0x00}, {0x07, 0x01, 0x3a, 0x00},
+    {0x07, 0x01, 0x3a, 0x00}, {0x07, 0x01, 0x3a, 0x00},
+    {0x07, 0x01, 0x3a, 0x00}, {0x07, 0x01, 0x3a, 0x00},
+    {0x07, 0x01, 0x3a, 0x00}, {0x07, 0x01, 0x3a, 0x00},
+    {0x07, 0x01, 0x3a, 0x00}, {0x07, 0x01, 0x3a, 0x00},
+    {0x07, 0x01, 0x3a, 0x00}, {0x07, 0x01, 0x3a, 0x00},
+    {0x07, 0x01, 0x42, 0x00}, {0x07, 0x01, 0x42, 0x00},
+    {0x07, 0x01, 0x42, 0x00}, {0x07, 0x01, 0x42, 0x00},
+    {0x07, 0x01, 0x42, 0x00}, {0x07, 0x01, 0x42, 0x00},
+    {0x07, 0x01, 0x42, 0x00}, {0x07, 0x01, 0x42, 0x00},
+    {0x07, 0x01, 0x42, 0x00}, {0x07, 0x01, 0x42, 0x00},
+    {0x07, 0x01, 0x42, 0x00}, {0x07, 0x01, 0x42, 0x00},
+    {0x07, 0x01, 0x42, 0x00}, {0x07, 0x01, 0x42, 0x00},
+    {0x07, 0x01, 0x42, 0x00}, {0x07, 0x01, 0x42, 0x00},
+    {0x07, 0x01, 0x43, 0x00}, {0x07, 0x01, 0x43, 0x00},
+    {0x07, 0x01, 0x43, 0x00}, {0x07, 0x01, 0x43, 0x00},
+    {0x07, 0x01, 0x43, 0x00}, {0x07, 0x01, 0x43, 0x00},
+    {0x07, 0x01, 0x43, 0x00}, {0x07, 0x01, 0x43, 0x00},
+    {0x07, 0x01, 0x43, 0x00}, {0x07, 0x01, 0x43, 0x00},
+    {0x07, 0x01, 0x43, 0x00}, {0x07, 0x01, 0x43, 0x00},
+    {0x07, 0x01, 0x43, 0x00}, {0x07, 0x01, 0x43, 0x00},
+    {0x07, 0x01, 0x43, 0x00}, {0x07, 0x01, 0x43, 0x00},
+    {0x07, 0x01, 0x44, 0x00}, {0x07, 0x01, 0x44, 0x00},
+    {0x07, 0x01, 0x44, 0x00}, {0x07, 0x01, 0x44, 0x00},
+    {0x07, 0x01, 0x44, 0x00}, {0x07, 0x01, 0x44, 0x00},
+    {0x07, 0x01, 0x44, 0x00}, {0x07, 0x01, 0x44, 0x00},
+    {0x07, 0x01, 0x44, 0x00}, {0x07, 0x01, 0x44, 0x00},
+    {0x07, 0x01, 0x44, 0x00}, {0x07, 0x01, 0x44, 0x00},
+    {0x07, 0x01, 0x44, 0x00}, {0x07, 0x01, 0x44, 0x00},
+    {0x07, 0x01, 0x44, 0x00}, {0x07, 0x01, 0x44, 0x00},
+    /* 0x600 */
+    {0x07, 0x01, 0x45, 0x00}, {0x07, 0x01, 0x45, 0x00},
+    {0x07, 0x01, 0x45, 0x00}, {0x07, 0x01, 0x45, 0x00},
+    {0x07, 0x01, 0x45, 0x00}, {0x07, 0x01, 0x45, 0x00},
+    {0x07, 0x01, 0x45, 0x00}, {0x07, 0x01, 0x45, 0x00},
+    {0x07, 0x01, 0x45, 0x00}, {0x07, 0x01, 0x45, 0x00},
+    {0x07, 0x01, 0x45, 0x00}, {0x07, 0x01, 0x45, 0x00},
+    {0x07, 0x01, 0x45, 0x00}, {0x07, 0x01, 0x45, 0x00},
+    {0x07, 0x01, 0x45, 0x00}, {0x07, 0x01, 0x45, 0x00},
+    {0x07, 0x01, 0x46, 0x00}, {0x07, 0x01, 0x46, 0x00},
+    {0x07, 0x01, 0x46, 0x00}, {0x07, 0x01, 0x46, 0x00},
+    {0x07, 0x01, 0x46, 0x00}, {0x07, 0x01, 0x46, 0x00},
+    {0x07, 0x01, 0x46, 0x00}, {0x07, 0x01, 0x46, 0x00},
+    {0x07, 0x01, 0x46, 0x00}, {0x07, 0x01, 0x46, 0x00},
+    {0x07, 0x01, 0x46, 0x00}, {0x07, 0x01, 0x46, 0x00},
+    {0x07, 0x01, 0x46, 0x00}, {0x07, 0x01, 0x46, 0x00},
+    {0x07, 0x01, 0x46, 0x00}, {0x07, 0x01, 0x46, 0x00},
+    {0x07, 0x01, 0x47, 0x00}, {0x07, 0x01, 0x47, 0x00},
+    {0x07, 0x01, 0x47, 0x00}, {0x07, 0x01, 0x47, 0x00},
+    {0x07, 0x01, 0x47, 0x00}, {0x07, 0x01, 0x47, 0x00},
+    {0x07, 0x01, 0x47, 0x00}, {0x07, 0x01, 0x47, 0x00},
+    {0x07, 0x01, 0x47, 0x00}, {0x07, 0x01, 0x47, 0x00},
+    {0x07, 0x01, 0x47, 0x00}, {0x07, 0x01, 0x47, 0x00},
+    {0x07, 0x01, 0x47, 0x00}, {0x07, 0x01, 0x47, 0x00},
+    {0x07, 0x01, 0x47, 0x00}, {0x07, 0x01, 0x47, 0x00},
+    {0x07, 0x01, 0x48, 0x00}, {0x07, 0x01, 0x48, 0x00},
+    {0x07, 0x01, 0x48, 0x00}, {0x07, 0x01, 0x48, 0x00},
+    {0x07, 0x01, 0x48, 0x00}, {0x07, 0x01, 0x48, 0x00},
+    {0x07, 0x01, 0x48, 0x00}, {0x07, 0x01, 0x48, 0x00},
+    {0x07, 0x01, 0x48, 0x00}, {0x07, 0x01, 0x48, 0x00},
+    {0x07, 0x01, 0x48, 0x00}, {0x07, 0x01, 0x48, 0x00},
+    {0x07, 0x01, 0x48, 0x00}, {0x07, 0x01, 0x48, 0x00},
+    {0x07, 0x01, 0x48, 0x00}, {0x07, 0x01, 0x48, 0x00},
+    /* 0x640 */
+    {0x07, 0x01, 0x49, 0x00}, {0x07, 0x01, 0x49, 0x00},
+    {0x07, 0x01, 0x49, 0x00}, {0x07, 0x01, 0x49, 0x00},
+    {0x07, 0x01, 0x49, 0x00}, {0x07, 0x01, 0x49, 0x00},
+    {0x07, 0x01, 0x49, 0x00}, {0x07, 0x01, 0x49, 0x00},
+    {0x07, 0x01, 0x49, 0x00}, {0x07, 0x01, 0x49, 0x00},
+    {0x07, 0x01, 0x49, 0x00}, {0x07, 0x01, 0x49, 0x00},
+    {0x07, 0x01, 0x49, 0x00}, {0x07, 0x01, 0x49, 0x00},
+    {0x07, 0x01, 0x49, 0x00}, {0x07, 0x01, 0x49, 0x00},
+    {0x07, 0x01, 0x4a, 0x00}, {0x07, 0x01, 0x4a, 0x00},
+    {0x07, 0x01, 0x4a, 0x00}, {0x07, 0x01, 0x4a, 0x00},
+    {0x07, 0x01, 0x4a, 0x00}, {0x07, 0x01, 0x4a, 0x00},
+    {0x07, 0x01, 0x4a, 0x00}, {0x07, 0x01, 0x4a, 0x00},
+    {0x07, 0x01, 0x4a, 0x00}, {0x07, 0x01, 0x4a, 0x00},
+    {0x07, 0x01, 0x4a, 0x00}, {0x07, 0x01, 0x4a, 0x00},
+    {0x07, 0x01, 0x4a, 0x00}, {0x07, 0x01, 0x4a, 0x00},
+    {0x07, 0x01, 0x4a, 0x00}, {0x07, 0x01, 0x4a, 0x00},
+    {0x07, 0x01, 0x4b, 0x00}, {0x07, 0x01, 0x4b, 0x00},
+    {0x07, 0x01, 0x4b, 0x00}, {0x07, 0x01, 0x4b, 0x00},
+    {0x07, 0x01, 0x4b, 0x00}, {0x07, 0x01, 0x4b, 0x00},
+    {0x07, 0x01, 0x4b, 0x00}, {0x07, 0x01, 0x4b, 0x00},
+    {0x07, 0x01, 0x4b, 0x00}, {0x07, 0x01, 0x4b, 0x00},
+    {0x07, 0x01, 0x4b, 0x00}, {0x07, 0x01, 0x4b, 0x00},
+    {0x07, 0x01, 0x4b, 0x00}, {0x07, 0x01, 0x4b, 0x00},
+    {0x07, 0x01, 0x4b, 0x00}, {0x07, 0x01, 0x4b, 0x00},
+    {0x07, 0x01, 0x4c, 0x00}, {0x07, 0x01, 0x4c, 0x00},
+    {0x07, 0x01, 0x4c, 0x00}, {0x07, 0x01, 0x4c, 0x00},
+    {0x07, 0x01, 0x4c, 0x00}, {0x07, 0x01, 0x4c, 0x00},
+    {0x07, 0x01, 0x4c, 0x00}, {0x07, 0x01, 0x4c, 0x00},
+    {0x07, 0x01, 0x4c, 0x00}, {0x07, 0x01, 0x4c, 0x00},
+    {0x07, 0x01, 0x4c, 0x00}, {0x07, 0x01, 0x4c, 0x00},
+    {0x07, 0x01, 0x4c, 0x00}, {0x07, 0x01, 0x4c, 0x00},
+    {0x07, 0x01, 0x4c, 0x00}, {0x07, 0x01, 0x4c, 0x00},
+    /* 0x680 */
+    {0x07, 0x01, 0x4d, 0x00}, {0x07, 0x01, 0x4d, 0x00},
+    {0x07, 0x01, 0x4d, 0x00}, {0x07, 0x01, 0x4d, 0x00},
+    {0x07, 0x01, 0x4d, 0x00}, {0x07, 0x01, 0x4d, 0x00},
+    {0x07, 0x01, 0x4d, 0x00}, {0x07, 0x01, 0x4d, 0x00},
+    {0x07, 0x01, 0x4d, 0x00}, {0x07, 0x01, 0x4d, 0x00},
+    {0x07, 0x01, 0x4d, 0x00}, {0x07, 0x01, 0x4d, 0x00},
+    {0x07, 0x01, 0x4d, 0x00}, {0x07, 0x01, 0x4d, 0x00},
+    {0x07, 0x01, 0x4d, 0x00}, {0x07, 0x01, 0x4d, 0x00},
+    {0x07, 0x01, 0x4e, 0x00}, {0x07, 0x01, 0x4e, 0x00},
+    {0x07, 0x01, 0x4e, 0x00}, {0x07, 0x01, 0x4e, 0x00},
+    {0x07, 0x01, 0x4e, 0x00}, {0x07, 0x01, 0x4e, 0x00},
+    {0x07, 0x01, 0x4e, 0x00}, {0x07, 0x01, 0x4e, 0x00},
+    {0x07, 0x01, 0x4e, 0x00}, {0x07, 0x01, 0x4e, 0x00},
+    {0x07, 0x01, 0x4e, 0x00}, {0x07, 0x01, 0x4e, 0x00},
+    {0x07, 0x01, 0x4e, 0x00}, {0x07, 0x01, 0x4e, 0x00},
+    {0x07, 0x01, 0x4e, 0x00}, {0x07, 0x01, 0x4e, 0x00},
+    {0x07, 0x01, 0x4f, 0x00}, {0x07, 0x01, 0x4f, 0x00},
+    {0x07, 0x01, 0x4f, 0x00}, {0x07, 0x01, 0x4f, 0x00},
+    {0x07, 0x01, 0x4f, 0x00}, {0x07, 0x01, 0x4f, 0x00},
+    {0x07, 0x01, 0x4f, 0x00}, {0x07, 0x01, 0x4f, 0x00},
+    {0x07, 0x01, 0x4f, 0x00}, {0x07, 0x01, 0x4f, 0x00},
+    {0x07, 0x01, 0x4f, 0x00}, {0x07, 0x01, 0x4f, 0x00},
+    {0x07, 0x01, 0x4f, 0x00}, {0x07, 0x01, 0x4f, 0x00},
+    {0x07, 0x01, 0x4f, 0x00}, {0x07, 0x01, 0x4f, 0x00},
+    {0x07, 0x01, 0x50, 0x00}, {0x07, 0x01, 0x50, 0x00},
+    {0x07, 0x01, 0x50, 0x00}, {0x07, 0x01, 0x50, 0x00},
+    {0x07, 0x01, 0x50, 0x00}, {0x07, 0x01, 0x50, 0x00},
+    {0x07, 0x01, 0x50, 0x00}, {0x07, 0x01, 0x50, 0x00},
+    {0x07, 0x01, 0x50, 0x00}, {0x07, 0x01, 0x50, 0x00},
+    {0x07, 0x01, 0x50, 0x00}, {0x07, 0x01, 0x50, 0x00},
+    {0x07, 0x01, 0x50, 0x00}, {0x07, 0x01, 0x50, 0x00},
+    {0x07, 0x01, 0x50, 0x00}, {0x07, 0x01, 0x50, 0x00},
+    /* 0x6c0 */
+    {0x07, 0x01, 0x51, 0x00}, {0x07, 0x01, 0x51, 0x00},
+    {0x07, 0x01, 0x51, 0x00}, {0x07, 0x01, 0x51, 0x00},
+    {0x07, 0x01, 0x51, 0x00}, {0x07, 0x01, 0x51, 0x00},
+    {0x07, 0x01, 0x51, 0x00}, {0x07, 0x01, 0x51, 0x00},
+    {0x07, 0x01, 0x51, 0x00}, {0x07, 0x01, 0x51, 0x00},
+    {0x07, 0x01, 0x51, 0x00}, {0x07, 0x01, 0x51, 0x00},
+    {0x07, 0x01, 0x51, 0x00}, {0x07, 0x01, 0x51, 0x00},
+    {0x07, 0x01, 0x51, 0x00}, {0x07, 0x01, 0x51, 0x00},
+    {0x07, 0x01, 0x52, 0x00}, {0x07, 0x01, 0x52, 0x00},
+    {0x07, 0x01, 0x52, 0x00}, {0x07, 0x01, 0x52, 0x00},
+    {0x07, 0x01, 0x52, 0x00}, {0x07, 0x01, 0x52, 0x00},
+    {0x07, 0x01, 0x52, 0x00}, {0x07, 0x01, 0x52, 0x00},
+    {0x07, 0x01, 0x52, 0x00}, {0x07, 0x01, 0x52, 0x00},
+    {0x07, 0x01, 0x52, 0x00}, {0x07, 0x01, 0x52, 0x00},
+    {0x07, 0x01, 0x52, 0x00}, {0x07, 0x01, 0x52, 0x00},
+    {0x07, 0x01, 0x52, 0x00}, {0x07, 0x01, 0x52, 0x00},
+    {0x07, 0x01, 0x53, 0x00}, {0x07, 0x01, 0x53, 0x00},
+    {0x07, 0x01, 0x53, 0x00}, {0x07, 0x01, 0x53, 0x00},
+    {0x07, 0x01, 0x53, 0x00}, {0x07, 0x01, 0x53, 0x00},
+    {0x07, 0x01, 0x53, 0x00}, {0x07, 0x01, 0x53, 0x00},
+    {0x07, 0x01, 0x53, 0x00}, {0x07, 0x01, 0x53, 0x00},
+    {0x07, 0x01, 0x53, 0x00}, {0x07, 0x01, 0x53, 0x00},
+    {0x07, 0x01, 0x53, 0x00}, {0x07, 0x01, 0x53, 0x00},
+    {0x07, 0x01, 0x53, 0x00}, {0x07, 0x01, 0x53, 0x00},
+    {0x07, 0x01, 0x54, 0x00}, {0x07, 0x01, 0x54, 0x00},
+    {0x07, 0x01, 0x54, 0x00}, {0x07, 0x01, 0x54, 0x00},
+    {0x07, 0x01, 0x54, 0x00}, {0x07, 0x01, 0x54, 0x00},
+    {0x07, 0x01, 0x54, 0x00}, {0x07, 0x01, 0x54, 0x00},
+    {0x07, 0x01, 0x54, 0x00}, {0x07, 0x01, 0x54, 0x00},
+    {0x07, 0x01, 0x54, 0x00}, {0x07, 0x01, 0x54, 0x00},
+    {0x07, 0x01, 0x54, 0x00}, {0x07, 0x01, 0x54, 0x00},
+    {0x07, 0x01, 0x54, 0x00}, {0x07, 0x01, 0x54, 0x00},
+    /* 0x700 */
+    {0x07, 0x01, 0x55, 0x00}, {0x07, 0x01, 0x55, 0x00},
+    {0x07, 0x01, 0x55, 0x00}, {0x07, 0x01, 0x55, 0x00},
+    {0x07, 0x01, 0x55, 0x00}, {0x07, 0x01, 0x55, 0x00},
+    {0x07, 0x01, 0x55, 0x00}, {0x07, 0x01, 0x55, 0x00},
+    {0x07, 0x01, 0x55, 0x00}, {0x07, 0x01, 0x55, 0x00},
+    {0x07, 0x01, 0x55, 0x00}, {0x07, 0x01, 0x55, 0x00},
+    {0x07, 0x01, 0x55, 0x00}, {0x07, 0x01, 0x55, 0x00},
+    {0x07, 0x01, 0x55, 0x00}, {0x07, 0x01, 0x55, 0x00},
+    {0x07, 0x01, 0x56, 0x00}, {0x07, 0x01, 0x56, 0x00},
+    {0x07, 0x01, 0x56, 0x00}, {0x07, 0x01, 0x56, 0x00},
+    {0x07, 0x01, 0x56, 0x00}, {0x07, 0x01, 0x56, 0x00},
+    {0x07, 0x01, 0x56, 0x00}, {0x07, 0x01, 0x56, 0x00},
+    {0x07, 0x01, 0x56, 0x00}, {0x07, 0x01, 0x56, 0x00},
+    {0x07, 0x01, 0x56, 0x00}, {0x07, 0x01, 0x56, 0x00},
+    {0x07, 0x01, 0x56, 0x00}, {0x07, 0x01, 0x56, 0x00},
+    {0x07, 0x01, 0x56, 0x00}, {0x07, 0x01, 0x56, 0x00},
+    {0x07, 0x01, 0x57, 0x00}, {0x07, 0x01, 0x57, 0x00},
+    {0x07, 0x01, 0x57, 0x00}, {0x07, 0x01, 0x57, 0x00},
+    {0x07, 0x01, 0x57, 0x00}, {0x07, 0x01, 0x57, 0x00},
+    {0x07, 0x01, 0x57, 0x00}, {0x07, 0x01, 0x57, 0x00},
+    {0x07, 0x01, 0x57, 0x00}, {0x07, 0x01, 0x57, 0x00},
+    {0x07, 0x01, 0x57, 0x00}, {0x07, 0x01, 0x57, 0x00},
+    {0x07, 0x01, 0x57, 0x00}, {0x07, 0x01, 0x57, 0x00},
+    {0x07, 0x01, 0x57, 0x00}, {0x07, 0x01, 0x57, 0x00},
+    {0x07, 0x01, 0x59, 0x00}, {0x07, 0x01, 0x59, 0x00},
+    {0x07, 0x01, 0x59, 0x00}, {0x07, 0x01, 0x59, 0x00},
+    {0x07, 0x01, 0x59, 0x00}, {0x07, 0x01, 0x59, 0x00},
+    {0x07, 0x01, 0x59, 0x00}, {0x07, 0x01, 0x59, 0x00},
+    {0x07, 0x01, 0x59, 0x00}, {0x07, 0x01, 0x59, 0x00},
+    {0x07, 0x01, 0x59, 0x00}, {0x07, 0x01, 0x59, 0x00},
+    {0x07, 0x01, 0x59, 0x00}, {0x07, 0x01, 0x59, 0x00},
+    {0x07, 0x01, 0x59, 0x00}, {0x07, 0x01, 0x59, 0x00},
+    /* 0x740 */
+    {0x07, 0x01, 0x6a, 0x00}, {0x07, 0x01, 0x6a, 0x00},
+    {0x07, 0x01, 0x6a, 0x00}, {0x07, 0x01, 0x6a, 0x00},
+    {0x07, 0x01, 0x6a, 0x00}, {0x07, 0x01, 0x6a, 0x00},
+    {0x07, 0x01, 0x6a, 0x00}, {0x07, 0x01, 0x6a, 0x00},
+    {0x07, 0x01, 0x6a, 0x00}, {0x07, 0x01, 0x6a, 0x00},
+    {0x07, 0x01, 0x6a, 0x00}, {0x07, 0x01, 0x6a, 0x00},
+    {0x07, 0x01, 0x6a, 0x00}, {0x07, 0x01, 0x6a, 0x00},
+    {0x07, 0x01, 0x6a, 0x00}, {0x07, 0x01, 0x6a, 0x00},
+    {0x07, 0x01, 0x6b, 0x00}, {0x07, 0x01, 0x6b, 0x00},
+    {0x07, 0x01, 0x6b, 0x00}, {0x07, 0x01, 0x6b, 0x00},
+    {0x07, 0x01, 0x6b, 0x00}, {0x07, 0x01, 0x6b, 0x00},
+    {0x07, 0x01, 0x6b, 0x00}, {0x07, 0x01, 0x6b, 0x00},
+    {0x07, 0x01, 0x6b, 0x00}, {0x07, 0x01, 0x6b, 0x00},
+    {0x07, 0x01, 0x6b, 0x00}, {0x07, 0x01, 0x6b, 0x00},
+    {0x07, 0x01, 0x6b, 0x00}, {0x07, 0x01, 0x6b, 0x00},
+    {0x07, 0x01, 0x6b, 0x00}, {0x07, 0x01, 0x6b, 0x00},
+    {0x07, 0x01, 0x71, 0x00}, {0x07, 0x01, 0x71, 0x00},
+    {0x07, 0x01, 0x71, 0x00}, {0x07, 0x01, 0x71, 0x00},
+    {0x07, 0x01, 0x71, 0x00}, {0x07, 0x01, 0x71, 0x00},
+    {0x07, 0x01, 0x71, 0x00}, {0x07, 0x01, 0x71, 0x00},
+    {0x07, 0x01, 0x71, 0x00}, {0x07, 0x01, 0x71, 0x00},
+    {0x07, 0x01, 0x71, 0x00}, {0x07, 0x01, 0x71, 0x00},
+    {0x07, 0x01, 0x71, 0x00}, {0x07, 0x01, 0x71, 0x00},
+    {0x07, 0x01, 0x71, 0x00}, {0x07, 0x01, 0x71, 0x00},
+    {0x07, 0x01, 0x76, 0x00}, {0x07, 0x01, 0x76, 0x00},
+    {0x07, 0x01, 0x76, 0x00}, {0x07, 0x01, 0x76, 0x00},
+    {0x07, 0x01, 0x76, 0x00}, {0x07, 0x01, 0x76, 0x00},
+    {0x07, 0x01, 0x76, 0x00}, {0x07, 0x01, 0x76, 0x00},
+    {0x07, 0x01, 0x76, 0x00}, {0x07, 0x01, 0x76, 0x00},
+    {0x07, 0x01, 0x76, 0x00}, {0x07, 0x01, 0x76, 0x00},
+    {0x07, 0x01, 0x76, 0x00}, {0x07, 0x01, 0x76, 0x00},
+    {0x07, 0x01, 0x76, 0x00}, {0x07, 0x01, 0x76, 0x00},
+    /* 0x780 */
+    {0x07, 0x01, 0x77, 0x00}, {0x07, 0x01, 0x77, 0x00},
+    {0x07, 0x01, 0x77, 0x00}, {0x07, 0x01, 0x77, 0x00},
+    {0x07, 0x01, 0x77, 0x00}, {0x07, 0x01, 0x77, 0x00},
+    {0x07, 0x01, 0x77, 0x00}, {0x07, 0x01, 0x77, 0x00},
+    {0x07, 0x01, 0x77, 0x00}, {0x07, 0x01, 0x77, 0x00},
+    {0x07, 0x01, 0x77, 0x00}, {0x07, 0x01, 0x77, 0x00},
+    {0x07, 0x01, 0x77, 0x00}, {0x07, 0x01, 0x77, 0x00},
+    {0x07, 0x01, 0x77, 0x00}, {0x07, 0x01, 0x77, 0x00},
+    {0x07, 0x01, 0x78, 0x00}, {0x07, 0x01, 0x78, 0x00},
+    {0x07, 0x01, 0x78, 0x00}, {0x07, 0x01, 0x78, 0x00},
+    {0x07, 0x01, 0x78, 0x00}, {0x07, 0x01, 0x78, 0x00},
+    {0x07, 0x01, 0x78, 0x00}, {0x07, 0x01, 0x78, 0x00},
+    {0x07, 0x01, 0x78, 0x00}, {0x07, 0x01, 0x78, 0x00},
+    {0x07, 0x01, 0x78, 0x00}, {0x07, 0x01, 0x78, 0x00},
+    {0x07, 0x01, 0x78, 0x00}, {0x07, 0x01, 0x78, 0x00},
+    {0x07, 0x01, 0x78, 0x00}, {0x07, 0x01, 0x78, 0x00},
+    {0x07, 0x01, 0x79, 0x00}, {0x07, 0x01, 0x79, 0x00},
+    {0x07, 0x01, 0x79, 0x00}, {0x07, 0x01, 0x79, 0x00},
+    {0x07, 0x01, 0x79, 0x00}, {0x07, 0x01, 0x79, 0x00},
+    {0x07, 0x01, 0x79, 0x00}, {0x07, 0x01, 0x79, 0x00},
+    {0x07, 0x01, 0x79, 0x00}, {0x07, 0x01, 0x79, 0x00},
+    {0x07, 0x01, 0x79, 0x00}, {0x07, 0x01, 0x79, 0x00},
+    {0x07, 0x01, 0x79, 0x00}, {0x07, 0x01, 0x79, 0x00},
+    {0x07, 0x01, 0x79, 0x00}, {0x07, 0x01, 0x79, 0x00},
+    {0x07, 0x01, 0x7a, 0x00}, {0x07, 0x01, 0x7a, 0x00},
+    {0x07, 0x01, 0x7a, 0x00}, {0x07, 0x01, 0x7a, 0x00},
+    {0x07, 0x01, 0x7a, 0x00}, {0x07, 0x01, 0x7a, 0x00},
+    {0x07, 0x01, 0x7a, 0x00}, {0x07, 0x01, 0x7a, 0x00},
+    {0x07, 0x01, 0x7a, 0x00}, {0x07, 0x01, 0x7a, 0x00},
+    {0x07, 0x01, 0x7a, 0x00}, {0x07, 0x01, 0x7a, 0x00},
+    {0x07, 0x01, 0x7a, 0x00}, {0x07, 0x01, 0x7a, 0x00},
+    {0x07, 0x01, 0x7a, 0x00}, {0x07, 0x01, 0x7a, 0x00},
+    /* 0x7c0 */
+    {0x08, 0x01, 0x26, 0x00}, {0x08, 0x01, 0x26, 0x00},
+    {0x08, 0x01, 0x26, 0x00}, {0x08, 0x01, 0x26, 0x00},
+    {0x08, 0x01, 0x26, 0x00}, {0x08, 0x01, 0x26, 0x00},
+    {0x08, 0x01, 0x26, 0x00}, {0x08, 0x01, 0x26, 0x00},
+    {0x08, 0x01, 0x2a, 0x00}, {0x08, 0x01, 0x2a, 0x00},
+    {0x08, 0x01, 0x2a, 0x00}, {0x08, 0x01, 0x2a, 0x00},
+    {0x08, 0x01, 0x2a, 0x00}, {0x08, 0x01, 0x2a, 0x00},
+    {0x08, 0x01, 0x2a, 0x00}, {0x08, 0x01, 0x2a, 0x00},
+    {0x08, 0x01, 0x2c, 0x00}, {0x08, 0x01, 0x2c, 0x00},
+    {0x08, 0x01, 0x2c, 0x00}, {0x08, 0x01, 0x2c, 0x00},
+    {0x08, 0x01, 0x2c, 0x00}, {0x08, 0x01, 0x2c, 0x00},
+    {0x08, 0x01, 0x2c, 0x00}, {0x08, 0x01, 0x2c, 0x00},
+    {0x08, 0x01, 0x3b, 0x00}, {0x08, 0x01, 0x3b, 0x00},
+    {0x08, 0x01, 0x3b, 0x00}, {0x08, 0x01, 0x3b, 0x00},
+    {0x08, 0x01, 0x3b, 0x00}, {0x08, 0x01, 0x3b, 0x00},
+    {0x08, 0x01, 0x3b, 0x00}, {0x08, 0x01, 0x3b, 0x00},
+    {0x08, 0x01, 0x58, 0x00}, {0x08, 0x01, 0x58, 0x00},
+    {0x08, 0x01, 0x58, 0x00}, {0x08, 0x01, 0x58, 0x00},
+    {0x08, 0x01, 0x58, 0x00}, {0x08, 0x01, 0x58, 0x00},
+    {0x08, 0x01, 0x58, 0x00}, {0x08, 0x01, 0x58, 0x00},
+    {0x08, 0x01, 0x5a, 0x00}, {0x08, 0x01, 0x5a, 0x00},
+    {0x08, 0x01, 0x5a, 0x00}, {0x08, 0x01, 0x5a, 0x00},
+    {0x08, 0x01, 0x5a, 0x00}, {0x08, 0x01, 0x5a, 0x00},
+    {0x08, 0x01, 0x5a, 0x00}, {0x08, 0x01, 0x5a, 0x00},
+    {0x0a, 0x01, 0x21, 0x00}, {0x0a, 0x01, 0x21, 0x00},
+    {0x0a, 0x01, 0x22, 0x00}, {0x0a, 0x01, 0x22, 0x00},
+    {0x0a, 0x01, 0x28, 0x00}, {0x0a, 0x01, 0x28, 0x00},
+    {0x0a, 0x01, 0x29, 0x00}, {0x0a, 0x01, 0x29, 0x00},
+    {0x0a, 0x01, 0x3f, 0x00}, {0x0a, 0x01, 0x3f, 0x00},
+    {0x0b, 0x01, 0x27, 0x00}, {0x0b, 0x01, 0x2b, 0x00},
+    {0x0b, 0x01, 0x7c, 0x00}, {0x00, 0x00, 0x00, 0x00},
+    {0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00}
+};
+
+#endif
+
+
 ngx_int_t
 ngx_http_huff_decode(u_char *state, u_char *src, size_t len, u_char **dst,
     ngx_uint_t last, ngx_log_t *log)
 {
-    u_char  *end, ch, ending;
+    u_char                       *end, *p, ch, st, ending;
+    uint64_t                      buf;
+    ngx_uint_t                    bits, code;
+#if (NGX_HTTP_HUFF_DECODE_FAST)
+    ngx_http_huff_decode_fast_t   fast;
+#endif
 
     ch = 0;
     ending = 1;
 
+    st = *state;
+    p = *dst;
+
+    buf = 0;
+    bits = 0;
+
     end = src + len;
 
-    while (src != end) {
-        ch = *src++;
+    for ( ;; ) {
 
-        if (ngx_http_huff_decode_bits(state, &ending, ch >> 4, dst)
-            != NGX_OK)
-        {
-            ngx_log_debug2(NGX_LOG_DEBUG_HTTP, log, 0,
-                           "http huffman decoding error at state %d: "
-                           "bad code 0x%Xd", *state, ch >> 4);
+        while (bits <= 56 && src != end) {
+            ch = *src++;
+            buf |= (uint64_t) ch << (56 - bits);
+            bits += 8;
+        }
 
-            return NGX_ERROR;
+        if (bits == 0) {
+            break;
+        }
+
+#if (NGX_HTTP_HUFF_DECODE_FAST)
+
+        if (st == 0 && bits >= NGX_HTTP_HUFF_DECODE_FAST_BITS) {
+            fast = ngx_http_huff_decode_fast_codes[
+                                   buf >> (64 - NGX_HTTP_HUFF_DECODE_FAST_BITS)];
+
+            if (fast.len) {
+                *p++ = fast.sym1;
+
+                if (fast.emit == 2) {
+                    *p++ = fast.sym2;
+                }
+
+                ending = 1;
+
+                buf <<= fast.len;
+                bits -= fast.len;
+
+                continue;
+            }
+        }
+
+#endif
+
+        if (bits >= 4) {
+            code = (ngx_uint_t) (buf >> 60);
+
+            if (ngx_http_huff_decode_bits(&st, &ending, code, &p) != NGX_OK) {
+                ngx_log_debug2(NGX_LOG_DEBUG_HTTP, log, 0,
+                               "http huffman decoding error at state %d: "
+                               "bad code 0x%Xd", st, code);
+
+                return NGX_ERROR;
+            }
+
+            buf <<= 4;
+            bits -= 4;
+
+            continue;
         }
 
-        if (ngx_http_huff_decode_bits(state, &ending, ch & 0xf, dst)
-            != NGX_OK)
-        {
+        code = (ngx_uint_t) (buf >> 63);
+
+        if (ngx_http_huff_decode_bit(&st, &ending, code, &p) != NGX_OK) {
             ngx_log_debug2(NGX_LOG_DEBUG_HTTP, log, 0,
                            "http huffman decoding error at state %d: "
-                           "bad code 0x%Xd", *state, ch & 0xf);
+                           "bad bit %ui", st, code);
 
             return NGX_ERROR;
         }
+
+        buf <<= 1;
+        bits--;
     }
 
+    *dst = p;
+
     if (last) {
         if (!ending) {
             ngx_log_debug1(NGX_LOG_DEBUG_HTTP, log, 0,
@@ -2683,14 +4113,15 @@ ngx_http_huff_decode(u_char *state, u_char *src, size_t len, u_char **dst,
             return NGX_ERROR;
         }
 
-        *state = 0;
+        st = 0;
     }
 
+    *state = st;
+
     return NGX_OK;
 }
 
 
-
 static ngx_inline ngx_int_t
 ngx_http_huff_decode_bits(u_char *state, u_char *ending, ngx_uint_t bits,
     u_char **dst)
@@ -2712,3 +4143,26 @@ ngx_http_huff_decode_bits(u_char *state, u_char *ending, ngx_uint_t bits,
 
     return NGX_OK;
 }
+
+
+static ngx_inline ngx_int_t
+ngx_http_huff_decode_bit(u_char *state, u_char *ending, ngx_uint_t bit,
+    u_char **dst)
+{
+    ngx_http_huff_decode_code_t  code;
+
+    code = ngx_http_huff_decode_bit_codes[*state][bit];
+
+    if (code.next == *state) {
+        return NGX_ERROR;
+    }
+
+    if (code.emit) {
+        *(*dst)++ = code.sym;
+    }
+
+    *ending = code.ending;
+    *state = code.next;
+
+    return NGX_OK;
+}
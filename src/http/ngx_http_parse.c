@@ -98,6 +98,50 @@ static uint32_t  usual[] = {
 #endif
 
 
+#if (NGX_HAVE_SSE42)
+
+static u_char *ngx_http_parse_find_sse42(u_char *p, u_char *last,
+    u_char *ranges, int len);
+static u_char *ngx_http_parse_span_sse42(u_char *p, u_char *last,
+    u_char *ranges, int len);
+
+
+/*
+ * the byte ranges which stop the runs of characters the state
+ * machines below consume without any action in the given state,
+ * padded to 16 bytes for the unaligned vector load
+ */
+
+static u_char  ngx_http_check_uri_ranges[16] = {
+    0x00, 0x20, '#', '#', '%', '%', '+', '+', '.', '/', '?', '?', 0x7f, 0x7f,
+#if (NGX_WIN32)
+    '\\', '\\'
+#endif
+};
+
+#if (NGX_WIN32)
+#define NGX_HTTP_CHECK_URI_RANGES_LEN  16
+#else
+#define NGX_HTTP_CHECK_URI_RANGES_LEN  14
+#endif
+
+static u_char  ngx_http_uri_ranges[16] = {
+    0x00, 0x20, '#', '#', 0x7f, 0x7f
+};
+
+static u_char  ngx_http_header_value_ranges[16] = {
+    '\0', '\0', LF, LF, CR, CR, ' ', ' '
+};
+
+/* the characters which have a lowcase mapping in a header name */
+
+static u_char  ngx_http_header_name_ranges[16] = {
+    '-', '-', '0', '9', 'A', 'Z', 'a', 'z'
+};
+
+#endif
+
+
 /* gcc, icc, msvc and others compile these switches as an jump table */
 
 ngx_int_t
@@ -537,6 +581,15 @@ ngx_http_parse_request_line(ngx_http_request_t *r, ngx_buf_t *b)
         /* check "/", "%" and "\" (Win32) in URI */
         case sw_check_uri:
 
+#if (NGX_HAVE_SSE42)
+            if ((ngx_cpu_features & NGX_CPU_SSE42) && b->last - p > 16) {
+                p = ngx_http_parse_find_sse42(p, b->last,
+                                              ngx_http_check_uri_ranges,
+                                              NGX_HTTP_CHECK_URI_RANGES_LEN);
+                ch = *p;
+            }
+#endif
+
             if (usual[ch >> 5] & (1U << (ch & 0x1f))) {
                 break;
             }
@@ -601,6 +654,14 @@ ngx_http_parse_request_line(ngx_http_request_t *r, ngx_buf_t *b)
         /* URI */
         case sw_uri:
 
+#if (NGX_HAVE_SSE42)
+            if ((ngx_cpu_features & NGX_CPU_SSE42) && b->last - p > 16) {
+                p = ngx_http_parse_find_sse42(p, b->last,
+                                              ngx_http_uri_ranges, 6);
+                ch = *p;
+            }
+#endif
+
             if (usual[ch >> 5] & (1U << (ch & 0x1f))) {
                 break;
             }
@@ -816,7 +877,7 @@ ngx_int_t
 ngx_http_parse_header_line(ngx_http_request_t *r, ngx_buf_t *b,
     ngx_uint_t allow_underscores)
 {
-    u_char      c, ch, *p;
+    u_char      c, ch, *p, *m;
     ngx_uint_t  hash, i;
     enum {
         sw_start = 0,
@@ -906,6 +967,23 @@ ngx_http_parse_header_line(ngx_http_request_t *r, ngx_buf_t *b,
 
         /* header name */
         case sw_name:
+
+#if (NGX_HAVE_SSE42)
+            if ((ngx_cpu_features & NGX_CPU_SSE42) && b->last - p > 16) {
+                m = ngx_http_parse_span_sse42(p, b->last,
+                                              ngx_http_header_name_ranges, 8);
+
+                while (p < m) {
+                    c = lowcase[*p++];
+                    hash = ngx_hash(hash, c);
+                    r->lowcase_header[i++] = c;
+                    i &= (NGX_HTTP_LC_HEADER_LEN - 1);
+                }
+
+                ch = *p;
+            }
+#endif
+
             c = lowcase[ch];
 
             if (c) {
@@ -994,6 +1072,15 @@ ngx_http_parse_header_line(ngx_http_request_t *r, ngx_buf_t *b,
 
         /* header value */
         case sw_value:
+
+#if (NGX_HAVE_SSE42)
+            if ((ngx_cpu_features & NGX_CPU_SSE42) && b->last - p > 16) {
+                p = ngx_http_parse_find_sse42(p, b->last,
+                                              ngx_http_header_value_ranges, 8);
+                ch = *p;
+            }
+#endif
+
             switch (ch) {
             case ' ':
                 r->header_end = p;
@@ -2404,3 +2491,69 @@ invalid:
 
     return NGX_ERROR;
 }
+
+
+#if (NGX_HAVE_SSE42)
+
+/*
+ * the functions below are called only if more than 16 bytes are left
+ * in the buffer, and always return a pointer before its end: either
+ * to the stop byte found, or to the start of the unscanned tail
+ */
+
+__attribute__((target("sse4.2")))
+static u_char *
+ngx_http_parse_find_sse42(u_char *p, u_char *last, u_char *ranges, int len)
+{
+    int      n;
+    __m128i  r, v;
+
+    r = _mm_loadu_si128((__m128i *) ranges);
+
+    do {
+        v = _mm_loadu_si128((__m128i *) p);
+
+        n = _mm_cmpestri(r, len, v, 16,
+                         _SIDD_UBYTE_OPS|_SIDD_CMP_RANGES
+                         |_SIDD_LEAST_SIGNIFICANT);
+
+        if (n != 16) {
+            return p + n;
+        }
+
+        p += 16;
+
+    } while (last - p > 16);
+
+    return p;
+}
+
+
+__attribute__((target("sse4.2")))
+static u_char *
+ngx_http_parse_span_sse42(u_char *p, u_char *last, u_char *ranges, int len)
+{
+    int      n;
+    __m128i  r, v;
+
+    r = _mm_loadu_si128((__m128i *) ranges);
+
+    do {
+        v = _mm_loadu_si128((__m128i *) p);
+
+        n = _mm_cmpestri(r, len, v, 16,
+                         _SIDD_UBYTE_OPS|_SIDD_CMP_RANGES
+                         |_SIDD_NEGATIVE_POLARITY|_SIDD_LEAST_SIGNIFICANT);
+
+        if (n != 16) {
+            return p + n;
+        }
+
+        p += 16;
+
+    } while (last - p > 16);
+
+    return p;
+}
+
+#endif
@@ -52,7 +52,6 @@ static ngx_int_t ngx_http_upstream_test_next(ngx_http_request_t *r,
     ngx_http_upstream_t *u);
 static ngx_int_t ngx_http_upstream_intercept_errors(ngx_http_request_t *r,
     ngx_http_upstream_t *u);
-static ngx_int_t ngx_http_upstream_test_connect(ngx_connection_t *c);
 static ngx_int_t ngx_http_upstream_process_headers(ngx_http_request_t *r,
     ngx_http_upstream_t *u);
 static ngx_int_t ngx_http_upstream_process_trailers(ngx_http_request_t *r,
@@ -95,6 +94,25 @@ static void ngx_http_upstream_dummy_handler(ngx_http_request_t *r,
     ngx_http_upstream_t *u);
 static void ngx_http_upstream_next(ngx_http_request_t *r,
     ngx_http_upstream_t *u, ngx_uint_t ft_type);
+static void ngx_http_upstream_hedge_arm(ngx_http_request_t *r,
+    ngx_http_upstream_t *u);
+static void ngx_http_upstream_hedge_timer_handler(ngx_event_t *ev);
+static void ngx_http_upstream_hedge_start(ngx_http_request_t *r,
+    ngx_http_upstream_t *u);
+static ngx_int_t ngx_http_upstream_hedge_get_peer(ngx_peer_connection_t *pc,
+    void *data);
+static void ngx_http_upstream_hedge_free_peer(ngx_peer_connection_t *pc,
+    void *data, ngx_uint_t state);
+static void ngx_http_upstream_hedge_handler(ngx_event_t *ev);
+static void ngx_http_upstream_hedge_send(ngx_http_request_t *r,
+    ngx_http_upstream_t *u);
+static void ngx_http_upstream_hedge_read(ngx_http_request_t *r,
+    ngx_http_upstream_t *u);
+static void ngx_http_upstream_hedge_promote(ngx_http_request_t *r,
+    ngx_http_upstream_t *u);
+static void ngx_http_upstream_hedge_cancel(ngx_http_request_t *r,
+    ngx_http_upstream_t *u, ngx_uint_t state);
+static void ngx_http_upstream_close_peer_connection(ngx_connection_t *c);
 static void ngx_http_upstream_cleanup(void *data);
 static void ngx_http_upstream_finalize_request(ngx_http_request_t *r,
     ngx_http_upstream_t *u, ngx_int_t rc);
@@ -449,6 +467,11 @@ static ngx_http_upstream_next_t  ngx_http_upstream_next_errors[] = {
 };
 
 
+/* the hedged requests budget of the worker, in percents of a request */
+
+static ngx_uint_t  ngx_http_upstream_hedge_tokens;
+
+
 ngx_conf_bitmask_t  ngx_http_upstream_cache_method_mask[] = {
     { ngx_string("GET"), NGX_HTTP_GET },
     { ngx_string("HEAD"), NGX_HTTP_HEAD },
@@ -2180,6 +2203,10 @@ ngx_http_upstream_send_request(ngx_http_request_t *r, ngx_http_upstream_t *u,
 
         ngx_add_timer(c->read, u->conf->read_timeout);
 
+        if (u->conf->hedge_after && u->hedge == NULL) {
+            ngx_http_upstream_hedge_arm(r, u);
+        }
+
         if (c->read->ready) {
             ngx_http_upstream_process_header(r, u);
             return;
@@ -2461,6 +2488,11 @@ ngx_http_upstream_process_header(ngx_http_request_t *r, ngx_http_upstream_t *u)
             return;
         }
 
+        if (u->hedge) {
+            /* the response arrived first, the hedged request is not needed */
+            ngx_http_upstream_hedge_cancel(r, u, 0);
+        }
+
         u->state->bytes_received += n;
 
         u->buffer.last += n;
@@ -2759,7 +2791,7 @@ ngx_http_upstream_intercept_errors(ngx_http_request_t *r,
 }
 
 
-static ngx_int_t
+ngx_int_t
 ngx_http_upstream_test_connect(ngx_connection_t *c)
 {
     int        err;
@@ -4412,6 +4444,14 @@ ngx_http_upstream_next(ngx_http_request_t *r, ngx_http_upstream_t *u,
 
     u->state->status = status;
 
+    if (u->hedge && u->hedge->sent && u->hedge->peer.connection) {
+
+        /* the hedged request is already in flight, continue with it */
+
+        ngx_http_upstream_hedge_promote(r, u);
+        return;
+    }
+
     timeout = u->conf->next_upstream_timeout;
 
     if (u->request_sent
@@ -4485,6 +4525,579 @@ ngx_http_upstream_next(ngx_http_request_t *r, ngx_http_upstream_t *u,
 }
 
 
+static void
+ngx_http_upstream_hedge_arm(ngx_http_request_t *r, ngx_http_upstream_t *u)
+{
+    ngx_chain_t                *cl;
+    ngx_http_upstream_conf_t   *conf;
+    ngx_http_upstream_hedge_t  *hedge;
+
+    /*
+     * only idempotent requests which can be resent from memory
+     * are hedged, at most once per request
+     */
+
+    if (!(r->method & (NGX_HTTP_GET|NGX_HTTP_HEAD))
+        || u->upstream == NULL
+        || u->ssl
+        || r->request_body_no_buffering)
+    {
+        return;
+    }
+
+    for (cl = u->request_bufs; cl; cl = cl->next) {
+        if (cl->buf->in_file) {
+            return;
+        }
+    }
+
+    hedge = ngx_pcalloc(r->pool, sizeof(ngx_http_upstream_hedge_t));
+    if (hedge == NULL) {
+        return;
+    }
+
+    hedge->timer.handler = ngx_http_upstream_hedge_timer_handler;
+    hedge->timer.data = r;
+    hedge->timer.log = r->connection->log;
+
+    u->hedge = hedge;
+
+    /*
+     * each eligible request adds hedge_budget percents of a hedged
+     * request to the per-worker budget, a hedged request costs 100
+     */
+
+    conf = u->conf;
+
+    ngx_http_upstream_hedge_tokens += conf->hedge_budget;
+
+    if (ngx_http_upstream_hedge_tokens > NGX_HTTP_UPSTREAM_HEDGE_BURST * 100) {
+        ngx_http_upstream_hedge_tokens = NGX_HTTP_UPSTREAM_HEDGE_BURST * 100;
+    }
+
+    ngx_add_timer(&hedge->timer, conf->hedge_after);
+}
+
+
+static void
+ngx_http_upstream_hedge_timer_handler(ngx_event_t *ev)
+{
+    ngx_connection_t     *c;
+    ngx_http_request_t   *r;
+    ngx_http_upstream_t  *u;
+
+    r = ev->data;
+    u = r->upstream;
+    c = r->connection;
+
+    ngx_http_set_log_request(c->log, r);
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "http upstream hedge timer");
+
+    ngx_http_upstream_hedge_start(r, u);
+
+    ngx_http_run_posted_requests(c);
+}
+
+
+static void
+ngx_http_upstream_hedge_start(ngx_http_request_t *r, ngx_http_upstream_t *u)
+{
+    ngx_int_t                   rc;
+    ngx_connection_t           *c;
+    ngx_peer_connection_t       peer;
+    ngx_http_upstream_conf_t   *conf;
+    ngx_http_upstream_hedge_t  *hedge;
+
+    hedge = u->hedge;
+    conf = u->conf;
+
+    if (u->peer.connection == NULL
+        || u->peer.sockaddr == NULL
+        || !u->request_body_sent
+        || u->state->bytes_received)
+    {
+        return;
+    }
+
+    if (ngx_http_upstream_hedge_tokens < 100) {
+        ngx_log_debug0(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                       "http upstream hedge budget exceeded");
+        return;
+    }
+
+    ngx_http_upstream_hedge_tokens -= 100;
+
+    /*
+     * the hedged request uses its own instance of the balancer data,
+     * so both attempts can be freed independently
+     */
+
+    peer = u->peer;
+
+    u->peer.data = NULL;
+
+    if (u->upstream->peer.init(r, u->upstream) != NGX_OK) {
+        u->peer = peer;
+        return;
+    }
+
+    hedge->peer = u->peer;
+    u->peer = peer;
+
+    hedge->peer.connection = NULL;
+    hedge->peer.sockaddr = NULL;
+    hedge->peer.socklen = 0;
+    hedge->peer.name = NULL;
+    hedge->peer.cached = 0;
+    hedge->peer.start_time = ngx_current_msec;
+
+    if (conf->next_upstream_tries
+        && hedge->peer.tries > conf->next_upstream_tries)
+    {
+        hedge->peer.tries = conf->next_upstream_tries;
+    }
+
+    hedge->original_get_peer = hedge->peer.get;
+    hedge->original_free_peer = hedge->peer.free;
+    hedge->data = hedge->peer.data;
+
+    hedge->peer.get = ngx_http_upstream_hedge_get_peer;
+    hedge->peer.free = ngx_http_upstream_hedge_free_peer;
+    hedge->peer.data = hedge;
+
+    ngx_memcpy(&hedge->avoid, u->peer.sockaddr, u->peer.socklen);
+    hedge->avoid_len = u->peer.socklen;
+
+    hedge->start_time = ngx_current_msec;
+    hedge->connect_time = (ngx_msec_t) -1;
+
+    rc = ngx_event_connect_peer(&hedge->peer);
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "http upstream hedge connect: %i", rc);
+
+    if (rc == NGX_ERROR || rc == NGX_BUSY || rc == NGX_DECLINED) {
+        ngx_http_upstream_hedge_cancel(r, u,
+                                  rc == NGX_DECLINED ? NGX_PEER_FAILED : 0);
+        return;
+    }
+
+    /* rc == NGX_OK || rc == NGX_AGAIN || rc == NGX_DONE */
+
+    c = hedge->peer.connection;
+
+    c->requests++;
+
+    c->data = r;
+
+    c->write->handler = ngx_http_upstream_hedge_handler;
+    c->read->handler = ngx_http_upstream_hedge_handler;
+
+    if (c->pool == NULL) {
+        c->pool = ngx_create_pool(128, r->connection->log);
+        if (c->pool == NULL) {
+            ngx_http_upstream_hedge_cancel(r, u, 0);
+            return;
+        }
+    }
+
+    c->log = r->connection->log;
+    c->pool->log = c->log;
+    c->read->log = c->log;
+    c->write->log = c->log;
+
+    if (rc == NGX_AGAIN) {
+        ngx_add_timer(c->write, conf->connect_timeout);
+        return;
+    }
+
+    ngx_http_upstream_hedge_send(r, u);
+}
+
+
+static ngx_int_t
+ngx_http_upstream_hedge_get_peer(ngx_peer_connection_t *pc, void *data)
+{
+    ngx_http_upstream_hedge_t  *hedge = data;
+
+    ngx_int_t   rc;
+    ngx_uint_t  n;
+
+    for (n = 0; /* void */; n++) {
+
+        rc = hedge->original_get_peer(pc, hedge->data);
+
+        if (rc != NGX_OK && rc != NGX_DONE) {
+            return rc;
+        }
+
+        if (hedge->avoid_len == 0
+            || ngx_cmp_sockaddr(pc->sockaddr, pc->socklen,
+                                &hedge->avoid.sockaddr, hedge->avoid_len, 1)
+               != NGX_OK)
+        {
+            return rc;
+        }
+
+        /* the peer already serves the request, try another one */
+
+        hedge->original_free_peer(pc, hedge->data, 0);
+        pc->sockaddr = NULL;
+
+        if (pc->connection) {
+            ngx_http_upstream_close_peer_connection(pc->connection);
+            pc->connection = NULL;
+        }
+
+        if (n == 1) {
+            return NGX_BUSY;
+        }
+    }
+}
+
+
+static void
+ngx_http_upstream_hedge_free_peer(ngx_peer_connection_t *pc, void *data,
+    ngx_uint_t state)
+{
+    ngx_http_upstream_hedge_t  *hedge = data;
+
+    hedge->original_free_peer(pc, hedge->data, state);
+}
+
+
+static void
+ngx_http_upstream_hedge_handler(ngx_event_t *ev)
+{
+    ngx_connection_t     *c;
+    ngx_http_request_t   *r;
+    ngx_http_upstream_t  *u;
+
+    c = ev->data;
+    r = c->data;
+
+    u = r->upstream;
+    c = r->connection;
+
+    ngx_http_set_log_request(c->log, r);
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "http upstream hedge handler: %d", ev->write);
+
+    if (ev->timedout) {
+        ngx_log_error(NGX_LOG_ERR, c->log, NGX_ETIMEDOUT,
+                      "upstream timed out while processing hedged request");
+        ngx_http_upstream_hedge_cancel(r, u, NGX_PEER_FAILED);
+
+    } else if (ev->write) {
+
+        if (u->hedge->sent) {
+            if (ngx_handle_write_event(ev, 0) != NGX_OK) {
+                ngx_http_upstream_hedge_cancel(r, u, 0);
+            }
+
+        } else {
+            ngx_http_upstream_hedge_send(r, u);
+        }
+
+    } else {
+        ngx_http_upstream_hedge_read(r, u);
+    }
+
+    ngx_http_run_posted_requests(c);
+}
+
+
+static void
+ngx_http_upstream_hedge_send(ngx_http_request_t *r, ngx_http_upstream_t *u)
+{
+    ngx_buf_t                  *b;
+    ngx_chain_t                *cl, *out, **ll;
+    ngx_connection_t           *c;
+    ngx_http_upstream_hedge_t  *hedge;
+
+    hedge = u->hedge;
+    c = hedge->peer.connection;
+
+    if (hedge->connect_time == (ngx_msec_t) -1) {
+
+        if (ngx_http_upstream_test_connect(c) != NGX_OK) {
+            ngx_http_upstream_hedge_cancel(r, u, NGX_PEER_FAILED);
+            return;
+        }
+
+        hedge->connect_time = ngx_current_msec - hedge->start_time;
+
+        /* the request as it was created, see ngx_http_upstream_reinit() */
+
+        ll = &hedge->out;
+
+        for (cl = u->request_bufs; cl; cl = cl->next) {
+
+            if (cl->buf->last == cl->buf->start) {
+                continue;
+            }
+
+            b = ngx_calloc_buf(r->pool);
+            if (b == NULL) {
+                ngx_http_upstream_hedge_cancel(r, u, 0);
+                return;
+            }
+
+            b->start = cl->buf->start;
+            b->pos = cl->buf->start;
+            b->last = cl->buf->last;
+            b->end = cl->buf->last;
+            b->memory = 1;
+
+            *ll = ngx_alloc_chain_link(r->pool);
+            if (*ll == NULL) {
+                ngx_http_upstream_hedge_cancel(r, u, 0);
+                return;
+            }
+
+            (*ll)->buf = b;
+            ll = &(*ll)->next;
+        }
+
+        *ll = NULL;
+    }
+
+    c->log->action = "sending hedged request to upstream";
+
+    out = c->send_chain(c, hedge->out, 0);
+
+    if (out == NGX_CHAIN_ERROR) {
+        ngx_http_upstream_hedge_cancel(r, u, NGX_PEER_FAILED);
+        return;
+    }
+
+    hedge->out = out;
+
+    if (out) {
+        ngx_add_timer(c->write, u->conf->send_timeout);
+
+        if (ngx_handle_write_event(c->write, 0) != NGX_OK) {
+            ngx_http_upstream_hedge_cancel(r, u, 0);
+        }
+
+        return;
+    }
+
+    if (c->write->timer_set) {
+        ngx_del_timer(c->write);
+    }
+
+    hedge->sent = 1;
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "http upstream hedged request sent");
+
+    if (ngx_handle_write_event(c->write, 0) != NGX_OK) {
+        ngx_http_upstream_hedge_cancel(r, u, 0);
+        return;
+    }
+
+    ngx_add_timer(c->read, u->conf->read_timeout);
+
+    if (c->read->ready) {
+        ngx_http_upstream_hedge_read(r, u);
+        return;
+    }
+
+    if (ngx_handle_read_event(c->read, 0) != NGX_OK) {
+        ngx_http_upstream_hedge_cancel(r, u, 0);
+    }
+}
+
+
+static void
+ngx_http_upstream_hedge_read(ngx_http_request_t *r, ngx_http_upstream_t *u)
+{
+    int                n;
+    char               buf[1];
+    ngx_err_t          err;
+    ngx_connection_t  *c;
+
+    c = u->hedge->peer.connection;
+
+    if (!u->hedge->sent) {
+        /* a response before the request was sent */
+        ngx_http_upstream_hedge_cancel(r, u, NGX_PEER_FAILED);
+        return;
+    }
+
+    /*
+     * only a response wins the race, a connection closed or reset
+     * by the hedge peer fails the hedged request alone
+     */
+
+    n = recv(c->fd, buf, 1, MSG_PEEK);
+
+    err = ngx_socket_errno;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, err,
+                   "http upstream hedge recv(): %d", n);
+
+    if (n > 0) {
+        ngx_http_upstream_hedge_promote(r, u);
+        return;
+    }
+
+    if (n == -1 && err == NGX_EAGAIN) {
+        c->read->ready = 0;
+
+        if (ngx_handle_read_event(c->read, 0) != NGX_OK) {
+            ngx_http_upstream_hedge_cancel(r, u, 0);
+        }
+
+        return;
+    }
+
+    if (n == 0) {
+        ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                      "upstream prematurely closed hedged connection");
+
+    } else {
+        ngx_log_error(NGX_LOG_ERR, c->log, err,
+                      "hedged connection recv() failed");
+    }
+
+    ngx_http_upstream_hedge_cancel(r, u, NGX_PEER_FAILED);
+}
+
+
+static void
+ngx_http_upstream_hedge_promote(ngx_http_request_t *r, ngx_http_upstream_t *u)
+{
+    ngx_connection_t           *c;
+    ngx_http_upstream_hedge_t  *hedge;
+
+    hedge = u->hedge;
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "http upstream hedged request won");
+
+    /* the original attempt lost the race */
+
+    if (u->state->response_time == (ngx_msec_t) -1) {
+        u->state->response_time = ngx_current_msec - u->start_time;
+    }
+
+    if (u->peer.connection) {
+        u->state->bytes_sent = u->peer.connection->sent;
+    }
+
+    if (u->peer.sockaddr) {
+        u->peer.free(&u->peer, u->peer.data, 0);
+        u->peer.sockaddr = NULL;
+    }
+
+    if (u->peer.connection) {
+        ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                       "close http upstream connection: %d",
+                       u->peer.connection->fd);
+
+        ngx_http_upstream_close_peer_connection(u->peer.connection);
+    }
+
+    u->peer = hedge->peer;
+
+    hedge->peer.connection = NULL;
+    hedge->peer.sockaddr = NULL;
+    hedge->avoid_len = 0;
+
+    u->state = ngx_array_push(r->upstream_states);
+    if (u->state == NULL) {
+        ngx_http_upstream_finalize_request(r, u,
+                                           NGX_HTTP_INTERNAL_SERVER_ERROR);
+        return;
+    }
+
+    ngx_memzero(u->state, sizeof(ngx_http_upstream_state_t));
+
+    u->start_time = hedge->start_time;
+
+    u->state->peer = u->peer.name;
+    u->state->response_time = (ngx_msec_t) -1;
+    u->state->connect_time = hedge->connect_time;
+    u->state->header_time = (ngx_msec_t) -1;
+
+    c = u->peer.connection;
+
+    c->write->handler = ngx_http_upstream_handler;
+    c->read->handler = ngx_http_upstream_handler;
+
+    u->writer.out = NULL;
+    u->writer.last = &u->writer.out;
+    u->writer.connection = c;
+
+    u->request_sent = 1;
+    u->request_body_sent = 1;
+
+    u->write_event_handler = ngx_http_upstream_dummy_handler;
+    u->read_event_handler = ngx_http_upstream_process_header;
+
+    ngx_http_upstream_process_header(r, u);
+}
+
+
+static void
+ngx_http_upstream_hedge_cancel(ngx_http_request_t *r, ngx_http_upstream_t *u,
+    ngx_uint_t state)
+{
+    ngx_uint_t                  keepalive;
+    ngx_http_upstream_hedge_t  *hedge;
+
+    hedge = u->hedge;
+
+    if (hedge->timer.timer_set) {
+        ngx_del_timer(&hedge->timer);
+    }
+
+    if (hedge->peer.sockaddr == NULL && hedge->peer.connection == NULL) {
+        return;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "http upstream hedge cancel: %ui", state);
+
+    if (hedge->peer.sockaddr) {
+
+        /*
+         * the connection has a request in flight, the keepalive
+         * module must not cache it as if it was the one completed
+         */
+
+        keepalive = u->keepalive;
+        u->keepalive = 0;
+
+        hedge->peer.free(&hedge->peer, hedge->peer.data, state);
+        hedge->peer.sockaddr = NULL;
+
+        u->keepalive = keepalive;
+    }
+
+    if (hedge->peer.connection) {
+        ngx_http_upstream_close_peer_connection(hedge->peer.connection);
+        hedge->peer.connection = NULL;
+    }
+}
+
+
+static void
+ngx_http_upstream_close_peer_connection(ngx_connection_t *c)
+{
+    if (c->pool) {
+        ngx_destroy_pool(c->pool);
+    }
+
+    ngx_close_connection(c);
+}
+
+
 static void
 ngx_http_upstream_cleanup(void *data)
 {
@@ -4515,6 +5128,10 @@ ngx_http_upstream_finalize_request(ngx_http_request_t *r,
     *u->cleanup = NULL;
     u->cleanup = NULL;
 
+    if (u->hedge) {
+        ngx_http_upstream_hedge_cancel(r, u, 0);
+    }
+
     if (u->resolved && u->resolved->ctx) {
         ngx_resolve_name_done(u->resolved->ctx);
         u->resolved->ctx = NULL;
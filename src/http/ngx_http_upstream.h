@@ -45,6 +45,9 @@
 #define NGX_HTTP_UPSTREAM_INVALID_HEADER     40
 
 
+#define NGX_HTTP_UPSTREAM_HEDGE_BURST        10
+
+
 #define NGX_HTTP_UPSTREAM_IGN_XA_REDIRECT    0x00000002
 #define NGX_HTTP_UPSTREAM_IGN_XA_EXPIRES     0x00000004
 #define NGX_HTTP_UPSTREAM_IGN_EXPIRES        0x00000008
@@ -153,6 +156,7 @@ typedef struct {
     ngx_msec_t                       send_timeout;
     ngx_msec_t                       read_timeout;
     ngx_msec_t                       next_upstream_timeout;
+    ngx_msec_t                       hedge_after;
 
     size_t                           send_lowat;
     size_t                           buffer_size;
@@ -172,6 +176,7 @@ typedef struct {
     ngx_uint_t                       next_upstream;
     ngx_uint_t                       store_access;
     ngx_uint_t                       next_upstream_tries;
+    ngx_uint_t                       hedge_budget;
     ngx_flag_t                       buffering;
     ngx_flag_t                       request_buffering;
     ngx_flag_t                       pass_request_headers;
@@ -318,6 +323,26 @@ typedef void (*ngx_http_upstream_handler_pt)(ngx_http_request_t *r,
     ngx_http_upstream_t *u);
 
 
+typedef struct {
+    ngx_peer_connection_t            peer;
+    ngx_event_t                      timer;
+
+    ngx_chain_t                     *out;
+
+    ngx_event_get_peer_pt            original_get_peer;
+    ngx_event_free_peer_pt           original_free_peer;
+    void                            *data;
+
+    ngx_sockaddr_t                   avoid;
+    socklen_t                        avoid_len;
+
+    ngx_msec_t                       start_time;
+    ngx_msec_t                       connect_time;
+
+    unsigned                         sent:1;
+} ngx_http_upstream_hedge_t;
+
+
 struct ngx_http_upstream_s {
     ngx_http_upstream_handler_pt     read_event_handler;
     ngx_http_upstream_handler_pt     write_event_handler;
@@ -341,6 +366,8 @@ struct ngx_http_upstream_s {
 
     ngx_http_upstream_resolved_t    *resolved;
 
+    ngx_http_upstream_hedge_t       *hedge;
+
     ngx_buf_t                        from_client;
 
     ngx_buf_t                        buffer;
@@ -419,6 +446,7 @@ ngx_int_t ngx_http_upstream_create(ngx_http_request_t *r);
 void ngx_http_upstream_init(ngx_http_request_t *r);
 ngx_int_t ngx_http_upstream_non_buffered_filter_init(void *data);
 ngx_int_t ngx_http_upstream_non_buffered_filter(void *data, ssize_t bytes);
+ngx_int_t ngx_http_upstream_test_connect(ngx_connection_t *c);
 ngx_http_upstream_srv_conf_t *ngx_http_upstream_add(ngx_conf_t *cf,
     ngx_url_t *u, ngx_uint_t flags);
 char *ngx_http_upstream_bind_set_slot(ngx_conf_t *cf, ngx_command_t *cmd,
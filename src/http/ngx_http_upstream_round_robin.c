@@ -18,6 +18,14 @@
                                     + ((p)->next ? (p)->next->tries : 0))
 
 
+#define NGX_HTTP_UPSTREAM_RR_SCHEDULE_MAX  65536
+#define NGX_HTTP_UPSTREAM_RR_PROBES        4
+
+
+static ngx_int_t ngx_http_upstream_init_schedule(ngx_conf_t *cf,
+    ngx_http_upstream_rr_peers_t *peers);
+static ngx_http_upstream_rr_peer_t *ngx_http_upstream_get_scheduled_peer(
+    ngx_http_upstream_rr_peer_data_t *rrp);
 static ngx_http_upstream_rr_peer_t *ngx_http_upstream_get_peer(
     ngx_http_upstream_rr_peer_data_t *rrp);
 
@@ -116,6 +124,10 @@ ngx_http_upstream_init_round_robin(ngx_conf_t *cf,                      // ту
 
         us->peer.data = peers;                                          // присваиваем в upstream итоговый список адресов
 
+        if (ngx_http_upstream_init_schedule(cf, peers) != NGX_OK) {
+            return NGX_ERROR;
+        }
+
         /* backup servers */
 
         n = 0;                                                          // еще раз то же самое, для адресов backup серверов
@@ -186,6 +198,10 @@ ngx_http_upstream_init_round_robin(ngx_conf_t *cf,                      // ту
 
         peers->next = backup;
 
+        if (ngx_http_upstream_init_schedule(cf, backup) != NGX_OK) {
+            return NGX_ERROR;
+        }
+
         return NGX_OK;
     }
 
@@ -457,6 +473,26 @@ ngx_http_upstream_get_round_robin_peer(ngx_peer_connection_t *pc, void *data)
     pc->connection = NULL;
 
     peers = rrp->peers;
+
+    if (peers->schedule) {
+        ngx_http_upstream_rr_peers_rlock(peers);
+
+        peer = ngx_http_upstream_get_scheduled_peer(rrp);
+
+        ngx_http_upstream_rr_peers_unlock(peers);
+
+        if (peer) {
+            ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                           "get rr peer, scheduled: %p", peer);
+
+            pc->sockaddr = peer->sockaddr;
+            pc->socklen = peer->socklen;
+            pc->name = &peer->name;
+
+            return NGX_OK;
+        }
+    }
+
     ngx_http_upstream_rr_peers_wlock(peers);
 
     if (peers->single) {                                                        // если 1 peer, просто выдаем его (если он есть)
@@ -531,6 +567,163 @@ failed:
 }
 
 
+/*
+ * The smooth weighted round-robin sequence of a peer set is computed once
+ * for static weights reduced by their gcd, and is walked with a shared
+ * cursor.  Peers that were tried, failed, or are still recovering their
+ * effective weight are left to ngx_http_upstream_get_peer().
+ */
+
+static ngx_int_t
+ngx_http_upstream_init_schedule(ngx_conf_t *cf,
+    ngx_http_upstream_rr_peers_t *peers)
+{
+    ngx_int_t                     *cw;
+    ngx_uint_t                     i, k, g, a, b, len, best;
+    ngx_http_upstream_rr_peer_t   *peer;
+
+    if (peers->number < 2) {
+        return NGX_OK;
+    }
+
+    g = 0;
+
+    for (peer = peers->peer; peer; peer = peer->next) {
+        if (peer->down) {
+            continue;
+        }
+
+        for (a = g, b = peer->weight; b; /* void */) {
+            k = a % b;
+            a = b;
+            b = k;
+        }
+
+        g = a;
+    }
+
+    if (g == 0) {
+        return NGX_OK;
+    }
+
+    len = 0;
+
+    for (peer = peers->peer; peer; peer = peer->next) {
+        if (!peer->down) {
+            len += peer->weight / g;
+        }
+    }
+
+    if (len > NGX_HTTP_UPSTREAM_RR_SCHEDULE_MAX) {
+        return NGX_OK;
+    }
+
+    peers->index = ngx_palloc(cf->pool,
+                              peers->number
+                              * sizeof(ngx_http_upstream_rr_peer_t *));
+    if (peers->index == NULL) {
+        return NGX_ERROR;
+    }
+
+    peers->schedule = ngx_palloc(cf->pool, len * sizeof(uint32_t));
+    if (peers->schedule == NULL) {
+        return NGX_ERROR;
+    }
+
+    cw = ngx_pcalloc(cf->temp_pool, peers->number * sizeof(ngx_int_t));
+    if (cw == NULL) {
+        return NGX_ERROR;
+    }
+
+    for (peer = peers->peer, i = 0; peer; peer = peer->next, i++) {
+        peers->index[i] = peer;
+    }
+
+    for (k = 0; k < len; k++) {
+        best = peers->number;
+
+        for (i = 0; i < peers->number; i++) {
+            peer = peers->index[i];
+
+            if (peer->down) {
+                continue;
+            }
+
+            cw[i] += peer->weight / g;
+
+            if (best == peers->number || cw[i] > cw[best]) {
+                best = i;
+            }
+        }
+
+        cw[best] -= len;
+        peers->schedule[k] = (uint32_t) best;
+    }
+
+    peers->nschedule = len;
+
+    return NGX_OK;
+}
+
+
+static ngx_http_upstream_rr_peer_t *
+ngx_http_upstream_get_scheduled_peer(ngx_http_upstream_rr_peer_data_t *rrp)
+{
+    time_t                         now;
+    uintptr_t                      m;
+    ngx_uint_t                     i, n, k;
+    ngx_http_upstream_rr_peer_t   *peer;
+    ngx_http_upstream_rr_peers_t  *peers;
+
+    now = ngx_time();
+
+    peers = rrp->peers;
+
+    for (k = 0; k < NGX_HTTP_UPSTREAM_RR_PROBES; k++) {
+
+        i = ngx_atomic_fetch_add(&peers->cursor, 1) % peers->nschedule;
+        i = peers->schedule[i];
+
+        n = i / (8 * sizeof(uintptr_t));
+        m = (uintptr_t) 1 << i % (8 * sizeof(uintptr_t));
+
+        if (rrp->tried[n] & m) {
+            continue;
+        }
+
+        peer = peers->index[i];
+
+        ngx_http_upstream_rr_peer_lock(peers, peer);
+
+        if (peer->down
+            || peer->effective_weight < peer->weight
+            || (peer->max_fails
+                && peer->fails >= peer->max_fails
+                && now - peer->checked <= peer->fail_timeout)
+            || (peer->max_conns && peer->conns >= peer->max_conns))
+        {
+            ngx_http_upstream_rr_peer_unlock(peers, peer);
+            continue;
+        }
+
+        peer->conns++;
+
+        if (now - peer->checked > peer->fail_timeout) {
+            peer->checked = now;
+        }
+
+        ngx_http_upstream_rr_peer_unlock(peers, peer);
+
+        rrp->current = peer;
+        rrp->tried[n] |= m;
+
+        return peer;
+    }
+
+    return NULL;
+}
+
+
 static ngx_http_upstream_rr_peer_t *
 ngx_http_upstream_get_peer(ngx_http_upstream_rr_peer_data_t *rrp)               // выбра пира из списка
 {
@@ -691,14 +884,17 @@ ngx_http_upstream_set_round_robin_peer_session(ngx_peer_connection_t *pc,
 {
     ngx_http_upstream_rr_peer_data_t  *rrp = data;
 
-    ngx_int_t                      rc;
-    ngx_ssl_session_t             *ssl_session;
-    ngx_http_upstream_rr_peer_t   *peer;
+    ngx_int_t                        rc;
+    ngx_ssl_session_t               *ssl_session;
+    ngx_http_upstream_rr_peer_t     *peer;
 #if (NGX_HTTP_UPSTREAM_ZONE)
-    int                            len;
-    const u_char                  *p;
-    ngx_http_upstream_rr_peers_t  *peers;
-    u_char                         buf[NGX_SSL_MAX_SESSION_SIZE];
+    int                              len;
+    time_t                           now;
+    ngx_uint_t                       i, n;
+    const u_char                    *p;
+    ngx_http_upstream_rr_peers_t    *peers;
+    ngx_http_upstream_rr_session_t  *session;
+    u_char                           buf[NGX_SSL_MAX_SESSION_SIZE];
 #endif
 
     peer = rrp->current;
@@ -710,15 +906,42 @@ ngx_http_upstream_set_round_robin_peer_session(ngx_peer_connection_t *pc,
         ngx_http_upstream_rr_peers_rlock(peers);
         ngx_http_upstream_rr_peer_lock(peers, peer);
 
-        if (peer->ssl_session == NULL) {
+        session = NULL;
+
+        if (peer->ssl_sessions) {
+            now = ngx_time();
+
+            /* the most recently saved session first */
+
+            for (i = 1; i <= NGX_HTTP_UPSTREAM_RR_SESSIONS; i++) {
+                n = (peer->ssl_session_next - i)
+                    & (NGX_HTTP_UPSTREAM_RR_SESSIONS - 1);
+
+                session = &peer->ssl_sessions[n];
+
+                if (session->len && session->expire > now) {
+                    break;
+                }
+
+                session = NULL;
+            }
+        }
+
+        if (session == NULL) {
             ngx_http_upstream_rr_peer_unlock(peers, peer);
             ngx_http_upstream_rr_peers_unlock(peers);
             return NGX_OK;
         }
 
-        len = peer->ssl_session_len;
+        len = session->len;
+
+        ngx_memcpy(buf, session->data, len);
 
-        ngx_memcpy(buf, peer->ssl_session, len);
+        /* TLS 1.3 tickets are not reused by different connections */
+
+        if (session->single) {
+            session->len = 0;
+        }
 
         ngx_http_upstream_rr_peer_unlock(peers, peer);
         ngx_http_upstream_rr_peers_unlock(peers);
@@ -754,13 +977,16 @@ ngx_http_upstream_save_round_robin_peer_session(ngx_peer_connection_t *pc,
 {
     ngx_http_upstream_rr_peer_data_t  *rrp = data;
 
-    ngx_ssl_session_t             *old_ssl_session, *ssl_session;
-    ngx_http_upstream_rr_peer_t   *peer;
+    ngx_ssl_session_t               *old_ssl_session, *ssl_session;
+    ngx_http_upstream_rr_peer_t     *peer;
 #if (NGX_HTTP_UPSTREAM_ZONE)
-    int                            len;
-    u_char                        *p;
-    ngx_http_upstream_rr_peers_t  *peers;
-    u_char                         buf[NGX_SSL_MAX_SESSION_SIZE];
+    int                              len;
+    time_t                           expire;
+    u_char                          *p;
+    ngx_uint_t                       single;
+    ngx_http_upstream_rr_peers_t    *peers;
+    ngx_http_upstream_rr_session_t  *session;
+    u_char                           buf[NGX_SSL_MAX_SESSION_SIZE];
 #endif
 
 #if (NGX_HTTP_UPSTREAM_ZONE)
@@ -774,6 +1000,19 @@ ngx_http_upstream_save_round_robin_peer_session(ngx_peer_connection_t *pc,
             return;
         }
 
+#ifdef TLS1_3_VERSION
+        single = (SSL_SESSION_get_protocol_version(ssl_session)
+                  >= TLS1_3_VERSION);
+#else
+        single = 0;
+#endif
+
+        /* a resumed TLS 1.2 session is already in the pool */
+
+        if (!single && SSL_session_reused(pc->connection->ssl->connection)) {
+            return;
+        }
+
         ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
                        "save session: %p", ssl_session);
 
@@ -788,34 +1027,57 @@ ngx_http_upstream_save_round_robin_peer_session(ngx_peer_connection_t *pc,
         p = buf;
         (void) i2d_SSL_SESSION(ssl_session, &p);
 
+        expire = SSL_SESSION_get_time(ssl_session)
+                 + SSL_SESSION_get_timeout(ssl_session);
+
         peer = rrp->current;
 
         ngx_http_upstream_rr_peers_rlock(peers);
         ngx_http_upstream_rr_peer_lock(peers, peer);
 
-        if (len > peer->ssl_session_len) {
+        if (peer->ssl_sessions == NULL) {
+            peer->ssl_sessions = ngx_slab_calloc(peers->shpool,
+                                     NGX_HTTP_UPSTREAM_RR_SESSIONS
+                                     * sizeof(ngx_http_upstream_rr_session_t));
+
+            if (peer->ssl_sessions == NULL) {
+                ngx_http_upstream_rr_peer_unlock(peers, peer);
+                ngx_http_upstream_rr_peers_unlock(peers);
+                return;
+            }
+        }
+
+        session = &peer->ssl_sessions[peer->ssl_session_next++
+                                      & (NGX_HTTP_UPSTREAM_RR_SESSIONS - 1)];
+
+        if (len > session->size) {
             ngx_shmtx_lock(&peers->shpool->mutex);
 
-            if (peer->ssl_session) {
-                ngx_slab_free_locked(peers->shpool, peer->ssl_session);
+            if (session->data) {
+                ngx_slab_free_locked(peers->shpool, session->data);
             }
 
-            peer->ssl_session = ngx_slab_alloc_locked(peers->shpool, len);
+            session->data = ngx_slab_alloc_locked(peers->shpool, len);
 
             ngx_shmtx_unlock(&peers->shpool->mutex);
 
-            if (peer->ssl_session == NULL) {
-                peer->ssl_session_len = 0;
+            if (session->data == NULL) {
+                session->len = 0;
+                session->size = 0;
 
                 ngx_http_upstream_rr_peer_unlock(peers, peer);
                 ngx_http_upstream_rr_peers_unlock(peers);
                 return;
             }
 
-            peer->ssl_session_len = len;
+            session->size = len;
         }
 
-        ngx_memcpy(peer->ssl_session, buf, len);
+        ngx_memcpy(session->data, buf, len);
+
+        session->len = len;
+        session->expire = expire;
+        session->single = single;
 
         ngx_http_upstream_rr_peer_unlock(peers, peer);
         ngx_http_upstream_rr_peers_unlock(peers);
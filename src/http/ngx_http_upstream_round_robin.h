@@ -13,6 +13,23 @@
 #include <ngx_http.h>
 
 
+/* set in peer->down by health checks */
+#define NGX_HTTP_UPSTREAM_RR_UNHEALTHY  0x02
+
+
+/* must be a power of two */
+#define NGX_HTTP_UPSTREAM_RR_SESSIONS  8
+
+
+typedef struct {
+    u_char                         *data;
+    int                             len;
+    int                             size;
+    time_t                          expire;
+    unsigned                        single:1;
+} ngx_http_upstream_rr_session_t;
+
+
 typedef struct ngx_http_upstream_rr_peer_s   ngx_http_upstream_rr_peer_t;
 
 struct ngx_http_upstream_rr_peer_s {
@@ -37,11 +54,17 @@ struct ngx_http_upstream_rr_peer_s {
     ngx_msec_t                      slow_start;
     ngx_msec_t                      start_time;
 
+    ngx_uint_t                      ewma;
+    ngx_msec_t                      ewma_time;
+
     ngx_uint_t                      down;
 
 #if (NGX_HTTP_SSL || NGX_COMPAT)
     void                           *ssl_session;
     int                             ssl_session_len;
+
+    ngx_http_upstream_rr_session_t *ssl_sessions;
+    ngx_uint_t                      ssl_session_next;
 #endif
 
 #if (NGX_HTTP_UPSTREAM_ZONE)
@@ -69,6 +92,11 @@ struct ngx_http_upstream_rr_peers_s {
     ngx_uint_t                      total_weight;
     ngx_uint_t                      tries;
 
+    ngx_uint_t                      nschedule;
+    uint32_t                       *schedule;
+    ngx_http_upstream_rr_peer_t   **index;
+    ngx_atomic_t                    cursor;
+
     unsigned                        single:1;
     unsigned                        weighted:1;
 
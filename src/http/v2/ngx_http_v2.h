@@ -26,6 +26,9 @@
 
 #define NGX_HTTP_V2_FRAME_HEADER_SIZE    9
 
+#define NGX_HTTP_V2_TABLE_SIZE           4096
+#define NGX_HTTP_V2_MAX_TABLE_SIZE       65536
+
 /* frame types */
 #define NGX_HTTP_V2_DATA_FRAME           0x0
 #define NGX_HTTP_V2_HEADERS_FRAME        0x1
@@ -67,6 +70,7 @@ typedef struct {
     ngx_uint_t                       concurrent_streams;
     size_t                           preread_size;
     ngx_uint_t                       streams_index_mask;
+    size_t                           hpack_table_size;
 } ngx_http_v2_srv_conf_t;
 
 
@@ -121,6 +125,37 @@ typedef struct {
 } ngx_http_v2_hpack_t;
 
 
+typedef struct {
+    ngx_uint_t                       name_hash;
+    ngx_uint_t                       value_hash;
+    ngx_uint_t                       next;
+    size_t                           name_len;
+    size_t                           value_len;
+    u_char                          *data;
+} ngx_http_v2_hpack_entry_t;
+
+
+typedef struct {
+    ngx_http_v2_hpack_entry_t       *entries;
+
+    ngx_uint_t                      *buckets;
+    ngx_uint_t                       mask;
+
+    ngx_uint_t                       added;
+    ngx_uint_t                       deleted;
+    ngx_uint_t                       allocated;
+
+    size_t                           max_size;
+    size_t                           limit;
+    size_t                           size;
+    size_t                           free;
+
+    u_char                          *storage;
+    u_char                          *pos;
+    u_char                          *end;
+} ngx_http_v2_hpack_enc_t;
+
+
 struct ngx_http_v2_connection_s {
     ngx_connection_t                *connection;
     ngx_http_connection_t           *http_connection;
@@ -146,6 +181,7 @@ struct ngx_http_v2_connection_s {
     ngx_http_v2_state_t              state;
 
     ngx_http_v2_hpack_t              hpack;
+    ngx_http_v2_hpack_enc_t          hpack_enc;
 
     ngx_pool_t                      *pool;
 
@@ -414,6 +450,11 @@ ngx_int_t ngx_http_v2_table_size(ngx_http_v2_connection_t *h2c, size_t size);
 
 u_char *ngx_http_v2_string_encode(u_char *dst, u_char *src, size_t len,
     u_char *tmp, ngx_uint_t lower);
+ngx_int_t ngx_http_v2_hpack_init(ngx_http_v2_connection_t *h2c, size_t size);
+u_char *ngx_http_v2_hpack_update(ngx_http_v2_connection_t *h2c, u_char *pos);
+u_char *ngx_http_v2_write_header(ngx_http_v2_connection_t *h2c, u_char *pos,
+    ngx_uint_t index, ngx_str_t *name, ngx_str_t *value, ngx_uint_t indexing,
+    u_char *tmp);
 
 
 extern ngx_module_t  ngx_http_v2_module;
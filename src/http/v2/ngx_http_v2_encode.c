@@ -12,6 +12,11 @@
 
 static u_char *ngx_http_v2_write_int(u_char *pos, ngx_uint_t prefix,
     ngx_uint_t value);
+static void ngx_http_v2_hpack_add(ngx_http_v2_connection_t *h2c,
+    ngx_str_t *name, ngx_uint_t name_hash, ngx_str_t *value,
+    ngx_uint_t value_hash);
+static void ngx_http_v2_hpack_account(ngx_http_v2_connection_t *h2c,
+    size_t size);
 
 
 u_char *
@@ -40,6 +45,266 @@ ngx_http_v2_string_encode(u_char *dst, u_char *src, size_t len, u_char *tmp,
 }
 
 
+ngx_int_t
+ngx_http_v2_hpack_init(ngx_http_v2_connection_t *h2c, size_t size)
+{
+    ngx_uint_t                n;
+    ngx_http_v2_hpack_enc_t  *hpack;
+
+    hpack = &h2c->hpack_enc;
+
+    hpack->max_size = size;
+    hpack->limit = NGX_HTTP_V2_TABLE_SIZE;
+
+    /*
+     * each entry takes at least 32 octets of the table size,
+     * and the strings of the entries never exceed the table size;
+     * twice as much storage allows to keep every string contiguous
+     */
+
+    hpack->allocated = size / 32 + 1;
+
+    hpack->entries = ngx_palloc(h2c->connection->pool,
+                                sizeof(ngx_http_v2_hpack_entry_t)
+                                * hpack->allocated);
+    if (hpack->entries == NULL) {
+        return NGX_ERROR;
+    }
+
+    /*
+     * entries are looked up by name with a hash of chains linked
+     * from the most recent entry, about two entries per bucket
+     * when the table is full of typical response fields
+     */
+
+    for (n = 1; n < hpack->allocated / 2; n <<= 1) { /* void */ }
+
+    hpack->buckets = ngx_pcalloc(h2c->connection->pool,
+                                 n * sizeof(ngx_uint_t));
+    if (hpack->buckets == NULL) {
+        return NGX_ERROR;
+    }
+
+    hpack->mask = n - 1;
+
+    hpack->storage = ngx_pnalloc(h2c->connection->pool, 2 * size);
+    if (hpack->storage == NULL) {
+        return NGX_ERROR;
+    }
+
+    hpack->pos = hpack->storage;
+    hpack->end = hpack->storage + 2 * size;
+
+    /* the table size is announced in the first header block */
+
+    hpack->size = 0;
+    hpack->free = 0;
+
+    h2c->table_update = 1;
+
+    return NGX_OK;
+}
+
+
+u_char *
+ngx_http_v2_hpack_update(ngx_http_v2_connection_t *h2c, u_char *pos)
+{
+    size_t                      size;
+    ssize_t                     needed;
+    ngx_http_v2_hpack_entry_t  *entry;
+    ngx_http_v2_hpack_enc_t    *hpack;
+
+    hpack = &h2c->hpack_enc;
+
+    size = ngx_min(hpack->max_size, hpack->limit);
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                   "http2 table size update: %uz", size);
+
+    if (hpack->storage) {
+        needed = hpack->size - size;
+
+        while (needed > (ssize_t) hpack->free) {
+            entry = &hpack->entries[hpack->deleted++ % hpack->allocated];
+            hpack->free += 32 + entry->name_len + entry->value_len;
+        }
+
+        hpack->size = size;
+        hpack->free -= needed;
+    }
+
+    h2c->table_update = 0;
+
+    *pos = 32;
+    return ngx_http_v2_write_int(pos, ngx_http_v2_prefix(5), size);
+}
+
+
+u_char *
+ngx_http_v2_write_header(ngx_http_v2_connection_t *h2c, u_char *pos,
+    ngx_uint_t index, ngx_str_t *name, ngx_str_t *value, ngx_uint_t indexing,
+    u_char *tmp)
+{
+    ngx_uint_t                  i, n, next, name_hash, value_hash;
+    ngx_http_v2_hpack_enc_t    *hpack;
+    ngx_http_v2_hpack_entry_t  *entry;
+
+    hpack = &h2c->hpack_enc;
+
+    if (hpack->storage == NULL) {
+
+        if (index) {
+            *pos++ = ngx_http_v2_inc_indexed(index);
+
+        } else {
+            *pos++ = 0;
+            pos = ngx_http_v2_write_name(pos, name->data, name->len, tmp);
+        }
+
+        return ngx_http_v2_write_value(pos, value->data, value->len, tmp);
+    }
+
+    name_hash = ngx_hash_strlow(tmp, name->data, name->len);
+    value_hash = ngx_hash_key(value->data, value->len);
+
+    /*
+     * chains are ordered from the most recent entry, the first evicted
+     * entry met ends the chain, as all entries following it are older
+     */
+
+    for (next = hpack->buckets[name_hash & hpack->mask];
+         next;
+         next = entry->next)
+    {
+        i = next - 1;
+
+        if (i - hpack->deleted >= hpack->added - hpack->deleted) {
+            break;
+        }
+
+        entry = &hpack->entries[i % hpack->allocated];
+
+        if (entry->name_hash != name_hash
+            || entry->name_len != name->len
+            || ngx_memcmp(entry->data, tmp, name->len) != 0)
+        {
+            continue;
+        }
+
+        n = 62 + hpack->added - 1 - i;
+
+        if (entry->value_hash == value_hash
+            && entry->value_len == value->len
+            && ngx_memcmp(entry->data + name->len, value->data, value->len)
+               == 0)
+        {
+            ngx_log_debug1(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                           "http2 table indexed: %ui", n);
+
+            *pos = 128;
+            return ngx_http_v2_write_int(pos, ngx_http_v2_prefix(7), n);
+        }
+
+        if (index == 0) {
+            index = n;
+        }
+    }
+
+    /*
+     * a field larger than half of the table would evict most of
+     * the entries, which are likely to be more useful for the
+     * following responses on the connection
+     */
+
+    if (indexing && 32 + name->len + value->len > hpack->size / 2) {
+        indexing = 0;
+    }
+
+    if (indexing) {
+        *pos = 64;
+        pos = ngx_http_v2_write_int(pos, ngx_http_v2_prefix(6), index);
+
+    } else {
+        *pos = 0;
+        pos = ngx_http_v2_write_int(pos, ngx_http_v2_prefix(4), index);
+    }
+
+    if (index == 0) {
+        pos = ngx_http_v2_write_name(pos, name->data, name->len, tmp);
+    }
+
+    pos = ngx_http_v2_write_value(pos, value->data, value->len, tmp);
+
+    if (indexing) {
+        ngx_http_v2_hpack_add(h2c, name, name_hash, value, value_hash);
+    }
+
+    return pos;
+}
+
+
+static void
+ngx_http_v2_hpack_add(ngx_http_v2_connection_t *h2c, ngx_str_t *name,
+    ngx_uint_t name_hash, ngx_str_t *value, ngx_uint_t value_hash)
+{
+    size_t                      len;
+    ngx_http_v2_hpack_enc_t    *hpack;
+    ngx_http_v2_hpack_entry_t  *entry;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                   "http2 table add: \"%V: %V\"", name, value);
+
+    hpack = &h2c->hpack_enc;
+
+    len = name->len + value->len;
+
+    ngx_http_v2_hpack_account(h2c, len);
+
+    if (hpack->added == hpack->deleted) {
+        hpack->pos = hpack->storage;
+
+    } else if ((size_t) (hpack->end - hpack->pos) < len) {
+        hpack->pos = hpack->storage;
+    }
+
+    entry = &hpack->entries[hpack->added % hpack->allocated];
+
+    entry->next = hpack->buckets[name_hash & hpack->mask];
+    hpack->buckets[name_hash & hpack->mask] = ++hpack->added;
+
+    entry->name_hash = name_hash;
+    entry->value_hash = value_hash;
+    entry->name_len = name->len;
+    entry->value_len = value->len;
+    entry->data = hpack->pos;
+
+    ngx_strlow(hpack->pos, name->data, name->len);
+    hpack->pos = ngx_cpymem(hpack->pos + name->len, value->data, value->len);
+}
+
+
+static void
+ngx_http_v2_hpack_account(ngx_http_v2_connection_t *h2c, size_t size)
+{
+    ngx_http_v2_hpack_enc_t    *hpack;
+    ngx_http_v2_hpack_entry_t  *entry;
+
+    hpack = &h2c->hpack_enc;
+
+    size += 32;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                   "http2 table account: %uz free:%uz", size, hpack->free);
+
+    while (size > hpack->free) {
+        entry = &hpack->entries[hpack->deleted++ % hpack->allocated];
+        hpack->free += 32 + entry->name_len + entry->value_len;
+    }
+
+    hpack->free -= size;
+}
+
+
 static u_char *
 ngx_http_v2_write_int(u_char *pos, ngx_uint_t prefix, ngx_uint_t value)
 {
@@ -102,8 +102,8 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
 {
     u_char                     status, *pos, *start, *p, *tmp;
     size_t                     len, tmp_len;
-    ngx_str_t                  host, location;
-    ngx_uint_t                 i, port, fin;
+    ngx_str_t                  host, location, value;
+    ngx_uint_t                 i, port, fin, indexing;
     ngx_list_part_t           *part;
     ngx_table_elt_t           *header;
     ngx_connection_t          *fc;
@@ -114,6 +114,7 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
     ngx_http_core_loc_conf_t  *clcf;
     ngx_http_core_srv_conf_t  *cscf;
     u_char                     addr[NGX_SOCKADDR_STRLEN];
+    u_char                     buf[sizeof("Wed, 31 Dec 1986 18:00:00 GMT")];
 
     static const u_char nginx[5] = "\x84\xaa\x63\x55\xe7";
 #if (NGX_HTTP_GZIP)
@@ -128,6 +129,17 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
                                   ngx_http_v2_literal_size(NGINX_VER_BUILD);
     static u_char nginx_ver_build[ngx_http_v2_literal_size(NGINX_VER_BUILD)];
 
+    static ngx_str_t  server_name = ngx_string("server");
+    static ngx_str_t  date_name = ngx_string("date");
+    static ngx_str_t  content_type_name = ngx_string("content-type");
+    static ngx_str_t  content_length_name = ngx_string("content-length");
+    static ngx_str_t  last_modified_name = ngx_string("last-modified");
+    static ngx_str_t  location_name = ngx_string("location");
+#if (NGX_HTTP_GZIP)
+    static ngx_str_t  vary_name = ngx_string("vary");
+    static ngx_str_t  vary_value = ngx_string("Accept-Encoding");
+#endif
+
     stream = r->stream;
 
     if (!stream) {
@@ -211,7 +223,16 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
 
     h2c = stream->connection;
 
-    len = h2c->table_update ? 1 : 0;
+    len = h2c->table_update ? 1 + NGX_HTTP_V2_INT_OCTETS : 0;
+
+    if (h2c->hpack_enc.storage) {
+        /*
+         * indexes of the static names in literals without indexing
+         * may take an extra octet, see ngx_http_v2_write_header()
+         */
+
+        len += 8;
+    }
 
     len += status ? 1 : 1 + ngx_http_v2_literal_size("418");
 
@@ -402,10 +423,7 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
     start = pos;
 
     if (h2c->table_update) {
-        ngx_log_debug0(NGX_LOG_DEBUG_HTTP, fc->log, 0,
-                       "http2 table size update: 0");
-        *pos++ = (1 << 5) | 0;
-        h2c->table_update = 0;
+        pos = ngx_http_v2_hpack_update(h2c, pos);
     }
 
     ngx_log_debug1(NGX_LOG_DEBUG_HTTP, fc->log, 0,
@@ -416,7 +434,9 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
         *pos++ = status;
 
     } else {
-        *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_STATUS_INDEX);
+        *pos++ = h2c->hpack_enc.storage
+                 ? NGX_HTTP_V2_STATUS_INDEX
+                 : ngx_http_v2_inc_indexed(NGX_HTTP_V2_STATUS_INDEX);
         *pos++ = NGX_HTTP_V2_ENCODE_RAW | 3;
         pos = ngx_sprintf(pos, "%03ui", r->headers_out.status);
     }
@@ -438,9 +458,24 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
                            "http2 output header: \"server: nginx\"");
         }
 
-        *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_SERVER_INDEX);
+        if (h2c->hpack_enc.storage) {
+
+            if (clcf->server_tokens == NGX_HTTP_SERVER_TOKENS_ON) {
+                ngx_str_set(&value, NGINX_VER);
+
+            } else if (clcf->server_tokens == NGX_HTTP_SERVER_TOKENS_BUILD) {
+                ngx_str_set(&value, NGINX_VER_BUILD);
+
+            } else {
+                ngx_str_set(&value, "nginx");
+            }
+
+            pos = ngx_http_v2_write_header(h2c, pos, NGX_HTTP_V2_SERVER_INDEX,
+                                           &server_name, &value, 1, tmp);
+
+        } else if (clcf->server_tokens == NGX_HTTP_SERVER_TOKENS_ON) {
+            *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_SERVER_INDEX);
 
-        if (clcf->server_tokens == NGX_HTTP_SERVER_TOKENS_ON) {
             if (nginx_ver[0] == '\0') {
                 p = ngx_http_v2_write_value(nginx_ver, (u_char *) NGINX_VER,
                                             sizeof(NGINX_VER) - 1, tmp);
@@ -450,6 +485,8 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
             pos = ngx_cpymem(pos, nginx_ver, nginx_ver_len);
 
         } else if (clcf->server_tokens == NGX_HTTP_SERVER_TOKENS_BUILD) {
+            *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_SERVER_INDEX);
+
             if (nginx_ver_build[0] == '\0') {
                 p = ngx_http_v2_write_value(nginx_ver_build,
                                             (u_char *) NGINX_VER_BUILD,
@@ -460,6 +497,7 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
             pos = ngx_cpymem(pos, nginx_ver_build, nginx_ver_build_len);
 
         } else {
+            *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_SERVER_INDEX);
             pos = ngx_cpymem(pos, nginx, sizeof(nginx));
         }
     }
@@ -469,13 +507,14 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
                        "http2 output header: \"date: %V\"",
                        &ngx_cached_http_time);
 
-        *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_DATE_INDEX);
-        pos = ngx_http_v2_write_value(pos, ngx_cached_http_time.data,
-                                      ngx_cached_http_time.len, tmp);
+        value.len = ngx_cached_http_time.len;
+        value.data = ngx_cached_http_time.data;
+
+        pos = ngx_http_v2_write_header(h2c, pos, NGX_HTTP_V2_DATE_INDEX,
+                                       &date_name, &value, 1, tmp);
     }
 
     if (r->headers_out.content_type.len) {
-        *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_CONTENT_TYPE_INDEX);
 
         if (r->headers_out.content_type_len == r->headers_out.content_type.len
             && r->headers_out.charset.len)
@@ -485,7 +524,7 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
 
             p = ngx_pnalloc(r->pool, len);
             if (p == NULL) {
-                return NGX_ERROR;
+                goto failed;
             }
 
             p = ngx_cpymem(p, r->headers_out.content_type.data,
@@ -506,8 +545,10 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
                        "http2 output header: \"content-type: %V\"",
                        &r->headers_out.content_type);
 
-        pos = ngx_http_v2_write_value(pos, r->headers_out.content_type.data,
-                                      r->headers_out.content_type.len, tmp);
+        pos = ngx_http_v2_write_header(h2c, pos,
+                                       NGX_HTTP_V2_CONTENT_TYPE_INDEX,
+                                       &content_type_name,
+                                       &r->headers_out.content_type, 1, tmp);
     }
 
     if (r->headers_out.content_length == NULL
@@ -517,30 +558,38 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
                        "http2 output header: \"content-length: %O\"",
                        r->headers_out.content_length_n);
 
-        *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_CONTENT_LENGTH_INDEX);
+        if (h2c->hpack_enc.storage) {
+            value.data = buf;
+            value.len = ngx_sprintf(buf, "%O", r->headers_out.content_length_n)
+                        - buf;
+
+            pos = ngx_http_v2_write_header(h2c, pos,
+                                           NGX_HTTP_V2_CONTENT_LENGTH_INDEX,
+                                           &content_length_name, &value, 0,
+                                           tmp);
+
+        } else {
+            *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_CONTENT_LENGTH_INDEX);
 
-        p = pos;
-        pos = ngx_sprintf(pos + 1, "%O", r->headers_out.content_length_n);
-        *p = NGX_HTTP_V2_ENCODE_RAW | (u_char) (pos - p - 1);
+            p = pos;
+            pos = ngx_sprintf(pos + 1, "%O", r->headers_out.content_length_n);
+            *p = NGX_HTTP_V2_ENCODE_RAW | (u_char) (pos - p - 1);
+        }
     }
 
     if (r->headers_out.last_modified == NULL
         && r->headers_out.last_modified_time != -1)
     {
-        *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_LAST_MODIFIED_INDEX);
-
-        ngx_http_time(pos, r->headers_out.last_modified_time);
-        len = sizeof("Wed, 31 Dec 1986 18:00:00 GMT") - 1;
+        value.data = buf;
+        value.len = ngx_http_time(buf, r->headers_out.last_modified_time)
+                    - buf;
 
-        ngx_log_debug2(NGX_LOG_DEBUG_HTTP, fc->log, 0,
-                       "http2 output header: \"last-modified: %*s\"",
-                       len, pos);
+        ngx_log_debug1(NGX_LOG_DEBUG_HTTP, fc->log, 0,
+                       "http2 output header: \"last-modified: %V\"", &value);
 
-        /*
-         * Date will always be encoded using huffman in the temporary buffer,
-         * so it's safe here to use src and dst pointing to the same address.
-         */
-        pos = ngx_http_v2_write_value(pos, pos, len, tmp);
+        pos = ngx_http_v2_write_header(h2c, pos,
+                                       NGX_HTTP_V2_LAST_MODIFIED_INDEX,
+                                       &last_modified_name, &value, 0, tmp);
     }
 
     if (r->headers_out.location && r->headers_out.location->value.len) {
@@ -548,9 +597,10 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
                        "http2 output header: \"location: %V\"",
                        &r->headers_out.location->value);
 
-        *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_LOCATION_INDEX);
-        pos = ngx_http_v2_write_value(pos, r->headers_out.location->value.data,
-                                      r->headers_out.location->value.len, tmp);
+        pos = ngx_http_v2_write_header(h2c, pos, NGX_HTTP_V2_LOCATION_INDEX,
+                                       &location_name,
+                                       &r->headers_out.location->value, 0,
+                                       tmp);
     }
 
 #if (NGX_HTTP_GZIP)
@@ -558,8 +608,14 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
         ngx_log_debug0(NGX_LOG_DEBUG_HTTP, fc->log, 0,
                        "http2 output header: \"vary: Accept-Encoding\"");
 
-        *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_VARY_INDEX);
-        pos = ngx_cpymem(pos, accept_encoding, sizeof(accept_encoding));
+        if (h2c->hpack_enc.storage) {
+            pos = ngx_http_v2_write_header(h2c, pos, NGX_HTTP_V2_VARY_INDEX,
+                                           &vary_name, &vary_value, 1, tmp);
+
+        } else {
+            *pos++ = ngx_http_v2_inc_indexed(NGX_HTTP_V2_VARY_INDEX);
+            pos = ngx_cpymem(pos, accept_encoding, sizeof(accept_encoding));
+        }
     }
 #endif
 
@@ -592,13 +648,19 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
         }
 #endif
 
-        *pos++ = 0;
+        /*
+         * Set-Cookie values are rarely repeated on a connection,
+         * indexing them only pushes other fields out of the table
+         */
 
-        pos = ngx_http_v2_write_name(pos, header[i].key.data,
-                                     header[i].key.len, tmp);
+        indexing = header[i].key.len != sizeof("Set-Cookie") - 1
+                   || ngx_strncasecmp(header[i].key.data,
+                                      (u_char *) "Set-Cookie",
+                                      sizeof("Set-Cookie") - 1)
+                      != 0;
 
-        pos = ngx_http_v2_write_value(pos, header[i].value.data,
-                                      header[i].value.len, tmp);
+        pos = ngx_http_v2_write_header(h2c, pos, 0, &header[i].key,
+                                       &header[i].value, indexing, tmp);
     }
 
     fin = r->header_only
@@ -606,7 +668,7 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
 
     frame = ngx_http_v2_create_headers_frame(r, start, pos, fin);
     if (frame == NULL) {
-        return NGX_ERROR;
+        goto failed;
     }
 
     ngx_http_v2_queue_blocked_frame(h2c, frame);
@@ -626,6 +688,15 @@ ngx_http_v2_header_filter(ngx_http_request_t *r)
     fc->need_flush_buf = 1;
 
     return ngx_http_v2_filter_send(fc, stream);
+
+failed:
+
+    if (h2c->hpack_enc.storage) {
+        /* the header block is lost, and the peer's table is out of sync */
+        h2c->connection->error = 1;
+    }
+
+    return NGX_ERROR;
 }
 
 
@@ -44,6 +44,7 @@
 #define NGX_HTTP_V3_PARAM_BLOCKED_STREAMS          0x07
 
 #define NGX_HTTP_V3_MAX_TABLE_CAPACITY             4096
+#define NGX_HTTP_V3_MAX_ENCODER_TABLE_CAPACITY     65536
 
 #define NGX_HTTP_V3_STREAM_CLIENT_CONTROL          0
 #define NGX_HTTP_V3_STREAM_SERVER_CONTROL          1
@@ -106,6 +107,7 @@ typedef struct {
     ngx_flag_t                    enable;
     ngx_flag_t                    enable_hq;
     size_t                        max_table_capacity;
+    size_t                        encoder_table_capacity;
     ngx_uint_t                    max_blocked_streams;
     ngx_uint_t                    max_concurrent_streams;
     ngx_quic_conf_t               quic;
@@ -124,6 +126,7 @@ struct ngx_http_v3_session_s {
     ngx_http_connection_t        *http_connection;
 
     ngx_http_v3_dynamic_table_t   table;
+    ngx_http_v3_encoder_table_t   encoder;
 
     ngx_event_t                   keepalive;
     ngx_uint_t                    nrequests;
@@ -10,6 +10,10 @@
 #include <ngx_http.h>
 
 
+static u_char *ngx_http_v3_encode_string(u_char *p, u_char *data, size_t len,
+    ngx_uint_t prefix, ngx_uint_t lower);
+
+
 uintptr_t
 ngx_http_v3_encode_varlen_int(u_char *p, uint64_t value)
 {
@@ -302,3 +306,112 @@ ngx_http_v3_encode_field_lpbi(u_char *p, ngx_uint_t index, u_char *data,
 
     return (uintptr_t) p;
 }
+
+
+uintptr_t
+ngx_http_v3_encode_set_capacity(u_char *p, ngx_uint_t capacity)
+{
+    /* Set Dynamic Table Capacity */
+
+    if (p == NULL) {
+        return ngx_http_v3_encode_prefix_int(NULL, capacity, 5);
+    }
+
+    *p = 0x20;
+
+    return ngx_http_v3_encode_prefix_int(p, capacity, 5);
+}
+
+
+uintptr_t
+ngx_http_v3_encode_insert_ri(u_char *p, ngx_uint_t index, u_char *data,
+    size_t len)
+{
+    /* Insert With Static Name Reference */
+
+    if (p == NULL) {
+        return ngx_http_v3_encode_prefix_int(NULL, index, 6)
+               + ngx_http_v3_encode_prefix_int(NULL, len, 7)
+               + len;
+    }
+
+    *p = 0xc0;
+    p = (u_char *) ngx_http_v3_encode_prefix_int(p, index, 6);
+
+    return (uintptr_t) ngx_http_v3_encode_string(p, data, len, 7, 0);
+}
+
+
+uintptr_t
+ngx_http_v3_encode_insert_l(u_char *p, ngx_str_t *name, ngx_str_t *value)
+{
+    /* Insert With Literal Name */
+
+    if (p == NULL) {
+        return ngx_http_v3_encode_prefix_int(NULL, name->len, 5)
+               + name->len
+               + ngx_http_v3_encode_prefix_int(NULL, value->len, 7)
+               + value->len;
+    }
+
+    *p = 0x40;
+    p = ngx_http_v3_encode_string(p, name->data, name->len, 5, 1);
+
+    *p = 0;
+
+    return (uintptr_t) ngx_http_v3_encode_string(p, value->data, value->len,
+                                                 7, 0);
+}
+
+
+uintptr_t
+ngx_http_v3_encode_duplicate(u_char *p, ngx_uint_t index)
+{
+    /* Duplicate */
+
+    if (p == NULL) {
+        return ngx_http_v3_encode_prefix_int(NULL, index, 5);
+    }
+
+    *p = 0;
+
+    return ngx_http_v3_encode_prefix_int(p, index, 5);
+}
+
+
+static u_char *
+ngx_http_v3_encode_string(u_char *p, u_char *data, size_t len,
+    ngx_uint_t prefix, ngx_uint_t lower)
+{
+    size_t   hlen;
+    u_char  *p1, *p2, bits;
+
+    /* the H bit immediately precedes the length prefix */
+
+    bits = *p;
+
+    p1 = p;
+    p = (u_char *) ngx_http_v3_encode_prefix_int(p, len, prefix);
+
+    p2 = p;
+    hlen = ngx_http_huff_encode(data, len, p, lower);
+
+    if (hlen) {
+        p = p1;
+        *p = bits | (1 << prefix);
+        p = (u_char *) ngx_http_v3_encode_prefix_int(p, hlen, prefix);
+
+        if (p != p2) {
+            ngx_memmove(p, p2, hlen);
+        }
+
+        return p + hlen;
+    }
+
+    if (lower) {
+        ngx_strlow(p, data, len);
+        return p + len;
+    }
+
+    return ngx_cpymem(p, data, len);
+}
@@ -84,8 +84,8 @@ ngx_http_v3_header_filter(ngx_http_request_t *r)
     u_char                    *p;
     size_t                     len, n;
     ngx_buf_t                 *b;
-    ngx_str_t                  host, location;
-    ngx_uint_t                 i, port;
+    ngx_str_t                  host, location, value;
+    ngx_uint_t                 i, port, indexing;
     ngx_chain_t               *out, *hl, *cl, **ll;
     ngx_list_part_t           *part;
     ngx_table_elt_t           *header;
@@ -94,6 +94,7 @@ ngx_http_v3_header_filter(ngx_http_request_t *r)
     ngx_http_v3_filter_ctx_t  *ctx;
     ngx_http_core_loc_conf_t  *clcf;
     ngx_http_core_srv_conf_t  *cscf;
+    ngx_http_v3_section_t      section;
     u_char                     addr[NGX_SOCKADDR_STRLEN];
 
     if (r->http_version != NGX_HTTP_VERSION_30) {
@@ -144,7 +145,14 @@ ngx_http_v3_header_filter(ngx_http_request_t *r)
     out = NULL;
     ll = &out;
 
-    len = ngx_http_v3_encode_field_section_prefix(NULL, 0, 0, 0);
+    ngx_http_v3_init_section(c, &section);
+
+    /*
+     * the field section prefix depends on the dynamic table references,
+     * and is written in front of the field lines when they are encoded
+     */
+
+    len = 2 * NGX_HTTP_V3_PREFIX_INT_LEN;
 
     if (r->headers_out.status == NGX_HTTP_OK) {
         len += ngx_http_v3_encode_field_ri(NULL, 0,
@@ -312,6 +320,11 @@ ngx_http_v3_header_filter(ngx_http_request_t *r)
 
         len += ngx_http_v3_encode_field_l(NULL, &header[i].key,
                                           &header[i].value);
+
+        if (section.dynamic) {
+            /* dynamic name reference may take an extra octet */
+            len++;
+        }
     }
 
     ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0, "http3 header len:%uz", len);
@@ -321,8 +334,8 @@ ngx_http_v3_header_filter(ngx_http_request_t *r)
         return NGX_ERROR;
     }
 
-    b->last = (u_char *) ngx_http_v3_encode_field_section_prefix(b->last,
-                                                                 0, 0, 0);
+    b->pos += 2 * NGX_HTTP_V3_PREFIX_INT_LEN;
+    b->last = b->pos;
 
     ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
                    "http3 output header: \":status: %03ui\"",
@@ -356,9 +369,12 @@ ngx_http_v3_header_filter(ngx_http_request_t *r)
         ngx_log_debug2(NGX_LOG_DEBUG_HTTP, c->log, 0,
                        "http3 output header: \"server: %*s\"", n, p);
 
-        b->last = (u_char *) ngx_http_v3_encode_field_lri(b->last, 0,
-                                                     NGX_HTTP_V3_HEADER_SERVER,
-                                                     p, n);
+        value.len = n;
+        value.data = p;
+
+        b->last = ngx_http_v3_encode_header(c, b->last, &section,
+                                            NGX_HTTP_V3_HEADER_SERVER, NULL,
+                                            &value, 1);
     }
 
     if (r->headers_out.date == NULL) {
@@ -366,10 +382,12 @@ ngx_http_v3_header_filter(ngx_http_request_t *r)
                        "http3 output header: \"date: %V\"",
                        &ngx_cached_http_time);
 
-        b->last = (u_char *) ngx_http_v3_encode_field_lri(b->last, 0,
-                                                     NGX_HTTP_V3_HEADER_DATE,
-                                                     ngx_cached_http_time.data,
-                                                     ngx_cached_http_time.len);
+        value.len = ngx_cached_http_time.len;
+        value.data = ngx_cached_http_time.data;
+
+        b->last = ngx_http_v3_encode_header(c, b->last, &section,
+                                            NGX_HTTP_V3_HEADER_DATE, NULL,
+                                            &value, 1);
     }
 
     if (r->headers_out.content_type.len) {
@@ -402,10 +420,9 @@ ngx_http_v3_header_filter(ngx_http_request_t *r)
                        "http3 output header: \"content-type: %V\"",
                        &r->headers_out.content_type);
 
-        b->last = (u_char *) ngx_http_v3_encode_field_lri(b->last, 0,
+        b->last = ngx_http_v3_encode_header(c, b->last, &section,
                                     NGX_HTTP_V3_HEADER_CONTENT_TYPE_TEXT_PLAIN,
-                                    r->headers_out.content_type.data,
-                                    r->headers_out.content_type.len);
+                                    NULL, &r->headers_out.content_type, 1);
     }
 
     if (r->headers_out.content_length == NULL
@@ -496,9 +513,28 @@ ngx_http_v3_header_filter(ngx_http_request_t *r)
                        "http3 output header: \"%V: %V\"",
                        &header[i].key, &header[i].value);
 
-        b->last = (u_char *) ngx_http_v3_encode_field_l(b->last,
-                                                        &header[i].key,
-                                                        &header[i].value);
+        /*
+         * a Set-Cookie value is rarely sent twice, inserting it would
+         * cost encoder stream bytes without saving any later
+         */
+
+        indexing = header[i].key.len != sizeof("Set-Cookie") - 1
+                   || ngx_strncasecmp(header[i].key.data,
+                                      (u_char *) "Set-Cookie",
+                                      sizeof("Set-Cookie") - 1)
+                      != 0;
+
+        b->last = ngx_http_v3_encode_header(c, b->last, &section, 0,
+                                            &header[i].key, &header[i].value,
+                                            indexing);
+    }
+
+    n = ngx_http_v3_encode_section_prefix(c, NULL, &section);
+    b->pos -= n;
+    (void) ngx_http_v3_encode_section_prefix(c, b->pos, &section);
+
+    if (ngx_http_v3_commit_section(c, &section) != NGX_OK) {
+        return NGX_ERROR;
     }
 
     if (r->header_only) {
@@ -12,10 +12,22 @@
 
 #define ngx_http_v3_table_entry_size(n, v) ((n)->len + (v)->len + 32)
 
+#define NGX_HTTP_V3_NO_INDEX               ((ngx_uint_t) -1)
+
 
 static ngx_int_t ngx_http_v3_evict(ngx_connection_t *c, size_t target);
 static void ngx_http_v3_unblock(void *data);
 static ngx_int_t ngx_http_v3_new_entry(ngx_connection_t *c);
+static u_char *ngx_http_v3_encode_ref(u_char *p, ngx_http_v3_section_t *s,
+    ngx_uint_t index);
+static ngx_uint_t ngx_http_v3_can_reference(ngx_http_v3_encoder_table_t *et,
+    ngx_http_v3_section_t *s, ngx_uint_t index);
+static ngx_uint_t ngx_http_v3_encoder_draining(
+    ngx_http_v3_encoder_table_t *et, ngx_uint_t n);
+static ngx_int_t ngx_http_v3_encoder_insert(ngx_connection_t *c,
+    ngx_http_v3_section_t *s, ngx_uint_t index, ngx_uint_t dup,
+    ngx_str_t *name, ngx_str_t *value);
+static ngx_int_t ngx_http_v3_encoder_set_capacity(ngx_connection_t *c);
 
 
 typedef struct {
@@ -331,19 +343,42 @@ void
 ngx_http_v3_cleanup_table(ngx_http_v3_session_t *h3c)
 {
     ngx_uint_t                    n;
+    ngx_queue_t                  *q;
+    ngx_http_v3_encoder_table_t  *et;
     ngx_http_v3_dynamic_table_t  *dt;
 
     dt = &h3c->table;
 
-    if (dt->elts == NULL) {
-        return;
+    if (dt->elts) {
+        for (n = 0; n < dt->nelts; n++) {
+            ngx_free(dt->elts[n]);
+        }
+
+        ngx_free(dt->elts);
+    }
+
+    et = &h3c->encoder;
+
+    if (et->elts) {
+        for (n = 0; n < et->nelts; n++) {
+            ngx_free(et->elts[n]);
+        }
+
+        ngx_free(et->elts);
+        ngx_free(et->buckets);
     }
 
-    for (n = 0; n < dt->nelts; n++) {
-        ngx_free(dt->elts[n]);
+    while (!ngx_queue_empty(&et->sections)) {
+        q = ngx_queue_head(&et->sections);
+        ngx_queue_remove(q);
+        ngx_free(ngx_queue_data(q, ngx_http_v3_section_t, queue));
     }
 
-    ngx_free(dt->elts);
+    while (!ngx_queue_empty(&et->free)) {
+        q = ngx_queue_head(&et->free);
+        ngx_queue_remove(q);
+        ngx_free(ngx_queue_data(q, ngx_http_v3_section_t, queue));
+    }
 }
 
 
@@ -411,10 +446,38 @@ ngx_http_v3_duplicate(ngx_connection_t *c, ngx_uint_t index)
 ngx_int_t
 ngx_http_v3_ack_section(ngx_connection_t *c, ngx_uint_t stream_id)
 {
+    ngx_queue_t                  *q;
+    ngx_http_v3_section_t        *section;
+    ngx_http_v3_session_t        *h3c;
+    ngx_http_v3_encoder_table_t  *et;
+
     ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
                    "http3 ack section %ui", stream_id);
 
-    /* we do not use dynamic tables */
+    h3c = ngx_http_v3_get_session(c);
+    et = &h3c->encoder;
+
+    /* the oldest outstanding section of the stream is acknowledged */
+
+    for (q = ngx_queue_head(&et->sections);
+         q != ngx_queue_sentinel(&et->sections);
+         q = ngx_queue_next(q))
+    {
+        section = ngx_queue_data(q, ngx_http_v3_section_t, queue);
+
+        if (section->stream_id != stream_id) {
+            continue;
+        }
+
+        if (et->known_received_count < section->insert_count) {
+            et->known_received_count = section->insert_count;
+        }
+
+        ngx_queue_remove(q);
+        ngx_queue_insert_tail(&et->free, q);
+
+        return NGX_OK;
+    }
 
     return NGX_HTTP_V3_ERR_DECODER_STREAM_ERROR;
 }
@@ -423,12 +486,51 @@ ngx_http_v3_ack_section(ngx_connection_t *c, ngx_uint_t stream_id)
 ngx_int_t
 ngx_http_v3_inc_insert_count(ngx_connection_t *c, ngx_uint_t inc)
 {
+    ngx_http_v3_session_t        *h3c;
+    ngx_http_v3_encoder_table_t  *et;
+
     ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
                    "http3 increment insert count %ui", inc);
 
-    /* we do not use dynamic tables */
+    h3c = ngx_http_v3_get_session(c);
+    et = &h3c->encoder;
 
-    return NGX_HTTP_V3_ERR_DECODER_STREAM_ERROR;
+    if (inc == 0
+        || inc > et->base + et->nelts - et->known_received_count)
+    {
+        return NGX_HTTP_V3_ERR_DECODER_STREAM_ERROR;
+    }
+
+    et->known_received_count += inc;
+
+    return NGX_OK;
+}
+
+
+void
+ngx_http_v3_cancel_sections(ngx_connection_t *c, ngx_uint_t stream_id)
+{
+    ngx_queue_t                  *q, *next;
+    ngx_http_v3_section_t        *section;
+    ngx_http_v3_session_t        *h3c;
+    ngx_http_v3_encoder_table_t  *et;
+
+    h3c = ngx_http_v3_get_session(c);
+    et = &h3c->encoder;
+
+    for (q = ngx_queue_head(&et->sections);
+         q != ngx_queue_sentinel(&et->sections);
+         q = next)
+    {
+        next = ngx_queue_next(q);
+
+        section = ngx_queue_data(q, ngx_http_v3_section_t, queue);
+
+        if (section->stream_id == stream_id) {
+            ngx_queue_remove(q);
+            ngx_queue_insert_tail(&et->free, q);
+        }
+    }
 }
 
 
@@ -684,14 +786,550 @@ ngx_http_v3_new_entry(ngx_connection_t *c)
 }
 
 
+void
+ngx_http_v3_init_section(ngx_connection_t *c, ngx_http_v3_section_t *s)
+{
+    ngx_http_v3_session_t        *h3c;
+    ngx_http_v3_srv_conf_t       *h3scf;
+    ngx_http_v3_encoder_table_t  *et;
+
+    h3c = ngx_http_v3_get_session(c);
+    h3scf = ngx_http_v3_get_module_srv_conf(c, ngx_http_v3_module);
+
+    et = &h3c->encoder;
+
+    s->stream_id = c->quic->id;
+    s->base = et->base + et->nelts;
+    s->insert_count = 0;
+    s->min_index = NGX_HTTP_V3_NO_INDEX;
+    s->dynamic = h3scf->encoder_table_capacity && et->max_capacity;
+}
+
+
+u_char *
+ngx_http_v3_encode_header(ngx_connection_t *c, u_char *p,
+    ngx_http_v3_section_t *s, ngx_uint_t index, ngx_str_t *name,
+    ngx_str_t *value, ngx_uint_t indexing)
+{
+    ngx_str_t                     key;
+    ngx_uint_t                    n, ref, next, name_index, name_hash,
+                                  value_hash;
+    ngx_http_v3_session_t        *h3c;
+    ngx_http_v3_encoder_field_t  *field;
+    ngx_http_v3_encoder_table_t  *et;
+
+    /* a NULL name refers to the name of the static table entry "index" */
+
+    if (!s->dynamic) {
+        goto literal;
+    }
+
+    if (name == NULL) {
+        if (ngx_http_v3_lookup_static(c, index, &key, NULL) != NGX_OK) {
+            goto literal;
+        }
+
+    } else {
+        key = *name;
+        index = NGX_HTTP_V3_NO_INDEX;
+    }
+
+    h3c = ngx_http_v3_get_session(c);
+    et = &h3c->encoder;
+
+    name_index = NGX_HTTP_V3_NO_INDEX;
+
+    name_hash = ngx_hash_key_lc(key.data, key.len);
+    value_hash = ngx_hash_key(value->data, value->len);
+
+    /*
+     * chains are ordered from the most recent entry, the first evicted
+     * entry met ends the chain, as all entries following it are older
+     */
+
+    for (next = et->buckets ? et->buckets[name_hash & et->mask] : 0;
+         next;
+         next = field->next)
+    {
+        ref = next - 1;
+
+        if (ref < et->base) {
+            break;
+        }
+
+        n = ref - et->base;
+        field = et->elts[n];
+
+        if (field->name_hash != name_hash
+            || field->name.len != key.len
+            || ngx_strncasecmp(field->name.data, key.data, key.len) != 0)
+        {
+            continue;
+        }
+
+        if (!ngx_http_v3_can_reference(et, s, ref)) {
+            continue;
+        }
+
+        if (field->value_hash != value_hash
+            || field->value.len != value->len
+            || ngx_memcmp(field->value.data, value->data, value->len) != 0)
+        {
+            if (name_index == NGX_HTTP_V3_NO_INDEX) {
+                name_index = ref;
+            }
+
+            continue;
+        }
+
+        /*
+         * entries close to eviction are duplicated rather than referenced,
+         * so that references do not keep them in the table
+         */
+
+        if (ngx_http_v3_encoder_draining(et, n)
+            && ngx_http_v3_encoder_insert(c, s, NGX_HTTP_V3_NO_INDEX, ref,
+                                          &key, value)
+               == NGX_OK)
+        {
+            n = et->base + et->nelts - 1;
+
+            if (ngx_http_v3_can_reference(et, s, n)) {
+                return ngx_http_v3_encode_ref(p, s, n);
+            }
+
+            if (ref < et->base) {
+                goto literal;
+            }
+        }
+
+        return ngx_http_v3_encode_ref(p, s, ref);
+    }
+
+    if (indexing
+        && ngx_http_v3_encoder_insert(c, s, index, NGX_HTTP_V3_NO_INDEX,
+                                      &key, value)
+           == NGX_OK)
+    {
+        n = et->base + et->nelts - 1;
+
+        if (ngx_http_v3_can_reference(et, s, n)) {
+            return ngx_http_v3_encode_ref(p, s, n);
+        }
+    }
+
+    if (name == NULL
+        || name_index == NGX_HTTP_V3_NO_INDEX
+        || name_index < et->base)
+    {
+        goto literal;
+    }
+
+    /* literal field line with dynamic name reference */
+
+    if (s->insert_count < name_index + 1) {
+        s->insert_count = name_index + 1;
+    }
+
+    if (s->min_index > name_index) {
+        s->min_index = name_index;
+    }
+
+    if (name_index < s->base) {
+        return (u_char *) ngx_http_v3_encode_field_lri(p, 1,
+                                                 s->base - 1 - name_index,
+                                                 value->data, value->len);
+    }
+
+    return (u_char *) ngx_http_v3_encode_field_lpbi(p, name_index - s->base,
+                                                    value->data, value->len);
+
+literal:
+
+    if (name == NULL) {
+        return (u_char *) ngx_http_v3_encode_field_lri(p, 0, index,
+                                                       value->data,
+                                                       value->len);
+    }
+
+    return (u_char *) ngx_http_v3_encode_field_l(p, name, value);
+}
+
+
+static u_char *
+ngx_http_v3_encode_ref(u_char *p, ngx_http_v3_section_t *s, ngx_uint_t index)
+{
+    if (s->insert_count < index + 1) {
+        s->insert_count = index + 1;
+    }
+
+    if (s->min_index > index) {
+        s->min_index = index;
+    }
+
+    if (index < s->base) {
+        return (u_char *) ngx_http_v3_encode_field_ri(p, 1,
+                                                      s->base - 1 - index);
+    }
+
+    return (u_char *) ngx_http_v3_encode_field_pbi(p, index - s->base);
+}
+
+
+static ngx_uint_t
+ngx_http_v3_can_reference(ngx_http_v3_encoder_table_t *et,
+    ngx_http_v3_section_t *s, ngx_uint_t index)
+{
+    ngx_uint_t              nblocked;
+    ngx_queue_t            *q;
+    ngx_http_v3_section_t  *section;
+
+    if (index < et->known_received_count
+        || s->insert_count > et->known_received_count)
+    {
+        return 1;
+    }
+
+    /* referencing an unacknowledged entry blocks the stream */
+
+    nblocked = 0;
+
+    for (q = ngx_queue_head(&et->sections);
+         q != ngx_queue_sentinel(&et->sections);
+         q = ngx_queue_next(q))
+    {
+        section = ngx_queue_data(q, ngx_http_v3_section_t, queue);
+
+        if (section->insert_count > et->known_received_count) {
+            nblocked++;
+        }
+    }
+
+    return nblocked < et->max_blocked;
+}
+
+
+static ngx_uint_t
+ngx_http_v3_encoder_draining(ngx_http_v3_encoder_table_t *et, ngx_uint_t n)
+{
+    size_t                        size;
+    ngx_uint_t                    i;
+    ngx_http_v3_encoder_field_t  *field;
+
+    /* the oldest quarter of an almost full table */
+
+    if (et->size < et->capacity / 4 * 3) {
+        return 0;
+    }
+
+    size = 0;
+
+    for (i = 0; i <= n; i++) {
+        field = et->elts[i];
+        size += ngx_http_v3_table_entry_size(&field->name, &field->value);
+    }
+
+    return size <= et->capacity / 4;
+}
+
+
+static ngx_int_t
+ngx_http_v3_encoder_insert(ngx_connection_t *c, ngx_http_v3_section_t *s,
+    ngx_uint_t index, ngx_uint_t dup, ngx_str_t *name, ngx_str_t *value)
+{
+    u_char                       *p, *buf, *last;
+    size_t                        size, target, len;
+    ngx_uint_t                    i, n, min_index, hash;
+    ngx_queue_t                  *q;
+    ngx_http_v3_section_t        *section;
+    ngx_http_v3_session_t        *h3c;
+    ngx_http_v3_encoder_field_t  *field;
+    ngx_http_v3_encoder_table_t  *et;
+
+    h3c = ngx_http_v3_get_session(c);
+    et = &h3c->encoder;
+
+    if (et->elts == NULL) {
+        if (ngx_http_v3_encoder_set_capacity(c) != NGX_OK) {
+            return NGX_ERROR;
+        }
+    }
+
+    size = ngx_http_v3_table_entry_size(name, value);
+
+    /*
+     * inserting a field over half of the capacity means evicting
+     * most of the table, and is likely to be blocked by entries
+     * still referenced by the decoder
+     */
+
+    if (size > et->capacity / 2) {
+        return NGX_DECLINED;
+    }
+
+    /*
+     * entries referenced by unacknowledged sections cannot be evicted,
+     * neither can entries whose insertion the decoder has not yet
+     * acknowledged, RFC 9204, 2.1.1
+     */
+
+    min_index = s->min_index;
+
+    for (q = ngx_queue_head(&et->sections);
+         q != ngx_queue_sentinel(&et->sections);
+         q = ngx_queue_next(q))
+    {
+        section = ngx_queue_data(q, ngx_http_v3_section_t, queue);
+
+        if (min_index > section->min_index) {
+            min_index = section->min_index;
+        }
+    }
+
+    target = et->capacity - size;
+    len = et->size;
+    n = 0;
+
+    while (len > target) {
+        if (et->base + n >= min_index
+            || et->base + n >= et->known_received_count)
+        {
+            ngx_log_debug0(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                           "http3 encoder table is pinned");
+            return NGX_DECLINED;
+        }
+
+        field = et->elts[n++];
+        len -= ngx_http_v3_table_entry_size(&field->name, &field->value);
+    }
+
+    if (dup != NGX_HTTP_V3_NO_INDEX) {
+        dup = et->base + et->nelts - 1 - dup;
+
+        buf = ngx_pnalloc(c->pool, ngx_http_v3_encode_duplicate(NULL, dup));
+        if (buf == NULL) {
+            return NGX_ERROR;
+        }
+
+        last = (u_char *) ngx_http_v3_encode_duplicate(buf, dup);
+
+    } else if (index != NGX_HTTP_V3_NO_INDEX) {
+        buf = ngx_pnalloc(c->pool, ngx_http_v3_encode_insert_ri(NULL, index,
+                                                              value->data,
+                                                              value->len));
+        if (buf == NULL) {
+            return NGX_ERROR;
+        }
+
+        last = (u_char *) ngx_http_v3_encode_insert_ri(buf, index,
+                                                       value->data,
+                                                       value->len);
+
+    } else {
+        buf = ngx_pnalloc(c->pool,
+                          ngx_http_v3_encode_insert_l(NULL, name, value));
+        if (buf == NULL) {
+            return NGX_ERROR;
+        }
+
+        last = (u_char *) ngx_http_v3_encode_insert_l(buf, name, value);
+    }
+
+    p = ngx_alloc(sizeof(ngx_http_v3_encoder_field_t) + name->len
+                  + value->len, c->log);
+    if (p == NULL) {
+        return NGX_ERROR;
+    }
+
+    if (ngx_http_v3_send_encoder_instructions(c, buf, last - buf) != NGX_OK) {
+        ngx_free(p);
+        return NGX_ERROR;
+    }
+
+    field = (ngx_http_v3_encoder_field_t *) p;
+
+    field->name.data = p + sizeof(ngx_http_v3_encoder_field_t);
+    field->name.len = name->len;
+    field->value.data = field->name.data + name->len;
+    field->value.len = value->len;
+
+    ngx_strlow(field->name.data, name->data, name->len);
+    ngx_memcpy(field->value.data, value->data, value->len);
+
+    field->name_hash = ngx_hash_key(field->name.data, name->len);
+    field->value_hash = ngx_hash_key(value->data, value->len);
+
+    if (n) {
+        ngx_log_debug2(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                       "http3 encoder evict [%ui,%ui)",
+                       et->base, et->base + n);
+
+        for (i = 0; i < n; i++) {
+            ngx_free(et->elts[i]);
+        }
+
+        et->nelts -= n;
+        et->base += n;
+        ngx_memmove(et->elts, &et->elts[n], et->nelts * sizeof(void *));
+    }
+
+    ngx_log_debug4(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "http3 encoder insert [%ui] \"%V\":\"%V\", size:%uz",
+                   et->base + et->nelts, &field->name, &field->value, size);
+
+    hash = field->name_hash & et->mask;
+
+    field->next = et->buckets[hash];
+    et->buckets[hash] = et->base + et->nelts + 1;
+
+    et->elts[et->nelts++] = field;
+    et->size = len + size;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v3_encoder_set_capacity(ngx_connection_t *c)
+{
+    u_char                        buf[NGX_HTTP_V3_PREFIX_INT_LEN];
+    size_t                        capacity;
+    ngx_uint_t                    n, *buckets;
+    ngx_http_v3_session_t        *h3c;
+    ngx_http_v3_encoder_field_t **elts;
+    ngx_http_v3_srv_conf_t       *h3scf;
+    ngx_http_v3_encoder_table_t  *et;
+
+    h3c = ngx_http_v3_get_session(c);
+    h3scf = ngx_http_v3_get_module_srv_conf(c, ngx_http_v3_module);
+
+    et = &h3c->encoder;
+
+    capacity = ngx_min(h3scf->encoder_table_capacity, et->max_capacity);
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "http3 encoder set capacity %uz", capacity);
+
+    elts = ngx_alloc((capacity / 32 + 1) * sizeof(void *), c->log);
+    if (elts == NULL) {
+        return NGX_ERROR;
+    }
+
+    /*
+     * entries are looked up by name with a hash of chains linked
+     * from the most recent entry, as in the HPACK encoder
+     */
+
+    for (n = 1; n < (capacity / 32 + 1) / 2; n <<= 1) { /* void */ }
+
+    buckets = ngx_calloc(n * sizeof(ngx_uint_t), c->log);
+    if (buckets == NULL) {
+        ngx_free(elts);
+        return NGX_ERROR;
+    }
+
+    if (ngx_http_v3_send_encoder_instructions(c, buf,
+                        (u_char *) ngx_http_v3_encode_set_capacity(buf, capacity)
+                        - buf)
+        != NGX_OK)
+    {
+        ngx_free(buckets);
+        ngx_free(elts);
+        return NGX_ERROR;
+    }
+
+    et->elts = elts;
+    et->buckets = buckets;
+    et->mask = n - 1;
+    et->capacity = capacity;
+
+    return NGX_OK;
+}
+
+
+uintptr_t
+ngx_http_v3_encode_section_prefix(ngx_connection_t *c, u_char *p,
+    ngx_http_v3_section_t *s)
+{
+    ngx_uint_t                    insert_count;
+    ngx_http_v3_session_t        *h3c;
+    ngx_http_v3_encoder_table_t  *et;
+
+    if (s->insert_count == 0) {
+        return ngx_http_v3_encode_field_section_prefix(p, 0, 0, 0);
+    }
+
+    h3c = ngx_http_v3_get_session(c);
+    et = &h3c->encoder;
+
+    /* QPACK 4.5.1.1. Required Insert Count */
+
+    insert_count = s->insert_count % (2 * (et->max_capacity / 32)) + 1;
+
+    if (s->base >= s->insert_count) {
+        return ngx_http_v3_encode_field_section_prefix(p, insert_count, 0,
+                                                 s->base - s->insert_count);
+    }
+
+    return ngx_http_v3_encode_field_section_prefix(p, insert_count, 1,
+                                             s->insert_count - s->base - 1);
+}
+
+
+ngx_int_t
+ngx_http_v3_commit_section(ngx_connection_t *c, ngx_http_v3_section_t *s)
+{
+    ngx_queue_t                  *q;
+    ngx_http_v3_section_t        *section;
+    ngx_http_v3_session_t        *h3c;
+    ngx_http_v3_encoder_table_t  *et;
+
+    if (s->insert_count == 0) {
+        return NGX_OK;
+    }
+
+    ngx_log_debug3(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "http3 encoder section insert_count:%ui base:%ui min:%ui",
+                   s->insert_count, s->base, s->min_index);
+
+    h3c = ngx_http_v3_get_session(c);
+    et = &h3c->encoder;
+
+    if (!ngx_queue_empty(&et->free)) {
+        q = ngx_queue_head(&et->free);
+        ngx_queue_remove(q);
+
+        section = ngx_queue_data(q, ngx_http_v3_section_t, queue);
+
+    } else {
+        section = ngx_alloc(sizeof(ngx_http_v3_section_t), c->log);
+        if (section == NULL) {
+            return NGX_ERROR;
+        }
+    }
+
+    *section = *s;
+
+    ngx_queue_insert_tail(&et->sections, &section->queue);
+
+    return NGX_OK;
+}
+
+
 ngx_int_t
 ngx_http_v3_set_param(ngx_connection_t *c, uint64_t id, uint64_t value)
 {
+    ngx_http_v3_session_t  *h3c;
+
+    h3c = ngx_http_v3_get_session(c);
+
     switch (id) {
 
     case NGX_HTTP_V3_PARAM_MAX_TABLE_CAPACITY:
         ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
                        "http3 param QPACK_MAX_TABLE_CAPACITY:%uL", value);
+
+        h3c->encoder.max_capacity = value;
         break;
 
     case NGX_HTTP_V3_PARAM_MAX_FIELD_SECTION_SIZE:
@@ -703,6 +1341,8 @@ ngx_http_v3_set_param(ngx_connection_t *c, uint64_t id, uint64_t value)
     case NGX_HTTP_V3_PARAM_BLOCKED_STREAMS:
         ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
                        "http3 param QPACK_BLOCKED_STREAMS:%uL", value);
+
+        h3c->encoder.max_blocked = value;
         break;
 
     default:
@@ -32,6 +32,41 @@ typedef struct {
 } ngx_http_v3_dynamic_table_t;
 
 
+typedef struct {
+    ngx_queue_t                   queue;
+    ngx_uint_t                    stream_id;
+    ngx_uint_t                    base;
+    ngx_uint_t                    insert_count;
+    ngx_uint_t                    min_index;
+    ngx_uint_t                    dynamic;
+} ngx_http_v3_section_t;
+
+
+typedef struct {
+    ngx_str_t                     name;
+    ngx_str_t                     value;
+    ngx_uint_t                    name_hash;
+    ngx_uint_t                    value_hash;
+    ngx_uint_t                    next;
+} ngx_http_v3_encoder_field_t;
+
+
+typedef struct {
+    ngx_http_v3_encoder_field_t **elts;
+    ngx_uint_t                    nelts;
+    ngx_uint_t                    base;
+    ngx_uint_t                   *buckets;
+    ngx_uint_t                    mask;
+    size_t                        size;
+    size_t                        capacity;
+    size_t                        max_capacity;
+    ngx_uint_t                    max_blocked;
+    ngx_uint_t                    known_received_count;
+    ngx_queue_t                   sections;
+    ngx_queue_t                   free;
+} ngx_http_v3_encoder_table_t;
+
+
 void ngx_http_v3_inc_insert_count_handler(ngx_event_t *ev);
 void ngx_http_v3_cleanup_table(ngx_http_v3_session_t *h3c);
 ngx_int_t ngx_http_v3_ref_insert(ngx_connection_t *c, ngx_uint_t dynamic,
@@ -51,6 +86,15 @@ ngx_int_t ngx_http_v3_decode_insert_count(ngx_connection_t *c,
 ngx_int_t ngx_http_v3_check_insert_count(ngx_connection_t *c,
     ngx_uint_t insert_count);
 void ngx_http_v3_ack_insert_count(ngx_connection_t *c, uint64_t insert_count);
+void ngx_http_v3_init_section(ngx_connection_t *c, ngx_http_v3_section_t *s);
+u_char *ngx_http_v3_encode_header(ngx_connection_t *c, u_char *p,
+    ngx_http_v3_section_t *s, ngx_uint_t index, ngx_str_t *name,
+    ngx_str_t *value, ngx_uint_t indexing);
+uintptr_t ngx_http_v3_encode_section_prefix(ngx_connection_t *c, u_char *p,
+    ngx_http_v3_section_t *s);
+ngx_int_t ngx_http_v3_commit_section(ngx_connection_t *c,
+    ngx_http_v3_section_t *s);
+void ngx_http_v3_cancel_sections(ngx_connection_t *c, ngx_uint_t stream_id);
 ngx_int_t ngx_http_v3_set_param(ngx_connection_t *c, uint64_t id,
     uint64_t value);
 
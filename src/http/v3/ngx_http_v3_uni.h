@@ -27,6 +27,8 @@ ngx_int_t ngx_http_v3_send_cancel_stream(ngx_connection_t *c,
     ngx_uint_t stream_id);
 ngx_int_t ngx_http_v3_send_inc_insert_count(ngx_connection_t *c,
     ngx_uint_t inc);
+ngx_int_t ngx_http_v3_send_encoder_instructions(ngx_connection_t *c,
+    u_char *buf, size_t n);
 
 
 #endif /* _NGX_HTTP_V3_UNI_H_INCLUDED_ */
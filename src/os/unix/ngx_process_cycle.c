@@ -52,6 +52,8 @@ sig_atomic_t  ngx_noaccept;
 ngx_uint_t    ngx_noaccepting;
 ngx_uint_t    ngx_restart;
 
+ngx_event_t  *ngx_channel_notify_event;
+
 
 static u_char  master_process[] = "master process";
 
@@ -940,6 +942,8 @@ static void
 ngx_worker_process_exit(ngx_cycle_t *cycle)
 {
     ngx_uint_t         i;
+    ngx_shm_zone_t    *shm_zone;
+    ngx_list_part_t   *part;
     ngx_connection_t  *c;
 
     for (i = 0; cycle->modules[i]; i++) {
@@ -948,6 +952,25 @@ ngx_worker_process_exit(ngx_cycle_t *cycle)
         }
     }
 
+    /* return chunks cached by this process to shared memory zones */
+
+    part = &cycle->shared_memory.part;
+    shm_zone = part->elts;
+
+    for (i = 0; /* void */ ; i++) {
+
+        if (i >= part->nelts) {
+            if (part->next == NULL) {
+                break;
+            }
+            part = part->next;
+            shm_zone = part->elts;
+            i = 0;
+        }
+
+        ngx_slab_flush((ngx_slab_pool_t *) shm_zone[i].shm.addr);
+    }
+
     if (ngx_exiting && !ngx_terminate) {
         c = cycle->connections;
         for (i = 0; i < cycle->connection_n; i++) {
@@ -1056,6 +1079,16 @@ ngx_channel_handler(ngx_event_t *ev)
             ngx_reopen = 1;
             break;
 
+        case NGX_CMD_NOTIFY:
+
+            /* repeated notifications are coalesced by the posted event */
+
+            if (ngx_channel_notify_event) {
+                ngx_post_event(ngx_channel_notify_event, &ngx_posted_events);
+            }
+
+            break;
+
         case NGX_CMD_OPEN_CHANNEL:
 
             ngx_log_debug3(NGX_LOG_DEBUG_CORE, ev->log, 0,
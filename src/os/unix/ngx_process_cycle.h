@@ -18,6 +18,7 @@
 #define NGX_CMD_QUIT           3
 #define NGX_CMD_TERMINATE      4
 #define NGX_CMD_REOPEN         5
+#define NGX_CMD_NOTIFY         6
 
 
 #define NGX_PROCESS_SINGLE     0
@@ -57,5 +58,7 @@ extern sig_atomic_t    ngx_reconfigure;
 extern sig_atomic_t    ngx_reopen;
 extern sig_atomic_t    ngx_change_binary;
 
+extern ngx_event_t    *ngx_channel_notify_event;
+
 
 #endif /* _NGX_PROCESS_CYCLE_H_INCLUDED_ */
@@ -14,6 +14,32 @@
 ngx_int_t
 ngx_shm_alloc(ngx_shm_t *shm)
 {
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+
+    size_t  size;
+
+    if (shm->hugepages) {
+
+        /* explicit 2M pages from the hugetlb pool, if reserved */
+
+        size = ngx_align(shm->size, NGX_SHM_HUGEPAGE_SIZE);
+
+        shm->addr = (u_char *) mmap(NULL, size, PROT_READ|PROT_WRITE,
+                                    MAP_ANON|MAP_SHARED|MAP_HUGETLB
+                                    |(21 << MAP_HUGE_SHIFT), -1, 0);
+
+        if (shm->addr != MAP_FAILED) {
+            shm->hugepages = NGX_SHM_HUGETLB;
+            return NGX_OK;
+        }
+
+        ngx_log_error(NGX_LOG_NOTICE, shm->log, ngx_errno,
+                      "mmap(MAP_HUGETLB, %uz) failed for \"%V\", "
+                      "using transparent huge pages", size, &shm->name);
+    }
+
+#endif
+
     shm->addr = (u_char *) mmap(NULL, shm->size,
                                 PROT_READ|PROT_WRITE,
                                 MAP_ANON|MAP_SHARED, -1, 0);
@@ -24,6 +50,18 @@ ngx_shm_alloc(ngx_shm_t *shm)
         return NGX_ERROR;
     }
 
+#if defined(MADV_HUGEPAGE)
+
+    if (shm->hugepages
+        && madvise((void *) shm->addr, shm->size, MADV_HUGEPAGE) == -1)
+    {
+        ngx_log_error(NGX_LOG_NOTICE, shm->log, ngx_errno,
+                      "madvise(MADV_HUGEPAGE) failed for \"%V\"",
+                      &shm->name);
+    }
+
+#endif
+
     return NGX_OK;
 }
 
@@ -31,9 +69,17 @@ ngx_shm_alloc(ngx_shm_t *shm)
 void
 ngx_shm_free(ngx_shm_t *shm)
 {
-    if (munmap((void *) shm->addr, shm->size) == -1) {
+    size_t  size;
+
+    size = shm->size;
+
+    if (shm->hugepages == NGX_SHM_HUGETLB) {
+        size = ngx_align(size, NGX_SHM_HUGEPAGE_SIZE);
+    }
+
+    if (munmap((void *) shm->addr, size) == -1) {
         ngx_log_error(NGX_LOG_ALERT, shm->log, ngx_errno,
-                      "munmap(%p, %uz) failed", shm->addr, shm->size);
+                      "munmap(%p, %uz) failed", shm->addr, size);
     }
 }
 
@@ -13,12 +13,19 @@
 #include <ngx_core.h>
 
 
+#define NGX_SHM_HUGEPAGES      1
+#define NGX_SHM_HUGETLB        2
+
+#define NGX_SHM_HUGEPAGE_SIZE  (2 * 1024 * 1024)
+
+
 typedef struct {
     u_char      *addr;
     size_t       size;
     ngx_str_t    name;
     ngx_log_t   *log;
     ngx_uint_t   exists;   /* unsigned  exists:1;  */
+    ngx_uint_t   hugepages;
 } ngx_shm_t;
 
 
@@ -13,6 +13,11 @@
 #include <ngx_core.h>
 
 
+/* huge pages are not used on win32 */
+
+#define NGX_SHM_HUGEPAGES      1
+
+
 typedef struct {
     u_char      *addr;
     size_t       size;
@@ -20,6 +25,7 @@ typedef struct {
     HANDLE       handle;
     ngx_log_t   *log;
     ngx_uint_t   exists;   /* unsigned  exists:1;  */
+    ngx_uint_t   hugepages;
 } ngx_shm_t;
 
 
@@ -0,0 +1,618 @@
+
+/*
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_stream.h>
+
+
+typedef struct {
+    ngx_msec_t                          interval;
+    ngx_msec_t                          timeout;
+    ngx_uint_t                          fails;
+    ngx_uint_t                          passes;
+    ngx_uint_t                          concurrency;
+} ngx_stream_upstream_hc_srv_conf_t;
+
+
+typedef struct ngx_stream_upstream_hc_s  ngx_stream_upstream_hc_t;
+
+typedef struct {
+    ngx_stream_upstream_hc_t           *hc;
+    ngx_stream_upstream_rr_peers_t     *peers;
+    ngx_stream_upstream_rr_peer_t      *peer;
+
+    ngx_peer_connection_t               pc;
+
+    ngx_uint_t                          fails;
+    ngx_uint_t                          passes;
+} ngx_stream_upstream_hc_peer_t;
+
+
+struct ngx_stream_upstream_hc_s {
+    ngx_stream_upstream_hc_srv_conf_t  *conf;
+    ngx_str_t                          *upstream;
+
+    ngx_event_t                         event;
+    ngx_event_t                         post;
+    ngx_log_t                           log;
+
+    ngx_stream_upstream_hc_peer_t      *peers;
+    ngx_uint_t                          npeers;
+    ngx_uint_t                          next;
+    ngx_uint_t                          running;
+};
+
+
+static ngx_int_t ngx_stream_upstream_hc_init_process(ngx_cycle_t *cycle);
+static ngx_int_t ngx_stream_upstream_hc_init_upstream(ngx_cycle_t *cycle,
+    ngx_stream_upstream_srv_conf_t *uscf);
+static void ngx_stream_upstream_hc_handler(ngx_event_t *ev);
+static void ngx_stream_upstream_hc_post_handler(ngx_event_t *ev);
+static void ngx_stream_upstream_hc_next(ngx_stream_upstream_hc_t *hc);
+static void ngx_stream_upstream_hc_start(ngx_stream_upstream_hc_peer_t *hp);
+static void ngx_stream_upstream_hc_connect_handler(ngx_event_t *ev);
+static ngx_int_t ngx_stream_upstream_hc_test_connect(ngx_connection_t *c);
+static void ngx_stream_upstream_hc_done(ngx_stream_upstream_hc_peer_t *hp,
+    ngx_uint_t ok);
+static ngx_int_t ngx_stream_upstream_hc_postconfiguration(ngx_conf_t *cf);
+static void *ngx_stream_upstream_hc_create_conf(ngx_conf_t *cf);
+static char *ngx_stream_upstream_hc(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf);
+
+
+static ngx_command_t  ngx_stream_upstream_hc_commands[] = {
+
+    { ngx_string("health_check"),
+      NGX_STREAM_UPS_CONF|NGX_CONF_ANY,
+      ngx_stream_upstream_hc,
+      NGX_STREAM_SRV_CONF_OFFSET,
+      0,
+      NULL },
+
+      ngx_null_command
+};
+
+
+static ngx_stream_module_t  ngx_stream_upstream_hc_module_ctx = {
+    NULL,                                    /* preconfiguration */
+    ngx_stream_upstream_hc_postconfiguration, /* postconfiguration */
+
+    NULL,                                    /* create main configuration */
+    NULL,                                    /* init main configuration */
+
+    ngx_stream_upstream_hc_create_conf,      /* create server configuration */
+    NULL                                     /* merge server configuration */
+};
+
+
+ngx_module_t  ngx_stream_upstream_hc_module = {
+    NGX_MODULE_V1,
+    &ngx_stream_upstream_hc_module_ctx,      /* module context */
+    ngx_stream_upstream_hc_commands,         /* module directives */
+    NGX_STREAM_MODULE,                       /* module type */
+    NULL,                                    /* init master */
+    NULL,                                    /* init module */
+    ngx_stream_upstream_hc_init_process,     /* init process */
+    NULL,                                    /* init thread */
+    NULL,                                    /* exit thread */
+    NULL,                                    /* exit process */
+    NULL,                                    /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+static ngx_int_t
+ngx_stream_upstream_hc_init_process(ngx_cycle_t *cycle)
+{
+    ngx_uint_t                           i;
+    ngx_stream_upstream_srv_conf_t     **uscfp;
+    ngx_stream_upstream_main_conf_t     *umcf;
+    ngx_stream_upstream_hc_srv_conf_t   *hccf;
+
+    /* checks are run by a single worker, results are kept in the zone */
+
+    if (ngx_process != NGX_PROCESS_WORKER
+        && ngx_process != NGX_PROCESS_SINGLE)
+    {
+        return NGX_OK;
+    }
+
+    if (ngx_worker != 0) {
+        return NGX_OK;
+    }
+
+    umcf = ngx_stream_cycle_get_module_main_conf(cycle,
+                                                 ngx_stream_upstream_module);
+    if (umcf == NULL) {
+        return NGX_OK;
+    }
+
+    uscfp = umcf->upstreams.elts;
+
+    for (i = 0; i < umcf->upstreams.nelts; i++) {
+
+        if (uscfp[i]->srv_conf == NULL || uscfp[i]->shm_zone == NULL) {
+            continue;
+        }
+
+        hccf = ngx_stream_conf_upstream_srv_conf(uscfp[i],
+                                                 ngx_stream_upstream_hc_module);
+
+        if (hccf->interval == NGX_CONF_UNSET_MSEC) {
+            continue;
+        }
+
+        if (ngx_stream_upstream_hc_init_upstream(cycle, uscfp[i]) != NGX_OK) {
+            return NGX_ERROR;
+        }
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_stream_upstream_hc_init_upstream(ngx_cycle_t *cycle,
+    ngx_stream_upstream_srv_conf_t *uscf)
+{
+    ngx_uint_t                       n;
+    ngx_stream_upstream_hc_t        *hc;
+    ngx_stream_upstream_rr_peer_t   *peer;
+    ngx_stream_upstream_rr_peers_t  *peers, *pp;
+    ngx_stream_upstream_hc_peer_t   *hp;
+
+    peers = uscf->peer.data;
+
+    n = 0;
+
+    for (pp = peers; pp; pp = pp->next) {
+        for (peer = pp->peer; peer; peer = peer->next) {
+            if (!peer->down) {
+                n++;
+            }
+        }
+    }
+
+    if (n == 0) {
+        return NGX_OK;
+    }
+
+    hc = ngx_pcalloc(cycle->pool, sizeof(ngx_stream_upstream_hc_t));
+    if (hc == NULL) {
+        return NGX_ERROR;
+    }
+
+    hp = ngx_pcalloc(cycle->pool, n * sizeof(ngx_stream_upstream_hc_peer_t));
+    if (hp == NULL) {
+        return NGX_ERROR;
+    }
+
+    hc->conf = ngx_stream_conf_upstream_srv_conf(uscf,
+                                                 ngx_stream_upstream_hc_module);
+    hc->upstream = &uscf->host;
+    hc->peers = hp;
+    hc->npeers = n;
+
+    hc->log = *cycle->log;
+    hc->log.action = "checking upstream health";
+
+    for (pp = peers; pp; pp = pp->next) {
+        for (peer = pp->peer; peer; peer = peer->next) {
+            if (peer->down) {
+                continue;
+            }
+
+            hp->hc = hc;
+            hp->peers = pp;
+            hp->peer = peer;
+
+            hp++;
+        }
+    }
+
+    hc->event.handler = ngx_stream_upstream_hc_handler;
+    hc->event.data = hc;
+    hc->event.log = &hc->log;
+    hc->event.cancelable = 1;
+
+    hc->post.handler = ngx_stream_upstream_hc_post_handler;
+    hc->post.data = hc;
+    hc->post.log = &hc->log;
+
+    ngx_add_timer(&hc->event, 0);
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_stream_upstream_hc_handler(ngx_event_t *ev)
+{
+    ngx_stream_upstream_hc_t  *hc;
+
+    hc = ev->data;
+
+    if (ngx_exiting || ngx_terminate || ngx_quit) {
+        return;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_STREAM, ev->log, 0,
+                   "health check upstream \"%V\"", hc->upstream);
+
+    hc->next = 0;
+
+    ngx_stream_upstream_hc_next(hc);
+}
+
+
+static void
+ngx_stream_upstream_hc_post_handler(ngx_event_t *ev)
+{
+    ngx_stream_upstream_hc_next(ev->data);
+}
+
+
+static void
+ngx_stream_upstream_hc_next(ngx_stream_upstream_hc_t *hc)
+{
+    while (hc->running < hc->conf->concurrency && hc->next < hc->npeers) {
+
+        if (ngx_exiting || ngx_terminate || ngx_quit) {
+            return;
+        }
+
+        ngx_stream_upstream_hc_start(&hc->peers[hc->next++]);
+    }
+
+    if (hc->running == 0 && hc->next == hc->npeers
+        && !(ngx_exiting || ngx_terminate || ngx_quit))
+    {
+        ngx_add_timer(&hc->event, hc->conf->interval);
+    }
+}
+
+
+static void
+ngx_stream_upstream_hc_start(ngx_stream_upstream_hc_peer_t *hp)
+{
+    ngx_int_t                  rc;
+    ngx_connection_t          *c;
+    ngx_stream_upstream_hc_t  *hc;
+
+    hc = hp->hc;
+
+    ngx_memzero(&hp->pc, sizeof(ngx_peer_connection_t));
+
+    hp->pc.sockaddr = hp->peer->sockaddr;
+    hp->pc.socklen = hp->peer->socklen;
+    hp->pc.name = &hp->peer->name;
+    hp->pc.get = ngx_event_get_peer;
+    hp->pc.log = &hc->log;
+    hp->pc.log_error = NGX_ERROR_ERR;
+
+    hc->running++;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_STREAM, &hc->log, 0,
+                   "health check peer %V", hp->pc.name);
+
+    rc = ngx_event_connect_peer(&hp->pc);
+
+    if (rc == NGX_ERROR || rc == NGX_BUSY || rc == NGX_DECLINED) {
+        ngx_stream_upstream_hc_done(hp, 0);
+        return;
+    }
+
+    c = hp->pc.connection;
+
+    c->data = hp;
+    c->idle = 1;
+    c->read->cancelable = 1;
+    c->write->cancelable = 1;
+    c->read->handler = ngx_stream_upstream_hc_connect_handler;
+    c->write->handler = ngx_stream_upstream_hc_connect_handler;
+
+    if (rc == NGX_AGAIN) {
+        ngx_add_timer(c->write, hc->conf->timeout);
+        return;
+    }
+
+    ngx_stream_upstream_hc_connect_handler(c->write);
+}
+
+
+static void
+ngx_stream_upstream_hc_connect_handler(ngx_event_t *ev)
+{
+    ngx_connection_t               *c;
+    ngx_stream_upstream_hc_peer_t  *hp;
+
+    c = ev->data;
+    hp = c->data;
+
+    if (c->close) {
+        /* graceful shutdown, see ngx_close_idle_connections() */
+        ngx_close_connection(c);
+        hp->pc.connection = NULL;
+        hp->hc->running--;
+        return;
+    }
+
+    if (ev->timedout) {
+        ngx_log_error(NGX_LOG_ERR, c->log, NGX_ETIMEDOUT,
+                      "health check of %V timed out", hp->pc.name);
+        ngx_stream_upstream_hc_done(hp, 0);
+        return;
+    }
+
+    if (ngx_stream_upstream_hc_test_connect(c) != NGX_OK) {
+        ngx_stream_upstream_hc_done(hp, 0);
+        return;
+    }
+
+    ngx_stream_upstream_hc_done(hp, 1);
+}
+
+
+static ngx_int_t
+ngx_stream_upstream_hc_test_connect(ngx_connection_t *c)
+{
+    int        err;
+    socklen_t  len;
+
+#if (NGX_HAVE_KQUEUE)
+
+    if (ngx_event_flags & NGX_USE_KQUEUE_EVENT)  {
+        if (c->write->pending_eof || c->read->pending_eof) {
+            if (c->write->pending_eof) {
+                err = c->write->kq_errno;
+
+            } else {
+                err = c->read->kq_errno;
+            }
+
+            (void) ngx_connection_error(c, err,
+                                    "kevent() reported that connect() failed");
+            return NGX_ERROR;
+        }
+
+    } else
+#endif
+    {
+        err = 0;
+        len = sizeof(int);
+
+        if (getsockopt(c->fd, SOL_SOCKET, SO_ERROR, (void *) &err, &len)
+            == -1)
+        {
+            err = ngx_socket_errno;
+        }
+
+        if (err) {
+            (void) ngx_connection_error(c, err, "connect() failed");
+            return NGX_ERROR;
+        }
+    }
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_stream_upstream_hc_done(ngx_stream_upstream_hc_peer_t *hp, ngx_uint_t ok)
+{
+    ngx_stream_upstream_hc_t        *hc;
+    ngx_stream_upstream_rr_peer_t   *peer;
+    ngx_stream_upstream_rr_peers_t  *peers;
+
+    hc = hp->hc;
+    peer = hp->peer;
+    peers = hp->peers;
+
+    if (hp->pc.connection) {
+        ngx_close_connection(hp->pc.connection);
+        hp->pc.connection = NULL;
+    }
+
+    ngx_stream_upstream_rr_peers_rlock(peers);
+    ngx_stream_upstream_rr_peer_lock(peers, peer);
+
+    if (ok) {
+        hp->fails = 0;
+
+        if ((peer->down & NGX_STREAM_UPSTREAM_RR_UNHEALTHY)
+            && ++hp->passes >= hc->conf->passes)
+        {
+            peer->down &= ~NGX_STREAM_UPSTREAM_RR_UNHEALTHY;
+            peer->fails = 0;
+
+            ngx_log_error(NGX_LOG_NOTICE, &hc->log, 0,
+                          "upstream server %V in upstream \"%V\" is healthy",
+                          &peer->name, hc->upstream);
+        }
+
+    } else {
+        hp->passes = 0;
+
+        if (!(peer->down & NGX_STREAM_UPSTREAM_RR_UNHEALTHY)
+            && ++hp->fails >= hc->conf->fails)
+        {
+            peer->down |= NGX_STREAM_UPSTREAM_RR_UNHEALTHY;
+
+            ngx_log_error(NGX_LOG_WARN, &hc->log, 0,
+                          "upstream server %V in upstream \"%V\" is unhealthy",
+                          &peer->name, hc->upstream);
+        }
+    }
+
+    ngx_stream_upstream_rr_peer_unlock(peers, peer);
+    ngx_stream_upstream_rr_peers_unlock(peers);
+
+    hc->running--;
+
+    /*
+     * the next probe is started from a posted event: a probe which
+     * fails right in ngx_stream_upstream_hc_start() would otherwise recurse
+     */
+
+    ngx_post_event(&hc->post, &ngx_posted_events);
+}
+
+
+static ngx_int_t
+ngx_stream_upstream_hc_postconfiguration(ngx_conf_t *cf)
+{
+    ngx_uint_t                           i;
+    ngx_stream_upstream_srv_conf_t     **uscfp;
+    ngx_stream_upstream_main_conf_t     *umcf;
+    ngx_stream_upstream_hc_srv_conf_t   *hccf;
+
+    umcf = ngx_stream_conf_get_module_main_conf(cf,
+                                                ngx_stream_upstream_module);
+
+    uscfp = umcf->upstreams.elts;
+
+    for (i = 0; i < umcf->upstreams.nelts; i++) {
+
+        if (uscfp[i]->srv_conf == NULL) {
+            continue;
+        }
+
+        hccf = ngx_stream_conf_upstream_srv_conf(uscfp[i],
+                                                 ngx_stream_upstream_hc_module);
+
+        if (hccf->interval != NGX_CONF_UNSET_MSEC
+            && uscfp[i]->shm_zone == NULL)
+        {
+            ngx_log_error(NGX_LOG_EMERG, cf->log, 0,
+                          "health check requires \"zone\" in upstream \"%V\" "
+                          "in %s:%ui", &uscfp[i]->host,
+                          uscfp[i]->file_name, uscfp[i]->line);
+            return NGX_ERROR;
+        }
+    }
+
+    return NGX_OK;
+}
+
+
+static void *
+ngx_stream_upstream_hc_create_conf(ngx_conf_t *cf)
+{
+    ngx_stream_upstream_hc_srv_conf_t  *conf;
+
+    conf = ngx_pcalloc(cf->pool, sizeof(ngx_stream_upstream_hc_srv_conf_t));
+    if (conf == NULL) {
+        return NULL;
+    }
+
+    conf->interval = NGX_CONF_UNSET_MSEC;
+
+    return conf;
+}
+
+
+static char *
+ngx_stream_upstream_hc(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
+{
+    ngx_stream_upstream_hc_srv_conf_t  *hccf = conf;
+
+    ngx_int_t   n;
+    ngx_str_t  *value, s;
+    ngx_uint_t  i;
+
+    if (hccf->interval != NGX_CONF_UNSET_MSEC) {
+        return "is duplicate";
+    }
+
+    hccf->interval = 5000;
+    hccf->timeout = 1000;
+    hccf->fails = 1;
+    hccf->passes = 1;
+    hccf->concurrency = 16;
+
+    value = cf->args->elts;
+
+    for (i = 1; i < cf->args->nelts; i++) {
+
+        if (ngx_strncmp(value[i].data, "interval=", 9) == 0) {
+
+            s.len = value[i].len - 9;
+            s.data = &value[i].data[9];
+
+            hccf->interval = ngx_parse_time(&s, 0);
+            if (hccf->interval == (ngx_msec_t) NGX_ERROR
+                || hccf->interval == 0)
+            {
+                goto invalid;
+            }
+
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "timeout=", 8) == 0) {
+
+            s.len = value[i].len - 8;
+            s.data = &value[i].data[8];
+
+            hccf->timeout = ngx_parse_time(&s, 0);
+            if (hccf->timeout == (ngx_msec_t) NGX_ERROR
+                || hccf->timeout == 0)
+            {
+                goto invalid;
+            }
+
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "fails=", 6) == 0) {
+
+            n = ngx_atoi(&value[i].data[6], value[i].len - 6);
+            if (n == NGX_ERROR || n == 0) {
+                goto invalid;
+            }
+
+            hccf->fails = n;
+
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "passes=", 7) == 0) {
+
+            n = ngx_atoi(&value[i].data[7], value[i].len - 7);
+            if (n == NGX_ERROR || n == 0) {
+                goto invalid;
+            }
+
+            hccf->passes = n;
+
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "concurrency=", 12) == 0) {
+
+            n = ngx_atoi(&value[i].data[12], value[i].len - 12);
+            if (n == NGX_ERROR || n == 0) {
+                goto invalid;
+            }
+
+            hccf->concurrency = n;
+
+            continue;
+        }
+
+        goto invalid;
+    }
+
+    return NGX_CONF_OK;
+
+invalid:
+
+    ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                       "invalid parameter \"%V\"", &value[i]);
+
+    return NGX_CONF_ERROR;
+}
@@ -14,6 +14,10 @@
 #include <ngx_stream.h>
 
 
+/* set in peer->down by health checks */
+#define NGX_STREAM_UPSTREAM_RR_UNHEALTHY  0x02
+
+
 typedef struct ngx_stream_upstream_rr_peer_s   ngx_stream_upstream_rr_peer_t;
 
 struct ngx_stream_upstream_rr_peer_s {